@@ -36,16 +36,16 @@ LD = ${CC}
 RANLIB = @RANLIB@
 PYTHON = @PYTHON@
 ASFLAGS = @ASFLAGS@
-CFLAGS = -g -O2 -DHAVE_CONFIG_H -fno-strength-reduce -W -Wall -Wno-unused-parameter -Wno-missing-field-initializers -pedantic -I/usr/include/ncursesw  -I/usr/include/SDL -D_GNU_SOURCE=1 -D_REENTRANT -I/usr/include/SDL -D_GNU_SOURCE=1 -D_REENTRANT
+CFLAGS = -g -O2 -DHAVE_CONFIG_H -fno-strength-reduce -W -Wall -Wno-unused-parameter -Wno-missing-field-initializers -pedantic -D_DEFAULT_SOURCE -D_XOPEN_SOURCE=600  -include signal.h -fcommon
 CXXFLAGS = @CXXFLAGS@
 CPPFLAGS =  -I.
 DFLAGS = @DFLAGS@
 ERLCFLAGS = @ERLCFLAGS@
 OBJCFLAGS = @OBJCFLAGS@
 OBJCXXFLAGS = @OBJCXXFLAGS@
-LDFLAGS = 
+LDFLAGS =  
 LDFLAGS_RPATH = @LDFLAGS_RPATH@
-LIBS =  -lncursesw  -lSM -lICE  -lX11  -L/usr/lib64 -lSDL -lpthread -lSDL_image -lSDL_ttf -lSDL_mixer -lm
+LIBS =  -lncursesw -ltinfo -lm -lsqlite3
 PYTHON_FLAGS = @PYTHON_FLAGS@
 PROG_IMPLIB_NEEDED = @PROG_IMPLIB_NEEDED@
 PROG_IMPLIB_LDFLAGS = @PROG_IMPLIB_LDFLAGS@
@@ -63,7 +63,7 @@ CLEAN_LIB = @CLEAN_LIB@
 LN_S = ln -s
 MKDIR_P = mkdir -p
 INSTALL = /usr/bin/install -c
-SHELL = /bin/sh
+SHELL = /bin/bash
 MSGFMT = @MSGFMT@
 JAVAC = @JAVAC@
 JAVACFLAGS = @JAVACFLAGS@
@@ -71,8 +71,8 @@ JAR = @JAR@
 WINDRES = @WINDRES@
 prefix = /usr/local
 exec_prefix = /usr/local
-bindir = /usr/local/games
-libdir = ${exec_prefix}/lib64
+bindir = ..
+libdir = ${exec_prefix}/lib
 plugindir ?= ${libdir}/${PACKAGE}
 datarootdir = ${prefix}/share
 datadir = ${datarootdir}
@@ -0,0 +1,146 @@
+/* src/autoconf.h.  Generated from autoconf.h.in by configure.  */
+/* src/autoconf.h.in.  Generated from configure.ac by autoheader.  */
+
+/* Path to the game's configuration data */
+#define DEFAULT_CONFIG_PATH "/root/repo/lib/"
+
+/* Path to the game's variable data */
+#define DEFAULT_DATA_PATH "/root/repo/lib/"
+
+/* Path to the game's lib directory */
+#define DEFAULT_LIB_PATH "/root/repo/lib/"
+
+/* Define to 1 if you have the `can_change_color' function. */
+#define HAVE_CAN_CHANGE_COLOR 1
+
+/* Define to 1 if you have the <dirent.h> header file, and it defines `DIR'.
+   */
+#define HAVE_DIRENT_H 1
+
+/* Define to 1 if you have the <fcntl.h> header file. */
+#define HAVE_FCNTL_H 1
+
+/* Define to 1 if you have the <inttypes.h> header file. */
+#define HAVE_INTTYPES_H 1
+
+/* Define to 1 if you have the <memory.h> header file. */
+#define HAVE_MEMORY_H 1
+
+/* Define to 1 if you have the `mkdir' function. */
+#define HAVE_MKDIR 1
+
+/* Define to 1 if you have the `mvwaddnwstr' function. */
+#define HAVE_MVWADDNWSTR 1
+
+/* Define to 1 if you have the <ndir.h> header file, and it defines `DIR'. */
+/* #undef HAVE_NDIR_H */
+
+/* Define to 1 if you have the `setegid' function. */
+#define HAVE_SETEGID 1
+
+/* Define to 1 if you have the `setresgid' function. */
+#define HAVE_SETRESGID 1
+
+/* Define to 1 if you have the `stat' function. */
+#define HAVE_STAT 1
+
+/* Define to 1 if stdbool.h conforms to C99. */
+#define HAVE_STDBOOL_H 1
+
+/* Define to 1 if you have the <stdint.h> header file. */
+#define HAVE_STDINT_H 1
+
+/* Define to 1 if you have the <stdlib.h> header file. */
+#define HAVE_STDLIB_H 1
+
+/* Define to 1 if you have the <strings.h> header file. */
+#define HAVE_STRINGS_H 1
+
+/* Define to 1 if you have the <string.h> header file. */
+#define HAVE_STRING_H 1
+
+/* Define to 1 if you have the <sys/dir.h> header file, and it defines `DIR'.
+   */
+/* #undef HAVE_SYS_DIR_H */
+
+/* Define to 1 if you have the <sys/ndir.h> header file, and it defines `DIR'.
+   */
+/* #undef HAVE_SYS_NDIR_H */
+
+/* Define to 1 if you have the <sys/stat.h> header file. */
+#define HAVE_SYS_STAT_H 1
+
+/* Define to 1 if you have the <sys/types.h> header file. */
+#define HAVE_SYS_TYPES_H 1
+
+/* Define to 1 if you have the <unistd.h> header file. */
+#define HAVE_UNISTD_H 1
+
+/* Define to 1 if you have the `use_default_colors' function. */
+#define HAVE_USE_DEFAULT_COLORS 1
+
+/* Define to 1 if the system has the type `_Bool'. */
+#define HAVE__BOOL 1
+
+/* Name of package */
+#define PACKAGE "faangband"
+
+/* Define to the address where bug reports for this package should be sent. */
+#define PACKAGE_BUGREPORT "nckmccnnll@gmail.com"
+
+/* Define to the full name of this package. */
+#define PACKAGE_NAME "FAangband"
+
+/* Define to the full name and version of this package. */
+#define PACKAGE_STRING "FAangband 1.2.0"
+
+/* Define to the one symbol short name of this package. */
+#define PACKAGE_TARNAME "faangband"
+
+/* Define to the home page for this package. */
+#define PACKAGE_URL ""
+
+/* Define to the version of this package. */
+#define PACKAGE_VERSION "1.2.0"
+
+/* Define as the return type of signal handlers (`int' or `void'). */
+#define RETSIGTYPE void
+
+/* Define to 1 if using SDL_mixer sound support and it's found. */
+/* #undef SOUND_SDL */
+
+/* Define to 1 if you have the ANSI C header files. */
+#define STDC_HEADERS 1
+
+/* Define to 1 if using the Curses frontend. */
+#define USE_GCU 1
+
+/* Define to 1 if NCurses is found. */
+#define USE_NCURSES 1
+
+/* Define to use private save and score paths. */
+/* #undef USE_PRIVATE_PATHS */
+
+/* Define to 1 if using the SDL interface and SDL is found. */
+/* #undef USE_SDL */
+
+/* Define to 0 to omit the stats frontend */
+#undef USE_STATS
+
+/* Define to 1 to build the test frontend */
+#undef USE_TEST
+
+/* Define to 1 if using the Windows interface. */
+/* #undef USE_WIN */
+
+/* Define to 1 if using the X11 frontend and X11 libraries are found. */
+/* #undef USE_X11 */
+
+/* Version number of package */
+#define VERSION ""
+
+/* Define to 1 if the X Window System is missing or not being used. */
+/* #undef X_DISPLAY_MISSING */
+
+/* Define to empty if `const' does not conform to ANSI C. */
+/* #undef const */
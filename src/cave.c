@@ -563,17 +563,17 @@ byte get_color(byte a, int attr, int n)
 bool dtrap_edge(int y, int x) 
 { 
     /* Check if the square is a dtrap in the first place */ 
-    if (!cave_has(cave_info[y][x], CAVE_DTRAP)) return FALSE; 
+    if (!cave_has(y, x, CAVE_DTRAP)) return FALSE; 
 
     /* Check for non-dtrap adjacent grids */ 
     if (in_bounds_fully(y + 1, x    ) && 
-	(!cave_has(cave_info[y + 1][x    ], CAVE_DTRAP))) return TRUE; 
+	(!cave_has(y + 1, x, CAVE_DTRAP))) return TRUE; 
     if (in_bounds_fully(y    , x + 1) && 
-	(!cave_has(cave_info[y    ][x + 1], CAVE_DTRAP))) return TRUE; 
+	(!cave_has(y, x + 1, CAVE_DTRAP))) return TRUE; 
     if (in_bounds_fully(y - 1, x    ) && 
-	(!cave_has(cave_info[y - 1][x    ], CAVE_DTRAP))) return TRUE; 
+	(!cave_has(y - 1, x, CAVE_DTRAP))) return TRUE; 
     if (in_bounds_fully(y    , x - 1) && 
-	(!cave_has(cave_info[y    ][x - 1], CAVE_DTRAP))) return TRUE; 
+	(!cave_has(y, x - 1, CAVE_DTRAP))) return TRUE; 
 
     return FALSE; 
 } 
@@ -750,8 +750,8 @@ void grid_data_as_text(grid_data *g, byte *ap, wchar_t *cp, byte *tap, wchar_t *
 			}
 			
 			/* Normal monster (not "clear" in any way) */
-			else if (!flags_test(r_ptr->flags, RF_SIZE,
-				RF_ATTR_CLEAR, RF_CHAR_CLEAR, FLAG_END))
+			else if (!rf_has(r_ptr->flags, RF_ATTR_CLEAR) &&
+				!rf_has(r_ptr->flags, RF_CHAR_CLEAR))
 			{
 				/* Use attr */
 				a = da;
@@ -915,7 +915,7 @@ void map_info(unsigned y, unsigned x, grid_data *g)
 
     /* Set things we can work out right now */
     g->f_idx = cave_feat[y][x];
-    g->in_view = cave_has(cave_info[y][x], CAVE_SEEN) ? TRUE : FALSE;
+    g->in_view = cave_has(y, x, CAVE_SEEN) ? TRUE : FALSE;
     g->is_player = (cave_m_idx[y][x] < 0) ? TRUE : FALSE;
     g->m_idx = (g->is_player) ? 0 : cave_m_idx[y][x];
     g->hallucinate = p_ptr->timed[TMD_IMAGE] ? TRUE : FALSE;
@@ -930,19 +930,19 @@ void map_info(unsigned y, unsigned x, grid_data *g)
     {
 	g->lighting = FEAT_LIGHTING_LIT;
 
-	if (!cave_has(cave_info[y][x], CAVE_GLOW) && OPT(view_yellow_light))
+	if (!cave_has(y, x, CAVE_GLOW) && OPT(view_yellow_light))
 	    g->lighting = FEAT_LIGHTING_BRIGHT;
 
     }
     /* Unknown */
-    else if (!cave_has(cave_info[y][x], CAVE_MARK))
+    else if (!cave_has(y, x, CAVE_MARK))
     {
 	g->f_idx = FEAT_NONE;
     }
        
     /* There is a trap in this grid */
-    if (cave_has(cave_info[y][x], CAVE_TRAP) && 
-	cave_has(cave_info[y][x], CAVE_MARK))
+    if (cave_has(y, x, CAVE_TRAP) && 
+	cave_has(y, x, CAVE_MARK))
     {
 	int i;
 	
@@ -1259,7 +1259,7 @@ void note_spot(int y, int x)
     object_type *o_ptr;
 
     /* Require "seen" flag */
-    if (!cave_has(cave_info[y][x], CAVE_SEEN)) return;
+    if (!cave_has(y, x, CAVE_SEEN)) return;
 
 
     /* Hack -- memorize objects */
@@ -1271,11 +1271,11 @@ void note_spot(int y, int x)
 
 
     /* Hack -- memorize grids */
-    if (cave_has(cave_info[y][x], CAVE_MARK))
+    if (cave_has(y, x, CAVE_MARK))
 	return;
 
     /* Memorize */
-    cave_on(cave_info[y][x], CAVE_MARK);
+    cave_on(y, x, CAVE_MARK);
 }
 
 
@@ -1931,18 +1931,13 @@ void do_cmd_view_map(void)
  * use of shifting instead of multiplication.
  *
  * Several pieces of information about each cave grid are stored in the
- * "cave_info" array, which is a special two dimensional array of bytes,
- * one for each cave grid, each containing eight separate "flags" which
- * describe some property of the cave grid.  These flags can be checked and
- * modified extremely quickly, especially when special idioms are used to
- * force the compiler to keep a local register pointing to the base of the
- * array.  Special location offset macros can be used to minimize the number
- * of computations which must be performed at runtime.  Note that using a
- * byte for each flag set may be slightly more efficient than using a larger
- * unit, so if another flag (or two) is needed later, and it must be fast,
- * then the two existing flags which do not have to be fast should be moved
- * out into some other data structure and the new flags should take their
- * place.  This may require a few minor changes in the savefile code.
+ * "cave_info" array, which holds one bitplane per cave flag, with one bit
+ * for each cave grid.  These flags can be checked and modified extremely
+ * quickly with the cave_has()/cave_on()/cave_off() macros, and a flag can
+ * be set or cleared across the whole level a 64-bit word at a time with
+ * the cave_flag_*() functions.  The savefile still stores the flags a byte
+ * per grid at a time (see cave_info_byte()), so new flags can be added
+ * freely.
  *
  * The "CAVE_ROOM" flag is saved in the savefile and is used to determine
  * which grids are part of "rooms", and thus which grids are affected by
@@ -2249,6 +2244,62 @@ static vinfo_type vinfo[VINFO_MAX_GRIDS];
 
 
 
+/*
+ * Incremental view state.
+ *
+ * The view is the union of eight octant scans, and each octant scan only
+ * looks at grids inside its own octant.  So if we remember which grids
+ * each octant found viewable, a terrain change only needs the octants
+ * containing that grid to be scanned again; if nothing has changed at all
+ * the view does not need recalculating.
+ *
+ * view_by[][] holds, for each grid near the view origin, the octants which
+ * found it viewable, whether it is lit, and a scratch "touched" mark.
+ */
+#define VIEW_RAD	MAX_SIGHT_LGE
+#define VIEW_WID	(2 * VIEW_RAD + 1)
+
+#define VIEW_LIT	0x0100
+#define VIEW_TOUCHED	0x0200
+
+static u16b view_by[VIEW_WID][VIEW_WID];
+static byte view_octants[VIEW_WID][VIEW_WID];
+static u16b view_oct_g[8][VINFO_MAX_GRIDS];
+static int view_oct_n[8];
+static byte view_dirty;
+static bool view_valid = FALSE;
+static int view_py, view_px, view_radius;
+static bool view_blind;
+
+
+
+/**
+ * Note that grid (y, x) has changed in a way which may affect the view.
+ */
+static void update_view_mark(int y, int x)
+{
+    int dy = y - view_py;
+    int dx = x - view_px;
+
+    if (!view_valid)
+	return;
+    if ((ABS(dy) > VIEW_RAD) || (ABS(dx) > VIEW_RAD))
+	return;
+
+    view_dirty |= view_octants[dy + VIEW_RAD][dx + VIEW_RAD];
+}
+
+
+/**
+ * Throw away the incremental view state, forcing a full calculation.
+ */
+static void update_view_invalidate(void)
+{
+    view_valid = FALSE;
+}
+
+
+
 
 /**
  * Slope scale factor
@@ -2685,6 +2736,26 @@ errr vinfo_init(void)
     }
 
 
+    /* Note which octants contain each grid */
+    memset(view_octants, 0, sizeof(view_octants));
+    for (i = 1; i < vinfo_grids; i++) {
+	y = vinfo[i].y;
+	x = vinfo[i].x;
+
+	view_octants[VIEW_RAD + y][VIEW_RAD + x] |= 0x01;
+	view_octants[VIEW_RAD + x][VIEW_RAD + y] |= 0x02;
+	view_octants[VIEW_RAD + x][VIEW_RAD - y] |= 0x04;
+	view_octants[VIEW_RAD + y][VIEW_RAD - x] |= 0x08;
+	view_octants[VIEW_RAD - y][VIEW_RAD - x] |= 0x10;
+	view_octants[VIEW_RAD - x][VIEW_RAD - y] |= 0x20;
+	view_octants[VIEW_RAD - x][VIEW_RAD + y] |= 0x40;
+	view_octants[VIEW_RAD - y][VIEW_RAD + x] |= 0x80;
+    }
+
+    /* Any old view is meaningless now */
+    update_view_invalidate();
+
+
     /* Kill hack */
     FREE(hack);
 
@@ -2695,6 +2766,19 @@ errr vinfo_init(void)
 
 
 
+/**
+ * Mark the monster (if any) in a grid which has entered or left the view,
+ * so that update_monsters() checks whether it can still be seen.
+ */
+static void view_mark_monster(int y, int x)
+{
+    int m_idx = cave_m_idx[y][x];
+
+    if (m_idx > 0)
+	m_list[m_idx].mflag |= (MFLAG_DIRTY);
+}
+
+
 /**
  * Forget the "CAVE_VIEW" grids, redrawing as needed
  */
@@ -2705,11 +2789,18 @@ void forget_view(void)
     int fast_view_n = view_n;
     u16b *fast_view_g = view_g;
 
+    /* The incremental view is gone too */
+    update_view_invalidate();
+
     /* None to forget */
     if (!fast_view_n)
 	return;
 
-    /* Clear them all */
+    /* Clear "CAVE_VIEW" and "CAVE_SEEN" flags */
+    cave_flag_wipe(CAVE_VIEW);
+    cave_flag_wipe(CAVE_SEEN);
+
+    /* Check and redraw them all */
     for (i = 0; i < fast_view_n; i++) {
 	int y, x;
 
@@ -2720,9 +2811,7 @@ void forget_view(void)
 	y = GRID_Y(g);
 	x = GRID_X(g);
 
-	/* Clear "CAVE_VIEW" and "CAVE_SEEN" flags */
-	cave_off(cave_info[y][x], CAVE_VIEW);
-	cave_off(cave_info[y][x], CAVE_SEEN);
+	view_mark_monster(y, x);
 
 	/* Only light the spot if is on the panel (can change due to resizing */
 	if (!panel_contains(y, x))
@@ -2745,6 +2834,9 @@ void forget_view(void)
 /**
  * Calculate the complete field of view using a new algorithm
  *
+ * This always recalculates everything; update_view() gives the same result
+ * but avoids rescanning octants which cannot have changed.
+ *
  * If "view_g" and "temp_g" were global pointers to arrays of grids, as
  * opposed to actual arrays of grids, then we could be more efficient by
  * using "pointer swapping".
@@ -2828,7 +2920,7 @@ void forget_view(void)
  * special grids.  Because the actual number of required grids is bizarre,
  * we simply allocate twice as many as we would normally need.  XXX XXX XXX
  */
-void update_view(void)
+void update_view_full(void)
 {
     int py = p_ptr->py;
     int px = p_ptr->px;
@@ -2859,17 +2951,17 @@ void update_view(void)
 	x = GRID_X(g);
 
 	/* Save "CAVE_SEEN" grids */
-	if (cave_has(cave_info[y][x], CAVE_SEEN)) {
+	if (cave_has(y, x, CAVE_SEEN)) {
 	    /* Set "CAVE_TEMP" flag */
-	    cave_on(cave_info[y][x], CAVE_TEMP);
+	    cave_on(y, x, CAVE_TEMP);
 
 	    /* Save grid for later */
 	    fast_temp_g[fast_temp_n++] = g;
 	}
 
 	/* Clear "CAVE_VIEW" and "CAVE_SEEN" flags */
-	cave_off(cave_info[y][x], CAVE_VIEW);
-	cave_off(cave_info[y][x], CAVE_SEEN);
+	cave_off(y, x, CAVE_VIEW);
+	cave_off(y, x, CAVE_SEEN);
 
 	/* Save cave info */
     }
@@ -2899,18 +2991,18 @@ void update_view(void)
     x = GRID_X(g);
 
     /* Assume viewable */
-    cave_on(cave_info[y][x], CAVE_VIEW);
+    cave_on(y, x, CAVE_VIEW);
 
     /* Torch-lit grid */
     if (0 < radius) {
 	/* Mark as "CAVE_SEEN" */
-	cave_on(cave_info[y][x], CAVE_SEEN);
+	cave_on(y, x, CAVE_SEEN);
     }
 
     /* Perma-lit grid */
-    else if (cave_has(cave_info[y][x], CAVE_GLOW)) {
+    else if (cave_has(y, x, CAVE_GLOW)) {
 	/* Mark as "CAVE_SEEN" */
-	cave_on(cave_info[y][x], CAVE_SEEN);
+	cave_on(y, x, CAVE_SEEN);
     }
 
     /* Save in array */
@@ -2972,19 +3064,19 @@ void update_view(void)
 		    bits3 &= ~(p->bits_3);
 
 		    /* Newly viewable wall */
-		    if (!cave_has(cave_info[y][x], CAVE_VIEW)) {
+		    if (!cave_has(y, x, CAVE_VIEW)) {
 			/* Mark as viewable */
-			cave_on(cave_info[y][x], CAVE_VIEW);
+			cave_on(y, x, CAVE_VIEW);
 
 			/* Torch-lit grids */
 			if (p->d < radius) {
 			    /* Mark as "CAVE_SEEN" */
-			    cave_on(cave_info[y][x], CAVE_SEEN);
+			    cave_on(y, x, CAVE_SEEN);
 
 			}
 
 			/* Perma-lit grids */
-			else if (cave_has(cave_info[y][x], CAVE_GLOW)) {
+			else if (cave_has(y, x, CAVE_GLOW)) {
 
 			    /* Hack -- move towards player */
 			    int yy =
@@ -2993,9 +3085,9 @@ void update_view(void)
 				(x < px) ? (x + 1) : (x > px) ? (x - 1) : x;
 
 			    /* Check for "simple" illumination */
-			    if (cave_has(cave_info[yy][xx], CAVE_GLOW)) {
+			    if (cave_has(yy, xx, CAVE_GLOW)) {
 				/* Mark as seen */
-				cave_on(cave_info[y][x], CAVE_SEEN);
+				cave_on(y, x, CAVE_SEEN);
 			    }
 
 			}
@@ -3018,21 +3110,21 @@ void update_view(void)
 		    }
 
 		    /* Newly viewable non-wall */
-		    if (!cave_has(cave_info[y][x], CAVE_VIEW)) {
+		    if (!cave_has(y, x, CAVE_VIEW)) {
 			/* Mark as "viewable" */
-			cave_on(cave_info[y][x], CAVE_VIEW);
+			cave_on(y, x, CAVE_VIEW);
 
 			/* Torch-lit grids */
 			if (p->d < radius) {
 			    /* Mark as "CAVE_SEEN" */
-			    cave_on(cave_info[y][x], CAVE_SEEN);
+			    cave_on(y, x, CAVE_SEEN);
 
 			}
 
 			/* Perma-lit grids */
-			else if (cave_has(cave_info[y][x], CAVE_GLOW)) {
+			else if (cave_has(y, x, CAVE_GLOW)) {
 			    /* Mark as "CAVE_SEEN" */
-			    cave_on(cave_info[y][x], CAVE_SEEN);
+			    cave_on(y, x, CAVE_SEEN);
 			}
 
 			/* Save in array */
@@ -3056,7 +3148,7 @@ void update_view(void)
 	    x = GRID_X(g);
 
 	    /* Grid cannot be "CAVE_SEEN" */
-	    cave_off(cave_info[y][x], CAVE_SEEN);
+	    cave_off(y, x, CAVE_SEEN);
 	}
     }
 
@@ -3070,8 +3162,8 @@ void update_view(void)
 	x = GRID_X(g);
 
 	/* Was not "CAVE_SEEN", is now "CAVE_SEEN" */
-	if (cave_has(cave_info[y][x], CAVE_SEEN) && 
-	    !cave_has(cave_info[y][x], CAVE_TEMP)) {
+	if (cave_has(y, x, CAVE_SEEN) && 
+	    !cave_has(y, x, CAVE_TEMP)) {
 	    /* Note */
 	    note_spot(y, x);
 
@@ -3090,12 +3182,12 @@ void update_view(void)
 	x = GRID_X(g);
 
 	/* Clear "CAVE_TEMP" flag */
-	cave_off(cave_info[y][x], CAVE_TEMP);
+	cave_off(y, x, CAVE_TEMP);
 
 	/* Save cave info */
 
 	/* Was "CAVE_SEEN", is now not "CAVE_SEEN" */
-	if (!cave_has(cave_info[y][x], CAVE_SEEN)) {
+	if (!cave_has(y, x, CAVE_SEEN)) {
 	    /* Redraw */
 	    light_spot(y, x);
 	}
@@ -3104,302 +3196,985 @@ void update_view(void)
 
     /* Save 'view_n' */
     view_n = fast_view_n;
-}
 
+    /* The incremental view was not kept up to date */
+    update_view_invalidate();
+}
 
 
 
 /**
- * Every so often, the character makes enough noise that nearby 
- * monsters can use it to home in on him.
- *
- * Fill in the "cave_cost" field of every grid that the player can 
- * reach with the number of steps needed to reach that grid.  This 
- * also yields the route distance of the player from every grid.
- *
- * Monsters use this information by moving to adjacent grids with 
- * lower flow costs, thereby homing in on the player even though 
- * twisty tunnels and mazes.  Monsters can also run away from loud 
- * noises.
- *
- * The biggest limitation of this code is that it does not easily 
- * allow for alternate ways around doors (not all monsters can handle 
- * doors) and lava/water (many monsters are not allowed to enter 
- * water, lava, or both).
- *
- * The flow table is three-dimensional.  The first dimension allows the 
- * table to both store and overwrite grids safely.  The second indicates 
- * whether this value is that for x or for y.  The third is the number 
- * of grids able to be stored at any flow distance.
+ * Scan one octant of the view from the player, in the same way as
+ * update_view_full(), recording the viewable grids for that octant.
+ * Grids which were not already in view are added to the "view_g" array.
  */
-void update_noise(void)
+static void update_view_octant(int o2, int radius, bool blind, int *view_np)
 {
-    int cost;
-    int route_distance = 0;
+    int py = view_py;
+    int px = view_px;
+    int pg = GRID(py, px);
+    int o = o2 / 2;
 
-    int i, d;
-    int y, x, y2, x2;
-    int last_index;
-    int grid_count = 0;
+    vinfo_type *p;
 
-    int dist;
-    bool full = FALSE;
+    /* Last added */
+    vinfo_type *last = &vinfo[0];
 
-    /* Note where we get information from, and where we overwrite */
-    int this_cycle = 0;
-    int next_cycle = 1;
+    /* Grid queue */
+    int queue_head = 0;
+    int queue_tail = 0;
+    vinfo_type *queue[VINFO_MAX_GRIDS * 2];
 
-    byte flow_table[2][2][8 * NOISE_STRENGTH];
+    /* Slope bit vector */
+    u32b bits0 = vinfo_bits_0;
+    u32b bits1 = vinfo_bits_1;
+    u32b bits2 = vinfo_bits_2;
+    u32b bits3 = vinfo_bits_3;
 
-    /* The character's grid has no flow info.  Do a full rebuild. */
-    if (cave_cost[p_ptr->py][p_ptr->px] == 0)
-	full = TRUE;
+    /* Forget the old scan */
+    view_oct_n[o] = 0;
 
-    /* Determine when to rebuild, update, or do nothing */
-    if (!full) {
-	dist = ABS(p_ptr->py - flow_center_y);
-	if (ABS(p_ptr->px - flow_center_x) > dist)
-	    dist = ABS(p_ptr->px - flow_center_x);
+    /* Initial grids */
+    queue[queue_tail++] = &vinfo[1];
+    queue[queue_tail++] = &vinfo[2];
 
-	/* 
-	 * Character is far enough away from the previous flow center - 
-	 * do a full rebuild.
-	 */
-	if (dist >= 15)
-	    full = TRUE;
+    /* Process queue */
+    while (queue_head < queue_tail) {
+	int g, y, x;
+	bool lit = FALSE;
+	u16b *by;
+	feature_type *f_ptr;
 
-	else {
-	    /* Get axis distance to center of last update */
-	    dist = ABS(p_ptr->py - update_center_y);
-	    if (ABS(p_ptr->px - update_center_x) > dist)
-		dist = ABS(p_ptr->px - update_center_x);
+	/* Dequeue next grid */
+	p = queue[queue_head++];
 
-	    /* 
-	     * We probably cannot decrease the center cost any more.
-	     * We should assume that we have to do a full rebuild.
-	     */
-	    if (cost_at_center - (dist + 5) <= 0)
-		full = TRUE;
+	/* Check bits */
+	if (!((bits0 & (p->bits_0)) || (bits1 & (p->bits_1))
+	      || (bits2 & (p->bits_2)) || (bits3 & (p->bits_3))))
+	    continue;
 
+	/* Extract grid value XXX XXX XXX */
+	g = pg + *((s16b *) (((byte *) (p)) + o2));
 
-	    /* Less than five grids away from last update */
-	    else if (dist < 5) {
-		/* We're in LOS of the last update - don't update again */
-		if (los(p_ptr->py, p_ptr->px, update_center_y, update_center_x))
-		    return;
+	/* Get grid info */
+	y = GRID_Y(g);
+	x = GRID_X(g);
+	f_ptr = &f_info[cave_feat[y][x]];
+
+	/* Handle los blockage by terrain */
+	if (!tf_has(f_ptr->flags, TF_LOS)) {
+	    /* Clear bits */
+	    bits0 &= ~(p->bits_0);
+	    bits1 &= ~(p->bits_1);
+	    bits2 &= ~(p->bits_2);
+	    bits3 &= ~(p->bits_3);
+
+	    /* Torch-lit grids */
+	    if (p->d < radius)
+		lit = TRUE;
+
+	    /* Perma-lit grids */
+	    else if (cave_has(y, x, CAVE_GLOW)) {
+		/* Hack -- move towards player */
+		int yy = (y < py) ? (y + 1) : (y > py) ? (y - 1) : y;
+		int xx = (x < px) ? (x + 1) : (x > px) ? (x - 1) : x;
+
+		/* Check for "simple" illumination */
+		if (cave_has(yy, xx, CAVE_GLOW))
+		    lit = TRUE;
+	    }
+	}
 
-		/* We're not in LOS - update */
-		else
-		    full = FALSE;
+	/* Handle non-wall */
+	else {
+	    /* Enqueue child */
+	    if (last != p->next_0) {
+		queue[queue_tail++] = last = p->next_0;
 	    }
 
-	    /* Always update if at least five grids away */
-	    else
-		full = FALSE;
+	    /* Enqueue child */
+	    if (last != p->next_1) {
+		queue[queue_tail++] = last = p->next_1;
+	    }
+
+	    /* Torch-lit or perma-lit grids */
+	    if ((p->d < radius) || cave_has(y, x, CAVE_GLOW))
+		lit = TRUE;
+	}
+
+	/* Blind players see nothing */
+	if (blind)
+	    lit = FALSE;
+
+	/* Remember the grid for this octant */
+	by = &view_by[y - py + VIEW_RAD][x - px + VIEW_RAD];
+	*by |= (1 << o);
+	if (lit)
+	    *by |= VIEW_LIT;
+	else
+	    *by &= ~(VIEW_LIT);
+	view_oct_g[o][view_oct_n[o]++] = g;
+
+	/* Newly viewable grid */
+	if (!cave_has(y, x, CAVE_VIEW)) {
+	    cave_on(y, x, CAVE_VIEW);
+	    if (lit)
+		cave_on(y, x, CAVE_SEEN);
+
+	    /* Save in array */
+	    view_g[(*view_np)++] = g;
 	}
     }
+}
 
-    /* Update */
-    if (!full) {
-	bool found = FALSE;
 
-	/* Start at the character's location */
-	flow_table[this_cycle][0][0] = p_ptr->py;
-	flow_table[this_cycle][1][0] = p_ptr->px;
-	grid_count = 1;
+/**
+ * Update the field of view, only rescanning what needs it.
+ *
+ * This gives the same result as update_view_full().  If the player has
+ * moved, or their light radius or blindness has changed, or the lighting
+ * of the level has changed (which calls forget_view()), every octant is
+ * scanned.  Otherwise only octants containing grids changed through
+ * cave_set_feat() since the last update are scanned, and if there are none
+ * there is nothing to do.
+ */
+void update_view(void)
+{
+    int py = p_ptr->py;
+    int px = p_ptr->px;
 
-	/* Erase outwards until we hit the previous update center */
-	for (cost = 0; cost <= NOISE_STRENGTH; cost++) {
-	    /* 
-	     * Keep track of the route distance to the previous 
-	     * update center.
-	     */
-	    route_distance++;
+    int i, o, g, y, x;
+    int radius;
+    bool blind = (p_ptr->timed[TMD_BLIND] ? TRUE : FALSE);
+
+    int fast_view_n = view_n;
+    u16b *fast_view_g = view_g;
 
+    int fast_temp_n = 0;
+    u16b *fast_temp_g = temp_g;
 
-	    /* Get the number of grids we'll be looking at */
-	    last_index = grid_count;
+    static u16b touched_g[8 * VINFO_MAX_GRIDS];
+    int touched_n = 0;
+    int first_new;
 
-	    /* Clear the grid count */
-	    grid_count = 0;
+    /* Extract "radius" value */
+    if ((player_has(PF_UNLIGHT) || p_ptr->state.darkness)
+	&& (p_ptr->cur_light <= 0))
+	radius = 2;
+    else
+	radius = p_ptr->cur_light;
 
-	    /* Get each valid entry in the flow table in turn */
-	    for (i = 0; i < last_index; i++) {
-		/* Get this grid */
-		y = flow_table[this_cycle][0][i];
-		x = flow_table[this_cycle][1][i];
+    /* Handle real light */
+    if (radius > 0)
+	++radius;
 
-		/* Look at all adjacent grids */
-		for (d = 0; d < 8; d++) {
-		    /* Child location */
-		    y2 = y + ddy_ddd[d];
-		    x2 = x + ddx_ddd[d];
+    /* Start again if anything has changed for the whole view */
+    if (!view_valid || (view_py != py) || (view_px != px)
+	|| (view_radius != radius) || (view_blind != blind)) {
+	/* Save the old "CAVE_SEEN" grids, and clear the old view */
+	for (i = 0; i < fast_view_n; i++) {
+	    g = fast_view_g[i];
+	    y = GRID_Y(g);
+	    x = GRID_X(g);
 
-		    /* Check Bounds */
-		    if (!in_bounds(y2, x2))
-			continue;
+	    if (cave_has(y, x, CAVE_SEEN)) {
+		cave_on(y, x, CAVE_TEMP);
+		fast_temp_g[fast_temp_n++] = g;
+	    }
 
-		    /* Ignore illegal grids */
-		    if (cave_cost[y2][x2] == 0)
-			continue;
+	    cave_off(y, x, CAVE_VIEW);
+	    cave_off(y, x, CAVE_SEEN);
+	    view_mark_monster(y, x);
+	}
+	fast_view_n = 0;
+
+	/* New view origin */
+	memset(view_by, 0, sizeof(view_by));
+	view_valid = TRUE;
+	view_py = py;
+	view_px = px;
+	view_radius = radius;
+	view_blind = blind;
+	view_dirty = 0xFF;
+
+	/* Player grid */
+	cave_on(py, px, CAVE_VIEW);
+	if (!blind && ((radius > 0) || cave_has(py, px, CAVE_GLOW)))
+	    cave_on(py, px, CAVE_SEEN);
+	fast_view_g[fast_view_n++] = GRID(py, px);
+    }
 
-		    /* Ignore previously erased grids */
-		    if (cave_cost[y2][x2] == 255)
-			continue;
+    /* Nothing to do */
+    else if (!view_dirty)
+	return;
 
-		    /* Erase previous info, mark grid */
-		    cave_cost[y2][x2] = 255;
+    /* Forget what the changed octants saw */
+    else {
+	for (o = 0; o < 8; o++) {
+	    if (!(view_dirty & (1 << o)))
+		continue;
 
-		    /* Store this grid in the flow table */
-		    flow_table[next_cycle][0][grid_count] = y2;
-		    flow_table[next_cycle][1][grid_count] = x2;
+	    for (i = 0; i < view_oct_n[o]; i++) {
+		u16b *by;
 
-		    /* Increment number of grids stored */
-		    grid_count++;
+		g = view_oct_g[o][i];
+		y = GRID_Y(g);
+		x = GRID_X(g);
+		by = &view_by[y - py + VIEW_RAD][x - px + VIEW_RAD];
 
-		    /* If this is the previous update center, we can stop */
-		    if ((y2 == update_center_y) && (x2 == update_center_x))
-			found = TRUE;
-		}
-	    }
+		/* Forget this octant */
+		*by &= ~(1 << o);
 
-	    /* Stop when we find the previous update center. */
-	    if (found)
-		break;
+		/* Already dealt with */
+		if (*by & VIEW_TOUCHED)
+		    continue;
+		*by |= VIEW_TOUCHED;
+		touched_g[touched_n++] = g;
 
+		/* Save "CAVE_SEEN" grids */
+		if (cave_has(y, x, CAVE_SEEN)) {
+		    cave_on(y, x, CAVE_TEMP);
+		    fast_temp_g[fast_temp_n++] = g;
+		}
 
-	    /* Swap write and read portions of the table */
-	    if (this_cycle == 0) {
-		this_cycle = 1;
-		next_cycle = 0;
-	    } else {
-		this_cycle = 0;
-		next_cycle = 1;
+		cave_off(y, x, CAVE_VIEW);
+		cave_off(y, x, CAVE_SEEN);
+		view_mark_monster(y, x);
 	    }
 	}
 
-	/* 
-	 * Reduce the flow cost assigned to the new center grid by 
-	 * enough to maintain the correct cost slope out to the range 
-	 * we have to update the flow.
-	 */
-	cost_at_center -= route_distance;
-
-	/* We can't reduce the center cost any more.  Do a full rebuild. */
-	if (cost_at_center < 0)
-	    full = TRUE;
-
-	else {
-	    /* Store the new update center */
-	    update_center_y = p_ptr->py;
-	    update_center_x = p_ptr->px;
+	/* Drop the forgotten grids from the view array */
+	for (i = 0, first_new = 0; i < fast_view_n; i++) {
+	    g = fast_view_g[i];
+	    if (cave_has(GRID_Y(g), GRID_X(g), CAVE_VIEW))
+		fast_view_g[first_new++] = g;
 	}
+	fast_view_n = first_new;
     }
 
+    /* Scan the changed octants */
+    first_new = fast_view_n;
+    for (o = 0; o < 8; o++) {
+	if (view_dirty & (1 << o))
+	    update_view_octant(2 * o, radius, blind, &fast_view_n);
+    }
+    view_dirty = 0;
 
-    /* Full rebuild */
-    if (full) {
-	/* 
-	 * Set the initial cost to 100; updates will progressively 
-	 * lower this value.  When it reaches zero, another full 
-	 * rebuild has to be done.
-	 */
-	cost_at_center = 100;
+    /* Restore touched grids still seen from unchanged octants */
+    for (i = 0; i < touched_n; i++) {
+	u16b *by;
 
-	/* Save the new noise epicenter */
-	flow_center_y = p_ptr->py;
-	flow_center_x = p_ptr->px;
-	update_center_y = p_ptr->py;
-	update_center_x = p_ptr->px;
+	g = touched_g[i];
+	y = GRID_Y(g);
+	x = GRID_X(g);
+	by = &view_by[y - py + VIEW_RAD][x - px + VIEW_RAD];
 
+	*by &= ~(VIEW_TOUCHED);
 
-	/* Erase all of the current flow (noise) information */
-	for (y = 0; y < DUNGEON_HGT; y++) {
-	    for (x = 0; x < DUNGEON_WID; x++) {
-		cave_cost[y][x] = 0;
-	    }
+	/* Out of view */
+	if (!(*by & 0xFF)) {
+	    *by = 0;
+	    continue;
+	}
+
+	/* Lighting does not depend on the octant */
+	if (!cave_has(y, x, CAVE_VIEW)) {
+	    cave_on(y, x, CAVE_VIEW);
+	    if (*by & VIEW_LIT)
+		cave_on(y, x, CAVE_SEEN);
+	    fast_view_g[fast_view_n++] = g;
 	}
     }
 
+    /* Process "new" grids */
+    for (i = first_new; i < fast_view_n; i++) {
+	g = fast_view_g[i];
+	y = GRID_Y(g);
+	x = GRID_X(g);
 
-  /*** Update or rebuild the flow ***/
+	/* Its monster may have come into view */
+	view_mark_monster(y, x);
 
+	/* Was not "CAVE_SEEN", is now "CAVE_SEEN" */
+	if (cave_has(y, x, CAVE_SEEN) && 
+	    !cave_has(y, x, CAVE_TEMP)) {
+	    /* Note */
+	    note_spot(y, x);
 
-    /* Store base cost at the character location */
-    cave_cost[p_ptr->py][p_ptr->px] = cost_at_center;
+	    /* Redraw */
+	    light_spot(y, x);
+	}
+    }
 
-    /* Store this grid in the flow table, note that we've done so */
-    flow_table[this_cycle][0][0] = p_ptr->py;
-    flow_table[this_cycle][1][0] = p_ptr->px;
-    grid_count = 1;
+    /* Process "old" grids */
+    for (i = 0; i < fast_temp_n; i++) {
+	g = fast_temp_g[i];
+	y = GRID_Y(g);
+	x = GRID_X(g);
 
-    /* Extend the noise burst out to its limits */
-    for (cost = cost_at_center + 1; cost <= cost_at_center + NOISE_STRENGTH;
-	 cost++) {
-	/* Get the number of grids we'll be looking at */
-	last_index = grid_count;
+	/* Clear "CAVE_TEMP" flag */
+	cave_off(y, x, CAVE_TEMP);
 
-	/* Stop if we've run out of work to do */
-	if (last_index == 0)
-	    break;
+	/* Was "CAVE_SEEN", is now not "CAVE_SEEN" */
+	if (!cave_has(y, x, CAVE_SEEN)) {
+	    /* Redraw */
+	    light_spot(y, x);
+	}
+    }
 
-	/* Clear the grid count */
-	grid_count = 0;
+    /* Save 'view_n' */
+    view_n = fast_view_n;
+}
 
-	/* Get each valid entry in the flow table in turn. */
-	for (i = 0; i < last_index; i++) {
-	    /* Get this grid */
-	    y = flow_table[this_cycle][0][i];
-	    x = flow_table[this_cycle][1][i];
 
-	    /* Look at all adjacent grids */
-	    for (d = 0; d < 8; d++) {
-		/* Child location */
-		y2 = y + ddy_ddd[d];
-		x2 = x + ddx_ddd[d];
 
-		/* Check Bounds */
-		if (!in_bounds(y2, x2))
-		    continue;
 
-		/* When doing a rebuild... */
-		if (full) {
-		    /* Ignore previously marked grids */
-		    if (cave_cost[y2][x2])
-			continue;
+/**
+ * Flow (noise) cost layers, one for each monster movement class.
+ *
+ * The noise layer is "cave_cost", and is always kept up to date.  The
+ * others are only maintained while monsters of their class keep asking
+ * for them, and are rebuilt from scratch when next wanted.
+ */
+typedef struct flow_layer {
+    bool active;		/* The layer is being maintained */
+    int idle;			/* Noise updates since a monster used it */
+    int center_y, center_x;	/* Center of the last full rebuild */
+    int update_y, update_x;	/* Center of the last update */
+    int cost_at_center;		/* Flow cost at the update center */
+} flow_layer;
 
-		    /* Ignore walls.  Do not ignore rubble. */
-		    if (tf_has(f_info[cave_feat[y2][x2]].flags, TF_NO_NOISE)) 
-			continue;
+static flow_layer flow_layers[FLOW_MAX];
+static byte flow_extra[FLOW_MAX - 1][DUNGEON_HGT][DUNGEON_WID];
+
+/**
+ * Unused layers are dropped after this many noise updates
+ */
+#define FLOW_IDLE	10
+
+/**
+ * Bucket queue for Dial's algorithm.  Step costs are at most
+ * FLOW_STEP_MAX, so every queued grid has a cost within FLOW_STEP_MAX of
+ * the cost being expanded, and bucket "cost % FLOW_BUCKETS" holds the
+ * grids of that cost.
+ */
+#define FLOW_BUCKETS	(FLOW_STEP_MAX + 1)
+static u16b flow_bucket[FLOW_BUCKETS][DUNGEON_HGT * DUNGEON_WID];
+static int flow_bucket_n[FLOW_BUCKETS];
+
+/**
+ * Grids given a cost by the current pass, which may yet be lowered
+ */
+static u16b flow_mark[DUNGEON_HGT][DUNGEON_WID];
+static u16b flow_pass = 0;
+
+/**
+ * Grids which have lost their flow, and the seeds to refill them from
+ */
+static u16b flow_lost[DUNGEON_HGT * DUNGEON_WID];
+static byte flow_lost_cost[DUNGEON_HGT * DUNGEON_WID];
+static u16b flow_seed[DUNGEON_HGT * DUNGEON_WID];
+static byte flow_seed_cost[DUNGEON_HGT * DUNGEON_WID];
+
+
+/**
+ * Get the cost array of a flow layer.
+ */
+static byte (*flow_layer_cost(int layer))[DUNGEON_WID]
+{
+    return (layer == FLOW_NOISE) ? cave_cost : flow_extra[layer - 1];
+}
+
+
+/**
+ * Cost for a monster of movement class "layer" to step into a grid of
+ * feature "feat", or zero if it cannot go there.
+ */
+static int flow_step(int layer, int feat)
+{
+    feature_type *f_ptr = &f_info[feat];
+
+    switch (layer) {
+    case FLOW_WALL:
+	/* Only permanent walls stop monsters which go through rock */
+	if (tf_has(f_ptr->flags, TF_WALL) && tf_has(f_ptr->flags, TF_PERMANENT))
+	    return 0;
+	return 1;
+
+    case FLOW_DRY:
+	/* Water cannot be crossed; doors, rubble and trees slow things down */
+	if (tf_has(f_ptr->flags, TF_NO_NOISE) || tf_has(f_ptr->flags, TF_WATERY))
+	    return 0;
+	if (tf_has(f_ptr->flags, TF_DOOR_CLOSED) ||
+	    tf_has(f_ptr->flags, TF_ROCK) || tf_has(f_ptr->flags, TF_TREE))
+	    return 2;
+	return 1;
+
+    default:
+	/* Sound goes everywhere except through rock.  Rubble carries it. */
+	return tf_has(f_ptr->flags, TF_NO_NOISE) ? 0 : 1;
+    }
+}
+
+
+/**
+ * Start a new flow pass.
+ */
+static void flow_new_pass(void)
+{
+    if (++flow_pass == 0) {
+	memset(flow_mark, 0, sizeof(flow_mark));
+	flow_pass = 1;
+    }
+}
+
+
+/**
+ * Spread flow outwards from the seed grids, cheapest first, out to cost
+ * "limit".  The seeds must be sorted by cost, and already have their
+ * costs stored.
+ *
+ * Grids with cost "open" are filled in.  Grids reached earlier in this
+ * pass may have their cost lowered; so may any grid, if "lower" is set.
+ */
+static void flow_spread(int layer, const u16b *seeds, const byte *seed_cost,
+			int seed_n, int limit, int open, bool lower)
+{
+    byte (*cave_flow)[DUNGEON_WID] = flow_layer_cost(layer);
+
+    int i, d, s = 0, queued = 0;
+    int cost;
+
+    if (!seed_n)
+	return;
+
+    for (cost = seed_cost[0]; cost <= limit; cost++) {
+	int b = cost % FLOW_BUCKETS;
+
+	/* Queue the seeds of this cost, unless they have been lowered */
+	for (; (s < seed_n) && (seed_cost[s] == cost); s++) {
+	    int g = seeds[s];
+
+	    if (cave_flow[GRID_Y(g)][GRID_X(g)] != cost)
+		continue;
+	    flow_bucket[b][flow_bucket_n[b]++] = g;
+	    queued++;
+	}
+
+	/* Stop if we've run out of work to do */
+	if (!queued && (s == seed_n))
+	    break;
+
+	/* Expand each grid of this cost */
+	for (i = 0; i < flow_bucket_n[b]; i++) {
+	    int g = flow_bucket[b][i];
+	    int y = GRID_Y(g);
+	    int x = GRID_X(g);
+
+	    /* Skip grids which have since been given a lower cost */
+	    if (cave_flow[y][x] != cost)
+		continue;
+
+	    /* Look at all adjacent grids */
+	    for (d = 0; d < 8; d++) {
+		int y2 = y + ddy_ddd[d];
+		int x2 = x + ddx_ddd[d];
+		int step, old, new_cost;
+
+		/* Check Bounds */
+		if (!in_bounds(y2, x2))
+		    continue;
+
+		/* Ignore impassable grids, and stay in range */
+		step = flow_step(layer, cave_feat[y2][x2]);
+		new_cost = cost + step;
+		if (!step || (new_cost > limit))
+		    continue;
+
+		/* Only fill open grids, or lower costs where allowed */
+		old = cave_flow[y2][x2];
+		if (old != open) {
+		    if (!lower && (flow_mark[y2][x2] != flow_pass))
+			continue;
+		    if (!old || (old <= new_cost))
+			continue;
+		}
+
+		/* Store cost at this location */
+		cave_flow[y2][x2] = new_cost;
+		flow_mark[y2][x2] = flow_pass;
+
+		/* Queue the grid */
+		flow_bucket[new_cost % FLOW_BUCKETS]
+		    [flow_bucket_n[new_cost % FLOW_BUCKETS]++] = GRID(y2, x2);
+		queued++;
+	    }
+	}
+
+	queued -= flow_bucket_n[b];
+	flow_bucket_n[b] = 0;
+    }
+
+    /* Empty the queue */
+    for (i = 0; i < FLOW_BUCKETS; i++)
+	flow_bucket_n[i] = 0;
+}
+
+
+/**
+ * Update or rebuild one flow layer around the character.
+ *
+ * Monsters use this information by moving to adjacent grids with
+ * lower flow costs, thereby homing in on the player even though
+ * twisty tunnels and mazes.  Monsters can also run away from loud
+ * noises.
+ *
+ * Rebuilding the flow every time the character moves would be too slow,
+ * so instead the grids between the character and the last update center
+ * are erased, the cost at the center is lowered by the route distance
+ * between them, and the erased grids are filled in again.  This keeps
+ * the costs sloping down towards the character until the center cost
+ * runs out, and then the layer is rebuilt.
+ */
+static void update_flow(int layer, bool full)
+{
+    flow_layer *fl = &flow_layers[layer];
+    byte (*cave_flow)[DUNGEON_WID] = flow_layer_cost(layer);
+
+    int py = p_ptr->py;
+    int px = p_ptr->px;
+
+    int cost;
+    int route_distance = 0;
+
+    int i, d;
+    int y, x, y2, x2;
+    int last_index;
+    int grid_count = 0;
+
+    int dist;
+
+    u16b seed = GRID(py, px);
+    byte seed_cost;
+
+    /* Note where we get information from, and where we overwrite */
+    int this_cycle = 0;
+    int next_cycle = 1;
+
+    /* The character's grid has no flow info.  Do a full rebuild. */
+    if (!fl->active || (cave_flow[py][px] == 0))
+	full = TRUE;
+
+    /* Determine when to rebuild, update, or do nothing */
+    if (!full) {
+	dist = ABS(py - fl->center_y);
+	if (ABS(px - fl->center_x) > dist)
+	    dist = ABS(px - fl->center_x);
+
+	/*
+	 * Character is far enough away from the previous flow center -
+	 * do a full rebuild.
+	 */
+	if (dist >= 15)
+	    full = TRUE;
+
+	else {
+	    /* Get axis distance to center of last update */
+	    dist = ABS(py - fl->update_y);
+	    if (ABS(px - fl->update_x) > dist)
+		dist = ABS(px - fl->update_x);
+
+	    /*
+	     * We probably cannot decrease the center cost any more.
+	     * We should assume that we have to do a full rebuild.
+	     */
+	    if (fl->cost_at_center - (dist + 5) <= 0)
+		full = TRUE;
+
+
+	    /* Less than five grids away from last update */
+	    else if (dist < 5) {
+		/* We're in LOS of the last update - don't update again */
+		if (los(py, px, fl->update_y, fl->update_x))
+		    return;
+
+		/* We're not in LOS - update */
+		else
+		    full = FALSE;
+	    }
+
+	    /* Always update if at least five grids away */
+	    else
+		full = FALSE;
+	}
+    }
+
+    /* Update */
+    if (!full) {
+	bool found = FALSE;
+
+	/* Start at the character's location */
+	flow_bucket[this_cycle][0] = GRID(py, px);
+	grid_count = 1;
+
+	/* Erase outwards until we hit the previous update center */
+	for (cost = 0; cost <= NOISE_STRENGTH; cost++) {
+	    /*
+	     * Keep track of the route distance to the previous
+	     * update center.
+	     */
+	    route_distance++;
+
+
+	    /* Get the number of grids we'll be looking at */
+	    last_index = grid_count;
+
+	    /* Clear the grid count */
+	    grid_count = 0;
+
+	    /* Get each valid entry in the flow table in turn */
+	    for (i = 0; i < last_index; i++) {
+		/* Get this grid */
+		y = GRID_Y(flow_bucket[this_cycle][i]);
+		x = GRID_X(flow_bucket[this_cycle][i]);
+
+		/* Look at all adjacent grids */
+		for (d = 0; d < 8; d++) {
+		    /* Child location */
+		    y2 = y + ddy_ddd[d];
+		    x2 = x + ddx_ddd[d];
+
+		    /* Check Bounds */
+		    if (!in_bounds(y2, x2))
+			continue;
+
+		    /* Ignore illegal grids */
+		    if (cave_flow[y2][x2] == 0)
+			continue;
+
+		    /* Ignore previously erased grids */
+		    if (cave_flow[y2][x2] == 255)
+			continue;
+
+		    /* Erase previous info, mark grid */
+		    cave_flow[y2][x2] = 255;
+
+		    /* Store this grid in the flow table */
+		    flow_bucket[next_cycle][grid_count] = GRID(y2, x2);
+
+		    /* Increment number of grids stored */
+		    grid_count++;
+
+		    /* If this is the previous update center, we can stop */
+		    if ((y2 == fl->update_y) && (x2 == fl->update_x))
+			found = TRUE;
 		}
+	    }
+
+	    /* Stop when we find the previous update center. */
+	    if (found)
+		break;
+
+
+	    /* Swap write and read portions of the table */
+	    if (this_cycle == 0) {
+		this_cycle = 1;
+		next_cycle = 0;
+	    } else {
+		this_cycle = 0;
+		next_cycle = 1;
+	    }
+	}
+
+	/*
+	 * Reduce the flow cost assigned to the new center grid by
+	 * enough to maintain the correct cost slope out to the range
+	 * we have to update the flow.
+	 */
+	fl->cost_at_center -= route_distance;
+
+	/* We can't reduce the center cost any more.  Do a full rebuild. */
+	if (fl->cost_at_center < 0)
+	    full = TRUE;
+
+	else {
+	    /* Store the new update center */
+	    fl->update_y = py;
+	    fl->update_x = px;
+	}
+    }
+
+
+    /* Full rebuild */
+    if (full) {
+	/*
+	 * Set the initial cost to 100; updates will progressively
+	 * lower this value.  When it reaches zero, another full
+	 * rebuild has to be done.
+	 */
+	fl->cost_at_center = 100;
+	fl->active = TRUE;
+
+	/* Save the new noise epicenter */
+	fl->center_y = py;
+	fl->center_x = px;
+	fl->update_y = py;
+	fl->update_x = px;
+
+
+	/* Erase all of the current flow (noise) information */
+	memset(cave_flow, 0, DUNGEON_HGT * sizeof(*cave_flow));
+    }
+
+
+  /*** Update or rebuild the flow ***/
+
+
+    /* Store base cost at the character location */
+    cave_flow[py][px] = fl->cost_at_center;
+    seed_cost = fl->cost_at_center;
+
+    /* Extend the noise burst out to its limits */
+    flow_new_pass();
+    flow_spread(layer, &seed, &seed_cost, 1,
+		fl->cost_at_center + NOISE_STRENGTH, full ? 0 : 255, FALSE);
+}
+
+
+/**
+ * Every so often, the character makes enough noise that nearby
+ * monsters can use it to home in on him.
+ *
+ * Fill in the "cave_cost" field of every grid that the player can
+ * reach with the number of steps needed to reach that grid.  This
+ * also yields the route distance of the player from every grid.
+ *
+ * Monsters which cannot go where sound does (see "FLOW_*") follow their
+ * own cost layers, which are updated here for as long as they are used.
+ */
+void update_noise(void)
+{
+    int layer;
+
+    for (layer = 0; layer < FLOW_MAX; layer++) {
+	flow_layer *fl = &flow_layers[layer];
+
+	if (layer != FLOW_NOISE) {
+	    /* Nobody wants this layer */
+	    if (!fl->active)
+		continue;
+
+	    /* Nobody has wanted it for a while */
+	    if (++fl->idle > FLOW_IDLE) {
+		fl->active = FALSE;
+		continue;
+	    }
+	}
+
+	update_flow(layer, FALSE);
+    }
+}
+
+
+/**
+ * Rebuild a flow layer around the character.
+ */
+void flow_rebuild(int layer)
+{
+    update_flow(layer, TRUE);
+}
+
+
+/**
+ * Forget all flow information, for a new level.
+ */
+void flow_wipe(void)
+{
+    int layer;
 
-		/* When doing an update... */
-		else {
-		    /* Ignore all but specially marked grids */
-		    if (cave_cost[y2][x2] != 255)
-			continue;
-		}
+    memset(cave_cost, 0, DUNGEON_HGT * sizeof(*cave_cost));
+    for (layer = 0; layer < FLOW_MAX; layer++)
+	flow_layers[layer].active = FALSE;
+}
 
-		/* Store cost at this location */
-		cave_cost[y2][x2] = cost;
 
-		/* Store this grid in the flow table */
-		flow_table[next_cycle][0][grid_count] = y2;
-		flow_table[next_cycle][1][grid_count] = x2;
+/**
+ * Get the flow cost of a grid for monster movement class "layer".  The
+ * layer is built if nobody has been using it.
+ */
+int flow_cost(int layer, int y, int x)
+{
+    flow_layer *fl = &flow_layers[layer];
+
+    if (layer != FLOW_NOISE) {
+	if (!fl->active)
+	    update_flow(layer, TRUE);
+	fl->idle = 0;
+    }
+
+    return flow_layer_cost(layer)[y][x];
+}
+
 
-		/* Increment number of grids stored */
-		grid_count++;
-	    }
+/**
+ * Get the flow cost at the center of the last flow update.
+ */
+int flow_center_cost(int layer)
+{
+    return flow_layers[layer].cost_at_center;
+}
+
+
+/**
+ * The grid (y, x) has become harder to cross, or impassable.  Erase the
+ * flow of every grid which got its cost through it, then fill them in
+ * again from the grids around them.
+ */
+static void flow_forget(int layer, int y, int x)
+{
+    byte (*cave_flow)[DUNGEON_WID] = flow_layer_cost(layer);
+    int limit = flow_layers[layer].cost_at_center + NOISE_STRENGTH;
+
+    int count[256];
+    int i, d, lost_n = 0, seed_n = 0;
+
+    /* Erase the grid */
+    flow_lost_cost[lost_n] = cave_flow[y][x];
+    flow_lost[lost_n++] = GRID(y, x);
+    cave_flow[y][x] = 255;
+
+    /* Erase every grid whose cost follows on from an erased one */
+    for (i = 0; i < lost_n; i++) {
+	int g = flow_lost[i];
+
+	for (d = 0; d < 8; d++) {
+	    int y2 = GRID_Y(g) + ddy_ddd[d];
+	    int x2 = GRID_X(g) + ddx_ddd[d];
+	    int c;
+
+	    if (!in_bounds(y2, x2))
+		continue;
+
+	    c = cave_flow[y2][x2];
+	    if (!c || (c == 255))
+		continue;
+	    if (c != flow_lost_cost[i] + flow_step(layer, cave_feat[y2][x2]))
+		continue;
+
+	    flow_lost_cost[lost_n] = c;
+	    flow_lost[lost_n++] = GRID(y2, x2);
+	    cave_flow[y2][x2] = 255;
 	}
+    }
 
-	/* Swap write and read portions of the table */
-	if (this_cycle == 0) {
-	    this_cycle = 1;
-	    next_cycle = 0;
-	} else {
-	    this_cycle = 0;
-	    next_cycle = 1;
+    /* Find the cheapest way into each erased grid from outside */
+    flow_new_pass();
+    for (i = 0; i < 256; i++)
+	count[i] = 0;
+    for (i = 0; i < lost_n; i++) {
+	int g = flow_lost[i];
+	int step = flow_step(layer, cave_feat[GRID_Y(g)][GRID_X(g)]);
+	int best = 255;
+
+	for (d = 0; step && (d < 8); d++) {
+	    int y2 = GRID_Y(g) + ddy_ddd[d];
+	    int x2 = GRID_X(g) + ddx_ddd[d];
+	    int c;
+
+	    if (!in_bounds(y2, x2))
+		continue;
+
+	    c = cave_flow[y2][x2];
+	    if (c && (c != 255) && (c + step < best))
+		best = c + step;
+	}
+
+	flow_lost_cost[i] = best;
+	if (best <= limit)
+	    count[best]++;
+    }
+
+    /* Sort the seeds by cost, and store their costs */
+    for (i = 1; i < 256; i++)
+	count[i] += count[i - 1];
+    seed_n = count[255];
+    for (i = lost_n - 1; i >= 0; i--) {
+	if (flow_lost_cost[i] > limit)
+	    continue;
+
+	d = --count[flow_lost_cost[i]];
+	flow_seed[d] = flow_lost[i];
+	flow_seed_cost[d] = flow_lost_cost[i];
+    }
+    for (i = 0; i < seed_n; i++) {
+	int g = flow_seed[i];
+
+	cave_flow[GRID_Y(g)][GRID_X(g)] = flow_seed_cost[i];
+	flow_mark[GRID_Y(g)][GRID_X(g)] = flow_pass;
+    }
+
+    /* Fill the erased grids in */
+    flow_spread(layer, flow_seed, flow_seed_cost, seed_n, limit, 255, FALSE);
+
+    /* Anything left over is out of range */
+    for (i = 0; i < lost_n; i++) {
+	int g = flow_lost[i];
+
+	if (cave_flow[GRID_Y(g)][GRID_X(g)] == 255)
+	    cave_flow[GRID_Y(g)][GRID_X(g)] = 0;
+    }
+}
+
+
+/**
+ * Repair the flow layers after the feature at (y, x) has changed from
+ * "old_feat".
+ */
+static void update_flow_mark(int y, int x, int old_feat)
+{
+    int layer, d;
+
+    for (layer = 0; layer < FLOW_MAX; layer++) {
+	byte (*cave_flow)[DUNGEON_WID] = flow_layer_cost(layer);
+	int step = flow_step(layer, cave_feat[y][x]);
+	int old_step = flow_step(layer, old_feat);
+	int limit = flow_layers[layer].cost_at_center + NOISE_STRENGTH;
+	int best = 255;
+	u16b seed;
+	byte seed_cost;
+
+	if (!flow_layers[layer].active || (step == old_step))
+	    continue;
+
+	/* Harder to cross than it was */
+	if (!step || (old_step && (step > old_step))) {
+	    if (cave_flow[y][x])
+		flow_forget(layer, y, x);
+	    continue;
+	}
+
+	/* Easier to cross; see if it gives a shorter way through */
+	for (d = 0; d < 8; d++) {
+	    int y2 = y + ddy_ddd[d];
+	    int x2 = x + ddx_ddd[d];
+	    int c;
+
+	    if (!in_bounds(y2, x2))
+		continue;
+
+	    c = cave_flow[y2][x2];
+	    if (c && (c != 255) && (c + step < best))
+		best = c + step;
 	}
+	if ((best > limit) || (cave_flow[y][x] && (cave_flow[y][x] <= best)))
+	    continue;
+
+	/* Lower the costs beyond it */
+	cave_flow[y][x] = best;
+	seed = GRID(y, x);
+	seed_cost = best;
+	flow_new_pass();
+	flow_spread(layer, &seed, &seed_cost, 1, limit, 0, TRUE);
     }
 }
 
@@ -3417,8 +4192,11 @@ void update_noise(void)
  * Speedy characters leave more scent, true, but it also ages faster, 
  * which makes it harder to hunt them down.
  *
- * Whenever the age count loops, most of the scent trail is erased and 
- * the age of the remainder is recalculated.
+ * Scent is stamped with the scent clock when it is laid, so that its age 
+ * is just the time since then (see "get_scent()").  Whenever the age count 
+ * loops, the earlier part of the trail is forgotten; rather than erase it 
+ * grid by grid, we note the time, and scent which was already too old by 
+ * then is ignored.
  */
 void update_smell(void)
 {
@@ -3441,25 +4219,11 @@ void update_smell(void)
 
     /* Scent becomes "younger" */
     scent_when--;
+    scent_turn++;
 
-    /* Loop the age and adjust scent values when necessary */
+    /* Loop the age when necessary, forgetting the earlier part of the trail */
     if (scent_when <= 0) {
-	/* Scan the entire dungeon */
-	for (y = 0; y < DUNGEON_HGT; y++) {
-	    for (x = 0; x < DUNGEON_WID; x++) {
-		/* Ignore non-existent scent */
-		if (cave_when[y][x] == 0)
-		    continue;
-
-		/* Erase the earlier part of the previous cycle */
-		if (cave_when[y][x] > SMELL_STRENGTH)
-		    cave_when[y][x] = 0;
-
-		/* Reset the ages of the most recent scent */
-		else
-		    cave_when[y][x] = 250 - SMELL_STRENGTH + cave_when[y][x];
-	    }
-	}
+	scent_loop = scent_turn;
 
 	/* Reset the age value */
 	scent_when = 250 - SMELL_STRENGTH;
@@ -3494,27 +4258,80 @@ void update_smell(void)
 		continue;
 
 	    /* Mark the grid with new scent */
-	    cave_when[y][x] = scent_when + scent_adjust[i][j];
+	    cave_when[y][x] = scent_turn - scent_adjust[i][j];
 	}
     }
 }
 
+/**
+ * The bits of word "w" of a cave row which belong to real grids.
+ */
+static u64b cave_row_bits(int w)
+{
+    int end = DUNGEON_WID - w * 64;
+
+    return ((end >= 64) ? ~((u64b) 0) : ((((u64b) 1) << end) - 1));
+}
+
+
+/**
+ * Spread the grids of a row mask to their left and right neighbours.
+ */
+static void cave_row_spread(const u64b *row, u64b *out)
+{
+    int w;
+
+    for (w = 0; w < CAVE_WORDS; w++) {
+	out[w] = row[w] | (row[w] << 1) | (row[w] >> 1);
+
+	/* Carry across the word boundaries */
+	if (w > 0)
+	    out[w] |= row[w - 1] >> 63;
+	if (w < CAVE_WORDS - 1)
+	    out[w] |= row[w + 1] << 63;
+
+	out[w] &= cave_row_bits(w);
+    }
+}
+
+
 /**
  * Map around a given point, or the current panel (plus some) 
  * ala "magic mapping".   Staffs of magic mapping map more than 
  * rods do, because staffs affect larger areas in general.
  *
+ * The passable grids of the area are collected into a mask a row at a
+ * time, and the walls next to them found by spreading that mask, so the
+ * "CAVE_MARK" plane is updated a word at a time.
+ *
  * We must never attempt to map the outer dungeon walls, or we
  * might induce illegal cave grid references.
  */
 void map_area(int y, int x, bool extended)
 {
-    int i, y_c, x_c;
+    int i, w, y_c, x_c, y_min, y_max, x_min, x_max;
     int rad = DETECT_RAD_DEFAULT;
 
+    /* Passable grids in the mapped area */
+    static u64b pass[DUNGEON_HGT][CAVE_WORDS];
+    u64b row[CAVE_WORDS], near[CAVE_WORDS];
+
+    /* How each feature is mapped */
+    byte feat_pass[256], feat_mark[256], feat_wall[256];
+
     if (extended)
 	rad += 10;
 
+    /* Passable grids are checked, interesting ones and walls memorized */
+    for (i = 0; i < z_info->f_max; i++) {
+	feature_type *f_ptr = &f_info[i];
+
+	feat_pass[i] = tf_has(f_ptr->flags, TF_PASSABLE);
+	feat_mark[i] = (!tf_has(f_ptr->flags, TF_FLOOR) ||
+			tf_has(f_ptr->flags, TF_INTERESTING));
+	feat_wall[i] = !tf_has(f_ptr->flags, TF_LOS);
+    }
+
     /* Map around a location, if given. */
     if ((y) && (x)) {
 	y_c = y;
@@ -3527,43 +4344,60 @@ void map_area(int y, int x, bool extended)
 	x_c = p_ptr->px;
     }
 
-    /* Scan the maximal area of mapping */
-    for (y = y_c - rad; y <= y_c + rad; y++) {
-	for (x = x_c - rad; x <= x_c + rad; x++) {
-	    feature_type *f_ptr = &f_info[cave_feat[y][x]];
+    /* Scan the maximal area of mapping, inside the outer walls */
+    y_min = MAX(y_c - rad, 1);
+    y_max = MIN(y_c + rad, DUNGEON_HGT - 2);
+    x_min = MAX(x_c - rad, 1);
+    x_max = MIN(x_c + rad, DUNGEON_WID - 2);
 
-	    /* Ignore "illegal" locations */
-	    if (!in_bounds(y, x))
+    memset(pass, 0, sizeof(pass));
+
+    for (y = y_min; y <= y_max; y++) {
+	memset(row, 0, sizeof(row));
+
+	for (x = x_min; x <= x_max; x++) {
+	    int feat = cave_feat[y][x];
+
+	    /* All passable grids are checked */
+	    if (!feat_pass[feat])
 		continue;
 
 	    /* Enforce a "circular" area */
 	    if (distance(y_c, x_c, y, x) > rad)
 		continue;
 
-	    /* All passable grids are checked */
-	    if (tf_has(f_ptr->flags, TF_PASSABLE)) {
-		/* Memorize interesting features */
-		if (!tf_has(f_ptr->flags, TF_FLOOR) ||
-		    tf_has(f_ptr->flags, TF_INTERESTING)) 
-		{
-		    /* Memorize the object */
-		    cave_on(cave_info[y][x], CAVE_MARK);
-		}
+	    pass[y][x >> 6] |= CAVE_BIT(x);
 
-		/* Memorize known walls */
-		for (i = 0; i < 8; i++) {
-		    int yy = y + ddy_ddd[i];
-		    int xx = x + ddx_ddd[i];
+	    /* Memorize interesting features */
+	    if (feat_mark[feat])
+		row[x >> 6] |= CAVE_BIT(x);
+	}
 
-		    /* All blockages are checked */
-		    f_ptr = &f_info[cave_feat[yy][xx]];
-		    if (!tf_has(f_ptr->flags, TF_LOS)) {
-			/* Memorize the walls */
-			cave_on(cave_info[yy][xx], CAVE_MARK);
-		    }
-		}
-	    }
+	for (w = 0; w < CAVE_WORDS; w++)
+	    cave_info[CAVE_MARK][y][w] |= row[w];
+    }
+
+    /* Memorize known walls next to the checked grids */
+    for (y = y_min - 1; y <= y_max + 1; y++) {
+	for (w = 0; w < CAVE_WORDS; w++) {
+	    row[w] = pass[y][w];
+	    if (y > 0)
+		row[w] |= pass[y - 1][w];
+	    if (y < DUNGEON_HGT - 1)
+		row[w] |= pass[y + 1][w];
+	}
+
+	cave_row_spread(row, near);
+	memset(row, 0, sizeof(row));
+
+	for (x = x_min - 1; x <= x_max + 1; x++) {
+	    /* All blockages are checked */
+	    if ((near[x >> 6] & CAVE_BIT(x)) && feat_wall[cave_feat[y][x]])
+		row[x >> 6] |= CAVE_BIT(x);
 	}
+
+	for (w = 0; w < CAVE_WORDS; w++)
+	    cave_info[CAVE_MARK][y][w] |= row[w];
     }
 
     /* Redraw map */
@@ -3610,7 +4444,7 @@ void wiz_light(bool wizard)
 
 	/* Skip objects in vaults, if not a wizard. */
 	if ((wizard == FALSE)
-	    && cave_has(cave_info[o_ptr->iy][o_ptr->ix], CAVE_ICKY))
+	    && cave_has(o_ptr->iy, o_ptr->ix, CAVE_ICKY))
 	    continue;
 
 	/* Memorize */
@@ -3638,10 +4472,10 @@ void wiz_light(bool wizard)
 		    f_ptr = &f_info[cave_feat[yy][xx]];		    
 
 		    /* Perma-light the grid (always) */
-		    cave_on(cave_info[yy][xx], CAVE_GLOW);
+		    cave_on(yy, xx, CAVE_GLOW);
 		    
 		    /* If not a wizard, do not mark passable grids in vaults */
-		    if ((!wizard) && cave_has(cave_info[yy][xx], CAVE_ICKY))
+		    if ((!wizard) && cave_has(yy, xx, CAVE_ICKY))
 		    {
 			if (tf_has(f_ptr->flags, TF_PASSABLE)) continue;
 		    }
@@ -3651,14 +4485,14 @@ void wiz_light(bool wizard)
 			cave_visible_trap(yy, xx))
 		    {
 			/* Memorize the grid */
-			cave_on(cave_info[yy][xx], CAVE_MARK);
+			cave_on(yy, xx, CAVE_MARK);
 		    }
 		    
 		    /* Optionally, memorize floors immediately */
 		    else if (OPT(view_perma_grids) && !OPT(view_torch_grids))
 		    {
 			/* Memorize the grid */
-			cave_on(cave_info[yy][xx], CAVE_MARK);
+			cave_on(yy, xx, CAVE_MARK);
 		    }
 		}
 	    }
@@ -3679,17 +4513,12 @@ void wiz_light(bool wizard)
  */
 void wiz_dark(void)
 {
-    int i, y, x;
+    int i;
 
 
     /* Forget every grid */
-    for (y = 0; y < DUNGEON_HGT; y++) {
-	for (x = 0; x < DUNGEON_WID; x++) {
-	    /* Process the grid */
-	    cave_off(cave_info[y][x], CAVE_MARK);
-	    cave_off(cave_info[y][x], CAVE_DTRAP);
-	}
-    }
+    cave_flag_wipe(CAVE_MARK);
+    cave_flag_wipe(CAVE_DTRAP);
 
     /* Forget all objects */
     for (i = 1; i < o_max; i++) {
@@ -3721,88 +4550,80 @@ void wiz_dark(void)
  */
 void illuminate(void)
 {
-    int y, x, i;
+    int i, y, x, w;
+    bool town = (p_ptr->depth == 0);
+    bool perma = OPT(view_perma_grids);
+
+    /* Shop doorways */
+    static u64b shop[DUNGEON_HGT][CAVE_WORDS];
+    u64b dark[CAVE_WORDS], lit[CAVE_WORDS], row[CAVE_WORDS], near[CAVE_WORDS];
+    byte feat_shop[256];
 
-    /* Apply light or darkness */
+    for (i = 0; i < z_info->f_max; i++)
+	feat_shop[i] = tf_has(f_info[i].flags, TF_SHOP);
+
+    /* Apply light or darkness, a row at a time */
     for (y = 0; y < DUNGEON_HGT; y++) {
+	memset(dark, 0, sizeof(dark));
+	memset(lit, 0, sizeof(lit));
+	memset(shop[y], 0, sizeof(shop[y]));
+
 	for (x = 0; x < DUNGEON_WID; x++) {
+	    int feat = cave_feat[y][x];
+
 	    /* Grids outside town walls */
-	    if ((cave_feat[y][x] == FEAT_PERM_SOLID)  && !p_ptr->depth)
-	    {
+	    if ((feat == FEAT_PERM_SOLID) && town)
+		dark[x >> 6] |= CAVE_BIT(x);
 
-		/* Darken the grid */
-		cave_off(cave_info[y][x], CAVE_GLOW);
+	    /* Special case of shops */
+	    else if (feat == FEAT_PERM_EXTRA)
+		lit[x >> 6] |= CAVE_BIT(x);
 
-		/* Hack -- Forget grids */
-		if (OPT(view_perma_grids)) 
-		{
-		    cave_off(cave_info[y][x], CAVE_MARK);
-		}
-	    }
+	    /* Track shop doorways */
+	    if (feat_shop[feat])
+		shop[y][x >> 6] |= CAVE_BIT(x);
+	}
 
-	    /* Special case of shops */
-	    else if (cave_feat[y][x] == FEAT_PERM_EXTRA)
-            {
-		/* Illuminate the grid */
-		cave_on(cave_info[y][x], CAVE_GLOW);
-              
-		/* Memorize the grid */
-		cave_on(cave_info[y][x], CAVE_MARK);
-            }
-          
-	    /* Viewable grids (light) */
-	    else if (is_daylight) 
-	    {
-		/* Illuminate the grid */
-		cave_on(cave_info[y][x], CAVE_GLOW);
-	    }
+	for (w = 0; w < CAVE_WORDS; w++) {
+	    /* Everything else is lit by day and dark by night */
+	    u64b glow = is_daylight ? cave_row_bits(w) : 0;
 
-	    /* Viewable grids (dark) */
-	    else 
-	    {
-		/* Darken the grid */
-		cave_off(cave_info[y][x], CAVE_GLOW);
-	    }
+	    cave_info[CAVE_GLOW][y][w] = (glow & ~dark[w]) | lit[w];
+
+	    /* Hack -- Forget grids outside the walls */
+	    if (perma)
+		cave_info[CAVE_MARK][y][w] &= ~dark[w];
+
+	    /* Memorize the shops */
+	    cave_info[CAVE_MARK][y][w] |= lit[w];
 	}
     }
 
+    /* Illuminate shop doorways and the grids around them */
+    for (y = 0; y < DUNGEON_HGT; y++) {
+	for (w = 0; w < CAVE_WORDS; w++) {
+	    row[w] = shop[y][w];
+	    if (y > 0)
+		row[w] |= shop[y - 1][w];
+	    if (y < DUNGEON_HGT - 1)
+		row[w] |= shop[y + 1][w];
+	}
 
-    /* Handle shop doorways */
-    for (y = 0; y < DUNGEON_HGT; y++) 
-    {
-	for (x = 0; x < DUNGEON_WID; x++) 
-	{
-	    feature_type *f_ptr = &f_info[cave_feat[y][x]];
-	    /* Track shop doorways */
-	    if (tf_has(f_ptr->flags, TF_SHOP)) 
-	    {
-		/* Illuminate the grid */
-		cave_on(cave_info[y][x], CAVE_GLOW);
-		
-		/* Hack -- Memorize grids */
-		if (OPT(view_perma_grids)) {
-		    cave_on(cave_info[y][x], CAVE_MARK);
-		}
-		
-		for (i = 0; i < 8; i++) 
-		{
-		    int yy = y + ddy_ddd[i];
-		    int xx = x + ddx_ddd[i];
+	cave_row_spread(row, near);
 
-		    /* Illuminate the grid */
-		    cave_on(cave_info[yy][xx], CAVE_GLOW);
+	for (w = 0; w < CAVE_WORDS; w++) {
+	    cave_info[CAVE_GLOW][y][w] |= near[w];
 
-		    /* Hack -- Memorize grids */
-		    if (OPT(view_perma_grids)) 
-		    {
-			cave_on(cave_info[yy][xx], CAVE_MARK);
-		    }
-		}
-	    }
+	    /* Hack -- Memorize grids */
+	    if (perma)
+		cave_info[CAVE_MARK][y][w] |= near[w];
 	}
     }
 
 
+    /* The old view used the old lighting */
+    update_view_invalidate();
+
     /* Fully update the visuals */
     p_ptr->update |= (PU_FORGET_VIEW | PU_UPDATE_VIEW | PU_MONSTERS);
 
@@ -3816,9 +4637,21 @@ void illuminate(void)
  */
 void cave_set_feat(int y, int x, int feat)
 {
+    int old_feat = cave_feat[y][x];
+
     /* Change the feature */
     cave_feat[y][x] = feat;
 
+    /* The view may need updating here */
+    update_view_mark(y, x);
+
+    /* Projection paths may have changed */
+    path_cache_wipe();
+
+    /* So may the flow */
+    if (character_dungeon)
+	update_flow_mark(y, x, old_feat);
+
     /* Notice/Redraw */
     if (character_dungeon) {
 	/* Notice */
@@ -3831,6 +4664,105 @@ void cave_set_feat(int y, int x, int feat)
 
 
 
+/**
+ * Clear one cave flag across the whole level.
+ */
+void cave_flag_wipe(int flag)
+{
+    memset(cave_info[flag], 0, sizeof(cave_plane));
+}
+
+
+/**
+ * Set cave flag "flag" on every grid which has cave flag "src".
+ */
+void cave_flag_union(int flag, int src)
+{
+    u64b *dst = &cave_info[flag][0][0];
+    u64b *add = &cave_info[src][0][0];
+    int i;
+
+    for (i = 0; i < DUNGEON_HGT * CAVE_WORDS; i++)
+	dst[i] |= add[i];
+}
+
+
+/**
+ * Count the grids on the level with a given cave flag.
+ */
+int cave_flag_count(int flag)
+{
+    u64b *w = &cave_info[flag][0][0];
+    int i, n = 0;
+
+    for (i = 0; i < DUNGEON_HGT * CAVE_WORDS; i++) {
+	u64b v = w[i];
+
+	/* Clear the lowest set bit until none are left */
+	while (v) {
+	    v &= v - 1;
+	    n++;
+	}
+    }
+
+    return (n);
+}
+
+
+/**
+ * Clear every cave flag across the whole level.
+ */
+void cave_info_wipe(void)
+{
+    memset(cave_info, 0, CAVE_MAX * sizeof(cave_plane));
+}
+
+
+/**
+ * Extract byte "n" of the flags of a grid, in the savefile layout (byte n,
+ * bit b holds flag n * FLAG_WIDTH + b + FLAG_START).
+ */
+byte cave_info_byte(int y, int x, int n)
+{
+    byte b = 0;
+    unsigned int i;
+
+    for (i = 0; i < FLAG_WIDTH; i++) {
+	int flag = n * FLAG_WIDTH + i + FLAG_START;
+
+	if (flag >= CAVE_MAX)
+	    break;
+
+	if (cave_has(y, x, flag))
+	    b |= (1 << i);
+    }
+
+    return (b);
+}
+
+
+/**
+ * Set byte "n" of the flags of a grid from the savefile layout.
+ */
+void cave_set_info_byte(int y, int x, int n, byte b)
+{
+    unsigned int i;
+
+    for (i = 0; i < FLAG_WIDTH; i++) {
+	int flag = n * FLAG_WIDTH + i + FLAG_START;
+
+	if (flag >= CAVE_MAX)
+	    break;
+
+	if (b & (1 << i))
+	    cave_on(y, x, flag);
+	else
+	    cave_off(y, x, flag);
+    }
+}
+
+
+
 /**
  * Determine the path taken by a projection.
  *
@@ -4112,6 +5044,74 @@ int project_path(u16b * gp, int range, int y1, int x1, int y2, int x2, int flg)
 }
 
 
+/**
+ * Number of projection paths remembered by projectable(); a power of two.
+ */
+#define PATH_CACHE_SIZE	1024
+
+/**
+ * A remembered projection path.  Only walls and the "PROJECT_THRU" flag
+ * decide where a path goes; monsters on it are checked afresh each time.
+ */
+typedef struct path_cache_entry {
+    u32b stamp;			/* Value of path_stamp when traced */
+    u16b from;			/* Grid the path starts from */
+    u16b to;			/* Grid the path heads for */
+    byte thru;			/* Traced with PROJECT_THRU */
+    byte range;			/* Maximum range of the path */
+    byte n;			/* Number of grids in the path */
+    u16b grid[MAX_RANGE_LGE];	/* The path grids */
+} path_cache_entry;
+
+static path_cache_entry path_cache[PATH_CACHE_SIZE];
+
+/**
+ * Paths traced before the terrain last changed have this stamp or less.
+ */
+static u32b path_stamp = 1;
+
+
+/**
+ * Forget all remembered projection paths.  Called whenever the terrain
+ * changes, and when a new level is made.
+ */
+void path_cache_wipe(void)
+{
+    path_stamp++;
+}
+
+
+/**
+ * Find the projection path from (y1,x1) to (y2,x2), tracing it only if it
+ * is not remembered.  Monsters are ignored.
+ */
+static path_cache_entry *path_cache_find(int y1, int x1, int y2, int x2,
+					 int flg)
+{
+    u16b from = GRID(y1, x1), to = GRID(y2, x2);
+    byte thru = ((flg & (PROJECT_THRU)) ? 1 : 0);
+    byte range = MAX_RANGE;
+    u32b h = ((u32b) from * 40503UL) ^ ((u32b) to * 2654435761UL) ^ thru;
+    path_cache_entry *pc = &path_cache[(h >> 12) & (PATH_CACHE_SIZE - 1)];
+
+    /* Remembered */
+    if ((pc->stamp == path_stamp) && (pc->from == from) && (pc->to == to)
+	&& (pc->thru == thru) && (pc->range == range))
+	return (pc);
+
+    /* Trace it */
+    pc->stamp = path_stamp;
+    pc->from = from;
+    pc->to = to;
+    pc->thru = thru;
+    pc->range = range;
+    pc->n = project_path(pc->grid, range, y1, x1, y2, x2,
+			 thru ? PROJECT_THRU : 0);
+
+    return (pc);
+}
+
+
 /**
  * Determine if a bolt spell cast from (y1,x1) to (y2,x2) will arrive
  * at the final destination, using the project_path() function to check 
@@ -4124,25 +5124,59 @@ int project_path(u16b * gp, int range, int y1, int x1, int y2, int x2, int flg)
  * This function is used to determine if the player can (easily) target
  * a given grid, if a monster can target the player, and if a clear shot 
  * exists from monster to player.
+ *
+ * The path itself is remembered until the terrain changes, so only the
+ * monsters along it are checked each time ("PROJECT_STOP" cuts the path 
+ * short at the first one, "PROJECT_CHCK" just notes that it is there).
+ *
+ * There is no batched "which monsters can cast at the player" query.
+ * choose_ranged_attack() asks for one monster, in its own turn, and only
+ * once its ranged attack roll has passed; its target may be another
+ * monster, and the monsters that moved before it change what PROJECT_CHCK
+ * finds on the path.  A sweep made at the start of process_monsters() would
+ * mostly answer questions nobody asks, with answers gone stale by the time
+ * they are.
  */
 byte projectable(int y1, int x1, int y2, int x2, int flg)
 {
-    int y, x;
+    int y, x, i;
 
     int grid_n = 0;
-    u16b grid_g[512];
+    bool blocked = FALSE;
+    path_cache_entry *pc;
     feature_type *f_ptr;
 
+    /* Too far away for any path to reach (the last step of a path can
+     * take it one grid past "range") */
+    if (distance(y1, x1, y2, x2) > MAX_RANGE + 1)
+	return (PROJECT_NO);
+
     /* Check the projection path */
-    grid_n = project_path(grid_g, MAX_RANGE, y1, x1, y2, x2, flg);
+    pc = path_cache_find(y1, x1, y2, x2, flg);
+    grid_n = pc->n;
 
     /* No grid is ever projectable from itself */
     if (!grid_n)
 	return (FALSE);
 
-    /* Final grid.  As grid_n may be negative, use absolute value.  */
-    y = GRID_Y(grid_g[ABS(grid_n) - 1]);
-    x = GRID_X(grid_g[ABS(grid_n) - 1]);
+    /* Look for monsters along the way (but not at the end) */
+    if (flg & (PROJECT_STOP | PROJECT_CHCK)) {
+	for (i = 0; i < grid_n - 1; i++) {
+	    if (!cave_m_idx[GRID_Y(pc->grid[i])][GRID_X(pc->grid[i])])
+		continue;
+
+	    /* Stop here, or carry on knowing the path is blocked */
+	    if (flg & (PROJECT_STOP))
+		grid_n = i + 1;
+	    else
+		blocked = TRUE;
+	    break;
+	}
+    }
+
+    /* Final grid */
+    y = GRID_Y(pc->grid[grid_n - 1]);
+    x = GRID_X(pc->grid[grid_n - 1]);
 
     /* May not end in an unrequested grid */
     if ((y != y2) || (x != x2))
@@ -4156,8 +5190,7 @@ byte projectable(int y1, int x1, int y2, int x2, int flg)
 
     /* Promise a clear bolt shot if we have verified that there is one */
     if ((flg & (PROJECT_STOP)) || (flg & (PROJECT_CHCK))) {
-	/* Positive value for grid_n mean no obstacle was found. */
-	if (grid_n > 0)
+	if (!blocked)
 	    return (PROJECT_CLEAR);
     }
 
@@ -4165,6 +5198,7 @@ byte projectable(int y1, int x1, int y2, int x2, int flg)
     return (PROJECT_NOT_CLEAR);
 }
 
+
 /**
  * Standard "find me a location" function
  *
@@ -4190,7 +5224,7 @@ void scatter(int *yp, int *xp, int y, int x, int d, int m)
 	nx = rand_spread(x, d);
 
 	/* Ignore annoying locations */
-	if (!in_bounds_fully(y, x))
+	if (!in_bounds_fully(ny, nx))
 	    continue;
 
 	/* Ignore "excessively distant" locations */
@@ -22,16 +22,28 @@ extern void display_map(int *cy, int *cx);
 extern void do_cmd_view_map(void);
 extern errr vinfo_init(void);
 extern void forget_view(void);
+extern void update_view_full(void);
 extern void update_view(void);
 extern void update_noise(void);
+extern void flow_rebuild(int layer);
+extern void flow_wipe(void);
+extern int flow_cost(int layer, int y, int x);
+extern int flow_center_cost(int layer);
 extern void update_smell(void);
 extern void map_area(int y, int x, bool extended);
 extern void wiz_light(bool wizard);
 extern void wiz_dark(void);
 extern void illuminate(void);
 extern void cave_set_feat(int y, int x, int feat);
+extern void cave_flag_wipe(int flag);
+extern void cave_flag_union(int flag, int src);
+extern int cave_flag_count(int flag);
+extern void cave_info_wipe(void);
+extern byte cave_info_byte(int y, int x, int n);
+extern void cave_set_info_byte(int y, int x, int n, byte b);
 extern int project_path(u16b *gp, int range, \
                          int y1, int x1, int y2, int x2, int flg);
+extern void path_cache_wipe(void);
 extern byte projectable(int y1, int x1, int y2, int x2, int flg);
 extern void scatter(int *yp, int *xp, int y, int x, int d, int m);
 extern void health_track(int m_idx);
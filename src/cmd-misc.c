@@ -47,7 +47,7 @@ void get_feats(int *surroundings)
 	    continue;
 
 	/* Must have knowledge */
-	if (!cave_has(cave_info[yy][xx], CAVE_MARK))
+	if (!cave_has(yy, xx, CAVE_MARK))
 	    continue;
 
 	/* Record the feature */
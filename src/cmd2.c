@@ -1513,7 +1513,7 @@ int count_feats(int *y, int *x, int flag, bool under)
 	    continue;
 
 	/* Must have knowledge */
-	if (!cave_has(cave_info[yy][xx], CAVE_MARK))
+	if (!cave_has(yy, xx, CAVE_MARK))
 	    continue;
 
 	/* Not looking for this feature */
@@ -1556,7 +1556,7 @@ int count_traps(int *y, int *x)
 	    continue;
 
 	/* Must have knowledge */
-	if (!cave_has(cave_info[yy][xx], CAVE_MARK))
+	if (!cave_has(yy, xx, CAVE_MARK))
 	    continue;
 
 	/* No trap */
@@ -1639,7 +1639,7 @@ static bool do_cmd_open_test(int y, int x)
     feature_type *f_ptr = &f_info[cave_feat[y][x]];
 
     /* Must have knowledge */
-    if (!cave_has(cave_info[y][x], CAVE_MARK)) {
+    if (!cave_has(y, x, CAVE_MARK)) {
 	/* Message */
 	msg("You see nothing there.");
 
@@ -1841,7 +1841,7 @@ static bool do_cmd_close_test(int y, int x)
     feature_type *f_ptr = &f_info[cave_feat[y][x]];
 
     /* Must have knowledge */
-    if (!cave_has(cave_info[y][x], CAVE_MARK)) {
+    if (!cave_has(y, x, CAVE_MARK)) {
 	/* Message */
 	msg("You see nothing there.");
 
@@ -1963,7 +1963,7 @@ static bool do_cmd_tunnel_test(int y, int x)
     feature_type *f_ptr = &f_info[cave_feat[y][x]];
 
     /* Must have knowledge */
-    if (!cave_has(cave_info[y][x], CAVE_MARK)) {
+    if (!cave_has(y, x, CAVE_MARK)) {
 	/* Message */
 	msg("You see nothing there.");
 
@@ -2002,7 +2002,7 @@ static bool twall(int y, int x)
     sound(MSG_DIG);
 
     /* Forget the wall */
-    cave_off(cave_info[y][x], CAVE_MARK);
+    cave_off(y, x, CAVE_MARK);
 
     /* Remove the feature */
     if (outside)
@@ -2243,7 +2243,7 @@ void do_cmd_tunnel(cmd_code code, cmd_arg args[])
 static bool do_cmd_disarm_test(int y, int x)
 {
     /* Must have knowledge */
-    if (!cave_has(cave_info[y][x], CAVE_MARK)) {
+    if (!cave_has(y, x, CAVE_MARK)) {
 	/* Message */
 	msg("You see nothing there.");
 
@@ -2435,7 +2435,7 @@ static bool do_cmd_bash_test(int y, int x)
     feature_type *f_ptr = &f_info[cave_feat[y][x]];
 
     /* Must have knowledge */
-    if (!cave_has(cave_info[y][x], CAVE_MARK)) {
+    if (!cave_has(y, x, CAVE_MARK)) {
 	/* Message */
 	msg("You see nothing there.");
 
@@ -2648,7 +2648,7 @@ void do_cmd_alter_aux(int dir)
     f_ptr = &f_info[feat];
 
     /* Must have knowledge to know feature XXX XXX */
-    if (!cave_has(cave_info[y][x], CAVE_MARK))
+    if (!cave_has(y, x, CAVE_MARK))
 	feat = FEAT_NONE;
 
 
@@ -2720,7 +2720,7 @@ void do_cmd_alter_aux(int dir)
     }
 
     /* Disarm traps */
-    else if (cave_has(cave_info[y][x], CAVE_TRAP)) 
+    else if (cave_has(y, x, CAVE_TRAP)) 
     {
 	/* Disarm */
 	more = do_cmd_disarm_aux(y, x);
@@ -2787,7 +2787,7 @@ bool do_cmd_spike_test(int y, int x)
     feature_type *f_ptr = &f_info[cave_feat[y][x]];
 
     /* Must have knowledge */
-    if (!cave_has(cave_info[y][x], CAVE_MARK)) {
+    if (!cave_has(y, x, CAVE_MARK)) {
 	/* Message */
 	msg("You see nothing there.");
 
@@ -2920,7 +2920,7 @@ static bool do_cmd_walk_test(int y, int x)
 
 
     /* Hack -- walking obtains knowledge XXX XXX */
-    if (!cave_has(cave_info[y][x], CAVE_MARK))
+    if (!cave_has(y, x, CAVE_MARK))
 	return (TRUE);
 
     /* Check for being stuck in a web */
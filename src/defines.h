@@ -291,6 +291,19 @@
  */
 #define NOISE_STRENGTH 45
 
+/**
+ * Flow cost layers, by monster movement class (see "cave.c")
+ */
+#define FLOW_NOISE	0	/* Sound, which most monsters follow */
+#define FLOW_WALL	1	/* Monsters which pass or bore through walls */
+#define FLOW_DRY	2	/* Monsters which cannot cross water */
+#define FLOW_MAX	3
+
+/**
+ * Largest cost of a single step in a flow layer
+ */
+#define FLOW_STEP_MAX	3
+
 /**
  * Character turns it takes for smell to totally dissipate
  */
@@ -485,6 +498,12 @@
 #define MAX_SIGHT (OPT(adult_small_device) ? MAX_SIGHT_SML : MAX_SIGHT_LGE)  
 #define MAX_RANGE (OPT(adult_small_device) ? MAX_RANGE_SML : MAX_RANGE_LGE)
 
+/*
+ * Pathfinder failures (see path_to_grid())
+ */
+#define PF_UNREACHABLE	-1	/* No known route to the grid */
+#define PF_OUT_OF_RANGE	-2	/* Grid is outside the pathfinding window */
+
 
 /**
  * There is a 1/160 chance per round of creating a new monster
@@ -1596,25 +1615,21 @@ enum
 	CAVE_MAX
 };
 
+/* Bytes of flags per grid, as stored in the savefile */
 #define CAVE_SIZE                FLAG_SIZE(CAVE_MAX)
 
-#define cave_has(f, flag)        flag_has_dbg(f, CAVE_SIZE, flag, #f, #flag)
-#define cave_next(f, flag)       flag_next(f, CAVE_SIZE, flag)
-#define cave_is_empty(f)         flag_is_empty(f, CAVE_SIZE)
-#define cave_is_full(f)          flag_is_full(f, CAVE_SIZE)
-#define cave_is_inter(f1, f2)    flag_is_inter(f1, f2, CAVE_SIZE)
-#define cave_is_subset(f1, f2)   flag_is_subset(f1, f2, CAVE_SIZE)
-#define cave_is_equal(f1, f2)    flag_is_equal(f1, f2, CAVE_SIZE)
-#define cave_on(f, flag)         flag_on_dbg(f, CAVE_SIZE, flag, #f, #flag)
-#define cave_off(f, flag)        flag_off(f, CAVE_SIZE, flag)
-#define cave_wipe(f)             flag_wipe(f, CAVE_SIZE)
-#define cave_setall(f)           flag_setall(f, CAVE_SIZE)
-#define cave_negate(f)           flag_negate(f, CAVE_SIZE)
-#define cave_copy(f1, f2)        flag_copy(f1, f2, CAVE_SIZE)
-#define cave_union(f1, f2)       flag_union(f1, f2, CAVE_SIZE)
-#define cave_comp_union(f1, f2)  flag_comp_union(f1, f2, CAVE_SIZE)
-#define cave_inter(f1, f2)       flag_inter(f1, f2, CAVE_SIZE)
-#define cave_diff(f1, f2)        flag_diff(f1, f2, CAVE_SIZE)
+/*
+ * Cave flags are kept as one bitplane per flag (see "cave_info"), with
+ * each dungeon row packed into CAVE_WORDS 64-bit words.  Single grids are
+ * tested and changed with these; whole-level passes should use the
+ * cave_flag_*() functions, which work a word at a time.
+ */
+#define CAVE_WORDS               ((DUNGEON_WID + 63) / 64)
+#define CAVE_BIT(X)              ((u64b) 1 << ((X) & 63))
+
+#define cave_has(Y, X, flag)     ((cave_info[flag][Y][(X) >> 6] & CAVE_BIT(X)) != 0)
+#define cave_on(Y, X, flag)      (cave_info[flag][Y][(X) >> 6] |= CAVE_BIT(X))
+#define cave_off(Y, X, flag)     (cave_info[flag][Y][(X) >> 6] &= ~CAVE_BIT(X))
 
 /*** Object flags ***/
 
@@ -1963,7 +1978,7 @@ enum
  * Special Monster Flags (all temporary)
  */
 #define MFLAG_VIEW	0x01	/* Monster is in line of sight */
-#define MFLAG_XXX1	0x02	/*  */
+#define MFLAG_DIRTY	0x02	/* Monster's visibility needs checking */
 #define MFLAG_XXX2	0x04	/*  */
 #define MFLAG_ACTV	0x08	/* Monster is in active mode */
 #define MFLAG_WARY	0x10	/* Monster is wary of traps */
@@ -2273,7 +2288,8 @@ enum
  * Some monster types are different.
  */
 #define monster_is_unusual(R) \
-	(flags_test((R)->flags, RF_SIZE, RF_DEMON, RF_UNDEAD, RF_STUPID, FLAG_END) || \
+	(rf_has((R)->flags, RF_DEMON) || rf_has((R)->flags, RF_UNDEAD) || \
+	rf_has((R)->flags, RF_STUPID) || \
 	strchr("Evg", (R)->d_char))
 
 /**
@@ -2388,7 +2404,7 @@ enum
  * Note the use of comparison to zero to force a "boolean" result
  */
 #define player_has_los_bold(Y,X) \
-    (cave_has(cave_info[Y][X], CAVE_VIEW))
+    (cave_has(Y, X, CAVE_VIEW))
 
 
 /**
@@ -2397,7 +2413,7 @@ enum
  * Note the use of comparison to zero to force a "boolean" result
  */
 #define player_can_see_bold(Y,X) \
-    (cave_has(cave_info[Y][X], CAVE_SEEN))
+    (cave_has(Y, X, CAVE_SEEN))
 
 
 /**
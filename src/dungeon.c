@@ -462,6 +462,10 @@ static void process_world(void)
 	extend_magic = TRUE;
 
     /*** Attempt timed autosave.  From Zangband. ***/
+
+    /* Notice when a background save has finished */
+    savefile_save_done(FALSE);
+
     if (autosave && autosave_freq) {
 	if (!(turn % ((s32b) autosave_freq * 10))) {
 	    is_autosave = TRUE;
@@ -1496,7 +1500,7 @@ static void process_player(void)
 
 		/* Check for a key */
 		e = inkey_ex();
-		if (e.type != EVT_NONE) {
+		if (cmd_check_abort(e.type != EVT_NONE)) {
 			/* Flush and disturb */
 			flush();
 			disturb(0, 0);
@@ -1862,6 +1866,69 @@ void idle_update(void)
     Term_fresh();
 }
 
+/**
+ * Count the game turns from now in which nothing can happen.
+ *
+ * The world is only processed every ten game turns, and otherwise a game
+ * turn does nothing but hand out energy unless the player or some monster
+ * gets enough of it to act.  No random numbers are used in such turns, so
+ * they can be skipped without changing the game.
+ */
+static int idle_game_turns(void)
+{
+    int n, i;
+
+    /* Every ten game turns the world (and monster recovery) is processed */
+    n = (10 - turn % 10) % 10;
+    if (!n)
+	return (0);
+
+    /* The player acts when reaching 100 energy */
+    if (p_ptr->energy >= 100)
+	return (0);
+    n = MIN(n, (99 - p_ptr->energy) / extract_energy[p_ptr->state.pspeed]);
+
+    /* So do the monsters */
+    for (i = 0; (i < mon_active_n) && n; i++) {
+	int m_idx = mon_active[i];
+	byte speed = m_list[m_idx].mspeed;
+
+	if (mon_energy[m_idx] >= 100)
+	    return (0);
+	n = MIN(n, (99 - mon_energy[m_idx]) / extract_energy[speed]);
+    }
+
+    return (n);
+}
+
+
+/**
+ * Jump over game turns in which nobody can act, handing out the energy
+ * that those turns would have given.
+ */
+static void skip_idle_game_turns(void)
+{
+    int n = idle_game_turns();
+    int i;
+
+    if (!n)
+	return;
+
+    /* Give the player the energy */
+    p_ptr->energy += n * extract_energy[p_ptr->state.pspeed];
+
+    /* And the monsters */
+    for (i = 0; i < mon_active_n; i++) {
+	int m_idx = mon_active[i];
+
+	mon_energy[m_idx] += n * extract_energy[m_list[m_idx].mspeed];
+    }
+
+    /* Count game turns */
+    turn += n;
+}
+
+
 /**
  * Interact with the current dungeon level.
  *
@@ -1940,7 +2007,7 @@ static void dungeon(void)
 	    cave_set_feat(py, px, p_ptr->create_stair);
 
 	    /* Mark the stairs as known */
-	    cave_on(cave_info[py][px], CAVE_MARK);
+	    cave_on(py, px, CAVE_MARK);
 	}
 
 	/* Cancel the stair request */
@@ -2069,6 +2136,10 @@ static void dungeon(void)
 
 	/*** Apply energy ***/
 
+	/* Skip game turns in which nothing happens */
+	if (!just_arrived)
+	    skip_idle_game_turns();
+
 	/* Give the player some energy */
 	p_ptr->energy += extract_energy[p_ptr->state.pspeed];
 
@@ -2076,24 +2147,18 @@ static void dungeon(void)
 	if (just_arrived) {
 	    just_arrived = FALSE;
 	    if (!p_ptr->leaving) {
-		int i;
-		monster_type *m_ptr;
+		int n;
 
 		/* Set the player energy to exactly 100 */
 		p_ptr->energy = 100;
 
 		/* Give the player more energy than any monster */
-		for (i = m_max - 1; i >= 1; i--) {
-		    /* Access the monster */
-		    m_ptr = &m_list[i];
-
-		    /* Ignore dead monsters */
-		    if (!m_ptr->r_idx)
-			continue;
+		for (n = 0; n < mon_active_n; n++) {
+		    int i = mon_active[n];
 
 		    /* Give the player at least as much energy */
-		    if (m_ptr->energy > p_ptr->energy)
-			p_ptr->energy = m_ptr->energy;
+		    if (mon_energy[i] > p_ptr->energy)
+			p_ptr->energy = mon_energy[i];
 		}
 	    }
 	}
@@ -2268,6 +2333,9 @@ void play_game(void)
 
     p_ptr->is_dead = TRUE;
 
+    /* A replay starts from the savefile it was recorded with */
+    cmd_replay_savefile();
+
     if (savefile[0] && file_exists(savefile))
     {
 	bool ok = savefile_load(savefile);
@@ -2320,6 +2388,9 @@ void play_game(void)
 	Rand_state_init(seed);
     }
 
+    /* Start recording (or replaying) commands */
+    cmd_record_start();
+
     /* Roll new character */
     if (new_game) {
 	/* The dungeon is not ready */
@@ -2542,4 +2613,7 @@ void play_game(void)
 
     /* Close stuff */
     close_game();
+
+    /* Finish any recording */
+    cmd_record_close();
 }
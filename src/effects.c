@@ -3218,7 +3218,7 @@ bool effect_do(effect_type effect, bool * ident, bool aware, int dir)
 		    continue;
 
 		/* Skip grids in vaults */
-		if (cave_has(cave_info[y][x], CAVE_ICKY))
+		if (cave_has(y, x, CAVE_ICKY))
 		    continue;
 
 		/* Lava now */
@@ -3310,7 +3310,6 @@ bool effect_do(effect_type effect, bool * ident, bool aware, int dir)
     {
 	int y, x;
 	int py = p_ptr->py, px = p_ptr->px;
-	monster_type *m_ptr;
 
 	msg
 	    ("Your foes slow, and you seem to have an eternity to act...");
@@ -3332,12 +3331,9 @@ bool effect_do(effect_type effect, bool * ident, bool aware, int dir)
 		if (!player_has_los_bold(y, x))
 		    continue;
 
-		/* Get the monster */
-		m_ptr = &m_list[cave_m_idx[y][x]];
-
 		/* Take the energy */
-		p_ptr->energy += m_ptr->energy;
-		m_ptr->energy = 0;
+		p_ptr->energy += mon_energy[cave_m_idx[y][x]];
+		mon_energy[cave_m_idx[y][x]] = 0;
 	    }
 
 	return TRUE;
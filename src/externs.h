@@ -134,29 +134,27 @@ extern int temp_n;
 extern u16b *temp_g;
 extern byte *temp_y;
 extern byte *temp_x;
-extern u16b (*adjacency)[NUM_STAGES];
-extern u16b (*stage_path)[NUM_STAGES];
-extern u16b (*temp_path)[NUM_STAGES];
 extern u16b (*race_prob)[NUM_STAGES];
 extern byte *dummy;
-extern bitflag (*cave_info)[256][CAVE_SIZE];
+extern cave_plane *cave_info;
 extern byte (*cave_feat)[DUNGEON_WID];
 extern s16b (*cave_o_idx)[DUNGEON_WID];
 extern s16b (*cave_m_idx)[DUNGEON_WID];
 
 extern byte (*cave_cost)[DUNGEON_WID];
-extern byte (*cave_when)[DUNGEON_WID];
+extern s32b (*cave_when)[DUNGEON_WID];
 extern int scent_when;
-extern int flow_center_y;
-extern int flow_center_x;
-extern int update_center_y;
-extern int update_center_x;
-extern int cost_at_center;
+extern s32b scent_turn;
+extern s32b scent_loop;
 
 extern maxima *z_info;
 extern trap_type *trap_list;
 extern object_type *o_list;
 extern monster_type *m_list;
+extern byte *mon_energy;
+extern bool *mon_moved;
+extern s16b *mon_active;
+extern s16b mon_active_n;
 extern monster_lore *l_list;
 extern quest *q_list;
 extern store_type *store;
@@ -165,11 +163,13 @@ extern object_type *inventory;
 extern object_type *quiver;
 extern s16b alloc_kind_size;
 extern alloc_entry *alloc_kind_table;
+extern rand_table alloc_kind_pick;
 extern s16b alloc_ego_size;
 extern alloc_entry *alloc_ego_table;
 extern s16b alloc_race_size;
 extern alloc_entry *alloc_race_table;
 extern u32b alloc_race_total;
+extern rand_table alloc_race_pick;
 extern byte gf_to_attr[GF_MAX][BOLT_MAX];
 extern wchar_t gf_to_char[GF_MAX][BOLT_MAX];
 extern byte misc_to_attr[256];
@@ -267,6 +267,12 @@ extern bool angband_keymap_flag;
 extern void (*sound_hook)(int);
 extern autoinscription *inscriptions;
 extern u16b inscriptions_count;
+extern bitflag rsf_breath_mask[RSF_SIZE];
+extern bitflag rsf_harass_mask[RSF_SIZE];
+extern bitflag rsf_bolt_mask[RSF_SIZE];
+extern bitflag rsf_archery_mask[RSF_SIZE];
+extern bitflag rsf_no_player_mask[RSF_SIZE];
+extern bitflag rsf_summon_mask[RSF_SIZE];
 
 /* util.c */
 extern struct keypress *inkey_next;
@@ -279,6 +285,7 @@ extern struct keypress *inkey_next;
 extern bool py_attack(int y, int x, bool can_push);
 
 /* birth.c */
+extern void player_init(struct player *p);
 extern void player_birth(bool quickstart_allowed);
 
 /* charattr.c */
@@ -315,6 +322,7 @@ int coords_to_dir(int y, int x);
 void death_screen(void);
 
 /* dungeon.c */
+extern void init_artifacts(void);
 extern void play_game(void);
 extern void idle_update(void);
 
@@ -331,6 +339,8 @@ extern void process_monsters(byte minimum_energy);
 extern void reset_monsters(void);
 
 /* pathfind.c */
+extern u32b pf_expanded;
+extern int path_to_grid(int y, int x);
 extern bool findpath(int y, int x);
 extern int get_angle_to_target(int y0, int x0, int y1, int x1, int dir);
 extern void get_grid_using_angle(int angle, int y0, int x0,
@@ -2628,8 +2628,9 @@ void save_game(void)
     /* Forbid suspend */
     signals_ignore_tstp();
 
-    /* Save the player */
-    if (savefile_save(savefile)) {
+    /* Save the player; autosaves are written in the background */
+    if (is_autosave ? savefile_save_background(savefile) :
+	savefile_save(savefile)) {
 	if (!is_autosave)
 	    prt("Saving game... done.", 0, 0);
     }
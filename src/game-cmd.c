@@ -37,6 +37,15 @@ static game_command cmd_queue[CMD_QUEUE_SIZE];
 static bool repeat_prev_allowed = FALSE;
 static bool repeating = FALSE;
 
+/* Whether a recording is being replayed (see below) */
+static bool replaying = FALSE;
+
+/* Depth of running commands; the store runs commands inside a command */
+static int cmd_depth = 0;
+
+static void replay_command(void);
+static void record_command(const game_command *cmd, int nrepeats);
+
 /* A simple list of commands and their handling functions. */
 static struct
 {
@@ -236,9 +245,14 @@ errr cmd_get(cmd_context c, game_command **cmd, bool wait)
 		return 0;
 	}
 
-	/* If there are no commands queued, ask the UI for one. */
-	if (cmd_head == cmd_tail) 
-		cmd_get_hook(c, wait);
+	/* If there are no commands queued, ask the UI (or the replay) for one. */
+	if (cmd_head == cmd_tail)
+	{
+		if (replaying && !cmd_depth)
+			replay_command();
+		else
+			cmd_get_hook(c, wait);
+	}
 
 	/* If we have a command ready, set it and return success. */
 	if (cmd_head != cmd_tail)
@@ -246,6 +260,10 @@ errr cmd_get(cmd_context c, game_command **cmd, bool wait)
 		*cmd = &cmd_queue[cmd_tail++];
 		if (cmd_tail == CMD_QUEUE_SIZE) cmd_tail = 0;
 
+		/* Birth commands are carried out as they come */
+		if (c == CMD_BIRTH)
+			record_command(*cmd, (*cmd)->nrepeats);
+
 		return 0;
 	}
 
@@ -386,6 +404,9 @@ void process_command(cmd_context ctx, bool no_request)
 {
 	game_command *cmd;
 
+	/* Repeats are not recorded, as the replay repeats them too */
+	bool queued = !repeating;
+
 	/* Reset so that when selecting items, we look in the default location */
 	p_ptr->command_wrk = 0;
 
@@ -427,6 +448,10 @@ void process_command(cmd_context ctx, bool no_request)
 				char o_name[80];
 				char tmp[80] = "";
 				object_type *o_ptr = object_from_item_idx(cmd->arg[0].item);
+
+				/* A replay has the inscription already */
+				if (replaying && cmd->arg_present[1])
+					break;
 			
 				object_desc(o_name, sizeof(o_name), o_ptr, ODESC_PREFIX | ODESC_FULL);
 				msg("Inscribing %s.", o_name);
@@ -612,6 +637,10 @@ void process_command(cmd_context ctx, bool no_request)
 			{
 				object_type *o_ptr = object_from_item_idx(cmd->arg[0].choice);
 				int slot = wield_slot(o_ptr);
+
+				/* A replay has the slot already */
+				if (replaying && cmd->arg_present[1])
+					break;
 			
 	    /* Deal with throwing weapons */
 	    if ((slot == INVEN_WIELD) && of_has(o_ptr->flags_obj, OF_THROWING))
@@ -673,8 +702,13 @@ void process_command(cmd_context ctx, bool no_request)
 		 */
 		repeat_prev_allowed = TRUE;
 
+		if (queued)
+			record_command(cmd, oldrepeats);
+
+		cmd_depth++;
 		if (game_cmds[idx].fn)
 			game_cmds[idx].fn(cmd->command, cmd->arg);
+		cmd_depth--;
 
 		/* If the command hasn't changed nrepeats, count this execution. */
 		if (cmd->nrepeats > 0 && oldrepeats == cmd_get_nrepeats())
@@ -732,3 +766,649 @@ void cmd_disable_repeat(void)
 {
 	repeat_prev_allowed = FALSE;
 }
+
+
+/*** Recording and replay ***/
+
+/*
+ * A recording starts with a header: the bytes "FAcr", a version, a flags
+ * byte, the state of the complex RNG and, if the game began from one, the
+ * savefile.  Records follow, each a tag byte and then varints (signed
+ * values zigzagged):
+ *
+ *   'C'  a command, as the game carried it out, and the turn it began
+ *   'K'  an event read while a command was running ('S' if not waited for)
+ *   'A'  a keypress that cut short a run, rest or repeated command
+ *   'O'  the options, whenever they have changed since the last command
+ *
+ * Commands are recorded once their arguments have been asked for, so a
+ * replay never prompts for them.  Targets are recorded with the commands
+ * aimed at them.  Things done purely through the UI, such as inspecting
+ * the map, leave nothing to replay.
+ */
+#define RECORD_VERSION		1
+
+/* Header flags */
+#define RECORD_SAVEFILE		0x01
+
+/* Command flags: the arguments present, and whether a target follows */
+#define RECORD_ARG(N)		(0x01 << (N))
+#define RECORD_TARGET		0x80
+
+/* Escapes to hand out in a row before giving up on a replay */
+#define REPLAY_IDLE_MAX		1000
+
+static ang_file *record_file;
+static bool recording = FALSE;
+
+static byte *replay_buf;
+static size_t replay_len = 0;
+static size_t replay_pos = 0;
+static size_t replay_save_pos = 0;
+static size_t replay_save_len = 0;
+static size_t replay_start_pos = 0;
+
+static bool record_paused = FALSE;
+
+/* Abort checks since the last record which did not abort */
+static u32b abort_checks = 0;
+
+/* The options as last recorded */
+static bool record_opt[OPT_MAX];
+
+static u32b replay_commands = 0;
+static u32b replay_desyncs = 0;
+static u32b replay_idle = 0;
+
+/* The record being built */
+static byte rec_buf[1024];
+static size_t rec_len = 0;
+
+static void rec_byte(byte b)
+{
+	if (rec_len < sizeof(rec_buf))
+		rec_buf[rec_len++] = b;
+}
+
+static void rec_uint(u32b v)
+{
+	while (v >= 0x80)
+	{
+		rec_byte((byte)(v | 0x80));
+		v >>= 7;
+	}
+
+	rec_byte((byte)v);
+}
+
+static void rec_int(s32b v)
+{
+	rec_uint(v < 0 ? ~((u32b)v << 1) : (u32b)v << 1);
+}
+
+static void rec_string(const char *str)
+{
+	size_t len = str ? strlen(str) : 0;
+
+	if (len > 255) len = 255;
+
+	rec_uint(len);
+	while (len--)
+		rec_byte((byte)*str++);
+}
+
+static void rec_flush(void)
+{
+	file_write(record_file, (const char *)rec_buf, rec_len);
+	rec_len = 0;
+	abort_checks = 0;
+}
+
+static int replay_peek(void)
+{
+	return (replay_pos < replay_len) ? replay_buf[replay_pos] : -1;
+}
+
+static byte replay_byte(void)
+{
+	return (replay_pos < replay_len) ? replay_buf[replay_pos++] : 0;
+}
+
+static u32b replay_uint(void)
+{
+	u32b v = 0;
+	int shift = 0;
+	byte b;
+
+	do
+	{
+		b = replay_byte();
+		if (shift < 32) v |= (u32b)(b & 0x7F) << shift;
+		shift += 7;
+	}
+	while (b & 0x80);
+
+	return v;
+}
+
+static s32b replay_int(void)
+{
+	u32b v = replay_uint();
+
+	return (v & 1) ? (s32b)~(v >> 1) : (s32b)(v >> 1);
+}
+
+static char *replay_string(void)
+{
+	u32b len = replay_uint();
+	char *str;
+
+	if (len > replay_len - replay_pos) len = replay_len - replay_pos;
+
+	str = mem_zalloc(len + 1);
+	memcpy(str, replay_buf + replay_pos, len);
+	replay_pos += len;
+
+	return str;
+}
+
+/*
+ * The state of the complex RNG, in the order wr_randomizer() saves it.
+ */
+static u32b *rng_state(int i)
+{
+	switch (i)
+	{
+		case 0: return &state_i;
+		case 1: return &z0;
+		case 2: return &z1;
+		case 3: return &z2;
+		default: return &STATE[i - 4];
+	}
+}
+
+#define RNG_STATE_LEN	(4 + RAND_DEG)
+
+
+/*
+ * Open a file to record into, once cmd_record_start() is reached.
+ */
+bool cmd_record_open(const char *path)
+{
+	record_file = file_open(path, MODE_WRITE, FTYPE_RAW);
+	return (record_file != NULL);
+}
+
+/*
+ * Read in a recording to replay, and check its header.  The replay itself
+ * starts with cmd_record_start().
+ */
+bool cmd_replay_open(const char *path)
+{
+	ang_file *f = file_open(path, MODE_READ, FTYPE_RAW);
+	size_t size = 4096;
+	int n, i;
+
+	if (!f) return FALSE;
+
+	replay_buf = mem_alloc(size);
+	while ((n = file_read(f, (char *)replay_buf + replay_len,
+			size - replay_len)) > 0)
+	{
+		replay_len += n;
+		if (replay_len == size)
+		{
+			size *= 2;
+			replay_buf = mem_realloc(replay_buf, size);
+		}
+	}
+	file_close(f);
+
+	if (replay_len < 6 || memcmp(replay_buf, "FAcr", 4) ||
+			replay_buf[4] != RECORD_VERSION)
+	{
+		FREE(replay_buf);
+		replay_len = 0;
+		return FALSE;
+	}
+
+	/* Skip over the RNG state for now */
+	replay_pos = 6;
+	for (i = 0; i < RNG_STATE_LEN; i++)
+		replay_uint();
+
+	/* Note where the savefile is */
+	if (replay_buf[5] & RECORD_SAVEFILE)
+	{
+		replay_save_len = replay_uint();
+		replay_save_pos = replay_pos;
+		replay_pos += replay_save_len;
+		if (replay_pos > replay_len)
+		{
+			FREE(replay_buf);
+			replay_len = 0;
+			return FALSE;
+		}
+	}
+
+	replay_start_pos = replay_pos;
+	replay_pos = 6;
+
+	return TRUE;
+}
+
+/*
+ * Have the game load the savefile the recording began from, or start a
+ * new character if it had none.  The game then saves to the same place,
+ * so a replay never touches the player's own savefiles.
+ */
+void cmd_replay_savefile(void)
+{
+	if (!replay_buf) return;
+
+	path_build(savefile, sizeof(savefile), ANGBAND_DIR_USER, "replay.sav");
+	file_delete(savefile);
+
+	if (replay_save_len)
+	{
+		ang_file *f = file_open(savefile, MODE_WRITE, FTYPE_SAVE);
+
+		if (!f) quit("cannot write the replay's savefile");
+		file_write(f, (const char *)replay_buf + replay_save_pos,
+			replay_save_len);
+		file_close(f);
+	}
+}
+
+/*
+ * Start recording, or replaying.  The savefile has been loaded, and the
+ * RNG seeded, by now; a replay takes up the RNG state it was recorded
+ * with.
+ */
+void cmd_record_start(void)
+{
+	int i;
+
+	if (replay_buf)
+	{
+		replay_pos = 6;
+		Rand_quick = FALSE;
+		for (i = 0; i < RNG_STATE_LEN; i++)
+			*rng_state(i) = replay_uint();
+
+		replay_pos = replay_start_pos;
+		replaying = TRUE;
+		return;
+	}
+
+	if (!record_file) return;
+
+	rec_byte('F');
+	rec_byte('A');
+	rec_byte('c');
+	rec_byte('r');
+	rec_byte(RECORD_VERSION);
+	rec_byte(file_exists(savefile) ? RECORD_SAVEFILE : 0);
+
+	for (i = 0; i < RNG_STATE_LEN; i++)
+		rec_uint(*rng_state(i));
+
+	/* Include the savefile, so the recording is all that is needed */
+	if (file_exists(savefile))
+	{
+		ang_file *f = file_open(savefile, MODE_READ, FTYPE_RAW);
+		size_t size = 65536, len = 0;
+		char *buf = mem_alloc(size);
+		int n;
+
+		while (f && (n = file_read(f, buf + len, size - len)) > 0)
+		{
+			len += n;
+			if (len == size)
+			{
+				size *= 2;
+				buf = mem_realloc(buf, size);
+			}
+		}
+		if (f) file_close(f);
+
+		rec_uint(len);
+		rec_flush();
+		file_write(record_file, buf, len);
+		FREE(buf);
+	}
+
+	rec_flush();
+
+	/* Any options set so far go out with the first command */
+	C_WIPE(record_opt, OPT_MAX, bool);
+	recording = TRUE;
+}
+
+/*
+ * Stop recording or replaying.
+ */
+void cmd_record_close(void)
+{
+	if (recording)
+		file_close(record_file);
+	record_file = NULL;
+	recording = FALSE;
+
+	FREE(replay_buf);
+	replaying = FALSE;
+}
+
+bool cmd_replaying(void)
+{
+	return replaying;
+}
+
+void cmd_replay_stats(u32b *commands, u32b *desyncs)
+{
+	*commands = replay_commands;
+	*desyncs = replay_desyncs;
+}
+
+/*
+ * Record a command the game is about to carry out, with any target it is
+ * aimed at, and the options if they have changed.
+ */
+static void record_command(const game_command *cmd, int nrepeats)
+{
+	byte flags = 0;
+	int i;
+
+	if (!recording || cmd_depth) return;
+
+	for (i = 0; i < OPT_MAX; i++)
+		if (op_ptr->opt[i] != record_opt[i]) break;
+
+	if (i < OPT_MAX)
+	{
+		byte bits = 0;
+
+		rec_byte('O');
+		for (i = 0; i < OPT_MAX; i++)
+		{
+			record_opt[i] = op_ptr->opt[i];
+			if (record_opt[i]) bits |= 1 << (i % 8);
+			if (i % 8 == 7)
+			{
+				rec_byte(bits);
+				bits = 0;
+			}
+		}
+		rec_flush();
+	}
+
+	for (i = 0; i < CMD_MAX_ARGS; i++)
+	{
+		if (!cmd->arg_present[i]) continue;
+
+		flags |= RECORD_ARG(i);
+
+		if (!(cmd->arg_type[i] & (arg_STRING | arg_POINT)) &&
+				cmd->arg[i].direction == DIR_TARGET && target_is_set())
+			flags |= RECORD_TARGET;
+	}
+
+	rec_byte('C');
+	rec_uint(cmd->command);
+	rec_int(nrepeats);
+	rec_int(turn);
+	rec_byte(flags);
+
+	for (i = 0; i < CMD_MAX_ARGS; i++)
+	{
+		if (!cmd->arg_present[i]) continue;
+
+		rec_byte(cmd->arg_type[i]);
+
+		if (cmd->arg_type[i] & arg_STRING)
+			rec_string(cmd->arg[i].string);
+		else if (cmd->arg_type[i] & arg_POINT)
+		{
+			rec_int(cmd->arg[i].point.x);
+			rec_int(cmd->arg[i].point.y);
+		}
+		else
+			rec_int(cmd->arg[i].number);
+	}
+
+	if (flags & RECORD_TARGET)
+	{
+		s16b x, y;
+
+		target_get(&x, &y);
+		rec_uint(target_get_monster());
+		rec_uint(target_get_object());
+		rec_int(y);
+		rec_int(x);
+	}
+
+	rec_flush();
+}
+
+/*
+ * Read the event of a 'K' or 'S' record.
+ */
+static ui_event replay_event(void)
+{
+	ui_event ke = EVENT_EMPTY;
+
+	ke.type = replay_byte();
+	if (ke.type == EVT_MOUSE)
+	{
+		ke.mouse.button = replay_byte();
+		ke.mouse.x = replay_uint();
+		ke.mouse.y = replay_uint();
+	}
+	else
+	{
+		ke.key.code = replay_uint();
+		ke.key.mods = replay_byte();
+	}
+
+	return ke;
+}
+
+/*
+ * Queue the next command of a replay, in place of asking the UI.  The
+ * replay is over when it runs out.
+ */
+static void replay_command(void)
+{
+	game_command cmd;
+	byte flags;
+	int tag, i;
+
+	/* Catch up with the options, and pass over anything out of step */
+	while ((tag = replay_peek()) != 'C')
+	{
+		if (tag < 0)
+		{
+			cmd_record_close();
+			quit(NULL);
+		}
+
+		replay_pos++;
+
+		if (tag == 'O')
+		{
+			for (i = 0; i < OPT_MAX; i += 8)
+			{
+				byte bits = replay_byte();
+				int j;
+
+				for (j = 0; j < 8 && i + j < OPT_MAX; j++)
+					op_ptr->opt[i + j] = (bits & (1 << j)) ? TRUE : FALSE;
+			}
+		}
+		else
+		{
+			replay_desyncs++;
+			if (tag == 'A') replay_uint();
+			else replay_event();
+		}
+	}
+
+	replay_pos++;
+	WIPE(&cmd, game_command);
+
+	cmd.command = replay_uint();
+	cmd.nrepeats = replay_int();
+	if (replay_int() != turn) replay_desyncs++;
+	flags = replay_byte();
+
+	for (i = 0; i < CMD_MAX_ARGS; i++)
+	{
+		if (!(flags & RECORD_ARG(i))) continue;
+
+		cmd.arg_present[i] = TRUE;
+		cmd.arg_type[i] = replay_byte();
+
+		/* Commands may keep the string (birth does), so it is theirs */
+		if (cmd.arg_type[i] & arg_STRING)
+			cmd.arg[i].string = replay_string();
+		else if (cmd.arg_type[i] & arg_POINT)
+		{
+			cmd.arg[i].point.x = replay_int();
+			cmd.arg[i].point.y = replay_int();
+		}
+		else
+			cmd.arg[i].number = replay_int();
+	}
+
+	if (flags & RECORD_TARGET)
+	{
+		int who = replay_uint();
+		int what = replay_uint();
+		int y = replay_int();
+		int x = replay_int();
+
+		if (who) target_set_monster(who);
+		else if (what) target_set_object(what);
+		else target_set_location(y, x);
+	}
+
+	abort_checks = 0;
+	replay_idle = 0;
+	replay_commands++;
+
+	cmd_insert_s(&cmd);
+}
+
+void cmd_record_pause(bool pause)
+{
+	record_paused = pause;
+}
+
+/*
+ * Record an event read while a command was running.
+ */
+void cmd_record_key(const ui_event *ke, bool scan)
+{
+	if (!recording || !cmd_depth || record_paused) return;
+
+	switch (ke->type)
+	{
+		case EVT_KBRD:
+		case EVT_BUTTON:
+		{
+			rec_byte(scan ? 'S' : 'K');
+			rec_byte(ke->type);
+			rec_uint(ke->key.code);
+			rec_byte(ke->key.mods);
+			break;
+		}
+
+		case EVT_MOUSE:
+		{
+			rec_byte(scan ? 'S' : 'K');
+			rec_byte(ke->type);
+			rec_byte(ke->mouse.button);
+			rec_uint(ke->mouse.x);
+			rec_uint(ke->mouse.y);
+			break;
+		}
+
+		default:
+			return;
+	}
+
+	rec_flush();
+}
+
+/*
+ * Supply the next event of a replay.  Running commands get what they
+ * read when recorded; anything else waiting for a key gets an escape.
+ */
+ui_event cmd_replay_key(bool scan)
+{
+	ui_event ke = EVENT_EMPTY;
+	int tag = replay_peek();
+
+	if (cmd_depth && !record_paused && tag == (scan ? 'S' : 'K'))
+	{
+		replay_pos++;
+		abort_checks = 0;
+		replay_idle = 0;
+		return replay_event();
+	}
+
+	if (scan) return ke;
+
+	/* The recording ended here */
+	if (tag < 0 && !record_paused)
+	{
+		cmd_record_close();
+		quit(NULL);
+	}
+
+	if (++replay_idle > REPLAY_IDLE_MAX)
+		quit("replay is stuck waiting for a key");
+
+	ke.type = EVT_KBRD;
+	ke.key.code = ESCAPE;
+	return ke;
+}
+
+/*
+ * Keypresses that abort runs, rests and repeats are read between commands,
+ * so they are recorded as the number of checks that came to nothing
+ * before one did.
+ */
+bool cmd_check_abort(bool aborted)
+{
+	if (replaying)
+	{
+		aborted = FALSE;
+
+		if (replay_peek() == 'A')
+		{
+			size_t pos = replay_pos++;
+
+			if (replay_uint() == abort_checks)
+				aborted = TRUE;
+			else
+				replay_pos = pos;
+		}
+
+		if (aborted) abort_checks = 0;
+		else abort_checks++;
+	}
+	else if (recording)
+	{
+		if (aborted)
+		{
+			rec_byte('A');
+			rec_uint(abort_checks);
+			rec_flush();
+		}
+		else
+			abort_checks++;
+	}
+
+	return aborted;
+}
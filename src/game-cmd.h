@@ -223,4 +223,46 @@ void cmd_disable_repeat(void);
  */
 int cmd_get_nrepeats(void);
 
+
+/*** Recording and replay ***/
+
+/*
+ * Start recording the command stream to the file 'path', or replaying a
+ * recording from it.  Either takes effect when cmd_record_start() is
+ * called, once the savefile has been loaded and the RNG seeded.
+ */
+bool cmd_record_open(const char *path);
+bool cmd_replay_open(const char *path);
+
+/* Point the savefile at the one stored in any recording to be replayed. */
+void cmd_replay_savefile(void);
+
+/* Write (or read back) the recording's header, with the RNG state. */
+void cmd_record_start(void);
+
+/* Finish the recording or replay. */
+void cmd_record_close(void);
+
+/* Whether a recording is being replayed. */
+bool cmd_replaying(void);
+
+/*
+ * Called with each event read by inkey_ex(), and in place of reading one
+ * during a replay.
+ */
+void cmd_record_key(const ui_event *ke, bool scan);
+ui_event cmd_replay_key(bool scan);
+
+/* Keys read while paused only dismiss prompts, and are not recorded. */
+void cmd_record_pause(bool pause);
+
+/*
+ * Called with the outcome of each check for a keypress that disturbs a
+ * run, rest or repeated command; returns the outcome to act on.
+ */
+bool cmd_check_abort(bool aborted);
+
+/* Commands replayed so far, and how many of them were out of step. */
+void cmd_replay_stats(u32b *commands, u32b *desyncs);
+
 #endif
@@ -37,6 +37,7 @@ typedef enum game_event_type
 	EVENT_MONSTERTARGET,
 	EVENT_OBJECTTARGET,
 	EVENT_MESSAGE,
+	EVENT_SAVED,		/* A background save has finished */
 
 	EVENT_INITSTATUS,	/* New status message for initialisation */
 	EVENT_BIRTHPOINTS,	/* Change in the birth points */
@@ -388,11 +388,11 @@ void destroy_level(bool new_level)
 		    }
 
 		    /* No longer part of a room or vault */
-		    cave_off(cave_info[y][x], CAVE_ROOM);
-		    cave_off(cave_info[y][x], CAVE_ICKY);
+		    cave_off(y, x, CAVE_ROOM);
+		    cave_off(y, x, CAVE_ICKY);
 
 		    /* No longer illuminated */
-		    cave_off(cave_info[y][x], CAVE_GLOW);
+		    cave_off(y, x, CAVE_GLOW);
 		}
 	    }
 	}
@@ -819,7 +819,7 @@ static void try_door(int y0, int x0)
 	return;
 
     /* Ignore room grids */
-    if (cave_has(cave_info[y0][x0], CAVE_ROOM))
+    if (cave_has(y0, x0, CAVE_ROOM))
 	return;
 
     /* Occasional door (if allowed) */
@@ -836,7 +836,7 @@ static void try_door(int y0, int x0)
 		continue;
 
 	    /* Skip grids inside rooms */
-	    if (cave_has(cave_info[y][x], CAVE_ROOM))
+	    if (cave_has(y, x, CAVE_ROOM))
 		continue;
 
 	    /* We require at least two walls outside of rooms. */
@@ -1031,7 +1031,7 @@ void build_tunnel(int start_room, int end_room)
 
 	    /* We're in our destination room - head straight for target. */
 	    if ((tmp == end_room) && 
-		cave_has(cave_info[row1][col1], CAVE_ROOM)) {
+		cave_has(row1, col1, CAVE_ROOM)) {
 		correct_dir(&row_dir, &col_dir, row1, col1, row2, col2);
 	    }
 
@@ -1261,7 +1261,7 @@ void build_tunnel(int start_room, int end_room)
 
 	    /* Forbid re-entry near this piercing. */
 	    if ((!unalterable(cave_feat[row1 + row_dir][col1 + col_dir]))
-		&& cave_has(cave_info[row1][col1], CAVE_ROOM)) {
+		&& cave_has(row1, col1, CAVE_ROOM)) {
 		if (row_dir) {
 		    for (x = col1 - 3; x <= col1 + 3; x++) {
 			/* Convert adjacent "outer" walls */
@@ -1491,7 +1491,7 @@ void build_tunnel(int start_room, int end_room)
 	}
 
 	/* Travel quickly through rooms. */
-	else if (cave_has(cave_info[tmp_row][tmp_col], CAVE_ROOM)) {
+	else if (cave_has(tmp_row, tmp_col, CAVE_ROOM)) {
 	    /* Accept the location */
 	    row1 = tmp_row;
 	    col1 = tmp_col;
@@ -2097,10 +2097,6 @@ extern void cave_gen(void)
 
 
     /* Clear "temp" flags. */
-    for (y = 0; y < DUNGEON_HGT; y++) {
-	for (x = 0; x < DUNGEON_WID; x++) {
-	    cave_off(cave_info[y][x], CAVE_TEMP);
-	}
-    }
+    cave_flag_wipe(CAVE_TEMP);
 }
 
@@ -211,7 +211,7 @@ static bool mon_select(int r_idx)
 
     /* Require correct breath attack */
     rsf_copy(mon_breath, r_ptr->spell_flags);
-    flags_mask(mon_breath, RSF_SIZE, RSF_BREATH_MASK, FLAG_END);
+    rsf_inter(mon_breath, rsf_breath_mask);
 
     /* Special case: Elemental war themed level. */
     if (p_ptr->themed_level == THEME_ELEMENTAL) {
@@ -545,7 +545,7 @@ int make_formation(int y, int x, int base_feat1, int base_feat2, int *feat,
 		    f_ptr = &f_info[cave_feat[yy][xx]];
 		    if ((tf_has(f_ptr->flags, TF_PERMANENT))
 			|| (distance(yy, xx, p_ptr->py, p_ptr->px) < 20)
-			|| cave_has(cave_info[yy][xx], CAVE_ICKY))
+			|| cave_has(yy, xx, CAVE_ICKY))
 			good_place = FALSE;
 		}
 	} else
@@ -595,7 +595,7 @@ int make_formation(int y, int x, int base_feat1, int base_feat2, int *feat,
 	/* Avoid paths, stay in bounds */
 	if (((cave_feat[ty][tx] != base_feat1)
 	     && (cave_feat[ty][tx] != base_feat2)) || !(in_bounds_fully(ty, tx))
-	    || cave_has(cave_info[ty][tx], CAVE_ICKY)) {
+	    || cave_has(ty, tx, CAVE_ICKY)) {
 	    free(all_feat);
 	    return (total);
 	}
@@ -608,7 +608,7 @@ int make_formation(int y, int x, int base_feat1, int base_feat2, int *feat,
 
 	/* Set the feature */
 	cave_set_feat(ty, tx, all_feat[i]);
-	cave_on(cave_info[ty][tx], CAVE_ICKY);
+	cave_on(ty, tx, CAVE_ICKY);
 
 	/* Choose a random step for next feature, try to keep going */
 	terrain = randint0(8) + 1;
@@ -617,7 +617,7 @@ int make_formation(int y, int x, int base_feat1, int base_feat2, int *feat,
 	for (j = 0; j < 100; j++) {
 	    ty += ddy[terrain];
 	    tx += ddx[terrain];
-	    if (!cave_has(cave_info[ty][tx], CAVE_ICKY))
+	    if (!cave_has(ty, tx, CAVE_ICKY))
 		break;
 	}
 
@@ -767,11 +767,7 @@ extern void plain_gen(void)
     }
 
     /* No longer "icky" */
-    for (y = 0; y < DUNGEON_HGT; y++) {
-	for (x = 0; x < DUNGEON_WID; x++) {
-	    cave_off(cave_info[y][x], CAVE_ICKY);
-	}
-    }
+    cave_flag_wipe(CAVE_ICKY);
 
     /* Basic "amount" */
     k = (p_ptr->depth / 2);
@@ -823,7 +819,7 @@ extern void plain_gen(void)
     /* Clear "temp" flags. */
     for (y = 0; y < DUNGEON_HGT; y++) {
 	for (x = 0; x < DUNGEON_WID; x++) {
-	    cave_off(cave_info[y][x], CAVE_TEMP);
+	    cave_off(y, x, CAVE_TEMP);
 
 	    /* Paranoia - remake the dungeon walls */
 
@@ -849,7 +845,7 @@ void mtn_connect(int y, int x, int y1, int x1)
 	    || (!in_bounds_fully(GRID_Y(gp[j]), GRID_X(gp[j]))))
 	    break;
 	cave_set_feat(GRID_Y(gp[j]), GRID_X(gp[j]), FEAT_ROAD);
-	cave_on(cave_info[GRID_Y(gp[j])][GRID_X(gp[j])], CAVE_ICKY);
+	cave_on(GRID_Y(gp[j]), GRID_X(gp[j]), CAVE_ICKY);
     }
 }
 
@@ -961,7 +957,7 @@ extern void mtn_gen(void)
 	for (x = 0; x < DUNGEON_WID; x++)
 	    if (cave_feat[y][x] == FEAT_ROAD) {
 		/* Hack - prepare for plateaux, connecting */
-		cave_on(cave_info[y][x], CAVE_ICKY);
+		cave_on(y, x, CAVE_ICKY);
 		floors++;
 	    }
     }
@@ -1072,7 +1068,7 @@ extern void mtn_gen(void)
 	    case FEAT_GRASS:
 		{
 		    cave_set_feat(y, x, FEAT_WALL_SOLID);
-		    cave_on(cave_info[y][x], CAVE_WALL);
+		    cave_on(y, x, CAVE_WALL);
 		    break;
 		}
 	    case FEAT_SHOP_HEAD:
@@ -1083,7 +1079,7 @@ extern void mtn_gen(void)
 	    case FEAT_SHOP_HEAD + 1:
 		{
 		    cave_set_feat(y, x, FEAT_MAGMA);
-		    cave_on(cave_info[y][x], CAVE_WALL);
+		    cave_on(y, x, CAVE_WALL);
 		    break;
 		}
 	    case FEAT_SHOP_HEAD + 2:
@@ -1113,7 +1109,7 @@ extern void mtn_gen(void)
     /* No longer "icky" */
     for (y = 0; y < DUNGEON_HGT; y++) {
 	for (x = 0; x < DUNGEON_WID; x++) {
-	    cave_off(cave_info[y][x], CAVE_ICKY);
+	    cave_off(y, x, CAVE_ICKY);
 
 	    /* Paranoia - remake the dungeon walls */
 
@@ -1174,11 +1170,7 @@ extern void mtn_gen(void)
 
 
     /* Clear "temp" flags. */
-    for (y = 0; y < DUNGEON_HGT; y++) {
-	for (x = 0; x < DUNGEON_WID; x++) {
-	    cave_off(cave_info[y][x], CAVE_TEMP);
-	}
-    }
+    cave_flag_wipe(CAVE_TEMP);
 }
 
 /**
@@ -1299,7 +1291,7 @@ extern void mtntop_gen(void)
 		floors--;
 		if (floors == spot) {
 		    player_place(y1, x1);
-		    cave_on(cave_info[y1][x1], CAVE_ICKY);
+		    cave_on(y1, x1, CAVE_ICKY);
 		    continue;
 		}
 	    }
@@ -1378,7 +1370,7 @@ extern void mtntop_gen(void)
     /* No longer "icky" */
     for (y = 0; y < DUNGEON_HGT; y++) {
 	for (x = 0; x < DUNGEON_WID; x++) {
-	    cave_off(cave_info[y][x], CAVE_ICKY);
+	    cave_off(y, x, CAVE_ICKY);
 
 	    /* Paranoia - remake the dungeon walls */
 
@@ -1415,11 +1407,7 @@ extern void mtntop_gen(void)
 
 
     /* Clear "temp" flags. */
-    for (y = 0; y < DUNGEON_HGT; y++) {
-	for (x = 0; x < DUNGEON_WID; x++) {
-	    cave_off(cave_info[y][x], CAVE_TEMP);
-	}
-    }
+    cave_flag_wipe(CAVE_TEMP);
 }
 
 /**
@@ -1552,7 +1540,7 @@ extern void forest_gen(void)
 		    cave_set_feat(y, x, FEAT_TREE);
 	    } else
 		/* Hack - prepare for clearings */
-		cave_on(cave_info[y][x], CAVE_ICKY);
+		cave_on(y, x, CAVE_ICKY);
 
 	    /* Mega hack - remove paths if emerging from Nan Dungortheb */
 	    if ((last_stage == q_list[2].stage)
@@ -1585,11 +1573,7 @@ extern void forest_gen(void)
     }
 
     /* No longer "icky" */
-    for (y = 0; y < DUNGEON_HGT; y++) {
-	for (x = 0; x < DUNGEON_WID; x++) {
-	    cave_off(cave_info[y][x], CAVE_ICKY);
-	}
-    }
+    cave_flag_wipe(CAVE_ICKY);
 
 
     /* Place some formations */
@@ -1614,11 +1598,7 @@ extern void forest_gen(void)
     }
 
     /* No longer "icky" */
-    for (y = 0; y < DUNGEON_HGT; y++) {
-	for (x = 0; x < DUNGEON_WID; x++) {
-	    cave_off(cave_info[y][x], CAVE_ICKY);
-	}
-    }
+    cave_flag_wipe(CAVE_ICKY);
 
     /* Basic "amount" */
     k = (p_ptr->depth / 2);
@@ -1669,7 +1649,7 @@ extern void forest_gen(void)
     /* Clear "temp" flags. */
     for (y = 0; y < DUNGEON_HGT; y++) {
 	for (x = 0; x < DUNGEON_WID; x++) {
-	    cave_off(cave_info[y][x], CAVE_TEMP);
+	    cave_off(y, x, CAVE_TEMP);
 	    /* Paranoia - remake the dungeon walls */
 
 	    if ((y == 0) || (x == 0) || (y == DUNGEON_HGT - 1)
@@ -1822,11 +1802,7 @@ extern void swamp_gen(void)
     }
 
     /* No longer "icky" */
-    for (y = 0; y < DUNGEON_HGT; y++) {
-	for (x = 0; x < DUNGEON_WID; x++) {
-	    cave_off(cave_info[y][x], CAVE_ICKY);
-	}
-    }
+    cave_flag_wipe(CAVE_ICKY);
 
     /* Basic "amount" */
     k = (p_ptr->depth / 2);
@@ -1877,7 +1853,7 @@ extern void swamp_gen(void)
     /* Clear "temp" flags. */
     for (y = 0; y < DUNGEON_HGT; y++) {
 	for (x = 0; x < DUNGEON_WID; x++) {
-	    cave_off(cave_info[y][x], CAVE_TEMP);
+	    cave_off(y, x, CAVE_TEMP);
 	    /* Paranoia - remake the dungeon walls */
 
 	    if ((y == 0) || (x == 0) || (y == DUNGEON_HGT - 1)
@@ -2046,7 +2022,7 @@ extern void desert_gen(void)
 		    cave_set_feat(y, x, FEAT_MAGMA);
 	    } else
 		/* Hack - prepare for clearings */
-		cave_on(cave_info[y][x], CAVE_ICKY);
+		cave_on(y, x, CAVE_ICKY);
 	}
     }
 
@@ -2074,11 +2050,7 @@ extern void desert_gen(void)
     }
 
     /* No longer "icky" */
-    for (y = 0; y < DUNGEON_HGT; y++) {
-	for (x = 0; x < DUNGEON_WID; x++) {
-	    cave_off(cave_info[y][x], CAVE_ICKY);
-	}
-    }
+    cave_flag_wipe(CAVE_ICKY);
 
 
     /* Place some formations */
@@ -2095,11 +2067,7 @@ extern void desert_gen(void)
     }
 
     /* No longer "icky" */
-    for (y = 0; y < DUNGEON_HGT; y++) {
-	for (x = 0; x < DUNGEON_WID; x++) {
-	    cave_off(cave_info[y][x], CAVE_ICKY);
-	}
-    }
+    cave_flag_wipe(CAVE_ICKY);
 
     /* Basic "amount" */
     k = (p_ptr->depth / 2);
@@ -2150,7 +2118,7 @@ extern void desert_gen(void)
     /* Clear "temp" flags. */
     for (y = 0; y < DUNGEON_HGT; y++) {
 	for (x = 0; x < DUNGEON_WID; x++) {
-	    cave_off(cave_info[y][x], CAVE_TEMP);
+	    cave_off(y, x, CAVE_TEMP);
 	    /* Paranoia - remake the dungeon walls */
 
 	    if ((y == 0) || (x == 0) || (y == DUNGEON_HGT - 1)
@@ -2289,7 +2257,7 @@ extern void river_gen(void)
 	for (x = i - randint0(5) - 10; x < i + randint0(5) + 10; x++) {
 	    /* Make the river */
 	    cave_set_feat(y, x, FEAT_WATER);
-	    cave_on(cave_info[y][x], CAVE_ICKY);
+	    cave_on(y, x, CAVE_ICKY);
 	}
 	/* Meander */
 	i += randint0(3) - 1;
@@ -2357,11 +2325,7 @@ extern void river_gen(void)
     }
 
     /* No longer "icky" */
-    for (y = 0; y < DUNGEON_HGT; y++) {
-	for (x = 0; x < DUNGEON_WID; x++) {
-	    cave_off(cave_info[y][x], CAVE_ICKY);
-	}
-    }
+    cave_flag_wipe(CAVE_ICKY);
 
     /* Hack - move the player out of the river */
     y = p_ptr->py;
@@ -2429,7 +2393,7 @@ extern void river_gen(void)
     /* Clear "temp" flags. */
     for (y = 0; y < DUNGEON_HGT; y++) {
 	for (x = 0; x < DUNGEON_WID; x++) {
-	    cave_off(cave_info[y][x], CAVE_TEMP);
+	    cave_off(y, x, CAVE_TEMP);
 	    /* Paranoia - remake the dungeon walls */
 
 	    if ((y == 0) || (x == 0) || (y == DUNGEON_HGT - 1)
@@ -2485,7 +2449,7 @@ bool place_web(int type)
 		    || (cave_feat[y][x] == FEAT_PERM_SOLID)
 		    || (cave_feat[y][x] == FEAT_MORE_SOUTH) || 
 		    ((y == p_ptr->py) && (x == p_ptr->px))
-		    || cave_has(cave_info[y][x], CAVE_ICKY))
+		    || cave_has(y, x, CAVE_ICKY))
 		    no_good = TRUE;
 
 	/* Try again, or stop if we've found a place */
@@ -2670,11 +2634,7 @@ extern void valley_gen(void)
     }
 
     /* No longer "icky" */
-    for (y = 0; y < DUNGEON_HGT; y++) {
-	for (x = 0; x < DUNGEON_WID; x++) {
-	    cave_off(cave_info[y][x], CAVE_ICKY);
-	}
-    }
+    cave_flag_wipe(CAVE_ICKY);
 
     if (!p_ptr->path_coord) {
 	y = DUNGEON_HGT / 2 - 10 + randint0(20);
@@ -2684,7 +2644,7 @@ extern void valley_gen(void)
 	p_ptr->path_coord = 0;
 
 	/* Make sure a web can't be placed on the player */
-	cave_on(cave_info[y][x], CAVE_ICKY);
+	cave_on(y, x, CAVE_ICKY);
     }
 
     /* Basic "amount" */
@@ -2743,7 +2703,7 @@ extern void valley_gen(void)
     /* Clear "temp" flags. */
     for (y = 0; y < DUNGEON_HGT; y++) {
 	for (x = 0; x < DUNGEON_WID; x++) {
-	    cave_off(cave_info[y][x], CAVE_TEMP);
+	    cave_off(y, x, CAVE_TEMP);
 	    /* Paranoia - remake the dungeon walls */
 
 	    if ((y == 0) || (x == 0) || (y == DUNGEON_HGT - 1)
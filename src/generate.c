@@ -433,7 +433,13 @@ static void clear_cave(void)
 	wipe_o_list();
 	wipe_m_list();
 	wipe_trap_list();
-	/* Clear flags and flow information. */
+	flow_wipe();
+	path_cache_wipe();
+
+	/* No flags */
+	cave_info_wipe();
+
+	/* Clear flow information. */
 	for (y = 0; y < DUNGEON_HGT; y++)
 	{
 		for (x = 0; x < DUNGEON_WID; x++)
@@ -441,11 +447,7 @@ static void clear_cave(void)
 			/* No features */
 			cave_feat[y][x] = 0;
 
-			/* No flags */
-			cave_wipe(cave_info[y][x]);
-
-			/* No flow */
-			cave_cost[y][x] = 0;
+			/* No scent */
 			cave_when[y][x] = 0;
 
 			/* Clear any left-over monsters (should be none) and the player. */
@@ -507,13 +509,12 @@ void generate_cave(void)
 
 
 	/* Clear flags and flow information. */
+	flow_wipe();
+	path_cache_wipe();
+	cave_info_wipe();
 	for (y = 0; y < DUNGEON_HGT; y++) {
 	    for (x = 0; x < DUNGEON_WID; x++) {
-		/* No flags */
-		cave_wipe(cave_info[y][x]);
-
-		/* No flow */
-		cave_cost[y][x] = 0;
+		/* No scent */
 		cave_when[y][x] = 0;
 
 	    }
@@ -216,6 +216,9 @@ typedef int errr;
     typedef unsigned long u32b;
   #endif
 
+  typedef signed long long s64b;
+  typedef unsigned long long u64b;
+
 #endif /* HAVE_STDINT_H */
 
 
@@ -2923,8 +2923,20 @@ static errr finish_parse_v(struct parser *p) {
 
     v_info = mem_zalloc(sizeof(*v) * z_info->v_max);
     for (v = parser_priv(p); v; v = v->next) {
+	size_t len, size;
+
 	if (v->vidx >= z_info->v_max)
 	    continue;
+
+	/* Pad short layouts so the vault builders never read past the end */
+	size = v->hgt * v->wid;
+	len = v->text ? strlen(v->text) : 0;
+	if (len < size) {
+	    v->text = mem_realloc(v->text, size + 1);
+	    memset(v->text + len, ' ', size - len);
+	    v->text[size] = '\0';
+	}
+
 	memcpy(&v_info[v->vidx], v, sizeof(*v));
     }
 
@@ -3864,6 +3876,14 @@ static errr init_other(void)
     /* Initialize the "message" package */
     (void)messages_init();
 
+    /* Build the monster spell masks */
+    flags_init(rsf_breath_mask, RSF_SIZE, RSF_BREATH_MASK, FLAG_END);
+    flags_init(rsf_harass_mask, RSF_SIZE, RSF_HARASS_MASK, FLAG_END);
+    flags_init(rsf_bolt_mask, RSF_SIZE, RSF_BOLT_MASK, FLAG_END);
+    flags_init(rsf_archery_mask, RSF_SIZE, RSF_ARCHERY_MASK, FLAG_END);
+    flags_init(rsf_no_player_mask, RSF_SIZE, RSF_NO_PLAYER_MASK, FLAG_END);
+    flags_init(rsf_summon_mask, RSF_SIZE, RSF_SUMMON_MASK, FLAG_END);
+
     /*** Prepare grid arrays ***/
 
     /* Array of grids */
@@ -3876,8 +3896,8 @@ static errr init_other(void)
 
     /*** Prepare dungeon arrays ***/
 
-    /* Padded into array */
-    cave_info = C_ZNEW(DUNGEON_HGT, grid_256);
+    /* Flag bitplanes */
+    cave_info = C_ZNEW(CAVE_MAX, cave_plane);
 
     /* Feature array */
     cave_feat = C_ZNEW(DUNGEON_HGT, byte_wid);
@@ -3888,7 +3908,7 @@ static errr init_other(void)
 
     /* Flow arrays */
     cave_cost = C_ZNEW(DUNGEON_HGT, byte_wid);
-    cave_when = C_ZNEW(DUNGEON_HGT, byte_wid);
+    cave_when = C_ZNEW(DUNGEON_HGT, s32b_wid);
 
 
     /*** Prepare entity arrays ***/
@@ -3898,6 +3918,9 @@ static errr init_other(void)
 
     /* Monsters */
     m_list = C_ZNEW(z_info->m_max, monster_type);
+    mon_energy = C_ZNEW(z_info->m_max, byte);
+    mon_moved = C_ZNEW(z_info->m_max, bool);
+    mon_active = C_ZNEW(z_info->m_max, s16b);
 
     /* Traps */
     trap_list = C_ZNEW(z_info->l_max, trap_type);
@@ -4090,6 +4113,8 @@ static errr init_alloc(void)
 
     /* Allocate the alloc_kind_table */
     alloc_kind_table = C_ZNEW(alloc_kind_size, alloc_entry);
+    alloc_kind_pick.sum = C_ZNEW(alloc_kind_size, u32b);
+    alloc_kind_pick.guide = C_ZNEW(alloc_kind_size, u16b);
   
     /* Access the table entry */
     table = alloc_kind_table;
@@ -4175,6 +4200,8 @@ static errr init_alloc(void)
 
     /* Allocate the alloc_race_table */
     alloc_race_table = C_ZNEW(alloc_race_size, alloc_entry);
+    alloc_race_pick.sum = C_ZNEW(alloc_race_size, u32b);
+    alloc_race_pick.guide = C_ZNEW(alloc_race_size, u16b);
 
     /* Get the table entry */
     table = alloc_race_table;
@@ -4299,8 +4326,115 @@ static errr init_alloc(void)
 
 
 
+/**
+ * Header of the racial probability image file: a magic number, the
+ * version which wrote it, the table size, and a hash of the stage map and
+ * racial hometowns the table was calculated from.
+ */
+#define RACE_PROB_HEAD	12
+#define RACE_PROB_BODY	(32 * NUM_STAGES * sizeof(u16b))
+
+/**
+ * Fill in the header for the racial probability image file
+ */
+static void race_probs_head(byte *head)
+{
+    int i, k;
+    u32b hash = 2166136261UL;
+
+    /* Hash everything the table depends on (FNV-1a) */
+    for (i = 0; i < NUM_STAGES; i++)
+    {
+	hash = (hash ^ (stage_map[i][LOCALITY] == NOWHERE)) * 16777619UL;
+	for (k = 2; k < 6; k++)
+	{
+	    hash = (hash ^ (stage_map[i][k] & 0xFF)) * 16777619UL;
+	    hash = (hash ^ (stage_map[i][k] >> 8)) * 16777619UL;
+	}
+    }
+    for (i = 0; i < z_info->p_max; i++)
+    {
+	hash = (hash ^ (towns[p_info[i].hometown] & 0xFF)) * 16777619UL;
+	hash = (hash ^ (towns[p_info[i].hometown] >> 8)) * 16777619UL;
+    }
+
+    head[0] = 'R';
+    head[1] = 'P';
+    head[2] = VERSION_MAJOR;
+    head[3] = VERSION_MINOR;
+    head[4] = VERSION_PATCH;
+    head[5] = (byte) z_info->p_max;
+    head[6] = (byte) ((NUM_STAGES >> 8) & 0xFF);
+    head[7] = (byte) (NUM_STAGES & 0xFF);
+    for (i = 0; i < 4; i++)
+	head[8 + i] = (byte) ((hash >> (24 - 8 * i)) & 0xFF);
+}
+
+/**
+ * Count the paths of length 8 and of length 9 from stage "start" to every
+ * stage, moving only between adjacent stages (not up or down), and put the
+ * larger of the two counts for each stage in "paths".
+ *
+ * Each stage has at most four neighbours, so each step along the map is
+ * linear in the number of stages; there is no need for the full matrix
+ * powers of the adjacency matrix.
+ */
+static void race_probs_paths(int start, u32b *paths)
+{
+    u32b *walk = C_ZNEW(NUM_STAGES, u32b);
+    u32b *next = C_ZNEW(NUM_STAGES, u32b);
+    u32b *swap;
+    int i, k, m, n;
+
+    walk[start] = 1;
+
+    for (n = 1; n <= 9; n++)
+    {
+	C_WIPE(next, NUM_STAGES, u32b);
+
+	for (i = 0; i < NUM_STAGES; i++)
+	{
+	    if (!walk[i]) continue;
+
+	    for (k = 2; k < 6; k++)
+	    {
+		int to = stage_map[i][k];
+
+		if (!to) continue;
+
+		/* A stage adjacent in two directions is still one step */
+		for (m = 2; m < k; m++)
+		    if (stage_map[i][m] == to) break;
+		if (m < k) continue;
+
+		next[to] += walk[i];
+	    }
+	}
+
+	swap = walk;
+	walk = next;
+	next = swap;
+
+	/* Keep the length 8s */
+	if (n == 8)
+	    C_COPY(paths, walk, NUM_STAGES, u32b);
+    }
+
+    /* Now replace by the length 9s if they're larger */
+    for (i = 0; i < NUM_STAGES; i++)
+	if (paths[i] < walk[i])
+	    paths[i] = walk[i];
+
+    FREE(walk);
+    FREE(next);
+}
+
 /**
  * Initialize the racial probability array
+ *
+ * The table is kept in the "raceprob.raw" image file in the user
+ * directory.  The image is only trusted if its header matches the current
+ * game; otherwise the table is recalculated and the image rewritten.
  */
 static errr init_race_probs(void)
 {
@@ -4310,10 +4444,15 @@ static errr init_race_probs(void)
   
     /* General buffer */
     char buf[1024];
+
+    /* Image file header, expected and found */
+    byte head[RACE_PROB_HEAD], file_head[RACE_PROB_HEAD];
+    bool loaded = FALSE;
   
     /* Make the arrays */
     race_prob = C_ZNEW(32, u16b_stage);
-    dummy = C_ZNEW(32 * NUM_STAGES * sizeof(u16b), byte);
+    dummy = C_ZNEW(RACE_PROB_BODY, byte);
+    race_probs_head(head);
   
     /*** Load the binary image file ***/
   
@@ -4326,91 +4465,43 @@ static errr init_race_probs(void)
     /* Process existing "raw" file */
     if (fd)
     {
-	/* Attempt to parse the "raw" file */
-	/* Read in the array */
-	file_read(fd, (char *)dummy, 32 * NUM_STAGES * sizeof(u16b));
+	/* Only accept an image written for this game */
+	if ((file_read(fd, (char *)file_head, RACE_PROB_HEAD) ==
+	     RACE_PROB_HEAD) && !memcmp(head, file_head, RACE_PROB_HEAD) &&
+	    (file_read(fd, (char *)dummy, RACE_PROB_BODY) == (int) RACE_PROB_BODY))
+	    loaded = TRUE;
       
 	/* Close it */
 	file_close(fd);
+    }
 
+    if (loaded)
+    {
 	for (i = 0; i < NUM_STAGES; i++)
 	{
 	    for (j = 0; j < 32; j++)
 	    {
-		int k = NUM_STAGES * j + 2 * i;
+		k = 2 * (NUM_STAGES * j + i);
 		race_prob[j][i] = (u16b) ((dummy[k] << 8) | dummy[k + 1]);
 	    }
 	}
     }
   
-    /* Do the matrix calculations? */
+    /* Count the paths? */
     else
     {
-	/*** Prepare temporary adjacency arrays ***/
-	adjacency = C_ZNEW(NUM_STAGES, u16b_stage);
-	stage_path = C_ZNEW(NUM_STAGES, u16b_stage);
-	temp_path = C_ZNEW(NUM_STAGES, u16b_stage);
-      
-	/* Make the adjacency matrix */
-	for (i = 0; i < NUM_STAGES; i++)
-	{
-	    /* Initialise this row */
-	    for (k = 0; k < NUM_STAGES; k++)
-	    {
-		adjacency[i][k] = 0;
-		stage_path[i][k] = 0;
-		temp_path[i][k] = 0;
-	    }
-	  
-	    /* Add 1s where there's an adjacent stage (not up or down) */
-	    for (k = 2; k < 6; k++)
-		if (stage_map[i][k] != 0) 
-		{
-		    adjacency[i][stage_map[i][k]] = 1;
-		    temp_path[i][stage_map[i][k]] = 1;
-		}
-	}
-      
-	/* Power it up (squaring 3 times gives eighth power) */
-	for (n = 0; n < 3; n++)
-	{
-	    /* Square */
-	    for (i = 0; i < NUM_STAGES; i++)
-		for (j = 0; j < NUM_STAGES; j++)
-		{
-		    stage_path[i][j] = 0;
-		    for (k = 0; k < NUM_STAGES; k++)
-			stage_path[i][j] += temp_path[i][k] * temp_path[k][j];
-		}
-	  
-	    /* Copy it over for the next squaring or final multiply */
-	    for (i = 0; i < NUM_STAGES; i++)
-		for (j = 0; j < NUM_STAGES; j++)
-		    temp_path[i][j] = stage_path[i][j];
-	  
-	}
-      
-	/* Get the max of length 8 and length 9 paths */
-	for (i = 0; i < NUM_STAGES; i++)
-	    for (j = 0; j < NUM_STAGES; j++)
-	    {
-		/* Multiply to get the length 9s */
-		stage_path[i][j] = 0;
-		for (k = 0; k < NUM_STAGES; k++)
-		    stage_path[i][j] += temp_path[i][k] * adjacency[k][j];
-	    
-		/* Now replace by the length 8s if it's larger */
-		if (stage_path[i][j] < temp_path[i][j])
-		    stage_path[i][j] = temp_path[i][j];
-	    
-	    }
+	/* Paths from each town, counted as needed */
+	u32b *town_paths[N_ELEMENTS(towns)];
+
+	for (k = 0; k < (int) N_ELEMENTS(towns); k++)
+	    town_paths[k] = NULL;
 
-	/* We now have the maximum of the number of paths of length 8 and the 
+	/* We take the maximum of the number of paths of length 8 and the 
 	 * number of paths of length 9 (we need to try odd and even length paths,
-	 * as using just one leads to anomalies) from any stage to any other,
-	 * which we will use as a basis for the racial probability table for 
+	 * as using just one leads to anomalies) from each race's hometown to
+	 * every stage as a basis for the racial probability table for 
 	 * racially based monsters in any given stage.  For a stage, we give 
-	 * every race a 1, then add the number of paths of length 8 from their 
+	 * every race a 1, then add the number of paths from their 
 	 * hometown to that stage.  We then turn every row entry into the 
 	 * cumulative total of the row to that point.  Whenever a racially based 
 	 * monster is called for, we will take a random integer less than the 
@@ -4418,10 +4509,18 @@ static errr init_race_probs(void)
 	 * allocating the race corresponding to the position where we first 
 	 *exceed that integer.
 	 */
+	for (j = 0; j < z_info->p_max && j < 32; j++)
+	{
+	    n = p_info[j].hometown;
+	    if (town_paths[n]) continue;
+
+	    town_paths[n] = C_ZNEW(NUM_STAGES, u32b);
+	    race_probs_paths(towns[n], town_paths[n]);
+	}
 
 	for (i = 0; i < NUM_STAGES; i++)
 	{
-	    int prob = 0;
+	    u32b prob = 0;
 	  
 	    /* No more than 32 races */
 	    for (j = 0; j < 32; j++)
@@ -4440,56 +4539,23 @@ static errr init_race_probs(void)
 		    continue;
 		}
 	      
-		/* Enter the cumulative probability */
-		prob += 1 + stage_path[towns[p_info[j].hometown]][i];
-		race_prob[j][i] = prob;
+		/* Enter the cumulative probability, which must stay in range */
+		prob += 1 + town_paths[p_info[j].hometown][i];
+		if (prob > 0xFFFF) prob = 0xFFFF;
+		race_prob[j][i] = (u16b) prob;
 	    } 
 	}
       
+	/* Free the path counts */
+	for (k = 0; k < (int) N_ELEMENTS(towns); k++)
+	    FREE(town_paths[k]);
+
 	/*** Dump the binary image file ***/
-      
-	/* Build the filename */
-	path_build(buf, sizeof(buf), ANGBAND_DIR_USER, "raceprob.raw");
-      
-	/* Attempt to open the file */
-	fd = file_open(buf, MODE_READ, -1);
-      
-	/* Failure */
-	if (!fd)
-	{
-	    /* Grab permissions */
-	    safe_setuid_grab();
-	    
-	    /* Create a new file */
-	    fd = file_open(buf, MODE_WRITE, FTYPE_RAW);
-	    
-	    /* Drop permissions */
-	    safe_setuid_drop();
-	    
-	    /* Failure */
-	    if (!fd)
-	    {
-		/* Complain */
-		plog_fmt("Cannot create the '%s' file!", buf);
-		
-		/* Free the temporary arrays */
-		FREE(temp_path);
-		FREE(adjacency);
-		FREE(stage_path);
-		FREE(dummy);
-
-		/* Continue */
-		return (0);
-	    }
-	}
-      
-	/* Close it */
-	file_close(fd);
-      
+
 	/* Grab permissions */
 	safe_setuid_grab();
       
-	/* Attempt to create the raw file */
+	/* Create a new file */
 	fd = file_open(buf, MODE_WRITE, FTYPE_RAW);
       
 	/* Drop permissions */
@@ -4499,12 +4565,7 @@ static errr init_race_probs(void)
 	if (!fd)
 	{
 	    /* Complain */
-	    plog_fmt("Cannot write the '%s' file!", buf);
-	  
-	    /* Free the temporary arrays */
-	    FREE(temp_path);
-	    FREE(adjacency);
-	    FREE(stage_path);
+	    plog_fmt("Cannot create the '%s' file!", buf);
 	    FREE(dummy);
 
 	    /* Continue */
@@ -4516,25 +4577,18 @@ static errr init_race_probs(void)
 	{
 	    for (j = 0; j < 32; j++)
 	    {
-		int k = NUM_STAGES * j + 2 * i;
+		k = 2 * (NUM_STAGES * j + i);
 		dummy[k] = (byte) ((race_prob[j][i] >> 8) & 0xFF);
 		dummy[k + 1] = (byte) (race_prob[j][i] & 0xFF);
 	    }
 	}
       
-	/* Dump to the file */
-	if (fd)
-	{
-	    /* Dump it */
-	    file_write(fd, (const char *)dummy, 32 * NUM_STAGES * sizeof(u16b));
+	/* Dump it */
+	file_write(fd, (const char *)head, RACE_PROB_HEAD);
+	file_write(fd, (const char *)dummy, RACE_PROB_BODY);
 
-	    /* Close */
-	    file_close(fd);
-	}
-	/* Free the temporary arrays */
-	FREE(temp_path);
-	FREE(adjacency);
-	FREE(stage_path);
+	/* Close */
+	file_close(fd);
 	FREE(dummy);
     }
   
@@ -4776,8 +4830,12 @@ void cleanup_angband(void)
 
     /* Free the allocation tables */
     FREE(alloc_kind_table);
+    FREE(alloc_kind_pick.sum);
+    FREE(alloc_kind_pick.guide);
     FREE(alloc_ego_table);
     FREE(alloc_race_table);
+    FREE(alloc_race_pick.sum);
+    FREE(alloc_race_pick.guide);
 
     event_remove_all_handlers();
 
@@ -4814,6 +4872,9 @@ void cleanup_angband(void)
     FREE(l_list);
     FREE(trap_list);
     FREE(m_list);
+    FREE(mon_energy);
+    FREE(mon_moved);
+    FREE(mon_active);
     FREE(o_list);
 
     /* Flow arrays */
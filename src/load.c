@@ -192,7 +192,7 @@ static int rd_item(object_type *o_ptr)
 /**
  * Read a monster
  */
-static int rd_monster(monster_type *m_ptr)
+static int rd_monster(monster_type *m_ptr, byte *energy)
 {
     byte tmp8u;
     s16b tmp16u;
@@ -208,7 +208,7 @@ static int rd_monster(monster_type *m_ptr)
     rd_s16b(&m_ptr->maxhp);
     rd_s16b(&m_ptr->csleep);
     rd_byte(&m_ptr->mspeed);
-    rd_byte(&m_ptr->energy);
+    rd_byte(energy);
     rd_byte(&m_ptr->stunned);
     rd_byte(&m_ptr->confused);
     rd_byte(&m_ptr->monfear);
@@ -1156,6 +1156,9 @@ int rd_squelch(u32b version)
   
     /* Read the current number of auto-inscriptions */
     rd_u16b(&inscriptions_count);
+
+    /* Make room to intern them in one go */
+    quarks_reserve(inscriptions_count);
   
     /* Write the autoinscriptions array*/
     for (i = 0; i < inscriptions_count; i++)
@@ -1549,7 +1552,7 @@ int rd_dungeon(u32b version)
 	    for (i = count; i > 0; i--)
 	    {
 		/* Extract "info" */
-		cave_info[y][x][n] = tmp8u;
+		cave_set_info_byte(y, x, n, tmp8u);
 	  
 		/* Advance/Wrap */
 		if (++x >= DUNGEON_WID)
@@ -1649,6 +1652,9 @@ int rd_objects(u32b version)
 	note(format("Too many (%d) object entries!", limit));
 	return (-1);
     }
+
+    /* Each item may bring an inscription */
+    quarks_reserve(limit);
   
     /* Read the dungeon items */
     for (i = 1; i < limit; i++)
@@ -1736,7 +1742,8 @@ int rd_monsters(u32b version)
 	monster_type monster_type_body;
 	monster_race *r_ptr;
       
-	int r_idx;
+	int r_idx, m_idx;
+	byte energy;
       
 	/* Get local monster */
 	n_ptr = &monster_type_body;
@@ -1745,7 +1752,7 @@ int rd_monsters(u32b version)
 	(void)WIPE(n_ptr, monster_type);
       
 	/* Read the monster */
-	rd_monster(n_ptr);
+	rd_monster(n_ptr, &energy);
       
 	/* Hack -- ignore "broken" monsters */
 	if (n_ptr->r_idx <= 0) continue;
@@ -1766,11 +1773,15 @@ int rd_monsters(u32b version)
 	}
       
 	/* Place monster in dungeon */
-	if (!monster_place(n_ptr->fy, n_ptr->fx, n_ptr))
+	m_idx = monster_place(n_ptr->fy, n_ptr->fx, n_ptr);
+	if (!m_idx)
 	{
 	    note(format("Cannot place monster %d", i));
 	    return (-1);
 	}
+
+	/* Restore its energy */
+	mon_energy[m_idx] = energy;
       
 	/* mark minimum range for recalculation */
 	n_ptr->min_range = 0;
@@ -105,6 +105,8 @@ static bool loaded_terminfo;
 typedef struct term_data {
 	term t;                 /* All term info */
 	WINDOW *win;            /* Pointer to the curses window */
+	int y, x;               /* Upper left corner on the screen */
+	int cy, cx;             /* Where the window wants the cursor */
 } term_data;
 
 /* Max number of windows on screen */
@@ -158,6 +160,367 @@ static int bg_color = COLOR_BLACK;
 
 #endif
 
+/*
+ * Direct output: instead of letting curses refresh the windows, keep our
+ * own copy of the screen and, on each TERM_XTRA_FRESH, write just the
+ * changed cells to the terminal ourselves in a single write().  Curses is
+ * still used for input and to set up and restore the terminal.
+ */
+static bool use_direct = FALSE;
+static bool show_stats = FALSE;
+
+/*
+ * One cell of the screen; "a" is an Angband attr, or one of the values below
+ */
+typedef struct gcu_cell {
+	wchar_t c;
+	int a;
+} gcu_cell;
+
+#define GCU_ATTR_NORMAL  -1     /* blank, in the terminal's normal colours */
+#define GCU_ATTR_UNKNOWN -2     /* not known to be on the terminal */
+
+/* What the terms have drawn, and what the terminal is showing */
+static gcu_cell *screen_want;
+static gcu_cell *screen_have;
+static int screen_rows, screen_cols;
+
+/* The terminal has to be cleared before the next frame */
+static bool screen_clear;
+
+/*
+ * SGR (colour and video attribute) states, packed as the foreground colour
+ * plus one (so that 0 is the terminal's default) and the flags below.
+ */
+#define SGR_FG      0x0FFF
+#define SGR_BOLD    0x1000
+#define SGR_REVERSE 0x2000
+
+/* The SGR state of each Angband attr */
+static int attr_sgr[256];
+
+/* What we last told the terminal; -1 for unknown */
+static int term_sgr = -1;
+static int term_cy = -1, term_cx = -1;
+static int term_cursor = -1;
+
+/* Where the last refreshed window wants the cursor */
+static int want_cy, want_cx;
+
+/*
+ * Going from one cell to a later one on the same row, just write the cells
+ * in between if there are at most this many, rather than moving the cursor
+ */
+#define GCU_GAP 4
+
+/* The frame being built */
+static char *out_buf;
+static size_t out_len, out_size;
+
+/* Output counters, for the "-s" suboption */
+static u32b stat_frames;
+static u32b stat_bytes;
+static u32b stat_max;
+
+/*
+ * Append a byte to the frame; this is the tputs() callback
+ */
+static int gcu_putc(int c) {
+	if (out_len == out_size) {
+		out_size = out_size ? 2 * out_size : 4096;
+		out_buf = mem_realloc(out_buf, out_size);
+	}
+	out_buf[out_len++] = (char)c;
+	return c;
+}
+
+/*
+ * Append a terminfo string to the frame, if the terminal has it
+ */
+static void gcu_puts(const char *str) {
+	if (str) tputs(str, 1, gcu_putc);
+}
+
+/*
+ * Append a character to the frame, in the locale's encoding
+ */
+static void gcu_put_char(wchar_t c) {
+	char mb[MB_LEN_MAX];
+	mbstate_t mbs;
+	size_t i, n;
+
+	if (c < 0x80) {
+		gcu_putc(c ? (int)c : ' ');
+		return;
+	}
+
+	memset(&mbs, 0, sizeof(mbs));
+	n = wcrtomb(mb, c, &mbs);
+	if (n == (size_t)-1) {
+		gcu_putc('?');
+		return;
+	}
+
+	for (i = 0; i < n; i++) gcu_putc((byte)mb[i]);
+}
+
+/*
+ * Work out the SGR state of each attr from the curses colour table, so
+ * that both kinds of output show the same colours.
+ */
+static void gcu_sgr_prepare(void) {
+	int i;
+
+	for (i = 0; i < 256; i++) {
+		int sgr = 0;
+
+#ifdef A_COLOR
+		if (can_use_color) {
+			int attr = colortable[(i & 127) < BASIC_COLORS ? (i & 127) :
+								  TERM_WHITE];
+			short fg, bg;
+
+			if (pair_content(PAIR_NUMBER(attr), &fg, &bg) == ERR) fg = -1;
+
+			sgr = (fg + 1) & SGR_FG;
+			if (attr & A_BOLD) sgr |= SGR_BOLD;
+			if (i > 127) sgr |= SGR_REVERSE;
+		}
+#endif
+
+		attr_sgr[i] = sgr;
+	}
+}
+
+/*
+ * The SGR state of a cell
+ */
+static int gcu_cell_sgr(const gcu_cell *cell) {
+	return (cell->a < 0) ? 0 : attr_sgr[cell->a];
+}
+
+/*
+ * Can the terminal cell "have" be left alone (or written over) with the
+ * given character and SGR state?  Spaces only need the reverse flag to
+ * match, since the foreground colour does not show.
+ */
+static bool gcu_cell_fits(const gcu_cell *have, wchar_t c, int sgr) {
+	int have_sgr;
+
+	if (have->a == GCU_ATTR_UNKNOWN || have->c != c) return FALSE;
+
+	have_sgr = gcu_cell_sgr(have);
+	if (c == ' ') return !((have_sgr ^ sgr) & SGR_REVERSE);
+
+	return have_sgr == sgr;
+}
+
+/*
+ * Bring the terminal to the given SGR state, with as little as we can
+ */
+static void gcu_put_sgr(int sgr) {
+	if (sgr == term_sgr) return;
+
+	/* Switching anything off, or going back to the default colour */
+	if ((term_sgr < 0) || (term_sgr & ~sgr & (SGR_BOLD | SGR_REVERSE)) ||
+		((term_sgr & SGR_FG) && !(sgr & SGR_FG))) {
+		gcu_puts(exit_attribute_mode);
+#ifdef A_COLOR
+		if (can_use_color && bg_color >= 0 && set_a_background)
+			gcu_puts(tparm(set_a_background, bg_color));
+#endif
+		term_sgr = 0;
+	}
+
+	if ((sgr & SGR_BOLD) && !(term_sgr & SGR_BOLD))
+		gcu_puts(enter_bold_mode);
+	if ((sgr & SGR_REVERSE) && !(term_sgr & SGR_REVERSE))
+		gcu_puts(enter_reverse_mode);
+	if (((sgr ^ term_sgr) & SGR_FG) && set_a_foreground)
+		gcu_puts(tparm(set_a_foreground, (sgr & SGR_FG) - 1));
+
+	term_sgr = sgr;
+}
+
+/*
+ * Move the terminal's cursor; "row" is the screen row, if the cells
+ * between here and there may simply be written again
+ */
+static void gcu_put_move(int y, int x, const gcu_cell *row) {
+	if (y == term_cy && x == term_cx) return;
+
+	/* A short step forwards over cells that the current SGR state suits */
+	if (row && y == term_cy && x > term_cx && x - term_cx <= GCU_GAP) {
+		int i;
+
+		for (i = term_cx; i < x; i++)
+			if (!gcu_cell_fits(&row[i], row[i].c, term_sgr)) break;
+
+		if (i == x) {
+			for (i = term_cx; i < x; i++) gcu_put_char(row[i].c);
+			term_cx = x;
+			return;
+		}
+	}
+
+	gcu_puts(tparm(cursor_address, y, x));
+	term_cy = y;
+	term_cx = x;
+}
+
+/*
+ * Send the frame to the terminal
+ */
+static void gcu_flush(void) {
+	char *buf = out_buf;
+	size_t len = out_len;
+
+	if (!len) return;
+
+	while (len) {
+		ssize_t n = write(1, buf, len);
+
+		if (n < 0) {
+			if (errno == EINTR) continue;
+			break;
+		}
+
+		buf += n;
+		len -= n;
+	}
+
+	stat_frames++;
+	stat_bytes += out_len;
+	if (out_len > stat_max) stat_max = out_len;
+
+	out_len = 0;
+}
+
+/*
+ * Build and send the frame for a window: everything in it that differs
+ * from what the terminal shows, then the cursor.
+ */
+static void gcu_frame(term_data *td) {
+	int y, x;
+	int y2 = MIN(td->y + td->t.hgt, screen_rows);
+	int x2 = MIN(td->x + td->t.wid, screen_cols);
+
+	/* Start again from a clear screen */
+	if (screen_clear) {
+		int i;
+
+		term_sgr = -1;
+		gcu_put_sgr(0);
+		gcu_puts(clear_screen);
+		term_cy = term_cx = 0;
+
+		for (i = 0; i < screen_rows * screen_cols; i++) {
+			screen_have[i].c = ' ';
+			screen_have[i].a = GCU_ATTR_NORMAL;
+		}
+
+		screen_clear = FALSE;
+	}
+
+	for (y = td->y; y < y2; y++) {
+		gcu_cell *want = &screen_want[y * screen_cols];
+		gcu_cell *have = &screen_have[y * screen_cols];
+
+		for (x = td->x; x < x2; x++) {
+			int sgr = gcu_cell_sgr(&want[x]);
+
+			if (gcu_cell_fits(&have[x], want[x].c, sgr)) continue;
+
+			/* Writing the bottom right corner could scroll the screen */
+			if (y == screen_rows - 1 && x == screen_cols - 1) continue;
+
+			gcu_put_move(y, x, have);
+			gcu_put_sgr(sgr);
+			gcu_put_char(want[x].c);
+			have[x] = want[x];
+
+			/* At the right edge the cursor position is not reliable */
+			if (++term_cx == screen_cols) term_cy = term_cx = -1;
+		}
+	}
+
+	gcu_put_move(want_cy, want_cx, NULL);
+	gcu_flush();
+}
+
+/*
+ * Hand the terminal back to curses in a sane state: normal video, with the
+ * cursor visible and at the bottom left, since curses does not know where
+ * we left it.
+ */
+static void gcu_leave(void) {
+	gcu_put_sgr(0);
+	if (term_cursor == 0) gcu_puts(cursor_normal);
+	term_cursor = -1;
+	gcu_put_move(screen_rows - 1, 0, NULL);
+	gcu_flush();
+}
+
+/*
+ * Report how much direct output wrote, once curses has exited
+ */
+static void gcu_report(void) {
+	if (!use_direct || !show_stats || !stat_frames) return;
+
+	printf("gcu: %lu frames, %lu bytes, %lu per frame, %lu at most\n",
+		   (unsigned long)stat_frames, (unsigned long)stat_bytes,
+		   (unsigned long)(stat_bytes / stat_frames),
+		   (unsigned long)stat_max);
+	stat_frames = 0;
+}
+
+/*
+ * Draw "n" cells into our copy of the screen; a NULL "s" means blanks
+ */
+static void gcu_cells_put(term_data *td, int x, int y, int n, int a,
+						  const wchar_t *s) {
+	gcu_cell *cell;
+	int i;
+
+	y += td->y;
+	x += td->x;
+
+	if (y < 0 || y >= screen_rows || x < 0) return;
+	if (x + n > screen_cols) n = screen_cols - x;
+
+	cell = &screen_want[y * screen_cols + x];
+
+	for (i = 0; i < n; i++) {
+		cell[i].c = s ? s[i] : ' ';
+		cell[i].a = s ? a : GCU_ATTR_NORMAL;
+	}
+}
+
+/*
+ * Size our copies of the screen to the curses screen, which is to be
+ * cleared before anything more is drawn.
+ */
+static void gcu_screen_prepare(void) {
+	int i;
+
+	FREE(screen_want);
+	FREE(screen_have);
+
+	screen_rows = LINES;
+	screen_cols = COLS;
+
+	screen_want = C_ZNEW(screen_rows * screen_cols, gcu_cell);
+	screen_have = C_ZNEW(screen_rows * screen_cols, gcu_cell);
+
+	for (i = 0; i < screen_rows * screen_cols; i++) {
+		screen_want[i].c = ' ';
+		screen_want[i].a = GCU_ATTR_NORMAL;
+	}
+
+	screen_clear = TRUE;
+	term_cursor = -1;
+}
+
 /*
  * Place the "keymap" into its "normal" state
  */
@@ -248,11 +611,15 @@ static errr Term_xtra_gcu_alive(int v) {
 		/* Flush the curses buffer */
 		refresh();
 
-		/* Get current cursor position */
-		getyx(stdscr, y, x);
+		if (use_direct) {
+			gcu_leave();
+		} else {
+			/* Get current cursor position */
+			getyx(stdscr, y, x);
 
-		/* Move the cursor to bottom right corner */
-		mvcur(y, x, LINES - 1, 0);
+			/* Move the cursor to bottom right corner */
+			mvcur(y, x, LINES - 1, 0);
+		}
 
 		/* Exit curses */
 		endwin();
@@ -268,6 +635,13 @@ static errr Term_xtra_gcu_alive(int v) {
 		noecho();
 		nonl();
 
+		/* Let curses set the terminal up again, then start afresh */
+		if (use_direct) {
+			refresh();
+			screen_clear = TRUE;
+			term_cursor = -1;
+		}
+
 		/* Go to angband keymap mode */
 		keymap_game();
 	}
@@ -276,7 +650,7 @@ static errr Term_xtra_gcu_alive(int v) {
 	return 0;
 }
 
-const char help_gcu[] = "Text mode, subopts -b(ig screen) -a(scii) -B(old)";
+const char help_gcu[] = "Text mode, subopts -b(ig screen) -a(scii) -B(old) -d(irect output) -s(tats)";
 
 /*
  * Init the "curses" system
@@ -293,6 +667,13 @@ static void Term_init_gcu(term *t) {
 	/* Count init's, handle first */
 	if (active++ != 0) return;
 
+	/* Our own output starts from a clear screen */
+	if (use_direct) {
+		gcu_screen_prepare();
+		keymap_game();
+		return;
+	}
+
 	/* Erase the window */
 	wclear(td->win);
 
@@ -328,11 +709,15 @@ static void Term_nuke_gcu(term *t) {
 	start_color();
 #endif
 
-	/* Get current cursor position */
-	getyx(stdscr, y, x);
+	if (use_direct) {
+		gcu_leave();
+	} else {
+		/* Get current cursor position */
+		getyx(stdscr, y, x);
 
-	/* Move the cursor to bottom right corner */
-	mvcur(y, x, LINES - 1, 0);
+		/* Move the cursor to bottom right corner */
+		mvcur(y, x, LINES - 1, 0);
+	}
 
 	/* Flush the curses buffer */
 	refresh();
@@ -345,6 +730,13 @@ static void Term_nuke_gcu(term *t) {
 
 	/* Normal keymap */
 	keymap_norm();
+
+	gcu_report();
+
+	FREE(screen_want);
+	FREE(screen_have);
+	FREE(out_buf);
+	out_len = out_size = 0;
 }
 
 
@@ -391,6 +783,12 @@ void get_gcu_term_size(int i, int *rows, int *cols, int *y, int *x) {
 void do_gcu_resize(void) {
 	int i, rows, cols, y, x;
 	term *old_t = Term;
+
+	/* Let curses repaint its own idea of the screen now, not later */
+	if (use_direct) {
+		refresh();
+		gcu_screen_prepare();
+	}
 	
 	for (i = 0; i < MAX_TERM_DATA; i++) {
 		/* If we're using a big screen, we only care about Term-0 */
@@ -401,6 +799,8 @@ void do_gcu_resize(void) {
 
 		/* If we can resize the curses window, then resize the Term */
 		get_gcu_term_size(i, &rows, &cols, &y, &x);
+		data[i].y = y;
+		data[i].x = x;
 		if (wresize(data[i].win, rows, cols) == OK)
 			Term_resize(cols, rows);
 
@@ -629,6 +1029,8 @@ static errr Term_xtra_gcu_react(void) {
 	}
 #endif
 
+	gcu_sgr_prepare();
+
 	return 0;
 }
 
@@ -639,6 +1041,34 @@ static errr Term_xtra_gcu_react(void) {
 static errr Term_xtra_gcu(int n, int v) {
 	term_data *td = (term_data *)(Term->data);
 
+	if (use_direct) {
+		switch (n) {
+			/* Clear our copy of the window */
+			case TERM_XTRA_CLEAR: {
+				int y;
+
+				for (y = 0; y < td->t.hgt; y++)
+					gcu_cells_put(td, 0, y, td->t.wid, GCU_ATTR_NORMAL, NULL);
+				return 0;
+			}
+
+			/* Send the frame */
+			case TERM_XTRA_FRESH:
+				want_cy = td->y + td->cy;
+				want_cx = td->x + td->cx;
+				gcu_frame(td);
+				return 0;
+
+			/* Change the cursor visibility with the next frame */
+			case TERM_XTRA_SHAPE:
+				if (v != term_cursor) {
+					gcu_puts(v ? cursor_normal : cursor_invisible);
+					term_cursor = v;
+				}
+				return 0;
+		}
+	}
+
 	/* Analyze the request */
 	switch (n) {
 		/* Clear screen */
@@ -681,6 +1111,13 @@ static errr Term_xtra_gcu(int n, int v) {
  */
 static errr Term_curs_gcu(int x, int y) {
 	term_data *td = (term_data *)(Term->data);
+
+	if (use_direct) {
+		td->cy = y;
+		td->cx = x;
+		return 0;
+	}
+
 	wmove(td->win, y, x);
 	return 0;
 }
@@ -693,6 +1130,11 @@ static errr Term_curs_gcu(int x, int y) {
 static errr Term_wipe_gcu(int x, int y, int n) {
 	term_data *td = (term_data *)(Term->data);
 
+	if (use_direct) {
+		gcu_cells_put(td, x, y, n, GCU_ATTR_NORMAL, NULL);
+		return 0;
+	}
+
 	wmove(td->win, y, x);
 
 	if (x + n >= td->t.wid)
@@ -707,11 +1149,9 @@ static errr Term_wipe_gcu(int x, int y, int n) {
 
 
 /*
- * Place some text on the screen using an attribute
+ * The curses attribute to draw an Angband attr with
  */
-static errr Term_text_gcu(int x, int y, int n, byte a, const wchar_t *s) {
-	term_data *td = (term_data *)(Term->data);
-
+static int gcu_attr(byte a) {
 #ifdef A_COLOR
 	if (can_use_color) {
 		/* the lower 7 bits of the attribute indicate the fg/bg */
@@ -720,14 +1160,60 @@ static errr Term_text_gcu(int x, int y, int n, byte a, const wchar_t *s) {
 		/* the high bit of the attribute indicates a reversed fg/bg */
 		int flip = a > 127 ? A_REVERSE : A_NORMAL;
 
-		wattrset(td->win, colortable[attr] | flip);
-		mvwaddnwstr(td->win, y, x, s, n);
-		wattrset(td->win, A_NORMAL);
-		return 0;
+		return colortable[attr] | flip;
 	}
 #endif
 
+	return A_NORMAL;
+}
+
+
+/*
+ * Place some text on the screen using an attribute
+ */
+static errr Term_text_gcu(int x, int y, int n, byte a, const wchar_t *s) {
+	term_data *td = (term_data *)(Term->data);
+
+	if (use_direct) {
+		gcu_cells_put(td, x, y, n, a, s);
+		return 0;
+	}
+
+	wattrset(td->win, gcu_attr(a));
 	mvwaddnwstr(td->win, y, x, s, n);
+	wattrset(td->win, A_NORMAL);
+	return 0;
+}
+
+
+/*
+ * Draw all the changed text of a refresh, only changing the curses
+ * attribute when it differs from the last span's.
+ */
+static errr Term_text_batch_gcu(const term_span *spans, int n) {
+	term_data *td = (term_data *)(Term->data);
+	int i, attr = A_NORMAL;
+
+	for (i = 0; i < n; i++) {
+		const term_span *sp = &spans[i];
+
+		if (use_direct) {
+			gcu_cells_put(td, sp->x, sp->y, sp->n,
+						  sp->s ? sp->a : GCU_ATTR_NORMAL, sp->s);
+			continue;
+		}
+
+		if (!sp->s) {
+			if (attr != A_NORMAL) wattrset(td->win, attr = A_NORMAL);
+			Term_wipe_gcu(sp->x, sp->y, sp->n);
+			continue;
+		}
+
+		if (gcu_attr(sp->a) != attr) wattrset(td->win, attr = gcu_attr(sp->a));
+		mvwaddnwstr(td->win, sp->y, sp->x, sp->s, sp->n);
+	}
+
+	if (attr != A_NORMAL) wattrset(td->win, A_NORMAL);
 	return 0;
 }
 
@@ -742,6 +1228,8 @@ static errr term_data_init_gcu(term_data *td, int rows, int cols, int y, int x)
 
 	/* Create new window */
 	td->win = newwin(rows, cols, y, x);
+	td->y = y;
+	td->x = x;
 
 	/* Check for failure */
 	if (!td->win)
@@ -766,6 +1254,7 @@ static errr term_data_init_gcu(term_data *td, int rows, int cols, int y, int x)
 
 	/* Set some more hooks */
 	t->text_hook = Term_text_gcu;
+	t->text_batch_hook = Term_text_batch_gcu;
 	t->wipe_hook = Term_wipe_gcu;
 	t->curs_hook = Term_curs_gcu;
 	t->xtra_hook = Term_xtra_gcu;
@@ -781,7 +1270,9 @@ static errr term_data_init_gcu(term_data *td, int rows, int cols, int y, int x)
 }
 
 static void hook_quit(const char *str) {
+	if (use_direct && active) gcu_leave();
 	endwin();
+	gcu_report();
 }
 
 /*
@@ -809,6 +1300,10 @@ errr init_gcu(int argc, char **argv) {
 			bold_extended = TRUE;
 		} else if (prefix(argv[i], "-a")) {
 			ascii_walls = TRUE;
+		} else if (prefix(argv[i], "-d")) {
+			use_direct = TRUE;
+		} else if (prefix(argv[i], "-s")) {
+			show_stats = TRUE;
 		} else {
 			plog_fmt("Ignoring option: %s", argv[i]);
 		}
@@ -887,6 +1382,14 @@ errr init_gcu(int argc, char **argv) {
 	}
 #endif
 
+	/* Direct output needs to be able to place the cursor */
+	if (use_direct && !cursor_address) {
+		plog("Direct output needs cursor addressing; using curses");
+		use_direct = FALSE;
+	}
+
+	gcu_sgr_prepare();
+
 	/* Paranoia -- Assume no waiting */
 	nodelay(stdscr, FALSE);
 
@@ -22,327 +22,421 @@
 
 #include "birth.h"
 #include "buildid.h"
+#include "cave.h"
+#include "game-event.h"
+#include "generate.h"
 #include "init.h"
-#include "monster/mon-make.h"
-#include "object/pval.h"
-#include "object/tvalsval.h"
-#include "stats/db.h"
-#include "stats/structs.h"
-#include <stddef.h>
+#include "monster.h"
+#include <sqlite3.h>
+#include <stdarg.h>
 #include <time.h>
-
-#define OBJ_FEEL_MAX	 11
-#define MON_FEEL_MAX 	 10
-#define LEVEL_MAX 		101
-#define TOP_DICE		 21 /* highest catalogued values for wearables */
-#define TOP_SIDES		 11
+#ifdef SET_UID
+#include <sys/wait.h>
+#endif
+
+#define LEVEL_MAX		MAX_DEPTH
+#define FEELING_MAX		 11
+#define STATS_ORIGINS	(ORIGIN_CHEST + 1)
+#define STATS_BONUSES	(A_MAX + MAX_P_BONUS)
+#define TOP_DICE		 11 /* highest catalogued values for wearables */
+#define TOP_SIDES		 21
 #define TOP_AC			146
 #define TOP_PLUS		 56
-#define TOP_POWER		999
-#define TOP_PVAL		 25
-#define RUNS_PER_CHECKPOINT	10000
-
-/* For ref, e_max is 128, a_max is 136, r_max is ~650,
-	ORIGIN_STATS is 14, OF_MAX is ~120 */
+#define TOP_BONUS		 10
+#define RUNS_PER_BATCH		10000
+#define MAX_STATS_WORKERS	64
 
-/* There are 416 kinds, of which about 150-200 are wearable */
+/* For ref, k_max is 755, of which 157 kinds are wearable; a_max is 250,
+	e_max is 192, r_max is 800 */
 
-static int randarts = 0;
 static int no_selling = 0;
 static u32b num_runs = 1;
+static u32b batch_runs = RUNS_PER_BATCH;
+static u32b seed_base = 0;
 static bool quiet = FALSE;
 static int nextkey = 0;
 static int running_stats = 0;
+static bool init_done = FALSE;
+static int num_workers = 1;
+static int stats_worker = 0;
 static char *ANGBAND_DIR_STATS;
 
-static int *consumables_index;
+/* The dungeon stage at each depth */
+static int level_stage[LEVEL_MAX];
+
+/* Monster populations as parsed, to start each run with */
+static byte *r_max_num;
+
+/* Wearable kinds are counted in a table of their own */
 static int *wearables_index;
-static int *pval_flags_index;
+static int *wearables_kind;
 static int wearable_count = 0;
-static int consumable_count = 0;
-static int pval_flags_count = 0;
-
-struct wearables_data {
-	u32b count;
-	u32b dice[TOP_DICE][TOP_SIDES];
-	u32b ac[TOP_AC];
-	u32b hit[TOP_PLUS];
-	u32b dam[TOP_PLUS];
-/*	u32b power[TOP_POWER]; not enough memory - add it later in bands */
-	u32b *egos;
-	u32b flags[OF_MAX];
-	u32b *pval_flags[TOP_PVAL];
+
+/*
+ * The count tables.  All of a level's counts live in one block of
+ * counters, and each table is a dense array of up to three keys within it.
+ */
+enum {
+	ST_MONSTERS = 0,
+	ST_FEELINGS,
+	ST_ARTIFACTS,
+	ST_CONSUMABLES,
+	ST_WEARABLES_COUNT,
+	ST_WEARABLES_DICE,
+	ST_WEARABLES_AC,
+	ST_WEARABLES_HIT,
+	ST_WEARABLES_DAM,
+	ST_WEARABLES_EGOS,
+	ST_WEARABLES_FLAGS,
+	ST_WEARABLES_CURSES,
+	ST_WEARABLES_BONUSES,
+	ST_MAX
+};
+
+static struct stats_table {
+	const char *name;
+	const char *keys;	/* key columns, after level and count */
+	const char *columns;	/* the same, declared */
+	int num_keys;
+	bool wearable;		/* the first key is a wearables_index[] entry */
+	int bias[3];		/* key value of the first cell */
+	int size[3];		/* number of values of each key */
+	size_t offset;		/* of the table in a level's counters */
+	sqlite3_stmt *stmt;	/* adds a batch's counts to the table */
+} stats_tables[ST_MAX] = {
+	{ "monsters", "r_idx",
+		"r_idx INT", 1, FALSE, { 0 } },
+	{ "feelings", "feeling",
+		"feeling INT", 1, FALSE, { 0 } },
+	{ "artifacts", "a_idx, origin",
+		"a_idx INT, origin INT", 2, FALSE, { 0 } },
+	{ "consumables", "k_idx, origin",
+		"k_idx INT, origin INT", 2, FALSE, { 0 } },
+	{ "wearables_count", "k_idx, origin",
+		"k_idx INT, origin INT", 2, TRUE, { 0 } },
+	{ "wearables_dice", "k_idx, dd, ds",
+		"k_idx INT, dd INT, ds INT", 3, TRUE, { 0 } },
+	{ "wearables_ac", "k_idx, ac",
+		"k_idx INT, ac INT", 2, TRUE, { 0 } },
+	{ "wearables_hit", "k_idx, to_h",
+		"k_idx INT, to_h INT", 2, TRUE, { 0 } },
+	{ "wearables_dam", "k_idx, to_d",
+		"k_idx INT, to_d INT", 2, TRUE, { 0 } },
+	{ "wearables_egos", "k_idx, e_idx",
+		"k_idx INT, e_idx INT", 2, TRUE, { 0 } },
+	{ "wearables_flags", "k_idx, of_idx",
+		"k_idx INT, of_idx INT", 2, TRUE, { 0 } },
+	{ "wearables_curses", "k_idx, cf_idx",
+		"k_idx INT, cf_idx INT", 2, TRUE, { 0 } },
+	{ "wearables_bonuses", "k_idx, bonus, value",
+		"k_idx INT, bonus INT, value INT", 3, TRUE,
+		{ 0, 0, -TOP_BONUS } },
 };
 
-static struct level_data {
-	u32b *monsters;
-/*  u32b *vaults;  Add these later - requires passing into generate.c
-	u32b *pits; */
-	u32b obj_feelings[OBJ_FEEL_MAX];
-	u32b mon_feelings[MON_FEEL_MAX];
-	long long gold[ORIGIN_STATS];
-	u32b *artifacts[ORIGIN_STATS];
-	u32b *consumables[ORIGIN_STATS];
-	struct wearables_data *wearables[ORIGIN_STATS];
-} level_data[LEVEL_MAX];
-
-static void create_indices()
+/* Counters per level, and the counters themselves */
+static size_t level_cells = 0;
+static u32b *level_counts;
+
+/* Gold can outgrow a counter */
+static long long level_gold[LEVEL_MAX][STATS_ORIGINS];
+
+/* The counters bumped by a forked run, in order, to be handed back */
+static bool run_logging = FALSE;
+static u32b *run_log;
+static size_t run_log_n = 0;
+static size_t run_log_size = 0;
+
+static sqlite3 *db;
+static sqlite3_stmt *gold_stmt;
+
+/**
+ * Set the size of each count table, and so the layout of a level's counts
+ */
+static void create_indices(void)
 {
-	int i;
+	int sizes[ST_MAX][3] = {
+		{ z_info->r_max, 1, 1 },
+		{ FEELING_MAX, 1, 1 },
+		{ z_info->a_max, STATS_ORIGINS, 1 },
+		{ z_info->k_max, STATS_ORIGINS, 1 },
+		{ 0, STATS_ORIGINS, 1 },
+		{ 0, TOP_DICE, TOP_SIDES },
+		{ 0, TOP_AC, 1 },
+		{ 0, TOP_PLUS, 1 },
+		{ 0, TOP_PLUS, 1 },
+		{ 0, z_info->e_max, 1 },
+		{ 0, OF_MAX, 1 },
+		{ 0, CF_MAX, 1 },
+		{ 0, STATS_BONUSES, 2 * TOP_BONUS + 1 },
+	};
+	int i, j;
 
-	consumables_index = C_ZNEW(z_info->k_max, int);
 	wearables_index = C_ZNEW(z_info->k_max, int);
-	pval_flags_index = C_ZNEW(OF_MAX, int);
+	wearables_kind = C_ZNEW(z_info->k_max + 1, int);
 
 	for (i = 0; i < z_info->k_max; i++) {
-
 		object_type object_type_body;
 		object_type *o_ptr = &object_type_body;
-		object_kind *kind = &k_info[i];
-		o_ptr->tval = kind->tval;
+		object_kind *k_ptr = &k_info[i];
 
-		if (! kind->name) continue;
+		if (!k_ptr->name) continue;
 
-		if (wearable_p(o_ptr))
+		o_ptr->tval = k_ptr->tval;
+		if (wearable_p(o_ptr)) {
 			wearables_index[i] = ++wearable_count;
-		else
-			consumables_index[i] = ++consumable_count;
+			wearables_kind[wearable_count] = i;
+		}
 	}
 
-	for (i = 0; i < OF_MAX; i++)
-		if (flag_uses_pval(i))
-			pval_flags_index[i] = ++pval_flags_count;
+	for (i = 0; i < ST_MAX; i++) {
+		struct stats_table *t = &stats_tables[i];
+
+		for (j = 0; j < 3; j++)
+			t->size[j] = sizes[i][j];
+		if (t->wearable)
+			t->size[0] = wearable_count + 1;
+
+		t->offset = level_cells;
+		level_cells += t->size[0] * t->size[1] * t->size[2];
+	}
 }
 
-static void alloc_memory()
+static void alloc_memory(void)
 {
-	int i, j, k, l;
-
-	for (i = 0; i < LEVEL_MAX; i++) {
-		level_data[i].monsters = C_ZNEW(z_info->r_max, u32b);
-/*		level_data[i].vaults = C_ZNEW(z_info->v_max, u32b);
-		level_data[i].pits = C_ZNEW(z_info->pit_max, u32b); */
-
-		for (j = 0; j < ORIGIN_STATS; j++) {
-			level_data[i].artifacts[j] = C_ZNEW(z_info->a_max, u32b);
-			level_data[i].consumables[j] = C_ZNEW(consumable_count + 1, u32b);
-			level_data[i].wearables[j]
-				= C_ZNEW(wearable_count + 1, struct wearables_data);
-
-			for (k = 0; k < wearable_count + 1; k++) {
-				level_data[i].wearables[j][k].egos
-					= C_ZNEW(z_info->e_max, u32b);
-				for (l = 0; l < TOP_PVAL; l++)
-					level_data[i].wearables[j][k].pval_flags[l]
-						= C_ZNEW(pval_flags_count + 1, u32b);
-			}
-		}
-	}
+	level_counts = C_ZNEW(LEVEL_MAX * level_cells, u32b);
 }
 
 static void free_stats_memory(void)
 {
-	int i, j, k, l;
-	for (i = 0; i < LEVEL_MAX; i++) {
-		mem_free(level_data[i].monsters);
-/*		mem_free(level_data[i].vaults);
- 		mem_free(level_data[i].pits); */
-		for (j = 0; j < ORIGIN_STATS; j++) {
-			mem_free(level_data[i].artifacts[j]);
-			mem_free(level_data[i].consumables[j]);
-			for (k = 0; k < wearable_count + 1; k++) {
-				for (l = 0; l < TOP_PVAL; l++) {
-					mem_free(level_data[i].wearables[j][k].pval_flags[l]);
-				}
-				mem_free(level_data[i].wearables[j][k].egos);
-			}
-			mem_free(level_data[i].wearables[j]);
-		}
-	}
-	mem_free(consumables_index);
+	mem_free(level_counts);
+	mem_free(run_log);
 	mem_free(wearables_index);
-	mem_free(pval_flags_index);
+	mem_free(wearables_kind);
+	mem_free(r_max_num);
 	string_free(ANGBAND_DIR_STATS);
 }
 
-/* Copied from birth.c:generate_player() */
-static void generate_player_for_stats()
+/**
+ * Count one of something on "level"; unused keys are 0
+ */
+static void stats_count(int table, int level, int k0, int k1, int k2)
+{
+	struct stats_table *t = &stats_tables[table];
+	size_t cell = (k0 * t->size[1] + k1) * t->size[2] + k2;
+
+	cell += level * level_cells + t->offset;
+
+	if (!run_logging) {
+		level_counts[cell]++;
+		return;
+	}
+
+	if (run_log_n == run_log_size) {
+		run_log_size = run_log_size ? 2 * run_log_size : 65536;
+		run_log = mem_realloc(run_log, run_log_size * sizeof(u32b));
+	}
+	run_log[run_log_n++] = (u32b) cell;
+}
+
+/**
+ * The dungeon-only map is a single descent, so each depth has one stage
+ */
+static void prep_stage_map(void)
+{
+	int i, j;
+
+	OPT(adult_dungeon) = TRUE;
+	for (i = 0; i < NUM_STAGES; i++)
+		for (j = 0; j < 9; j++)
+			stage_map[i][j] = dungeon_map[i][j];
+
+	for (i = 0; i < NUM_STAGES; i++) {
+		int depth = stage_map[i][DEPTH];
+
+		if (stage_map[i][STAGE_TYPE] == TOWN) continue;
+		if ((depth > 0) && (depth < LEVEL_MAX) && !level_stage[depth])
+			level_stage[depth] = i;
+	}
+
+	/* Remember how many of each monster there may be */
+	r_max_num = C_ZNEW(z_info->r_max, byte);
+	for (i = 0; i < z_info->r_max; i++)
+		r_max_num[i] = r_info[i].max_num;
+}
+
+/* Copied from birth.c:player_birth() */
+static void generate_player_for_stats(void)
 {
-	OPT(birth_randarts) = randarts;
-	OPT(birth_no_selling) = no_selling;
-	OPT(birth_no_stacking) = FALSE;
+	OPT(adult_no_sell) = no_selling;
+	OPT(birth_no_sell) = no_selling;
 	OPT(auto_more) = TRUE;
 
 	p_ptr->wizard = 1; /* Set wizard mode on */
 
 	p_ptr->psex = 0;   /* Female  */
-	p_ptr->race = races;  /* Human   */
-	p_ptr->class = classes; /* Warrior */
+	p_ptr->prace = 0;  /* Human   */
+	p_ptr->pclass = 0; /* Warrior */
 
-	/* Level 1 */
-	p_ptr->max_lev = p_ptr->lev = 1;
-
-	/* Experience factor */
-	p_ptr->expfact = p_ptr->race->r_exp + p_ptr->class->c_exp;
-
-	/* Hitdice */
-	p_ptr->hitdie = p_ptr->race->r_mhp + p_ptr->class->c_mhp;
+	player_generate(p_ptr, NULL, NULL, NULL);
 
 	/* Initial hitpoints -- high just to be safe */
 	p_ptr->mhp = p_ptr->chp = 2000;
 
-	/* Pre-calculate level 1 hitdice */
-	p_ptr->player_hp[0] = p_ptr->hitdie;
-
-	/* Set age/height/weight */
-	p_ptr->ht = p_ptr->ht_birth = 66;
-	p_ptr->wt = p_ptr->wt_birth = 150;
-	p_ptr->age = 14;
-
-	/* Set social class and (null) history */
-	p_ptr->history = get_history(p_ptr->race->history, &p_ptr->sc);
-	p_ptr->sc_birth = p_ptr->sc;
+	/* Dungeon quests */
+	q_list[0].stage = 31;
+	q_list[1].stage = 56;
+	q_list[2].stage = 71;
+	q_list[3].stage = 86;
+	q_list[4].stage = 101;
 }
 
-static void initialize_character(void)
+/**
+ * Start run "run" from its own seed.  Where runs are forked (see
+ * stats_fork_run()) each also starts from the state left by initialisation,
+ * so the results do not depend on how the runs are shared between workers;
+ * otherwise things such as lore and the objects already made carry over
+ * from the run before.
+ */
+static void initialize_character(u32b run)
 {
-	u32b seed;
+	int i;
 
-	if (!quiet) {
+	if (!quiet && !stats_worker) {
 		printf(" [I  ]\b\b\b\b\b\b");
 		fflush(stdout);
 	}
 
-	seed = (time(NULL));
+	/* Each run gets its own stream, whatever ran before it */
 	Rand_quick = FALSE;
-	Rand_state_init(seed);
+	state_i = 0;
+	Rand_state_init(seed_base + run);
 
 	player_init(p_ptr);
 	generate_player_for_stats();
 
 	seed_flavor = randint0(0x10000000);
-	seed_town = randint0(0x10000000);
-	seed_randart = randint0(0x10000000);
+	flavor_init();
 
-	if (randarts)
-	{
-		do_randart(seed_randart, TRUE);
-	}
+	/* Every character has new random artifacts */
+	initialize_random_artifacts();
+	init_artifacts();
+
+	/* Unkill uniques */
+	for (i = 0; i < z_info->r_max; i++)
+		r_info[i].max_num = r_max_num[i];
 
-	store_reset();
-	flavor_init();
 	p_ptr->playing = TRUE;
-	p_ptr->autosave = FALSE;
-	cave_generate(cave, p_ptr);
+	character_dungeon = FALSE;
 }
 
 static void kill_all_monsters(int level)
 {
 	int i;
 
-	for (i = cave_monster_max(cave) - 1; i >= 1; i--) {
-		monster_type *m_ptr = cave_monster(cave, i);
+	for (i = m_max - 1; i >= 1; i--) {
+		monster_type *m_ptr = &m_list[i];
 		monster_race *r_ptr = &r_info[m_ptr->r_idx];
 
-		level_data[level].monsters[m_ptr->r_idx]++;
+		if (!m_ptr->r_idx) continue;
+
+		stats_count(ST_MONSTERS, level, m_ptr->r_idx, 0, 0);
 
-		monster_death(m_ptr, TRUE);
+		monster_death(i);
 
 		if (rf_has(r_ptr->flags, RF_UNIQUE))
 			r_ptr->max_num = 0;
 	}
 }
 
-static void unkill_uniques(void)
+/**
+ * This game only marks special origins, so tell the floor from the drops
+ * ourselves: objects lying or carried before the monsters die, and then
+ * anything else new.
+ */
+static void mark_origins(bool killed)
 {
 	int i;
 
-	if (!quiet) {
-		printf(" [U  ]\b\b\b\b\b\b");
-		fflush(stdout);
-	}
+	for (i = 1; i < o_max; i++) {
+		object_type *o_ptr = &o_list[i];
 
-	for (i = 0; i < z_info->r_max; i++) {
-		monster_race *r_ptr = &r_info[i];
+		if (!o_ptr->k_idx || o_ptr->origin) continue;
 
-		if (rf_has(r_ptr->flags, RF_UNIQUE))
-			r_ptr->max_num = 1;
+		if (killed || o_ptr->held_m_idx)
+			o_ptr->origin = ORIGIN_DROP;
+		else
+			o_ptr->origin = ORIGIN_FLOOR;
 	}
 }
 
-static void reset_artifacts(void)
+static void log_all_objects(int level)
 {
-	int i;
+	int i, j;
 
-	if (!quiet) {
-		printf(" [R  ]\b\b\b\b\b\b");
-		fflush(stdout);
-	}
+	for (i = 1; i < o_max; i++) {
+		object_type *o_ptr = &o_list[i];
+		int origin = o_ptr->origin;
 
-	for (i = 0; i < z_info->a_max; i++)
-		a_info[i].created = FALSE;
+		if (!o_ptr->k_idx || o_ptr->held_m_idx) continue;
 
-}
+		/* Capture gold amounts */
+		if (o_ptr->tval == TV_GOLD) {
+			level_gold[level][origin] += o_ptr->pval;
+			continue;
+		}
 
-static void log_all_objects(int level)
-{
-	int x, y, i;
-
-	for (y = 1; y < DUNGEON_HGT - 1; y++) {
-		for (x = 1; x < DUNGEON_WID - 1; x++) {
-			object_type *o_ptr = get_first_object(y, x);
-
-			if (o_ptr) do {
-			/*	u32b o_power = 0; */
-
-				/* Mark object as fully known */
-				object_notice_everything(o_ptr);
-
-/*				o_power = object_power(o_ptr, FALSE, NULL, TRUE); */
-
-				/* Capture gold amounts */
-				if (o_ptr->tval == TV_GOLD)
-					level_data[level].gold[o_ptr->origin] += o_ptr->pval[DEFAULT_PVAL];
-
-				/* Capture artifact drops */
-				if (o_ptr->artifact)
-					level_data[level].artifacts[o_ptr->origin][o_ptr->artifact->aidx]++;
-
-				/* Capture kind details */
-				if (wearable_p(o_ptr)) {
-					struct wearables_data *w
-						= &level_data[level].wearables[o_ptr->origin][wearables_index[o_ptr->kind->kidx]];
-
-					w->count++;
-					w->dice[MIN(o_ptr->dd, TOP_DICE - 1)][MIN(o_ptr->ds, TOP_SIDES - 1)]++;
-					w->ac[MIN(MAX(o_ptr->ac + o_ptr->to_a, 0), TOP_AC - 1)]++;
-					w->hit[MIN(MAX(o_ptr->to_h, 0), TOP_PLUS - 1)]++;
-					w->dam[MIN(MAX(o_ptr->to_d, 0), TOP_PLUS - 1)]++;
-
-					/* Capture egos */
-					if (o_ptr->ego)
-						w->egos[o_ptr->ego->eidx]++;
-					/* Capture object flags */
-					for (i = of_next(o_ptr->flags, FLAG_START); i != FLAG_END;
-							i = of_next(o_ptr->flags, i + 1)) {
-						w->flags[i]++;
-						if (flag_uses_pval(i)) {
-							int p = o_ptr->pval[which_pval(o_ptr, i)];
-							w->pval_flags[MIN(MAX(p, 0), TOP_PVAL - 1)][pval_flags_index[i]]++;
-						}
-					}
-				} else
-					level_data[level].consumables[o_ptr->origin][consumables_index[o_ptr->kind->kidx]]++;
-			}
-			while ((o_ptr = get_next_object(o_ptr)));
+		/* Capture artifact drops, and keep them found through the wipe */
+		if (o_ptr->name1) {
+			stats_count(ST_ARTIFACTS, level, o_ptr->name1, origin, 0);
+			o_ptr->ident |= IDENT_KNOWN;
 		}
+
+		/* Capture kind details */
+		if (wearable_p(o_ptr)) {
+			int w = wearables_index[o_ptr->k_idx];
+
+			stats_count(ST_WEARABLES_COUNT, level, w, origin, 0);
+			stats_count(ST_WEARABLES_DICE, level, w,
+				MIN(o_ptr->dd, TOP_DICE - 1),
+				MIN(o_ptr->ds, TOP_SIDES - 1));
+			stats_count(ST_WEARABLES_AC, level, w,
+				MIN(MAX(o_ptr->ac + o_ptr->to_a, 0), TOP_AC - 1), 0);
+			stats_count(ST_WEARABLES_HIT, level, w,
+				MIN(MAX(o_ptr->to_h, 0), TOP_PLUS - 1), 0);
+			stats_count(ST_WEARABLES_DAM, level, w,
+				MIN(MAX(o_ptr->to_d, 0), TOP_PLUS - 1), 0);
+
+			/* Capture egos */
+			if (o_ptr->name2)
+				stats_count(ST_WEARABLES_EGOS, level, w, o_ptr->name2, 0);
+
+			/* Capture object flags and curses */
+			for (j = of_next(o_ptr->flags_obj, FLAG_START); j != FLAG_END;
+					j = of_next(o_ptr->flags_obj, j + 1))
+				stats_count(ST_WEARABLES_FLAGS, level, w, j, 0);
+			for (j = cf_next(o_ptr->flags_curse, FLAG_START);
+					j != FLAG_END;
+					j = cf_next(o_ptr->flags_curse, j + 1))
+				stats_count(ST_WEARABLES_CURSES, level, w, j, 0);
+
+			/* Capture stat and other bonuses */
+			for (j = 0; j < STATS_BONUSES; j++) {
+				int b = (j < A_MAX) ? o_ptr->bonus_stat[j] :
+					o_ptr->bonus_other[j - A_MAX];
+
+				if (!b) continue;
+				b = MIN(MAX(b, -TOP_BONUS), TOP_BONUS);
+				stats_count(ST_WEARABLES_BONUSES, level, w, j,
+					b + TOP_BONUS);
+			}
+		} else
+			stats_count(ST_CONSUMABLES, level, o_ptr->k_idx, origin, 0);
 	}
 }
 
 static void descend_dungeon(void)
 {
 	int level;
-	u16b obj_f, mon_f;
 
 	clock_t last = 0;
 
@@ -350,7 +444,9 @@ static void descend_dungeon(void)
 
 	for (level = 1; level < LEVEL_MAX; level++)
 	{
-		if (!quiet) {
+		if (!level_stage[level]) continue;
+
+		if (!quiet && !stats_worker) {
 			clock_t now = clock();
 			if (now - last > wait) {
 				printf(" [%3d]\b\b\b\b\b\b", level);
@@ -359,16 +455,17 @@ static void descend_dungeon(void)
 			}
 		}
 
-		dungeon_change_level(level);
-		cave_generate(cave, p_ptr);
+		p_ptr->stage = level_stage[level];
+		p_ptr->depth = level;
+		generate_cave();
 
 		/* Store level feelings */
-		obj_f = cave->feeling / 10;
-		mon_f = cave->feeling - (10 * obj_f);
-		level_data[level].obj_feelings[MIN(obj_f, OBJ_FEEL_MAX - 1)]++;
-		level_data[level].mon_feelings[MIN(mon_f, MON_FEEL_MAX - 1)]++;
+		stats_count(ST_FEELINGS, level, MIN(feeling, FEELING_MAX - 1),
+			0, 0);
 
+		mark_origins(FALSE);
 		kill_all_monsters(level);
+		mark_origins(TRUE);
 		log_all_objects(level);
 	}
 }
@@ -390,48 +487,162 @@ static void prep_output_dir(void)
 	}
 }
 
+/**
+ * Open a new database in the stats directory, replacing any old one
+ */
+static bool stats_db_open(void)
+{
+	char buf[1024];
+
+	path_build(buf, sizeof(buf), ANGBAND_DIR_STATS, "stats.db");
+	if (file_exists(buf) && !file_delete(buf))
+		return FALSE;
+
+	return sqlite3_open(buf, &db) == SQLITE_OK;
+}
+
+static void stats_db_close(void)
+{
+	int i;
+
+	for (i = 0; i < ST_MAX; i++)
+	{
+		sqlite3_finalize(stats_tables[i].stmt);
+		stats_tables[i].stmt = NULL;
+	}
+	sqlite3_finalize(gold_stmt);
+	gold_stmt = NULL;
+
+	sqlite3_close(db);
+	db = NULL;
+}
+
+static int stats_db_exec(const char *sql_str)
+{
+	return sqlite3_exec(db, sql_str, NULL, NULL, NULL);
+}
+
+static int stats_db_stmt_prep(sqlite3_stmt **sql_stmt, const char *sql_str)
+{
+	return sqlite3_prepare_v2(db, sql_str, -1, sql_stmt, NULL);
+}
+
+/**
+ * Bind "n" integers to the parameters of "sql_stmt" after the first
+ * "offset" of them
+ */
+static int stats_db_bind_ints(sqlite3_stmt *sql_stmt, int n, int offset, ...)
+{
+	int err = SQLITE_OK, i;
+	va_list vp;
+
+	va_start(vp, offset);
+	for (i = 0; i < n && !err; i++)
+		err = sqlite3_bind_int(sql_stmt, offset + i + 1, va_arg(vp, int));
+	va_end(vp);
+
+	return err;
+}
+
+/**
+ * Bind a random value, as text of the form A+BdC+Md, to parameter "col"
+ */
+static int stats_db_bind_rv(sqlite3_stmt *sql_stmt, int col, random_value rv)
+{
+	char buf[80];
+
+	if (rv.dice && rv.sides && rv.m_bonus)
+		strnfmt(buf, sizeof(buf), "%d+%dd%dM%d", rv.base, rv.dice,
+			rv.sides, rv.m_bonus);
+	else if (rv.dice && rv.sides)
+		strnfmt(buf, sizeof(buf), "%d+%dd%d", rv.base, rv.dice, rv.sides);
+	else if (rv.m_bonus)
+		strnfmt(buf, sizeof(buf), "%d+M%d", rv.base, rv.m_bonus);
+	else
+		strnfmt(buf, sizeof(buf), "%d", rv.base);
+
+	return sqlite3_bind_text(sql_stmt, col, buf, strlen(buf),
+		SQLITE_TRANSIENT);
+}
+
+/* Step a statement and make it ready for new parameters */
+#define STATS_DB_STEP_RESET(s) \
+	err = sqlite3_step(s); \
+	if (err && err != SQLITE_DONE) return err; \
+	sqlite3_reset(s);
+
+#define STATS_DB_FINALIZE(s) \
+	err = sqlite3_finalize(s); \
+	if (err) return err;
+
 /**
  * Caller is responsible for prepping and finalizing flags_stmt, which
- * should have two parameters. 
+ * should have two parameters.
  */
-static int stats_dump_oflags(sqlite3_stmt *flags_stmt, int idx, 
-	bitflag flags[OF_SIZE]) 
+static int stats_dump_flags(sqlite3_stmt *flags_stmt, int idx,
+	const bitflag *flags, size_t size)
 {
 	int err, flag;
 
 	err = sqlite3_bind_int(flags_stmt, 1, idx);
 	if (err) return err;
-	for (flag = of_next(flags, FLAG_START); flag != FLAG_END;
-		flag = of_next(flags, flag + 1))
+	for (flag = flag_next(flags, size, FLAG_START); flag != FLAG_END;
+		flag = flag_next(flags, size, flag + 1))
 	{
 		err = sqlite3_bind_int(flags_stmt, 2, flag);
 		if (err) return err;
 		STATS_DB_STEP_RESET(flags_stmt)
 	}
 
+	return SQLITE_OK;
+}
+
+/**
+ * Caller is responsible for prepping and finalizing bonus_stmt, which
+ * should have three parameters.
+ */
+static int stats_dump_bonuses(sqlite3_stmt *bonus_stmt, int idx,
+	const int *bonus_stat, const int *bonus_other)
+{
+	int err, i;
+
+	for (i = 0; i < STATS_BONUSES; i++)
+	{
+		int b = (i < A_MAX) ? bonus_stat[i] : bonus_other[i - A_MAX];
+
+		if (!b) continue;
+
+		err = stats_db_bind_ints(bonus_stmt, 3, 0, idx, i, b);
+		if (err) return err;
+		STATS_DB_STEP_RESET(bonus_stmt)
+	}
 
 	return SQLITE_OK;
 }
 
 static int stats_dump_artifacts(void)
 {
-	int err, idx, i, flag;
-	char sql_buf[256];
-	sqlite3_stmt *info_stmt, *flags_stmt, *pval_flags_stmt;
+	int err, idx;
+	sqlite3_stmt *info_stmt, *flags_stmt, *curses_stmt, *bonus_stmt;
+
+	err = stats_db_stmt_prep(&info_stmt,
+		"INSERT INTO artifact_info VALUES (?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?);");
+	if (err) return err;
 
-	strnfmt(sql_buf, 256, "INSERT INTO artifact_info VALUES (?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?);");
-	err = stats_db_stmt_prep(&info_stmt, sql_buf);
+	err = stats_db_stmt_prep(&flags_stmt,
+		"INSERT INTO artifact_flags_map VALUES (?,?);");
 	if (err) return err;
 
-	strnfmt(sql_buf, 256, "INSERT INTO artifact_flags_map VALUES (?,?);");
-	err = stats_db_stmt_prep(&flags_stmt, sql_buf);
+	err = stats_db_stmt_prep(&curses_stmt,
+		"INSERT INTO artifact_curses_map VALUES (?,?);");
 	if (err) return err;
 
-	strnfmt(sql_buf, 256, "INSERT INTO artifact_pval_flags_map VALUES (?,?,?);");
-	err = stats_db_stmt_prep(&pval_flags_stmt, sql_buf);
+	err = stats_db_stmt_prep(&bonus_stmt,
+		"INSERT INTO artifact_bonuses_map VALUES (?,?,?);");
 	if (err) return err;
 
-	for (idx = 0; idx < z_info->a_max; idx++)
+	/* The random artifacts are remade for every character */
+	for (idx = 0; idx < ART_MIN_RANDOM; idx++)
 	{
 		artifact_type *a_ptr = &a_info[idx];
 
@@ -439,61 +650,62 @@ static int stats_dump_artifacts(void)
 
 		err = sqlite3_bind_int(info_stmt, 1, idx);
 		if (err) return err;
-		err = sqlite3_bind_text(info_stmt, 2, a_ptr->name, 
+		err = sqlite3_bind_text(info_stmt, 2, a_ptr->name,
 			strlen(a_ptr->name), SQLITE_STATIC);
 		if (err) return err;
-		err = stats_db_bind_ints(info_stmt, 14, 2, 
-			a_ptr->tval, a_ptr->sval, a_ptr->weight,
-			a_ptr->cost, a_ptr->alloc_prob, a_ptr->alloc_min,
-			a_ptr->alloc_max, a_ptr->ac, a_ptr->dd,
-			a_ptr->ds, a_ptr->to_h, a_ptr->to_d,
-			a_ptr->to_a, a_ptr->effect);
+		err = stats_db_bind_ints(info_stmt, 14, 2,
+			a_ptr->tval, a_ptr->sval, a_ptr->level, a_ptr->rarity,
+			a_ptr->weight, a_ptr->cost, a_ptr->ac, a_ptr->dd,
+			a_ptr->ds, a_ptr->to_h, a_ptr->to_d, a_ptr->to_a,
+			a_ptr->effect, a_ptr->set_no);
+		if (err) return err;
 		STATS_DB_STEP_RESET(info_stmt)
 
-		err = stats_dump_oflags(flags_stmt, idx, a_ptr->flags);
+		err = stats_dump_flags(flags_stmt, idx, a_ptr->flags_obj,
+			OF_SIZE);
 		if (err) return err;
 
-		for (i = 0; i < a_ptr->num_pvals; i++)
-		{
-			for (flag = of_next(a_ptr->pval_flags[i], FLAG_START);
-				flag != FLAG_END;
-				flag = of_next(a_ptr->pval_flags[i], flag + 1))
-			{
-				err = stats_db_bind_ints(pval_flags_stmt, 3, 0, 
-					idx, flag, a_ptr->pval[i]);
-				if (err) return err;
-				STATS_DB_STEP_RESET(pval_flags_stmt)
-			}
-		}
+		err = stats_dump_flags(curses_stmt, idx, a_ptr->flags_curse,
+			CF_SIZE);
+		if (err) return err;
+
+		err = stats_dump_bonuses(bonus_stmt, idx, a_ptr->bonus_stat,
+			a_ptr->bonus_other);
+		if (err) return err;
 	}
 
 	STATS_DB_FINALIZE(info_stmt)
 	STATS_DB_FINALIZE(flags_stmt)
-	STATS_DB_FINALIZE(pval_flags_stmt)
+	STATS_DB_FINALIZE(curses_stmt)
+	STATS_DB_FINALIZE(bonus_stmt)
 
 	return SQLITE_OK;
 }
 
 static int stats_dump_egos(void)
 {
-	int err, idx, flag, i;
-	char sql_buf[256];
-	sqlite3_stmt *info_stmt, *flags_stmt, *pval_flags_stmt, *type_stmt;
+	int err, idx, i;
+	sqlite3_stmt *info_stmt, *flags_stmt, *curses_stmt, *bonus_stmt;
+	sqlite3_stmt *type_stmt;
+
+	err = stats_db_stmt_prep(&info_stmt,
+		"INSERT INTO ego_info VALUES (?,?,?,?,?,?,?,?,?,?);");
+	if (err) return err;
 
-	strnfmt(sql_buf, 256, "INSERT INTO ego_info VALUES (?,?,?,?,?,?,?,?,?,?,?,?,?,?);");
-	err = stats_db_stmt_prep(&info_stmt, sql_buf);
+	err = stats_db_stmt_prep(&flags_stmt,
+		"INSERT INTO ego_flags_map VALUES (?,?);");
 	if (err) return err;
 
-	strnfmt(sql_buf, 256, "INSERT INTO ego_flags_map VALUES (?,?);");
-	err = stats_db_stmt_prep(&flags_stmt, sql_buf);
+	err = stats_db_stmt_prep(&curses_stmt,
+		"INSERT INTO ego_curses_map VALUES (?,?);");
 	if (err) return err;
 
-	strnfmt(sql_buf, 256, "INSERT INTO ego_pval_flags_map VALUES (?,?,?,?);");
-	err = stats_db_stmt_prep(&pval_flags_stmt, sql_buf);
+	err = stats_db_stmt_prep(&bonus_stmt,
+		"INSERT INTO ego_bonuses_map VALUES (?,?,?);");
 	if (err) return err;
 
-	strnfmt(sql_buf, 256, "INSERT INTO ego_type_map VALUES (?,?,?,?);");
-	err = stats_db_stmt_prep(&type_stmt, sql_buf);
+	err = stats_db_stmt_prep(&type_stmt,
+		"INSERT INTO ego_type_map VALUES (?,?,?,?);");
 	if (err) return err;
 
 	for (idx = 0; idx < z_info->e_max; idx++)
@@ -504,55 +716,44 @@ static int stats_dump_egos(void)
 
 		err = sqlite3_bind_int(info_stmt, 1, idx);
 		if (err) return err;
-		err = sqlite3_bind_text(info_stmt, 2, e_ptr->name, 
+		err = sqlite3_bind_text(info_stmt, 2, e_ptr->name,
 			strlen(e_ptr->name), SQLITE_STATIC);
 		if (err) return err;
-		err = stats_db_bind_rv(info_stmt, 3, e_ptr->to_h); 
-		if (err) return err;
-		err = stats_db_bind_rv(info_stmt, 4, e_ptr->to_d); 
-		if (err) return err;
-		err = stats_db_bind_rv(info_stmt, 5, e_ptr->to_a); 
-		if (err) return err;
-		err = stats_db_bind_ints(info_stmt, 9, 5, 
+		err = stats_db_bind_ints(info_stmt, 8, 2,
 			e_ptr->cost, e_ptr->level, e_ptr->rarity,
-			e_ptr->rating, e_ptr->num_pvals, e_ptr->min_to_h, 
-			e_ptr->min_to_d, e_ptr->min_to_a, e_ptr->xtra);
+			e_ptr->rating, e_ptr->max_to_h, e_ptr->max_to_d,
+			e_ptr->max_to_a, e_ptr->effect);
 		if (err) return err;
 		STATS_DB_STEP_RESET(info_stmt)
 
-		err = stats_dump_oflags(flags_stmt, idx, e_ptr->flags);
+		err = stats_dump_flags(flags_stmt, idx, e_ptr->flags_obj,
+			OF_SIZE);
 		if (err) return err;
 
-		for (i = 0; i < e_ptr->num_pvals; i++)
-		{
-			for (flag = of_next(e_ptr->pval_flags[i], FLAG_START);
-				flag != FLAG_END;
-				flag = of_next(e_ptr->pval_flags[i], flag + 1))
-			{
-				err = stats_db_bind_ints(pval_flags_stmt, 3, 0, 
-					idx, flag, e_ptr->min_pval[i]);
-				if (err) return err;
-				err = stats_db_bind_rv(pval_flags_stmt, 4,
-					e_ptr->pval[i]);
-				if (err) return err;
-				STATS_DB_STEP_RESET(pval_flags_stmt)
-			}
-		}
+		err = stats_dump_flags(curses_stmt, idx, e_ptr->flags_curse,
+			CF_SIZE);
+		if (err) return err;
+
+		err = stats_dump_bonuses(bonus_stmt, idx, e_ptr->bonus_stat,
+			e_ptr->bonus_other);
+		if (err) return err;
 
 		for (i = 0; i < EGO_TVALS_MAX; i++)
 		{
+			if (!e_ptr->tval[i]) continue;
+
 			err = stats_db_bind_ints(type_stmt, 4, 0,
-				idx, e_ptr->tval[i], e_ptr->min_sval[i], 
+				idx, e_ptr->tval[i], e_ptr->min_sval[i],
 				e_ptr->max_sval[i]);
 			if (err) return err;
 			STATS_DB_STEP_RESET(type_stmt)
 		}
-
 	}
 
 	STATS_DB_FINALIZE(info_stmt)
 	STATS_DB_FINALIZE(flags_stmt)
-	STATS_DB_FINALIZE(pval_flags_stmt)
+	STATS_DB_FINALIZE(curses_stmt)
+	STATS_DB_FINALIZE(bonus_stmt)
 	STATS_DB_FINALIZE(type_stmt)
 
 	return SQLITE_OK;
@@ -560,20 +761,23 @@ static int stats_dump_egos(void)
 
 static int stats_dump_objects(void)
 {
-	int err, idx, i, flag;
-	char sql_buf[256];
-	sqlite3_stmt *info_stmt, *flags_stmt, *pval_flags_stmt;
+	int err, idx;
+	sqlite3_stmt *info_stmt, *flags_stmt, *curses_stmt, *bonus_stmt;
+
+	err = stats_db_stmt_prep(&info_stmt,
+		"INSERT INTO object_info VALUES (?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?);");
+	if (err) return err;
 
-	strnfmt(sql_buf, 256, "INSERT INTO object_info VALUES (?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?);");
-	err = stats_db_stmt_prep(&info_stmt, sql_buf);
+	err = stats_db_stmt_prep(&flags_stmt,
+		"INSERT INTO object_flags_map VALUES (?,?);");
 	if (err) return err;
 
-	strnfmt(sql_buf, 256, "INSERT INTO object_flags_map VALUES (?,?);");
-	err = stats_db_stmt_prep(&flags_stmt, sql_buf);
+	err = stats_db_stmt_prep(&curses_stmt,
+		"INSERT INTO object_curses_map VALUES (?,?);");
 	if (err) return err;
 
-	strnfmt(sql_buf, 256, "INSERT INTO object_pval_flags_map VALUES (?,?,?);");
-	err = stats_db_stmt_prep(&pval_flags_stmt, sql_buf);
+	err = stats_db_stmt_prep(&bonus_stmt,
+		"INSERT INTO object_bonuses_map VALUES (?,?,?);");
 	if (err) return err;
 
 	for (idx = 0; idx < z_info->k_max; idx++)
@@ -584,109 +788,66 @@ static int stats_dump_objects(void)
 
 		err = sqlite3_bind_int(info_stmt, 1, idx);
 		if (err) return err;
-		err = sqlite3_bind_text(info_stmt, 2, k_ptr->name, 
+		err = sqlite3_bind_text(info_stmt, 2, k_ptr->name,
 			strlen(k_ptr->name), SQLITE_STATIC);
 		if (err) return err;
-		err = stats_db_bind_ints(info_stmt, 14, 2, 
+		err = stats_db_bind_ints(info_stmt, 10, 2,
 			k_ptr->tval, k_ptr->sval, k_ptr->level, k_ptr->weight,
 			k_ptr->cost, k_ptr->ac, k_ptr->dd, k_ptr->ds,
-			k_ptr->alloc_prob, k_ptr->alloc_min,
-			k_ptr->alloc_max, k_ptr->effect,
-			k_ptr->gen_mult_prob, k_ptr->stack_size);
+			k_ptr->effect, k_ptr->gen_mult_prob);
 		if (err) return err;
-		err = stats_db_bind_rv(info_stmt, 17, k_ptr->to_h);
+		err = stats_db_bind_rv(info_stmt, 13, k_ptr->to_h);
 		if (err) return err;
-		err = stats_db_bind_rv(info_stmt, 18, k_ptr->to_d);
+		err = stats_db_bind_rv(info_stmt, 14, k_ptr->to_d);
 		if (err) return err;
-		err = stats_db_bind_rv(info_stmt, 19, k_ptr->to_a);
+		err = stats_db_bind_rv(info_stmt, 15, k_ptr->to_a);
 		if (err) return err;
-		err = stats_db_bind_rv(info_stmt, 20, k_ptr->charge);
+		err = stats_db_bind_rv(info_stmt, 16, k_ptr->pval);
 		if (err) return err;
-		err = stats_db_bind_rv(info_stmt, 21, k_ptr->time);
+		err = stats_db_bind_rv(info_stmt, 17, k_ptr->charge);
+		if (err) return err;
+		err = stats_db_bind_rv(info_stmt, 18, k_ptr->time);
+		if (err) return err;
+		err = stats_db_bind_rv(info_stmt, 19, k_ptr->stack_size);
 		if (err) return err;
 		STATS_DB_STEP_RESET(info_stmt)
 
-		err = stats_dump_oflags(flags_stmt, idx, k_ptr->flags);
+		err = stats_dump_flags(flags_stmt, idx, k_ptr->flags_obj,
+			OF_SIZE);
 		if (err) return err;
 
-		for (i = 0; i < k_ptr->num_pvals; i++)
-		{
-			for (flag = of_next(k_ptr->pval_flags[i], FLAG_START);
-				flag != FLAG_END;
-				flag = of_next(k_ptr->pval_flags[i], flag + 1))
-			{
-				err = stats_db_bind_ints(pval_flags_stmt, 2, 0, 
-					idx, flag);
-				if (err) return err;
-				err = stats_db_bind_rv(pval_flags_stmt, 3,
-					k_ptr->pval[i]);
-				if (err) return err;
-				STATS_DB_STEP_RESET(pval_flags_stmt)
-			}
-		}
-	}
-
-	STATS_DB_FINALIZE(info_stmt)
-	STATS_DB_FINALIZE(flags_stmt)
-	STATS_DB_FINALIZE(pval_flags_stmt)
-
-	/* Handle object_base */
-	strnfmt(sql_buf, 256, "INSERT INTO object_base_info VALUES (?,?);");
-	err = stats_db_stmt_prep(&info_stmt, sql_buf);
-	if (err) return err;
-
-	strnfmt(sql_buf, 256, "INSERT INTO object_base_flags_map VALUES (?,?);");
-	err = stats_db_stmt_prep(&flags_stmt, sql_buf);
-	if (err) return err;
-
-	idx = 0;
-	for (idx = 0; idx < TV_MAX; idx++)
-	{
-		object_base *kb_ptr = &kb_info[idx];
-
-		if (!kb_ptr->name) continue;
-
-		err = sqlite3_bind_int(info_stmt, 1, idx);
-		if (err) return err;
-		err = sqlite3_bind_text(info_stmt, 2, kb_ptr->name,
-			strlen(kb_ptr->name), SQLITE_STATIC);
+		err = stats_dump_flags(curses_stmt, idx, k_ptr->flags_curse,
+			CF_SIZE);
 		if (err) return err;
-		STATS_DB_STEP_RESET(info_stmt)
 
-		for (flag = of_next(kb_ptr->flags, FLAG_START);
-			flag != FLAG_END;
-			flag = of_next(kb_ptr->flags, flag + 1))
-		{
-			err = stats_db_bind_ints(flags_stmt, 2, 0,
-				idx, flag);
-			if (err) return err;
-			STATS_DB_STEP_RESET(flags_stmt)
-		}
+		err = stats_dump_bonuses(bonus_stmt, idx, k_ptr->bonus_stat,
+			k_ptr->bonus_other);
+		if (err) return err;
 	}
-	
+
 	STATS_DB_FINALIZE(info_stmt)
 	STATS_DB_FINALIZE(flags_stmt)
+	STATS_DB_FINALIZE(curses_stmt)
+	STATS_DB_FINALIZE(bonus_stmt)
 
 	return SQLITE_OK;
 }
 
 static int stats_dump_monsters(void)
 {
-	int err, idx, flag;
-	char sql_buf[256];
+	int err, idx;
 	sqlite3_stmt *info_stmt, *flags_stmt, *spell_flags_stmt;
-	monster_base *rb_ptr;
 
-	strnfmt(sql_buf, 256, "INSERT INTO monster_info VALUES (?,?,?,?,?,?,?,?,?,?,?,?);");
-	err = stats_db_stmt_prep(&info_stmt, sql_buf);
+	err = stats_db_stmt_prep(&info_stmt,
+		"INSERT INTO monster_info VALUES (?,?,?,?,?,?,?,?,?,?,?,?,?);");
 	if (err) return err;
 
-	strnfmt(sql_buf, 256, "INSERT INTO monster_flags_map VALUES (?,?);");
-	err = stats_db_stmt_prep(&flags_stmt, sql_buf);
+	err = stats_db_stmt_prep(&flags_stmt,
+		"INSERT INTO monster_flags_map VALUES (?,?);");
 	if (err) return err;
 
-	strnfmt(sql_buf, 256, "INSERT INTO monster_spell_flags_map VALUES (?,?);");
-	err = stats_db_stmt_prep(&spell_flags_stmt, sql_buf);
+	err = stats_db_stmt_prep(&spell_flags_stmt,
+		"INSERT INTO monster_spell_flags_map VALUES (?,?);");
 	if (err) return err;
 
 	for (idx = 0; idx < z_info->r_max; idx++)
@@ -696,256 +857,131 @@ static int stats_dump_monsters(void)
 		/* Skip empty entries */
 		if (!r_ptr->name) continue;
 
-		err = stats_db_bind_ints(info_stmt, 10, 0, idx,
+		err = stats_db_bind_ints(info_stmt, 11, 0, idx,
 			r_ptr->ac, r_ptr->sleep, r_ptr->speed, r_ptr->mexp,
-			r_ptr->avg_hp, r_ptr->freq_innate, r_ptr->freq_spell,
-			r_ptr->level, r_ptr->rarity);
+			r_ptr->hdice, r_ptr->hside, r_ptr->freq_ranged,
+			r_ptr->level, r_ptr->rarity, r_ptr->max_num);
 		if (err) return err;
-		err = sqlite3_bind_text(info_stmt, 11, r_ptr->name,
+		err = sqlite3_bind_text(info_stmt, 12, r_ptr->name,
 			strlen(r_ptr->name), SQLITE_STATIC);
 		if (err) return err;
-		err = sqlite3_bind_text(info_stmt, 12, r_ptr->base->name,
-			strlen(r_ptr->base->name), SQLITE_STATIC);
+		if (r_ptr->base)
+			err = sqlite3_bind_text(info_stmt, 13, r_ptr->base->name,
+				strlen(r_ptr->base->name), SQLITE_STATIC);
+		else
+			err = sqlite3_bind_null(info_stmt, 13);
 		if (err) return err;
 		STATS_DB_STEP_RESET(info_stmt)
 
-		for (flag = rf_next(r_ptr->flags, FLAG_START);
-			flag != FLAG_END;
-			flag = rf_next(r_ptr->flags, flag + 1))
-		{
-			err = stats_db_bind_ints(flags_stmt, 2, 0, idx, flag);
-			if (err) return err;
-			STATS_DB_STEP_RESET(flags_stmt)
-		}
+		err = stats_dump_flags(flags_stmt, idx, r_ptr->flags, RF_SIZE);
+		if (err) return err;
 
-		for (flag = rsf_next(r_ptr->spell_flags, FLAG_START);
-			flag != FLAG_END;
-			flag = rsf_next(r_ptr->spell_flags, flag + 1))
-		{
-			err = stats_db_bind_ints(spell_flags_stmt, 2, 0, 
-				idx, flag);
-			if (err) return err;
-			STATS_DB_STEP_RESET(spell_flags_stmt)
-		}
+		err = stats_dump_flags(spell_flags_stmt, idx, r_ptr->spell_flags,
+			RSF_SIZE);
+		if (err) return err;
 	}
 
 	STATS_DB_FINALIZE(info_stmt)
 	STATS_DB_FINALIZE(flags_stmt)
 	STATS_DB_FINALIZE(spell_flags_stmt)
 
-	/* Handle monster bases */
-	strnfmt(sql_buf, 256, "INSERT INTO monster_base_flags_map VALUES (?,?);");
-	err = stats_db_stmt_prep(&flags_stmt, sql_buf);
-	if (err) return err;
+	return SQLITE_OK;
+}
 
-	strnfmt(sql_buf, 256, "INSERT INTO monster_base_spell_flags_map VALUES (?,?);");
-	err = stats_db_stmt_prep(&spell_flags_stmt, sql_buf);
+/**
+ * Dump one of the lists of names to table "name"
+ */
+static int stats_dump_list(const char *name, const char **list, int first)
+{
+	char sql_buf[256];
+	sqlite3_stmt *sql_stmt;
+	int err, idx;
+
+	strnfmt(sql_buf, 256, "INSERT INTO %s VALUES(?,?);", name);
+	err = stats_db_stmt_prep(&sql_stmt, sql_buf);
 	if (err) return err;
 
-	for (rb_ptr = rb_info, idx = 0; rb_ptr; rb_ptr = rb_ptr->next, idx++)
+	for (idx = first; list[idx] != NULL; idx++)
 	{
-		for (flag = rf_next(rb_ptr->flags, FLAG_START);
-			flag != FLAG_END;
-			flag = rf_next(rb_ptr->flags, flag + 1))
-		{
-			err = sqlite3_bind_text(flags_stmt, 1, rb_ptr->name,
-				strlen(rb_ptr->name), SQLITE_STATIC);
-			if (err) return err;
-			err = sqlite3_bind_int(flags_stmt, 2, flag);
-			if (err) return err;
-			STATS_DB_STEP_RESET(flags_stmt)
-		}
-
-		for (flag = rsf_next(rb_ptr->spell_flags, FLAG_START);
-			flag != FLAG_END;
-			flag = rsf_next(rb_ptr->spell_flags, flag + 1))
-		{
-			err = sqlite3_bind_text(spell_flags_stmt, 1, 
-				rb_ptr->name, strlen(rb_ptr->name), 
-				SQLITE_STATIC);
-			if (err) return err;
-			err = sqlite3_bind_int(spell_flags_stmt, 2, flag);
-			if (err) return err;
-			STATS_DB_STEP_RESET(spell_flags_stmt)
-		}
-		
+		err = sqlite3_bind_int(sql_stmt, 1, idx);
+		if (err) return err;
+		err = sqlite3_bind_text(sql_stmt, 2, list[idx],
+			strlen(list[idx]), SQLITE_STATIC);
+		if (err) return err;
+		STATS_DB_STEP_RESET(sql_stmt)
 	}
 
-	STATS_DB_FINALIZE(flags_stmt)
-	STATS_DB_FINALIZE(spell_flags_stmt)
-
-	return SQLITE_OK;
+	return sqlite3_finalize(sql_stmt);
 }
 
 static int stats_dump_lists(void)
 {
-	int err, idx;
-	char sql_buf[256];
-	sqlite3_stmt *sql_stmt;
+	int err;
+
+	const char *object_flags[] =
+	{
+		#define OF(a, b) #a,
+		#include "list-object-flags.h"
+		#undef OF
+		NULL
+	};
 
-	/* Note: these lists are sometimes different from the ones the core
-	 * game uses, insofar as we put the name of the flag in a
-	 * description field. */
-	info_entry effects[] =
+	const char *curse_flags[] =
 	{
-		#define EFFECT(x, y, r, z)    { EF_##x, y, r, #x },
-		#include "list-effects.h"
-		#undef EFFECT
+		#define CF(a, b) #a,
+		#include "list-curse-flags.h"
+		#undef CF
+		NULL
 	};
 
-	char *r_info_flags[] =
+	const char *monster_flags[] =
 	{
 		#define RF(a, b) #a,
-		#include "monster/list-mon-flags.h"
+		#include "list-mon-flags.h"
 		#undef RF
 		NULL
 	};
 
-	struct mon_spell mon_spell_table[] =
+	const char *monster_spell_flags[] =
 	{
-		#define RSF(a, b, c, d, e, f, g, h, i, j, k, l, m) \
-			{ RSF_##a, b, #a, d, e, f, g, h, i, j, k, l, m },
-		#define RV(b, x, y, m) {b, x, y, m}
-		#include "monster/list-mon-spells.h"
-		#undef RV
+		#define RSF(a, b) #a,
+		#include "list-mon-spells.h"
 		#undef RSF
+		NULL
 	};
 
-	struct object_flag object_flag_table[] =
+	const char *bonuses[] =
 	{
-		#define OF(a, b, c, d, e, f, g, h, i, j, k, l, m, n, o, p, q, r, s) \
-			{ OF_##a, b, c, d, e, f, g, h, i, j, k, l, m, n, o, p, q, r, #a },
-		#include "object/list-object-flags.h"
-		#undef OF
+		"STR", "INT", "WIS", "DEX", "CON", "CHR",
+		"M_MASTERY", "STEALTH", "SEARCH", "INFRA", "TUNNEL", "SPEED",
+		"SHOTS", "MIGHT",
+		NULL
 	};
 
-	struct slay slay_table[] =
+	const char *origins[] =
 	{
-		#define SLAY(a, b, c, d, e, f, g, h, i, j) \
-			{ SL_##a, b, c, d, e, f, g, h, #a, j},
-		#include "object/list-slays.h"
-		#undef SLAY
+		"NONE", "MIXED", "BIRTH", "STORE", "FLOOR", "DROP",
+		"DROP_UNKNOWN", "ACQUIRE", "CHEAT", "CHEST",
+		NULL
 	};
 
-	err = stats_db_stmt_prep(&sql_stmt, 
-		"INSERT INTO effects_list VALUES(?,?,?,?);");
+	err = stats_dump_list("object_flags_list", object_flags, 1);
 	if (err) return err;
 
-	for (idx = 1; idx < EF_MAX; idx++)
-	{
-		if (! effects[idx].desc) continue;
+	err = stats_dump_list("curse_flags_list", curse_flags, 1);
+	if (err) return err;
 
-		err = stats_db_bind_ints(sql_stmt, 3, 0, idx, 
-			effects[idx].aim, effects[idx].power);
-		if (err) return err;
-		err = sqlite3_bind_text(sql_stmt, 4, effects[idx].desc,
-			strlen(effects[idx].desc), SQLITE_STATIC);
-		if (err) return err;
-		STATS_DB_STEP_RESET(sql_stmt)
-	}
+	err = stats_dump_list("monster_flags_list", monster_flags, 1);
+	if (err) return err;
 
-	STATS_DB_FINALIZE(sql_stmt)
+	err = stats_dump_list("monster_spell_flags_list", monster_spell_flags,
+		1);
+	if (err) return err;
 
-	err = stats_db_stmt_prep(&sql_stmt, 
-		"INSERT INTO monster_flags_list VALUES(?,?);");
+	err = stats_dump_list("bonuses_list", bonuses, 0);
 	if (err) return err;
 
-	for (idx = 0; r_info_flags[idx] != NULL; idx++)
-	{
-		err = sqlite3_bind_int(sql_stmt, 1, idx);
-		if (err) return err;
-		err = sqlite3_bind_text(sql_stmt, 2, r_info_flags[idx],
-			strlen(r_info_flags[idx]), SQLITE_STATIC);
-		if (err) return err;
-		STATS_DB_STEP_RESET(sql_stmt)
-	}
-
-	STATS_DB_FINALIZE(sql_stmt)
-
-	err = stats_db_stmt_prep(&sql_stmt, 
-		"INSERT INTO monster_spell_flags_list VALUES(?,?,?,?);");
-	if (err) return err;
-
-	for (idx = 1; idx < RSF_MAX; idx++)
-	{
-		if (! mon_spell_table[idx].desc) continue;
-
-		err = stats_db_bind_ints(sql_stmt, 3, 0, idx, 
-			mon_spell_table[idx].cap, mon_spell_table[idx].div);
-		if (err) return err;
-		err = sqlite3_bind_text(sql_stmt, 4, mon_spell_table[idx].desc,
-			strlen(mon_spell_table[idx].desc), SQLITE_STATIC);
-		if (err) return err;
-		STATS_DB_STEP_RESET(sql_stmt)
-	}
-
-	STATS_DB_FINALIZE(sql_stmt)
-
-	err = stats_db_stmt_prep(&sql_stmt, 
-		"INSERT INTO object_flags_list VALUES(?,?,?,?,?,?);");
-	if (err) return err;
-
-	for (idx = 1; idx < OF_MAX; idx++)
-	{
-		struct object_flag *of_ptr = &object_flag_table[idx];
-		if (! of_ptr->message) continue;
-
-		err = stats_db_bind_ints(sql_stmt, 5, 0, idx, 
-			of_ptr->pval, of_ptr->type, of_ptr->power,
-			of_ptr->pval_mult);
-		if (err) return err;
-		err = sqlite3_bind_text(sql_stmt, 6, of_ptr->message,
-			strlen(of_ptr->message), SQLITE_STATIC);
-		if (err) return err;
-		STATS_DB_STEP_RESET(sql_stmt)
-	}
-
-	STATS_DB_FINALIZE(sql_stmt)
-
-	err = stats_db_stmt_prep(&sql_stmt, 
-		"INSERT INTO object_slays_list VALUES(?,?,?,?,?,?);");
-	if (err) return err;
-
-	for (idx = 1; idx < SL_MAX; idx++)
-	{
-		struct slay *s_ptr = &slay_table[idx];
-		if (! s_ptr->desc) continue;
-
-		err = stats_db_bind_ints(sql_stmt, 5, 0, idx, 
-			s_ptr->object_flag, s_ptr->monster_flag, 
-			s_ptr->resist_flag, s_ptr->mult);
-		if (err) return err;
-		err = sqlite3_bind_text(sql_stmt, 6, s_ptr->desc,
-			strlen(s_ptr->desc), SQLITE_STATIC);
-		if (err) return err;
-		STATS_DB_STEP_RESET(sql_stmt)
-	}
-
-	STATS_DB_FINALIZE(sql_stmt)
-
-	/* Hack, until we refactor origin kinds into a header */
-	#define STATS_ORIGIN(idx,name) \
-		strnfmt(sql_buf, 256, "INSERT INTO origin_flags_list VALUES(%d,'%s');", idx, #name); \
-		err = stats_db_exec(sql_buf);\
-		if (err) return err;
-
-	STATS_ORIGIN(0,NONE)
-	STATS_ORIGIN(1,FLOOR)
-	STATS_ORIGIN(2,DROP)
-	STATS_ORIGIN(3,CHEST)
-	STATS_ORIGIN(4,DROP_SPECIAL)
-	STATS_ORIGIN(5,DROP_PIT)
-	STATS_ORIGIN(6,DROP_VAULT)
-	STATS_ORIGIN(7,SPECIAL)
-	STATS_ORIGIN(8,PIT)
-	STATS_ORIGIN(9,VAULT)
-	STATS_ORIGIN(10,LABYRINTH)
-	STATS_ORIGIN(11,CAVERN)
-	STATS_ORIGIN(12,RUBBLE)
-	STATS_ORIGIN(13,MIXED)
-	#undef STATS_ORIGIN
-
-	return SQLITE_OK;
+	return stats_dump_list("origin_list", origins, 0);
 }
 
 static int stats_dump_info(void)
@@ -963,13 +999,13 @@ static int stats_dump_info(void)
 	err = stats_db_exec(sql_buf);
 	if (err) return err;
 
-	strnfmt(sql_buf, 256, "INSERT INTO metadata VALUES('randarts',%d);",
-		randarts);
+	strnfmt(sql_buf, 256, "INSERT INTO metadata VALUES('no_selling',%d);",
+		no_selling);
 	err = stats_db_exec(sql_buf);
 	if (err) return err;
 
-	strnfmt(sql_buf, 256, "INSERT INTO metadata VALUES('no_selling',%d);",
-		no_selling);
+	strnfmt(sql_buf, 256, "INSERT INTO metadata VALUES('seed',%lu);",
+		(unsigned long) seed_base);
 	err = stats_db_exec(sql_buf);
 	if (err) return err;
 
@@ -1000,663 +1036,562 @@ static int stats_dump_info(void)
  * Note that random_value types are stored as either A+BdC+Md or A.
  * Tables:
  *     metadata -- key-value pairs describing the stats run
- *     artifact_info -- dump of artifact.txt
+ *     artifact_info -- dump of artifact.txt (the fixed artifacts)
  *     artifact_flags_map -- map between artifacts and object flags
- *     artifact_pval_flags_map -- map between artifacts and pval flags, with pvals
+ *     artifact_curses_map -- map between artifacts and curse flags
+ *     artifact_bonuses_map -- map between artifacts and bonuses
  *     ego_info -- dump of ego_item.txt
  *     ego_flags_map -- map between egos and object flags
- *     ego_pval_flags_map -- map between egos and pval flags, with pvals and minima
+ *     ego_curses_map -- map between egos and curse flags
+ *     ego_bonuses_map -- map between egos and bonuses
  *     ego_type_map -- map between egos and tvals/svals
- *     monster_base_flags_map -- map between monster bases and monster flags
- *     monster_base_spell_flags_map -- map between monster bases and monster spell flags
- *     monster_info -- dump of monsters.txt
+ *     monster_info -- dump of monster.txt
  *     monster_flags_map -- map between monsters and monster flags
  *     monster_spell_flags_map -- map between monsters and monster spell flags
- *     object_base_info -- dump of object_base.txt
- *     object_base_flags_map -- map between object templates and object flags
- *     object_info -- dump of objects.txt
- *     object_flags_map -- map between artifacts and object flags
- *     object_pval_flags_map -- map between artifacts and pval flags, with pvals
- *     effects_list -- dump of list-effects.h
+ *     object_info -- dump of object.txt
+ *     object_flags_map -- map between objects and object flags
+ *     object_curses_map -- map between objects and curse flags
+ *     object_bonuses_map -- map between objects and bonuses
+ *     object_flags_list -- dump of list-object-flags.h
+ *     curse_flags_list -- dump of list-curse-flags.h
  *     monster_flags_list -- dump of list-mon-flags.h
  *     monster_spell_flags_list -- dump of list-mon-spells.h
- *     object_flags_list -- dump of list-object-flags.h
- *     object_slays_list -- dump of list-object-slays.h
- *     origin_flags_list -- dump of origin enum
+ *     bonuses_list -- stat bonuses, then other bonuses
+ *     origin_list -- dump of origin enum
  * Count tables:
- *     monsters
- *     obj_feelings
- *     mon_feelings
- *     gold
- *     artifacts
- *     consumables
- *     wearables_count
- *     wearables_dice
- *     wearables_ac
- *     wearables_hit
- *     wearables_dam
- *     wearables_egos
- *     wearables_flags
- *     wearables_pval_flags
+ *     gold, and each of stats_tables[]
  */
 static bool stats_prep_db(void)
 {
-	bool status;
-	int err;
+	char sql_buf[256];
+	int err, i;
 
 	/* Open the database connection */
-	status = stats_db_open();
-	if (!status) return status;
+	if (!stats_db_open()) return FALSE;
 
 	/* Create some tables */
 	err = stats_db_exec("CREATE TABLE metadata(field TEXT UNIQUE NOT NULL, value TEXT);");
-	if (err) return false;
+	if (err) return FALSE;
 
-	err = stats_db_exec("CREATE TABLE artifact_info(idx INT PRIMARY KEY, name TEXT, tval INT, sval INT, weight INT, cost INT, alloc_prob INT, alloc_min INT, alloc_max INT, ac INT, dd INT, ds INT, to_h INT, to_d INT, to_a INT, effect INT);");
-	if (err) return false;
+	err = stats_db_exec("CREATE TABLE artifact_info(idx INT PRIMARY KEY, name TEXT, tval INT, sval INT, level INT, rarity INT, weight INT, cost INT, ac INT, dd INT, ds INT, to_h INT, to_d INT, to_a INT, effect INT, set_no INT);");
+	if (err) return FALSE;
 
 	err = stats_db_exec("CREATE TABLE artifact_flags_map(a_idx INT, o_flag INT);");
-	if (err) return false;
+	if (err) return FALSE;
+
+	err = stats_db_exec("CREATE TABLE artifact_curses_map(a_idx INT, c_flag INT);");
+	if (err) return FALSE;
 
-	err = stats_db_exec("CREATE TABLE artifact_pval_flags_map(a_idx INT, pval_flag INT, pval INT);");
-	if (err) return false;
+	err = stats_db_exec("CREATE TABLE artifact_bonuses_map(a_idx INT, bonus INT, value INT);");
+	if (err) return FALSE;
 
-	err = stats_db_exec("CREATE TABLE ego_info(idx INT PRIMARY KEY, name TEXT, to_h TEXT, to_d TEXT, to_a TEXT, cost INT, level INT, rarity INT, rating INT, num_pvals INT, min_to_h INT, min_to_d INT, min_to_a INT, xtra INT);");
-	if (err) return false;
+	err = stats_db_exec("CREATE TABLE ego_info(idx INT PRIMARY KEY, name TEXT, cost INT, level INT, rarity INT, rating INT, max_to_h INT, max_to_d INT, max_to_a INT, effect INT);");
+	if (err) return FALSE;
 
 	err = stats_db_exec("CREATE TABLE ego_flags_map(e_idx INT, o_flag INT);");
-	if (err) return false;
+	if (err) return FALSE;
 
-	err = stats_db_exec("CREATE TABLE ego_pval_flags_map(e_idx INT, pval_flag INT, min_pval INT, pval TEXT);");
-	if (err) return false;
+	err = stats_db_exec("CREATE TABLE ego_curses_map(e_idx INT, c_flag INT);");
+	if (err) return FALSE;
 
-	err = stats_db_exec("CREATE TABLE ego_type_map(e_idx INT, tval INT, min_sval INT, max_sval INT);");
-	if (err) return false;
+	err = stats_db_exec("CREATE TABLE ego_bonuses_map(e_idx INT, bonus INT, value INT);");
+	if (err) return FALSE;
 
-	err = stats_db_exec("CREATE TABLE monster_base_flags_map(rb_idx INT, r_flag INT);");
-	if (err) return false;
-
-	err = stats_db_exec("CREATE TABLE monster_base_spell_flags_map(rb_idx INT, rs_flag INT);");
-	if (err) return false;
+	err = stats_db_exec("CREATE TABLE ego_type_map(e_idx INT, tval INT, min_sval INT, max_sval INT);");
+	if (err) return FALSE;
 
-	err = stats_db_exec("CREATE TABLE monster_info(idx INT PRIMARY KEY, ac INT, sleep INT, speed INT, mexp INT, hp INT, freq_innate INT, freq_spell INT, level INT, rarity INT, name TEXT, base TEXT);");
-	if (err) return false;
+	err = stats_db_exec("CREATE TABLE monster_info(idx INT PRIMARY KEY, ac INT, sleep INT, speed INT, mexp INT, hdice INT, hside INT, freq_ranged INT, level INT, rarity INT, max_num INT, name TEXT, base TEXT);");
+	if (err) return FALSE;
 
 	err = stats_db_exec("CREATE TABLE monster_flags_map(r_idx INT, r_flag INT);");
-	if (err) return false;
+	if (err) return FALSE;
 
 	err = stats_db_exec("CREATE TABLE monster_spell_flags_map(r_idx INT, rs_flag INT);");
-	if (err) return false;
+	if (err) return FALSE;
 
-	err = stats_db_exec("CREATE TABLE object_base_info(idx INT PRIMARY KEY, name TEXT);");
-	if (err) return false;
-
-	err = stats_db_exec("CREATE TABLE object_base_flags_map(kb_idx INT, o_flag INT);");
-	if (err) return false;
-
-	err = stats_db_exec("CREATE TABLE object_info(idx INT PRIMARY KEY, name TEXT, tval INT, sval INT, level INT, weight INT, cost INT, ac INT, dd INT, ds INT, alloc_prob INT, alloc_min INT, alloc_max INT, effect INT, gen_mult_prob INT, stack_size INT, to_h TEXT, to_d TEXT, to_a TEXT, charge TEXT, recharge_time TEXT);");
-	if (err) return false;
+	err = stats_db_exec("CREATE TABLE object_info(idx INT PRIMARY KEY, name TEXT, tval INT, sval INT, level INT, weight INT, cost INT, ac INT, dd INT, ds INT, effect INT, gen_mult_prob INT, to_h TEXT, to_d TEXT, to_a TEXT, pval TEXT, charge TEXT, recharge_time TEXT, stack_size TEXT);");
+	if (err) return FALSE;
 
 	err = stats_db_exec("CREATE TABLE object_flags_map(k_idx INT, o_flag INT);");
-	if (err) return false;
-
-	err = stats_db_exec("CREATE TABLE object_pval_flags_map(k_idx INT, pval_flag INT, pval TEXT);");
-	if (err) return false;
+	if (err) return FALSE;
 
-	err = stats_db_exec("CREATE TABLE effects_list(idx INT PRIMARY KEY, aim INT, rating INT, name TEXT);");
-	if (err) return false;
-
-	err = stats_db_exec("CREATE TABLE monster_flags_list(idx INT PRIMARY KEY, name TEXT);");
-	if (err) return false;
+	err = stats_db_exec("CREATE TABLE object_curses_map(k_idx INT, c_flag INT);");
+	if (err) return FALSE;
 
-	err = stats_db_exec("CREATE TABLE monster_spell_flags_list(idx INT PRIMARY KEY, cap INT, div INT, name TEXT);");
-	if (err) return false;
+	err = stats_db_exec("CREATE TABLE object_bonuses_map(k_idx INT, bonus INT, value INT);");
+	if (err) return FALSE;
 
-	err = stats_db_exec("CREATE TABLE object_flags_list(idx INT PRIMARY KEY, pval INT, type INT, power INT, pval_mult INT, name TEXT);");
-	if (err) return false;
+	err = stats_db_exec("CREATE TABLE object_flags_list(idx INT PRIMARY KEY, name TEXT);");
+	if (err) return FALSE;
 
-	err = stats_db_exec("CREATE TABLE object_slays_list(idx INT PRIMARY KEY, object_flag INT, monster_flag INT, resist_flag INT, mult INT, name TEXT);");
-	if (err) return false;
+	err = stats_db_exec("CREATE TABLE curse_flags_list(idx INT PRIMARY KEY, name TEXT);");
+	if (err) return FALSE;
 
-	err = stats_db_exec("CREATE TABLE origin_flags_list(idx INT PRIMARY KEY, name TEXT);");
-	if (err) return false;
-
-	err = stats_db_exec("CREATE TABLE monsters(level INT, count INT, k_idx INT, UNIQUE (level, k_idx) ON CONFLICT REPLACE);");
-	if (err) return false;
-
-	err = stats_db_exec("CREATE TABLE obj_feelings(level INT, count INT, feeling INT, UNIQUE (level, feeling) ON CONFLICT REPLACE);");
-	if (err) return false;
-
-	err = stats_db_exec("CREATE TABLE mon_feelings(level INT, count INT, feeling INT, UNIQUE (level, feeling) ON CONFLICT REPLACE);");
-	if (err) return false;
-
-	err = stats_db_exec("CREATE TABLE gold(level INT, count INT, origin INT, UNIQUE (level, origin) ON CONFLICT REPLACE);");
-	if (err) return false;
-
-	err = stats_db_exec("CREATE TABLE artifacts(level INT, count INT, a_idx INT, origin INT, UNIQUE (level, a_idx, origin) ON CONFLICT REPLACE);");
-	if (err) return false;
-
-	err = stats_db_exec("CREATE TABLE consumables(level INT, count INT, k_idx INT, origin INT, UNIQUE (level, k_idx, origin) ON CONFLICT REPLACE);");
-	if (err) return false;
-
-	err = stats_db_exec("CREATE TABLE wearables_count(level INT, count INT, k_idx INT, origin INT, UNIQUE (level, k_idx, origin) ON CONFLICT REPLACE);");
-	if (err) return false;
-
-	err = stats_db_exec("CREATE TABLE wearables_dice(level INT, count INT, k_idx INT, origin INT, dd INT, ds INT, UNIQUE (level, k_idx, origin, dd, ds) ON CONFLICT REPLACE);");
-	if (err) return false;
+	err = stats_db_exec("CREATE TABLE monster_flags_list(idx INT PRIMARY KEY, name TEXT);");
+	if (err) return FALSE;
 
-	err = stats_db_exec("CREATE TABLE wearables_ac(level INT, count INT, k_idx INT, origin INT, ac INT, UNIQUE (level, k_idx, origin, ac) ON CONFLICT REPLACE);");
-	if (err) return false;
+	err = stats_db_exec("CREATE TABLE monster_spell_flags_list(idx INT PRIMARY KEY, name TEXT);");
+	if (err) return FALSE;
 
-	err = stats_db_exec("CREATE TABLE wearables_hit(level INT, count INT, k_idx INT, origin INT, to_h INT, UNIQUE (level, k_idx, origin, to_h) ON CONFLICT REPLACE);");
-	if (err) return false;
+	err = stats_db_exec("CREATE TABLE bonuses_list(idx INT PRIMARY KEY, name TEXT);");
+	if (err) return FALSE;
 
-	err = stats_db_exec("CREATE TABLE wearables_dam(level INT, count INT, k_idx INT, origin INT, to_d INT, UNIQUE (level, k_idx, origin, to_d) ON CONFLICT REPLACE);");
-	if (err) return false;
+	err = stats_db_exec("CREATE TABLE origin_list(idx INT PRIMARY KEY, name TEXT);");
+	if (err) return FALSE;
 
-	err = stats_db_exec("CREATE TABLE wearables_egos(level INT, count INT, k_idx INT, origin INT, e_idx INT, UNIQUE (level, k_idx, origin, e_idx) ON CONFLICT REPLACE);");
-	if (err) return false;
+	err = stats_db_exec("CREATE TABLE gold(level INT, count INT, origin INT, UNIQUE (level, origin));");
+	if (err) return FALSE;
 
-	err = stats_db_exec("CREATE TABLE wearables_flags(level INT, count INT, k_idx INT, origin INT, of_idx INT, UNIQUE (level, k_idx, origin, of_idx) ON CONFLICT REPLACE);");
-	if (err) return false;
+	/* Each batch adds its counts to those already written */
+	err = stats_db_stmt_prep(&gold_stmt, "INSERT INTO gold VALUES(?,?,?) ON CONFLICT(level, origin) DO UPDATE SET count = count + excluded.count;");
+	if (err) return FALSE;
 
-	err = stats_db_exec("CREATE TABLE wearables_pval_flags(level INT, count INT, k_idx INT, origin INT, pval INT, of_idx INT, UNIQUE (level, k_idx, origin, pval, of_idx) ON CONFLICT REPLACE);");
-	if (err) return false;
+	for (i = 0; i < ST_MAX; i++)
+	{
+		struct stats_table *t = &stats_tables[i];
+
+		strnfmt(sql_buf, 256, "CREATE TABLE %s(level INT, count INT, %s, UNIQUE (level, %s));",
+			t->name, t->columns, t->keys);
+		err = stats_db_exec(sql_buf);
+		if (err) return FALSE;
+
+		strnfmt(sql_buf, 256, "INSERT INTO %s VALUES(?,?%s) ON CONFLICT(level, %s) DO UPDATE SET count = count + excluded.count;",
+			t->name, (t->num_keys == 1) ? ",?" :
+			(t->num_keys == 2) ? ",?,?" : ",?,?,?", t->keys);
+		err = stats_db_stmt_prep(&t->stmt, sql_buf);
+		if (err) return FALSE;
+	}
 
 	err = stats_dump_info();
-	if (err) return false;
+	if (err) return FALSE;
 
-	return true;
+	return TRUE;
 }
 
 /**
- * Find the offset of the given member of the level_data struct. Not elegant.
+ * Add this batch's counts of table "t" on every level to the database
  */
-static int stats_level_data_offsetof(const char *member)
+static int stats_write_db_table(struct stats_table *t)
 {
-	if (streq(member, "monsters"))
-		return offsetof(struct level_data, monsters);
-	else if (streq(member, "obj_feelings"))
-		return offsetof(struct level_data, obj_feelings);
-	else if (streq(member, "mon_feelings"))
-		return offsetof(struct level_data, mon_feelings);
-	else if (streq(member, "gold"))
-		return offsetof(struct level_data, gold);
-	else if (streq(member, "artifacts"))
-		return offsetof(struct level_data, artifacts);
-	else if (streq(member, "consumables"))
-		return offsetof(struct level_data, consumables);
-	else if (streq(member, "wearables"))
-		return offsetof(struct level_data, wearables);
-		
-	/* We should not get to this point. */
-	assert(0);
-}
+	int err, level, i, j, k;
 
-/**
- * Find the offset of the given member of the wearables_data struct. Not 
- * elegant.
- */
-static int stats_wearables_data_offsetof(const char *member)
-{
-	if (streq(member, "count"))
-		return offsetof(struct wearables_data, count);
-	else if (streq(member, "dice"))
-		return offsetof(struct wearables_data, dice);
-	else if (streq(member, "ac"))
-		return offsetof(struct wearables_data, ac);
-	else if (streq(member, "hit"))
-		return offsetof(struct wearables_data, hit);
-	else if (streq(member, "dam"))
-		return offsetof(struct wearables_data, dam);
-	else if (streq(member, "egos"))
-		return offsetof(struct wearables_data, egos);
-	else if (streq(member, "flags"))
-		return offsetof(struct wearables_data, flags);
-	else if (streq(member, "pval_flags"))
-		return offsetof(struct wearables_data, pval_flags);
-		
-	/* We should not get to this point. */
-	assert(0);
-}
+	for (level = 1; level < LEVEL_MAX; level++)
+	{
+		u32b *count = level_counts + level * level_cells + t->offset;
 
-/**
- * Given a pointer to a dynamically allocated array and a value, look up
- * the index with that value; e.g. given wearables_index[k_idx], return k_idx.
- * If not found, return -1 * value.
- */
+		for (i = 0; i < t->size[0]; i++)
+		{
+			int k0 = t->wearable ? wearables_kind[i] : i;
 
-static int stats_lookup_index(const int *index, int max_idx, int value)
-{
-	int idx;
+			for (j = 0; j < t->size[1]; j++)
+			{
+				for (k = 0; k < t->size[2]; k++, count++)
+				{
+					if (!*count) continue;
 
-	for (idx = 0; idx < max_idx; idx ++) {
-		if (index[idx] == value) return idx;
+					err = sqlite3_bind_int(t->stmt, 1, level);
+					if (err) return err;
+					err = sqlite3_bind_int64(t->stmt, 2, *count);
+					if (err) return err;
+					err = stats_db_bind_ints(t->stmt, t->num_keys, 2,
+						k0 + t->bias[0], j + t->bias[1], k + t->bias[2]);
+					if (err) return err;
+
+					STATS_DB_STEP_RESET(t->stmt)
+				}
+			}
+		}
 	}
 
-	return -1 * value;
+	return SQLITE_OK;
 }
 
-static int stats_write_db_level_data(const char *table, int max_idx)
+/**
+ * Add the counts of the batch that ended with run "run" to the database,
+ * in one transaction, and clear them for the next batch
+ */
+static int stats_write_db(u32b run)
 {
 	char sql_buf[256];
-	sqlite3_stmt *sql_stmt;
-	int err, level, i, offset;
+	int err, level, origin, i;
 
-	strnfmt(sql_buf, 256, "INSERT INTO %s VALUES(?,?,?);", table);
-	err = stats_db_stmt_prep(&sql_stmt, sql_buf);
+	/* Wrap entire write into a transaction */
+	err = stats_db_exec("BEGIN TRANSACTION;");
 	if (err) return err;
 
-	offset = stats_level_data_offsetof(table);
+	strnfmt(sql_buf, 256,
+		"INSERT OR REPLACE INTO metadata VALUES('runs', %lu);",
+		(unsigned long) run);
+	err = stats_db_exec(sql_buf);
+	if (err) return err;
 
 	for (level = 1; level < LEVEL_MAX; level++)
 	{
-		for (i = 0; i < max_idx; i++)
+		for (origin = 0; origin < STATS_ORIGINS; origin++)
 		{
-			/* This arcane expression finds the value of 
-			 * level_data[level].<table>[i] */
-			u32b count;
-			if (streq(table, "gold"))
-			{
-				count = *((long long *)((byte *)&level_data[level] + offset) + i);
-			}
-			else
-			{
-				count = *((u32b *)((byte *)&level_data[level] + offset) + i);
-			}
-			if (!count) continue;
+			if (!level_gold[level][origin]) continue;
 
-			err = stats_db_bind_ints(sql_stmt, 3, 0,
-				level, count, i);
+			err = sqlite3_bind_int(gold_stmt, 1, level);
+			if (err) return err;
+			err = sqlite3_bind_int64(gold_stmt, 2,
+				level_gold[level][origin]);
+			if (err) return err;
+			err = sqlite3_bind_int(gold_stmt, 3, origin);
 			if (err) return err;
 
-			STATS_DB_STEP_RESET(sql_stmt)
+			STATS_DB_STEP_RESET(gold_stmt)
 		}
 	}
 
-	return sqlite3_finalize(sql_stmt);
-}
-
-static int stats_write_db_level_data_items(const char *table, int max_idx, 
-	bool translate_consumables)
-{
-	char sql_buf[256];
-	sqlite3_stmt *sql_stmt;
-	int err, level, origin, i, offset;
-
-	strnfmt(sql_buf, 256, "INSERT INTO %s VALUES(?,?,?,?);", table);
-	err = stats_db_stmt_prep(&sql_stmt, sql_buf);
-	if (err) return err;
-
-	offset = stats_level_data_offsetof(table);
-
-	for (level = 1; level < LEVEL_MAX; level++)
+	for (i = 0; i < ST_MAX; i++)
 	{
-		for (origin = 0; origin < ORIGIN_STATS; origin++)
-		{
-			for (i = 0; i < max_idx; i++)
-			{
-				/* This arcane expression finds the value of 
-				 * level_data[level].<table>[origin][i] */
-				u32b count = ((u32b **)((byte *)&level_data[level] + offset))[origin][i];
-				if (!count) continue;
+		err = stats_write_db_table(&stats_tables[i]);
+		if (err) return err;
+	}
 
-				err = stats_db_bind_ints(sql_stmt, 4, 0,
-					level, count, 
-					translate_consumables ? stats_lookup_index(consumables_index, z_info->k_max, i) : i, origin);
-				if (err) return err;
+	/* Commit transaction */
+	err = stats_db_exec("COMMIT;");
+	if (err) return err;
 
-				STATS_DB_STEP_RESET(sql_stmt)
-			}
-		}
-	}
+	/* The next batch starts from nothing */
+	memset(level_counts, 0, LEVEL_MAX * level_cells * sizeof(u32b));
+	memset(level_gold, 0, sizeof(level_gold));
 
-	return sqlite3_finalize(sql_stmt);
+	return SQLITE_OK;
 }
 
-static int stats_write_db_wearables_count(void)
-{
-	sqlite3_stmt *sql_stmt;
-	int err, level, origin, k_idx, idx;
+/**
+ * Call with the number of runs that have been completed.
+ */
 
-	err = stats_db_stmt_prep(&sql_stmt, 
-		"INSERT INTO wearables_count VALUES(?,?,?,?);");
-	if (err) return err;
+#define STATS_PROGRESS_BAR_LEN 30
 
-	for (level = 1; level < LEVEL_MAX; level++)
-	{
-		for (origin = 0; origin < ORIGIN_STATS; origin++)
-		{
-			for (idx = 0; idx < wearable_count + 1; idx++)
-			{
-				u32b count = level_data[level].wearables[origin][idx].count;
-				/* Skip if object did not appear */
-				if (!count) continue;
+static void progress_bar(u32b run, time_t start) {
+	u32b i;
+	u32b n = (run * STATS_PROGRESS_BAR_LEN) / num_runs;
+	u32b p10 = ((long long)run * 1000) / num_runs;
 
-				k_idx = stats_lookup_index(wearables_index, 
-					z_info->k_max, idx);
+	time_t delta = time(NULL) - start;
+	u32b togo = num_runs - run;
+	u32b expect = delta ? ((long long)delta * (long long)togo) / run
+		: 0;
 
-				/* Skip if pile */
-				if (! k_idx) continue;
+	int h = expect / 3600;
+	int m = (expect % 3600) / 60;
+	int s = expect % 60;
+
+	printf("\r|");
+	for (i = 0; i < n; i++) printf("*");
+	for (i = 0; i < STATS_PROGRESS_BAR_LEN - n; i++) printf(" ");
+	printf("| %d/%d (%5.1f%%) %3d:%02d:%02d ", run, num_runs, p10/10.0, h, m, s);
+	fflush(stdout);
+}
 
-				err = stats_db_bind_ints(sql_stmt, 4, 0,
-					level, count, k_idx, origin);
-				if (err) return err;
+#ifdef SET_UID
 
-				STATS_DB_STEP_RESET(sql_stmt)
-			}
-		}
-	}
+/**
+ * Where worker "w" leaves the counts of each of its runs
+ */
+static void stats_run_path(char *buf, size_t len, int w)
+{
+	char name[32];
 
-	return sqlite3_finalize(sql_stmt);
+	strnfmt(name, sizeof(name), "run-%d.raw", w);
+	path_build(buf, len, ANGBAND_DIR_STATS, name);
 }
 
 /**
- * Unfortunately, the arcane expression used to find the value of an array 
- * member of a struct differs depending on whether the member is declared
- * as an array or as a pointer. Pass in true if the member is an array, and
- * false if the member is a pointer.
+ * Write a forked run's gold and counters to "f", or add those read from
+ * "f" to the counts
  */
-static int stats_write_db_wearables_array(const char *field, int max_val, bool array_p)
+static bool stats_log_io(ang_file *f, bool add)
 {
-	char sql_buf[256];
-	sqlite3_stmt *sql_stmt;
-	int err, level, origin, idx, k_idx, i, offset;
+	u32b buf[4096];
+	long long gold[LEVEL_MAX][STATS_ORIGINS];
+	u32b n;
+	int i, j;
+
+	if (!add) {
+		n = (u32b) run_log_n;
+		return file_write(f, (char *) level_gold, sizeof(level_gold)) &&
+			file_write(f, (char *) &n, sizeof(n)) &&
+			file_write(f, (char *) run_log, n * sizeof(u32b));
+	}
 
-	strnfmt(sql_buf, 256, "INSERT INTO wearables_%s VALUES(?,?,?,?,?);", field);
-	err = stats_db_stmt_prep(&sql_stmt, sql_buf);
-	if (err) return err;
+	if ((file_read(f, (char *) gold, sizeof(gold)) != (int) sizeof(gold)) ||
+		(file_read(f, (char *) &n, sizeof(n)) != (int) sizeof(n)))
+		return FALSE;
 
-	offset = stats_wearables_data_offsetof(field);
+	for (i = 0; i < LEVEL_MAX; i++)
+		for (j = 0; j < STATS_ORIGINS; j++)
+			level_gold[i][j] += gold[i][j];
 
-	for (level = 1; level < LEVEL_MAX; level++)
-	{
-		for (origin = 0; origin < ORIGIN_STATS; origin++)
-		{
-			for (idx = 0; idx < wearable_count + 1; idx++)
-			{
-				k_idx = stats_lookup_index(wearables_index, 
-					z_info->k_max, idx);
+	while (n) {
+		u32b k, chunk = MIN(n, N_ELEMENTS(buf));
 
-				/* Skip if pile */
-				if (! k_idx) continue;
+		if (file_read(f, (char *) buf, chunk * sizeof(u32b)) !=
+			(int) (chunk * sizeof(u32b)))
+			return FALSE;
 
-				for (i = 0; i < max_val; i++)
-				{
-					/* This arcane expression finds the value of
-					 * level_data[level].wearables[origin][idx].<field>[i] */
-					u32b count;
-					if (array_p)
-					{
-						count = ((u32b *)((byte *)&level_data[level].wearables[origin][idx] + offset))[i];
-					}
-					else
-					{
-						count = ((u32b *)*((u32b **)((byte *)&level_data[level].wearables[origin][idx] + offset)))[i];
-					}
-					if (!count) continue;
-
-					err = stats_db_bind_ints(sql_stmt, 5, 0,
-						level, count, k_idx, origin, i);
-					if (err) return err;
+		for (k = 0; k < chunk; k++)
+			level_counts[buf[k]]++;
 
-					STATS_DB_STEP_RESET(sql_stmt)
-				}
-			}
-		}
+		n -= chunk;
 	}
 
-	return sqlite3_finalize(sql_stmt);
+	return TRUE;
 }
 
 /**
- * Unfortunately, the arcane expression used to find the value of an array 
- * member of a struct differs depending on whether the member is declared
- * as an array or as a pointer. Pass in true if the member is an array, and
- * false if the member is a pointer.
+ * Make run "run" in a forked process and add what it counted to the counts.
+ *
+ * A run changes a great deal of global state (lore, artifacts, uniques,
+ * the objects and egos already seen...), and the next run would start
+ * from it.  Forking means every run starts from the state left by
+ * initialisation instead, as it would in a process of its own.
  */
-static int stats_write_db_wearables_2d_array(const char *field, 
-	int max_val1, int max_val2, bool array_p, bool translate_pval_flags)
+static void stats_fork_run(u32b run)
 {
-	char sql_buf[256];
-	sqlite3_stmt *sql_stmt;
-	int err, level, origin, idx, k_idx, i, j, offset;
+	char path[1024];
+	pid_t pid;
+	int status;
+	ang_file *f;
 
-	strnfmt(sql_buf, 256, "INSERT INTO wearables_%s VALUES(?,?,?,?,?,?);", field);
-	err = stats_db_stmt_prep(&sql_stmt, sql_buf);
-	if (err) return err;
+	stats_run_path(path, sizeof(path), stats_worker);
 
-	offset = stats_wearables_data_offsetof(field);
-
-	for (level = 1; level < LEVEL_MAX; level++)
-	{
-		for (origin = 0; origin < ORIGIN_STATS; origin++)
-		{
-			for (idx = 0; idx < wearable_count + 1; idx++)
-			{
-				k_idx = stats_lookup_index(wearables_index, 
-					z_info->k_max, idx);
+	/* Don't duplicate buffered output in the run */
+	fflush(stdout);
 
-				/* Skip if pile */
-				if (! k_idx) continue;
+	pid = fork();
+	if (pid < 0)
+		quit("Couldn't start a stats run!");
 
-				for (i = 0; i < max_val1; i++)
-				{
-					for (j = 0; j < max_val2; j++)
-					{
-						/* This arcane expression finds the value of
-				 		* level_data[level].wearables[origin][idx].<field>[i][j] */
-						u32b count;
-						int real_j = translate_pval_flags ? stats_lookup_index(pval_flags_index, OF_MAX, j) : j; 
-
-						if (i == 0 && real_j == 0) continue;
-
-						if (array_p)
-						{
-							count = ((u32b *)((byte *)&level_data[level].wearables[origin][idx] + offset))[i * max_val2 + j];
-						}
-						else
-						{
-							count = *(*((u32b **)((byte *)&level_data[level].wearables[origin][idx] + offset) + i) + j);
-						}
-						if (!count) continue;
-
-						err = stats_db_bind_ints(sql_stmt, 6, 0,
-							level, count, k_idx, origin, 
-							i, real_j);
-						if (err) return err;
-
-						STATS_DB_STEP_RESET(sql_stmt)
-					}
-				}
-			}
-		}
-	}
+	if (!pid) {
+		/* Count this run alone */
+		run_logging = TRUE;
+		memset(level_gold, 0, sizeof(level_gold));
 
-	return sqlite3_finalize(sql_stmt);
-}
+		initialize_character(run);
+		descend_dungeon();
+		fflush(stdout);
 
-static int stats_write_db(u32b run)
-{
-	char sql_buf[256];
-	int err;
+		f = file_open(path, MODE_WRITE, FTYPE_RAW);
+		if (!f || !stats_log_io(f, FALSE))
+			_exit(1);
+		file_close(f);
+		_exit(0);
+	}
 
-	/* Wrap entire write into a transaction */
-	err = stats_db_exec("BEGIN TRANSACTION;");
-	if (err) return err;
+	if ((waitpid(pid, &status, 0) < 0) || !WIFEXITED(status) ||
+		WEXITSTATUS(status))
+		quit_fmt("Stats run %lu failed!", (unsigned long) run);
 
-	strnfmt(sql_buf, 256, 
-		"INSERT OR REPLACE INTO metadata VALUES('runs', %d);", run);
-	err = stats_db_exec(sql_buf);
-	if (err) return err;
+	f = file_open(path, MODE_READ, FTYPE_RAW);
+	if (!f || !stats_log_io(f, TRUE))
+		quit_fmt("Couldn't read the results of stats run %lu!",
+			(unsigned long) run);
+	file_close(f);
+	file_delete(path);
+}
 
-	err = stats_write_db_level_data("monsters", z_info->r_max);
-	if (err) return err;
+#endif /* SET_UID */
 
-	err = stats_write_db_level_data("obj_feelings", OBJ_FEEL_MAX);
-	if (err) return err;
+/**
+ * Make runs "first" to "last" through the dungeon
+ */
+static void stats_do_runs(u32b first, u32b last, time_t start)
+{
+	u32b run;
 
-	err = stats_write_db_level_data("mon_feelings", MON_FEEL_MAX);
-	if (err) return err;
+	for (run = first; run <= last; run++)
+	{
+		/* Worker 0 speaks for everyone */
+		if (!quiet && !stats_worker)
+			progress_bar(first - 1 + (run - first) * num_workers, start);
+
+#ifdef SET_UID
+		stats_fork_run(run);
+#else
+		initialize_character(run);
+		descend_dungeon();
+#endif
 
-	err = stats_write_db_level_data("gold", ORIGIN_STATS);
-	if (err) return err;
+		if (quiet && run % 1000 == 0) {
+			printf("Finished %d runs.\n", run);
+			fflush(stdout);
+		}
+	}
+}
 
-	err = stats_write_db_level_data_items("artifacts", z_info->a_max, 
-		false);
-	if (err) return err;
+#ifdef SET_UID
 
-	err = stats_write_db_level_data_items("consumables", 
-		consumable_count + 1, true);
-	if (err) return err;
+/**
+ * Where worker "w" leaves its counts
+ */
+static void stats_worker_path(char *buf, size_t len, int w)
+{
+	char name[32];
 
-	err = stats_write_db_wearables_count();
-	if (err) return err;
+	strnfmt(name, sizeof(name), "worker-%d.raw", w);
+	path_build(buf, len, ANGBAND_DIR_STATS, name);
+}
 
-	err = stats_write_db_wearables_2d_array("dice", TOP_DICE, TOP_SIDES, true, false);
-	if (err) return err;
+/**
+ * Write all of the counts to "f", or add the counts read from "f" to them
+ */
+static bool stats_counts_io(ang_file *f, bool add)
+{
+	u32b buf[4096];
+	long long gold[LEVEL_MAX][STATS_ORIGINS];
+	size_t done, n = LEVEL_MAX * level_cells;
+	int i, j;
 
-	err = stats_write_db_wearables_array("ac", TOP_AC, true);
-	if (err) return err;
+	if (!add)
+		return file_write(f, (char *) level_gold, sizeof(level_gold)) &&
+			file_write(f, (char *) level_counts, n * sizeof(u32b));
 
-	err = stats_write_db_wearables_array("hit", TOP_PLUS, true);
-	if (err) return err;
+	if (file_read(f, (char *) gold, sizeof(gold)) != (int) sizeof(gold))
+		return FALSE;
 
-	err = stats_write_db_wearables_array("dam", TOP_PLUS, true);
-	if (err) return err;
+	for (i = 0; i < LEVEL_MAX; i++)
+		for (j = 0; j < STATS_ORIGINS; j++)
+			level_gold[i][j] += gold[i][j];
 
-	err = stats_write_db_wearables_array("egos", z_info->e_max, false);
-	if (err) return err;
+	for (done = 0; done < n; ) {
+		size_t k, chunk = MIN(n - done, N_ELEMENTS(buf));
 
-	err = stats_write_db_wearables_array("flags", OF_MAX, true);
-	if (err) return err;
+		if (file_read(f, (char *) buf, chunk * sizeof(u32b)) !=
+			(int) (chunk * sizeof(u32b)))
+			return FALSE;
 
-	err = stats_write_db_wearables_2d_array("pval_flags", TOP_PVAL, pval_flags_count + 1, false, true);
-	if (err) return err;
+		for (k = 0; k < chunk; k++)
+			level_counts[done + k] += buf[k];
 
-	/* Commit transaction */
-	err = stats_db_exec("COMMIT;");
-	if (err) return err;
+		done += chunk;
+	}
 
-	return SQLITE_OK;
+	return TRUE;
 }
 
 /**
- * Call with the number of runs that have been completed.
+ * Split runs "first" to "last" between num_workers processes and add up
+ * their results.
+ *
+ * All of the level generation state is global, so each worker is a forked
+ * process with its own copy of it; the workers share nothing, and only
+ * their counts come back, through a file each.
  */
+static void stats_run_workers(u32b first, u32b last_run, time_t start)
+{
+	pid_t pid[MAX_STATS_WORKERS];
+	char path[1024];
+	u32b share;
+	int w, workers = num_workers;
 
-#define STATS_PROGRESS_BAR_LEN 30
+	/* No idle workers */
+	if ((u32b) workers > last_run - first + 1)
+		workers = last_run - first + 1;
+	share = (last_run - first + 1) / workers;
 
-void progress_bar(u32b run, time_t start) {
-	u32b i;
-	u32b n = (run * STATS_PROGRESS_BAR_LEN) / num_runs;
-	u32b p10 = ((long long)run * 1000) / num_runs;
+	/* Don't duplicate buffered output in every worker */
+	fflush(stdout);
 
-	time_t delta = time(NULL) - start;
-	u32b togo = num_runs - run;
-	u32b expect = delta ? ((long long)delta * (long long)togo) / run 
-		: 0;
+	for (w = 0; w < workers; w++) {
+		u32b last = (w == workers - 1) ? last_run : first + share - 1;
 
-	int h = expect / 3600;
-	int m = (expect % 3600) / 60;
-	int s = expect % 60;
+		pid[w] = fork();
+		if (pid[w] < 0)
+			quit("Couldn't start a stats worker!");
 
-	printf("\r|");
-	for (i = 0; i < n; i++) printf("*");
-	for (i = 0; i < STATS_PROGRESS_BAR_LEN - n; i++) printf(" ");
-	printf("| %d/%d (%5.1f%%) %3d:%02d:%02d ", run, num_runs, p10/10.0, h, m, s);
-	fflush(stdout);
-}
+		if (!pid[w]) {
+			ang_file *f;
 
-/**
- * Clean up memory after each run. Should only affect character and
- * dungeon structs allocated during normal initialization, not persistent 
- * data like *_info.
- */
+			stats_worker = w;
+			stats_do_runs(first, last, start);
 
-static void stats_cleanup_angband_run(void)
-{
-	if (p_ptr->history) FREE(p_ptr->history);
+			/* Hand back the counts; the database belongs to the parent */
+			stats_worker_path(path, sizeof(path), w);
+			f = file_open(path, MODE_WRITE, FTYPE_RAW);
+			if (!f || !stats_counts_io(f, FALSE))
+				_exit(1);
+			file_close(f);
+			_exit(0);
+		}
+
+		first = last + 1;
+	}
+
+	/* Merge the results */
+	for (w = 0; w < workers; w++) {
+		int status;
+		ang_file *f;
+
+		if ((waitpid(pid[w], &status, 0) < 0) || !WIFEXITED(status) ||
+			WEXITSTATUS(status))
+			quit_fmt("Stats worker %d failed!", w);
+
+		stats_worker_path(path, sizeof(path), w);
+		f = file_open(path, MODE_READ, FTYPE_RAW);
+		if (!f || !stats_counts_io(f, TRUE))
+			quit_fmt("Couldn't read the results of stats worker %d!", w);
+		file_close(f);
+		file_delete(path);
+	}
 }
 
+#endif /* SET_UID */
+
 static errr run_stats(void)
 {
-	u32b run;
-	artifact_type *a_info_save;
-	unsigned int i;
 	int err;
-	bool status; 
-
+	u32b first, last;
 	time_t start;
 
+	if (!seed_base) seed_base = (u32b) time(NULL);
+
 	prep_output_dir();
+	prep_stage_map();
 	create_indices();
 	alloc_memory();
-	if (randarts)
-	{
-		a_info_save = mem_zalloc(z_info->a_max * sizeof(artifact_type));
-		for (i = 0; i < z_info->a_max; i++)
-		{
-			if (!a_info[i].name) continue;
-
-			memcpy(&a_info_save[i], &a_info[i], sizeof(artifact_type));
-		}
-	}
+	vinfo_init();
 
 	if (!quiet) printf("Creating the database and dumping info...\n");
-	status = stats_prep_db();
-	if (!status) quit("Couldn't prepare database!");
+	if (!stats_prep_db()) quit("Couldn't prepare database!");
 
 	if (!quiet) {
 		printf("Beginning %d runs...\n", num_runs);
 		fflush(stdout);
 	}
 
+	/* Write the counts out after every batch, so they never pile up */
 	start = time(NULL);
-	for (run = 1; run <= num_runs; run++)
+	for (first = 1; first <= num_runs; first = last + 1)
 	{
-		if (!quiet) progress_bar(run - 1, start);
-
-		if (randarts)
-		{
-			for (i = 0; i < z_info->a_max; i++)
-			{
-				memcpy(&a_info[i], &a_info_save[i], sizeof(artifact_type));
-			}
-		}
+		last = (num_runs - first < batch_runs) ? num_runs :
+			first + batch_runs - 1;
 
-		initialize_character();
-		unkill_uniques();
-		reset_artifacts();
-		descend_dungeon();
-		stats_cleanup_angband_run();
+#ifdef SET_UID
+		if (num_workers > 1)
+			stats_run_workers(first, last, start);
+		else
+#endif
+			stats_do_runs(first, last, start);
 
-		/* Checkpoint every so many runs */
-		if (run % RUNS_PER_CHECKPOINT == 0)
+		err = stats_write_db(last);
+		if (err)
 		{
-			err = stats_write_db(run);
-			if (err)
-			{
-				stats_db_close();
-				quit_fmt("Problems writing to database!  sqlite3 errno %d.", err);
-			}
-		}
-
-		if (quiet && run % 1000 == 0) {
-			printf("Finished %d runs.\n", run);
-			fflush(stdout);
+			stats_db_close();
+			quit_fmt("Problems writing to database!  sqlite3 errno %d.", err);
 		}
 	}
 
 	if (!quiet) {
 		progress_bar(num_runs, start);
-		printf("\nSaving the data...\n");
+		printf("\n");
 		fflush(stdout);
 	}
 
-	err = stats_write_db(run);
 	stats_db_close();
-	if (err) quit_fmt("Problems writing to database!  sqlite3 errno %d.", err);
 	free_stats_memory();
 	cleanup_angband();
 	if (!quiet) printf("Done!\n");
@@ -1704,6 +1639,11 @@ static errr term_xtra_alive(int v) {
 }
 
 static errr term_xtra_event(int v) {
+	/* Let the splash screen go by until the game data is loaded */
+	if (!init_done) {
+		Term_keypress(ESCAPE, 0);
+		return 0;
+	}
 	if (nextkey) {
 		Term_keypress(nextkey, 0);
 		nextkey = 0;
@@ -1786,17 +1726,26 @@ static void term_data_link(int i) {
 	angband_term[i] = t;
 }
 
-const char help_stats[] = "Stats mode, subopts -q(uiet) -r(andarts) -n(# of runs) -s(no selling)";
+static void stats_leave_init(game_event_type type, game_event_data *data,
+	void *user)
+{
+	init_done = TRUE;
+}
+
+const char help_stats[] = "Stats mode, subopts -q(uiet) -n(# of runs) -b(# of runs per batch) -s(no selling) -j(# of workers) -x(seed)";
 
 /*
  * Usage:
  *
- * angband -mstats -- [-q] [-r] [-nNNNN] [-s]
+ * faangband -mstats -- [-q] [-nNNNN] [-bNNNN] [-s] [-jNN] [-xNNNN]
  *
  *   -q      Quiet mode (turn off progress messages)
- *   -r      Turn on randarts
  *   -nNNNN  Make NNNN runs through the dungeon (default: 1)
+ *   -bNNNN  Write the counts to the database every NNNN runs
+ *           (default: 10000)
  *   -s      Turn on no-selling
+ *   -jNN    Share the runs between NN worker processes (default: 1)
+ *   -xNNNN  Seed run N with NNNN + N (default: the time)
  */
 
 errr init_stats(int argc, char *argv[]) {
@@ -1804,26 +1753,40 @@ errr init_stats(int argc, char *argv[]) {
 
 	/* Skip over argv[0] */
 	for (i = 1; i < argc; i++) {
-		if (streq(argv[i], "-r")) {
-			randarts = 1;
-			continue;
-		}
 		if (streq(argv[i], "-q")) {
 			quiet = TRUE;
 			continue;
 		}
 		if (prefix(argv[i], "-n")) {
 			num_runs = atoi(&argv[i][2]);
+			if (num_runs < 1) num_runs = 1;
+			continue;
+		}
+		if (prefix(argv[i], "-b")) {
+			batch_runs = atoi(&argv[i][2]);
+			if (batch_runs < 1) batch_runs = 1;
 			continue;
 		}
 		if (prefix(argv[i], "-s")) {
 			no_selling = 1;
 			continue;
 		}
+		if (prefix(argv[i], "-j")) {
+			num_workers = atoi(&argv[i][2]);
+			if (num_workers < 1) num_workers = 1;
+			if (num_workers > MAX_STATS_WORKERS)
+				num_workers = MAX_STATS_WORKERS;
+			continue;
+		}
+		if (prefix(argv[i], "-x")) {
+			seed_base = strtoul(&argv[i][2], NULL, 10);
+			continue;
+		}
 		printf("init-stats: bad argument '%s'\n", argv[i]);
 	}
 
 	term_data_link(0);
+	event_add_handler(EVENT_LEAVE_INIT, stats_leave_init, NULL);
 	return 0;
 }
 
@@ -26,6 +26,10 @@ static int prompt = 0;
 static int verbose = 0;
 static int nextkey = 0;
 
+/* Replaying a recording, and when it started */
+static int replay = 0;
+static clock_t replay_start;
+
 static void c_key(char *rest) {
 	if (!strcmp(rest, "left")) {
 		nextkey = ARROW_LEFT;
@@ -73,9 +77,7 @@ static void c_player_birth(char *rest) {
 	char *sex = strtok(rest, " ");
 	char *race = strtok(NULL, " ");
 	char *class = strtok(NULL, " ");
-	int i;
-	struct player_class *c;
-	struct player_race *r;
+	int i, r, c;
 
 	if (!sex) sex = "Female";
 	if (!race) race = "Human";
@@ -93,36 +95,38 @@ static void c_player_birth(char *rest) {
 		return;
 	}
 
-	for (r = races; r; r = r->next)
-		if (!strcmp(race, r->name))
+	for (r = 0; r < z_info->p_max; r++)
+		if (p_info[r].name && !strcmp(race, p_info[r].name))
 			break;
-	if (!r) {
+	if (r == z_info->p_max) {
 		printf("player-birth: bad race '%s'\n", race);
 		return;
 	}
 
-	for (c = classes; c; c = c->next)
-		if (!strcmp(class, c->name))
+	for (c = 0; c < z_info->c_max; c++)
+		if (c_info[c].name && !strcmp(class, c_info[c].name))
 			break;
 
-	if (!c) {
+	if (c == z_info->c_max) {
 		printf("player-birth: bad class '%s'\n", class);
 		return;
 	}
 
-	player_generate(p_ptr, NULL, r, c);
+	p_ptr->prace = r;
+	p_ptr->pclass = c;
+	player_generate(p_ptr, NULL, NULL, NULL);
 }
 
 static void c_player_class(char *rest) {
-	printf("player-class: %s\n", p_ptr->class->name);
+	printf("player-class: %s\n", cp_ptr->name);
 }
 
 static void c_player_race(char *rest) {
-	printf("player-race: %s\n", p_ptr->race->name);
+	printf("player-race: %s\n", rp_ptr->name);
 }
 
 static void c_player_sex(char *rest) {
-	printf("player-sex: %s\n", p_ptr->sex->title);
+	printf("player-sex: %s\n", sp_ptr->title);
 }
 
 typedef struct {
@@ -197,6 +201,16 @@ static void term_init_test(term *t) {
 
 static void term_nuke_test(term *t) {
 	if (verbose) printf("term-end\n");
+
+	if (replay) {
+		u32b commands, desyncs;
+
+		cmd_replay_stats(&commands, &desyncs);
+		printf("replay: %lu commands (%lu out of step) to turn %ld "
+			"in %.3f seconds\n", (unsigned long)commands,
+			(unsigned long)desyncs, (long)turn,
+			(double)(clock() - replay_start) / CLOCKS_PER_SEC);
+	}
 }
 
 static errr term_xtra_clear(int v) {
@@ -226,6 +240,13 @@ static errr term_xtra_alive(int v) {
 
 static errr term_xtra_event(int v) {
 	if (verbose) printf("term-xtra-event %d\n", v);
+
+	/* The replay feeds the game; only the splash screen waits on us */
+	if (replay) {
+		if (v) Term_keypress(ESCAPE, 0);
+		return 0;
+	}
+
 	if (nextkey) {
 		Term_keypress(nextkey, 0);
 		nextkey = 0;
@@ -311,7 +332,7 @@ static void term_data_link(int i) {
 	angband_term[i] = t;
 }
 
-const char help_test[] = "Test mode, subopts -p(rompt)";
+const char help_test[] = "Test mode, subopts -p(rompt) -r<file> (replay)";
 
 errr init_test(int argc, char *argv[]) {
 	int i;
@@ -322,6 +343,15 @@ errr init_test(int argc, char *argv[]) {
 			prompt = 1;
 			continue;
 		}
+		if (!strncmp(argv[i], "-r", 2)) {
+			if (!cmd_replay_open(argv[i] + 2)) {
+				printf("init-test: cannot replay '%s'\n", argv[i] + 2);
+				return 1;
+			}
+			replay = 1;
+			replay_start = clock();
+			continue;
+		}
 		printf("init-test: bad argument '%s'\n", argv[i]);
 	}
 
@@ -257,6 +257,7 @@ int main(int argc, char *argv[])
 
 	const char *mstr = NULL;
 	const char *soundstr = NULL;
+	const char *recordstr = NULL;
 
 	bool args = TRUE;
 
@@ -343,6 +344,11 @@ int main(int argc, char *argv[])
 				debug_opt(arg);
 				continue;
 
+			case 'c':
+				if (!*arg) goto usage;
+				recordstr = arg;
+				continue;
+
 			case '-':
 				argv[i] = argv[0];
 				argc = argc - i;
@@ -360,6 +366,7 @@ int main(int argc, char *argv[])
 				puts("  -x<opt>        Debug options; see -xhelp");
 				puts("  -u<who>        Use your <who> savefile");
 				puts("  -d<path>       Store pref files and screendumps in <path>");
+				puts("  -c<file>       Record the game's commands to <file>");
 				puts("  -s<mod>        Use sound module <sys>:");
 				for (i = 0; i < (int)N_ELEMENTS(sound_modules); i++)
 					printf("     %s   %s\n", sound_modules[i].name,
@@ -446,6 +453,10 @@ int main(int argc, char *argv[])
 	/* Set up the command hook */
 	cmd_get_hook = default_get_cmd;
 
+	/* Record the commands if asked */
+	if (recordstr && !cmd_record_open(recordstr))
+		quit("Cannot open the file to record commands to");
+
 	/* Set up the display handlers and things. */
 	init_display();
 
@@ -134,8 +134,7 @@ static void find_range(monster_type * m_ptr)
 	    m_ptr->best_range += 3;
 
 	/* Breathers like point blank range */
-	if ((flags_test
-	     (r_ptr->spell_flags, RSF_SIZE, RSF_BREATH_MASK, FLAG_END))
+	if (rsf_is_inter(r_ptr->spell_flags, rsf_breath_mask)
 	    && (m_ptr->best_range < 6) && (m_ptr->hp > m_ptr->maxhp / 2))
 	    m_ptr->best_range = 6;
     }
@@ -185,7 +184,7 @@ static byte side_dirs[20][8] = {
 int get_scent(int y, int x)
 {
     int age;
-    int scent;
+    s32b scent;
 
     /* Check Bounds */
     if (!(in_bounds(y, x)))
@@ -198,8 +197,12 @@ int get_scent(int y, int x)
     if (!scent)
 	return (-1);
 
+    /* Scent which was too old when the age marker last looped has gone */
+    if (scent_loop - scent > SMELL_STRENGTH)
+	return (-1);
+
     /* Get age of scent */
-    age = scent - scent_when;
+    age = scent_turn - scent;
 
     /* Return the age of the scent */
     return (age);
@@ -971,7 +974,7 @@ int choose_ranged_attack(int m_idx, bool archery_only, int shape_rate)
 	    return (0);
 
 	/* restrict to archery */
-	flags_mask(mon_spells, RSF_SIZE, RSF_ARCHERY_MASK, FLAG_END);
+	rsf_inter(mon_spells, rsf_archery_mask);
 
 	/* choose at random from restricted list */
 	return (choose_attack_spell_fast(m_idx, TRUE));
@@ -980,9 +983,9 @@ int choose_ranged_attack(int m_idx, bool archery_only, int shape_rate)
     /* Remove spells the 'no-brainers' */
     /* Spells that require LOS */
     if (!los) {
-	flags_mask(mon_spells, RSF_SIZE, RSF_NO_PLAYER_MASK, FLAG_END);
+	rsf_inter(mon_spells, rsf_no_player_mask);
     } else if (path == PROJECT_NOT_CLEAR) {
-	flags_clear(mon_spells, RSF_SIZE, RSF_BOLT_MASK, FLAG_END);
+	rsf_diff(mon_spells, rsf_bolt_mask);
     }
 
     /* No spells left */
@@ -1072,19 +1075,15 @@ int choose_ranged_attack(int m_idx, bool archery_only, int shape_rate)
 
     /* Now check every remaining spell */
     for (i = FLAG_START; i < RSF_MAX; i++) {
-	bitflag temp[RSF_SIZE];
-
 	/* Do we even have this spell? */
 	if (!rsf_has(mon_spells, i))
 	    continue;
 
 	/* Is it a breath? */
-	flags_init(temp, RSF_SIZE, RSF_BREATH_MASK, FLAG_END);
-	is_breath = rsf_has(temp, i);
+	is_breath = rsf_has(rsf_breath_mask, i);
 
 	/* Is it a harassing spell? */
-	flags_init(temp, RSF_SIZE, RSF_HARASS_MASK, FLAG_END);
-	is_harass = rsf_has(temp, i);
+	is_harass = rsf_has(rsf_harass_mask, i);
 
 	/* Base Desirability */
 	cur_spell_rating = spell_desire[i][D_RES];
@@ -1609,19 +1608,48 @@ static int cave_passable_mon(monster_type *m_ptr, int y, int x, bool *bash)
 }
 
 
+/**
+ * Which flow layer a monster follows when it advances (see "FLOW_*").
+ */
+static int monster_flow_layer(monster_race *r_ptr)
+{
+    /* Rock is no obstacle */
+    if ((rf_has(r_ptr->flags, RF_PASS_WALL))
+	|| (rf_has(r_ptr->flags, RF_KILL_WALL)))
+	return (FLOW_WALL);
+
+    /* Flying monsters can always cross water */
+    if (rf_has(r_ptr->flags, RF_FLYING))
+	return (FLOW_NOISE);
+
+    /* Earthbound demons, firebreathers and "red" elementals cannot */
+    if ((rsf_has(r_ptr->flags, RSF_BRTH_FIRE))
+	|| (strchr("uU", r_ptr->d_char))
+	|| ((strchr("E", r_ptr->d_char))
+	    && ((r_ptr->d_attr == TERM_RED)
+		|| (r_ptr->d_attr == TERM_L_RED))))
+	return (FLOW_DRY);
+
+    return (FLOW_NOISE);
+}
+
+
 /**
  * Helper function for monsters that want to advance toward the character.
  * Assumes that the monster isn't frightened, and is not in LOS of the 
  * character.
  *
- * Ghosts and rock-eaters do not use flow information, because they 
- * can - in general - move directly towards the character.  We could make 
- * them look for a grid at their preferred range, but the character 
- * would then be able to avoid them better (it might also be a little 
- * hard on those poor warriors...).
+ * Ghosts and rock-eaters can - in general - move directly towards the 
+ * character, so they only use their own flow information (which goes 
+ * through anything but permanent walls) to find their way round vaults.  
+ * We could make them look for a grid at their preferred range, but the 
+ * character would then be able to avoid them better (it might also be a 
+ * little hard on those poor warriors...).
  *
  * Other monsters will use target information, then their ears, then their
- * noses (if they can), and advance blindly if nothing else works.
+ * noses (if they can), and advance blindly if nothing else works.  
+ * Monsters which cannot cross water follow their own flow information 
+ * where it reaches them, and the sound of the character otherwise.
  * 
  * When flowing, monsters prefer non-diagonal directions.
  *
@@ -1643,36 +1671,48 @@ static void get_move_advance(monster_type * m_ptr, int *ty, int *tx)
     bool use_scent = FALSE;
 
     monster_race *r_ptr = &r_info[m_ptr->r_idx];
+    int layer = monster_flow_layer(r_ptr);
+
+    /* Monster location */
+    y1 = m_ptr->fy;
+    x1 = m_ptr->fx;
 
     /* Monster can go through rocks - head straight for target */
-    if ((rf_has(r_ptr->flags, RF_PASS_WALL))
-	|| (rf_has(r_ptr->flags, RF_KILL_WALL))) {
+    if (layer == FLOW_WALL) {
+	/* Player is the target, and within reach of our flow */
+	if ((m_ptr->hostile < 0) && flow_cost(FLOW_WALL, y1, x1)) {
+	    use_psound = TRUE;
+	}
+
 	/* Player is the target */
-	if (m_ptr->hostile < 0) {
+	else if (m_ptr->hostile < 0) {
 	    *ty = py;
 	    *tx = px;
+	    return;
 	}
 	/* Another monster is the target */
-	else if (m_ptr->hostile > 0) {
-	    *ty = m_list[m_ptr->hostile].fy;
-	    *tx = m_list[m_ptr->hostile].fx;
+	else {
+	    if (m_ptr->hostile > 0) {
+		*ty = m_list[m_ptr->hostile].fy;
+		*tx = m_list[m_ptr->hostile].fx;
+	    }
+	    return;
 	}
-	return;
     }
 
-    /* Monster location */
-    y1 = m_ptr->fy;
-    x1 = m_ptr->fx;
-
     /* Use target information if available */
-    if ((m_ptr->ty) && (m_ptr->tx)) {
+    else if ((m_ptr->ty) && (m_ptr->tx)) {
 	*ty = m_ptr->ty;
 	*tx = m_ptr->tx;
 	return;
     }
 
     /* If we can hear noises, advance towards them */
-    if (cave_cost[y1][x1]) {
+    else if ((layer != FLOW_NOISE) && flow_cost(layer, y1, x1)) {
+	use_psound = TRUE;
+    }
+    else if (cave_cost[y1][x1]) {
+	layer = FLOW_NOISE;
 	use_psound = TRUE;
     }
 
@@ -1720,7 +1760,7 @@ static void get_move_advance(monster_type * m_ptr, int *ty, int *tx)
 
 	/* We're using sound */
 	else {
-	    int cost = cave_cost[y][x];
+	    int cost = flow_cost(layer, y, x);
 
 	    /* Accept louder sounds */
 	    if ((cost == 0) || (lowest_cost < cost))
@@ -2414,7 +2454,7 @@ static bool get_move(monster_type * m_ptr, int *ty, int *tx, bool * fear,
 	    /* Character is insufficiently vulnerable */
 	    if (p_ptr->vulnerability <= 4) {
 		/* If we're in sight, find a hiding place */
-		if (cave_has(cave_info[m_ptr->fy][m_ptr->fx], CAVE_SEEN)) {
+		if (cave_has(m_ptr->fy, m_ptr->fx, CAVE_SEEN)) {
 		    /* Find a safe spot to lurk in */
 		    if (get_move_retreat(m_ptr, ty, tx)) {
 			*fear = TRUE;
@@ -2738,7 +2778,7 @@ static void make_confused_move(monster_type * m_ptr, int y, int x)
     f_ptr = &f_info[feat];
 
     /* Check visibility */
-    if ((m_ptr->ml) && cave_has(cave_info[y][x], CAVE_SEEN))
+    if ((m_ptr->ml) && cave_has(y, x, CAVE_SEEN))
 	seen = TRUE;
 
 
@@ -3096,9 +3136,9 @@ static bool make_move(monster_type * m_ptr, int *ty, int *tx, bool fear,
 		}
 
 		/* Monster can't be seen, and is not in a "seen" grid. */
-		if ((!m_ptr->ml) && (!cave_has(cave_info[oy][ox], CAVE_SEEN))) {
+		if ((!m_ptr->ml) && (!cave_has(oy, ox, CAVE_SEEN))) {
 		    /* Do not enter a "seen" grid */
-		    if (cave_has(cave_info[ny][nx], CAVE_SEEN)) {
+		    if (cave_has(ny, nx, CAVE_SEEN)) {
 			moves_data[i].move_chance = 0;
 			continue;
 		    }
@@ -3615,7 +3655,7 @@ static void apply_monster_trap(monster_type * m_ptr, int y, int x, bool * death)
 		    continue;
 
 		/* Ignore monsters in icky squares */
-		if (cave_has(cave_info[n_ptr->fy][n_ptr->fx], CAVE_ICKY))
+		if (cave_has(n_ptr->fy, n_ptr->fx, CAVE_ICKY))
 		    continue;
 
 		/* Ignore monsters too far away */
@@ -3782,13 +3822,13 @@ static void process_move(monster_type * m_ptr, int ty, int tx, bool bash)
     if (cave_trap_specific(ny, nx, RUNE_PROTECT)) 
     {
 	/* Describe observable breakage */
-	if (cave_has(cave_info[ny][nx], CAVE_MARK)) 
+	if (cave_has(ny, nx, CAVE_MARK)) 
 	{
 	    msg("The rune of protection is broken!");
 	}
 
 	/* Forget the rune */
-	cave_off(cave_info[ny][nx], CAVE_MARK);
+	cave_off(ny, nx, CAVE_MARK);
 
 	/* Break the rune */
 	remove_trap_kind(ny, nx, FALSE, RUNE_PROTECT);
@@ -3816,7 +3856,7 @@ static void process_move(monster_type * m_ptr, int ty, int tx, bool bash)
 	    did_kill_wall = TRUE;
 
 	    /* Forget the wall */
-	    cave_off(cave_info[ny][nx], CAVE_MARK);
+	    cave_off(ny, nx, CAVE_MARK);
 
 	    /* Notice */
 	    if (outside)
@@ -3825,7 +3865,7 @@ static void process_move(monster_type * m_ptr, int ty, int tx, bool bash)
 		cave_set_feat(ny, nx, FEAT_FLOOR);
 
 	    /* Note changes to grid - but only if actually seen */
-	    if (cave_has(cave_info[ny][nx], CAVE_SEEN))
+	    if (cave_has(ny, nx, CAVE_SEEN))
 		do_view = TRUE;
 	}
 
@@ -3855,7 +3895,7 @@ static void process_move(monster_type * m_ptr, int ty, int tx, bool bash)
 		    cave_set_feat(ny, nx, FEAT_OPEN);
 
 		/* Handle viewable doors */
-		if (cave_has(cave_info[ny][nx], CAVE_SEEN)) 
+		if (cave_has(ny, nx, CAVE_SEEN)) 
 		    do_view = TRUE;
 		
 		/* Disturb */
@@ -3977,7 +4017,7 @@ static void process_move(monster_type * m_ptr, int ty, int tx, bool bash)
 		    did_kill_wall = TRUE;
 
 		    /* Forget the wall */
-		    cave_off(cave_info[yy][xx], CAVE_MARK);
+		    cave_off(yy, xx, CAVE_MARK);
 
 		    /* Notice */
 		    if (outside)
@@ -3986,7 +4026,7 @@ static void process_move(monster_type * m_ptr, int ty, int tx, bool bash)
 			cave_set_feat(yy, xx, FEAT_FLOOR);
 
 		    /* Note changes to grid - but only if actually seen */
-		    if (cave_has(cave_info[yy][xx], CAVE_SEEN))
+		    if (cave_has(yy, xx, CAVE_SEEN))
 			do_view = TRUE;
 		}
 
@@ -4291,6 +4331,7 @@ static void process_monster(monster_type * m_ptr)
     monster_race *r_ptr = &r_info[m_ptr->r_idx];
     monster_lore *l_ptr = &l_list[m_ptr->r_idx];
 
+    int m_idx = m_ptr - m_list;
     int i, k, y, x;
     int ty, tx;
     int chance = 0;
@@ -4334,7 +4375,7 @@ static void process_monster(monster_type * m_ptr)
 	}
 
 	/* Add the energy */
-	m_ptr->energy += (5 - i);
+	mon_energy[m_idx] += (5 - i);
 
 	/* If target is too far away from home, go back */
 	if (distance(m_ptr->y_terr, m_ptr->x_terr, m_ptr->ty, m_ptr->tx) >
@@ -4354,7 +4395,7 @@ static void process_monster(monster_type * m_ptr)
 	if ((m_ptr->cdis >= FLEE_RANGE) && (m_ptr->cdis > scan_range)
 	    && (!m_ptr->ty) && (!m_ptr->tx)) {
 	    /* Monster cannot smell the character */
-	    if (!cave_when[m_ptr->fy][m_ptr->fx])
+	    if (get_scent(m_ptr->fy, m_ptr->fx) == -1)
 		m_ptr->mflag &= ~(MFLAG_ACTV);
 	    else if (!monster_can_smell(m_ptr))
 		m_ptr->mflag &= ~(MFLAG_ACTV);
@@ -4372,7 +4413,7 @@ static void process_monster(monster_type * m_ptr)
 	    m_ptr->mflag |= (MFLAG_ACTV);
 
 	/* The monster is catching too much of a whiff to ignore */
-	else if (cave_when[m_ptr->fy][m_ptr->fx]) {
+	else if (get_scent(m_ptr->fy, m_ptr->fx) != -1) {
 	    if (monster_can_smell(m_ptr))
 		m_ptr->mflag |= (MFLAG_ACTV);
 	}
@@ -4680,8 +4721,9 @@ static void process_monster(monster_type * m_ptr)
  *
  * This function is called a lot, and is therefore fairly expensive.
  */
-static void recover_monster(monster_type * m_ptr, bool regen)
+static void recover_monster(int m_idx, bool regen)
 {
+    monster_type *m_ptr = &m_list[m_idx];
     monster_race *r_ptr = &r_info[m_ptr->r_idx];
     monster_lore *l_ptr = &l_list[m_ptr->r_idx];
 
@@ -4723,8 +4765,8 @@ static void recover_monster(monster_type * m_ptr, bool regen)
 	    return;
 
 	/* Monster gets its bearings */
-	else if (m_ptr->energy > p_ptr->energy)
-	    m_ptr->energy = p_ptr->energy;
+	else if (mon_energy[m_idx] > p_ptr->energy)
+	    mon_energy[m_idx] = p_ptr->energy;
     }
 
 
@@ -4859,8 +4901,8 @@ static void recover_monster(monster_type * m_ptr, bool regen)
 		}
 
 		/* Monster gets its bearings */
-		if (m_ptr->energy > p_ptr->energy)
-		    m_ptr->energy = p_ptr->energy;
+		if (mon_energy[m_idx] > p_ptr->energy)
+		    mon_energy[m_idx] = p_ptr->energy;
 	    }
 	}
     }
@@ -4907,8 +4949,8 @@ static void recover_monster(monster_type * m_ptr, bool regen)
 		}
 
 		/* Monster gets its bearings */
-		if (m_ptr->energy > p_ptr->energy)
-		    m_ptr->energy = p_ptr->energy;
+		if (mon_energy[m_idx] > p_ptr->energy)
+		    mon_energy[m_idx] = p_ptr->energy;
 	    }
 	}
     }
@@ -5119,7 +5161,7 @@ static void recover_monster(monster_type * m_ptr, bool regen)
  */
 void process_monsters(byte minimum_energy)
 {
-    int i;
+    int i, n;
     monster_type *m_ptr;
 
     /* Only process some things every so often */
@@ -5135,43 +5177,47 @@ void process_monsters(byte minimum_energy)
 	    regen = TRUE;
     }
 
-    /* Process the monsters (backwards) */
-    for (i = m_max - 1; i >= 1; i--) {
+    /* 
+     * Process the live monsters (backwards).  Monsters may be born or die
+     * during the pass, so if the current one has moved in the list the
+     * next one is found afresh as the highest live index below it.
+     */
+    for (n = mon_active_n - 1; n >= 0;
+	 n = (((n < mon_active_n) && (mon_active[n] == i)) ? n :
+	      mon_active_find(i)) - 1) {
 	/* Player is dead or leaving the current level */
 	if (p_ptr->leaving)
 	    break;
 
-	/* Access the monster */
-	m_ptr = &m_list[i];
-
-	/* Ignore dead monsters */
-	if (!m_ptr->r_idx)
-	    continue;
+	i = mon_active[n];
 
 	/* Ignore monsters that have already been handled */
-	if (m_ptr->moved)
+	if (mon_moved[i])
 	    continue;
 
 	/* Leave monsters without enough energy for later */
-	if (m_ptr->energy < minimum_energy)
+	if (mon_energy[i] < minimum_energy)
 	    continue;
 
 	/* Prevent reprocessing */
-	m_ptr->moved = TRUE;
+	mon_moved[i] = TRUE;
+
+	/* Access the monster */
+	m_ptr = &m_list[i];
 
 	/* Handle temporary monster attributes every ten game turns */
 	if (recover)
-	    recover_monster(m_ptr, regen);
+	    recover_monster(i, regen);
 
 	/* Give this monster some energy */
-	m_ptr->energy += extract_energy[m_ptr->mspeed];
+	mon_energy[i] += extract_energy[m_ptr->mspeed];
 
 	/* End the turn of monsters without enough energy to move */
-	if (m_ptr->energy < 100)
+	if (mon_energy[i] < 100)
 	    continue;
 
 	/* Use up some energy */
-	m_ptr->energy -= 100;
+	mon_energy[i] -= 100;
 
 	/* Let the monster take its turn */
 	process_monster(m_ptr);
@@ -5186,17 +5232,9 @@ void process_monsters(byte minimum_energy)
  */
 void reset_monsters(void)
 {
-    int i;
-    monster_type *m_ptr;
-
-    /* Process the monsters (backwards) */
-    for (i = m_max - 1; i >= 1; i--) {
-	/* Access the monster */
-	m_ptr = &m_list[i];
+    /* Monsters are ready to go again */
+    C_WIPE(mon_moved, m_max, bool);
 
-	/* Monster is ready to go again */
-	m_ptr->moved = FALSE;
-    }
     /* Clear the current noise after it is used to wake up monsters */ 
     if (turn % 10 == 0) {
 	total_wakeup_chance = 0L;
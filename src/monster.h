@@ -14,12 +14,14 @@ extern bool prepare_ghost(int r_idx, monster_type *m_ptr, bool from_savefile);
 /* monster2.c */
 extern void monster_death(int m_idx);
 extern bool mon_take_hit(int m_idx, int dam, bool *fear, const char *note);
+extern int mon_active_find(int m_idx);
 extern void delete_monster_idx(int i);
 extern void delete_monster(int y, int x);
 extern void compact_monsters(int size);
 extern void wipe_m_list(void);
 extern s16b m_pop(void);
 extern errr get_mon_num_prep(void);
+extern void get_mon_num_forget(void);
 extern s16b get_mon_num(int level);
 extern s16b get_mon_num_quick(int level);
 extern void display_monlist(void);
@@ -30,6 +32,7 @@ extern void lore_do_probe(int m_idx);
 extern void lore_treasure(int m_idx, int num_item, int num_gold);
 extern void update_mon(int m_idx, bool full);
 extern void update_monsters(bool full);
+extern u32b update_mon_calls;
 extern s16b monster_carry(int m_idx, object_type *j_ptr);
 extern void monster_swap(int y1, int x1, int y2, int x2);
 extern s16b player_place(int y, int x);
@@ -1264,7 +1264,7 @@ extern void describe_monster(int r_idx, bool spoilers)
     m = vn;
 
     /* Summons are described somewhat differently. */
-    if (flags_test(mon_spells, RSF_SIZE, RSF_SUMMON_MASK, FLAG_END)) {
+    if (rsf_is_inter(mon_spells, rsf_summon_mask)) {
 	/* Summons */
 	if (rsf_has(mon_spells, RSF_S_KIN)) {
 	    if (rf_has(r_ptr->spell_flags, RF_UNIQUE))
@@ -30,6 +30,70 @@
 #include "trap.h"
 
 
+/**
+ * Find the position in the active monster list of the first live monster
+ * with an index of at least "m_idx" (mon_active_n if there is none).
+ */
+int mon_active_find(int m_idx)
+{
+    int lo = 0, hi = mon_active_n;
+
+    /* Binary search */
+    while (lo < hi) {
+	int mid = (lo + hi) / 2;
+
+	if (mon_active[mid] < m_idx)
+	    lo = mid + 1;
+	else
+	    hi = mid;
+    }
+
+    return (lo);
+}
+
+
+/**
+ * Add a monster to the active monster list, keeping it in order.
+ *
+ * New monsters almost always take the top index, so this is usually just
+ * an append.
+ */
+static void mon_active_add(int m_idx)
+{
+    int n = mon_active_find(m_idx);
+
+    /* Paranoia -- already there */
+    if ((n < mon_active_n) && (mon_active[n] == m_idx))
+	return;
+
+    /* Make room */
+    if (n < mon_active_n)
+	memmove(&mon_active[n + 1], &mon_active[n],
+		(mon_active_n - n) * sizeof(s16b));
+
+    mon_active[n] = m_idx;
+    mon_active_n++;
+}
+
+
+/**
+ * Remove a monster from the active monster list.
+ */
+static void mon_active_remove(int m_idx)
+{
+    int n = mon_active_find(m_idx);
+
+    /* Paranoia -- not there */
+    if ((n >= mon_active_n) || (mon_active[n] != m_idx))
+	return;
+
+    mon_active_n--;
+    if (n < mon_active_n)
+	memmove(&mon_active[n], &mon_active[n + 1],
+		(mon_active_n - n) * sizeof(s16b));
+}
+
+
 /**
  * Delete a monster by index.
  *
@@ -104,6 +168,11 @@ void delete_monster_idx(int i)
 
     /* Wipe the Monster */
     (void) WIPE(m_ptr, monster_type);
+    mon_energy[i] = 0;
+    mon_moved[i] = FALSE;
+
+    /* No longer active */
+    mon_active_remove(i);
 
     /* Count monsters */
     m_cnt--;
@@ -179,9 +248,17 @@ static void compact_monsters_aux(int i1, int i2)
 
     /* Hack -- move monster */
     (void) COPY(&m_list[i2], &m_list[i1], monster_type);
+    mon_energy[i2] = mon_energy[i1];
+    mon_moved[i2] = mon_moved[i1];
 
     /* Hack -- wipe hole */
     (void) WIPE(&m_list[i1], monster_type);
+    mon_energy[i1] = 0;
+    mon_moved[i1] = FALSE;
+
+    /* Update the active list */
+    mon_active_remove(i1);
+    mon_active_add(i2);
 }
 
 
@@ -329,6 +406,11 @@ void wipe_m_list(void)
     /* Hack - wipe the player */
     cave_m_idx[p_ptr->py][p_ptr->px] = 0;
 
+    /* Clear the scheduling state */
+    C_WIPE(mon_energy, m_max, byte);
+    C_WIPE(mon_moved, m_max, bool);
+    mon_active_n = 0;
+
     /* Reset "m_max" */
     m_max = 1;
 
@@ -434,6 +516,25 @@ errr get_mon_num_prep(void)
 
 
 
+/**
+ * Whether "alloc_race_pick" holds the running totals of the current 
+ * "prob3" values of the "monster allocation table".
+ */
+static bool race_pick_ready = FALSE;
+
+
+/**
+ * Note that the "prob3" values have been worked out afresh, so the running
+ * totals must be made again before "get_mon_num_quick()" next picks from
+ * them.  A single pick just scans the table; the running totals only pay
+ * for themselves over the repeated picks of "get_mon_num_quick()".
+ */
+void get_mon_num_forget(void)
+{
+    race_pick_ready = FALSE;
+}
+
+
 /**
  * Choose a monster race that seems "appropriate" to the given level
  *
@@ -623,6 +724,9 @@ s16b get_mon_num(int level)
 	    alloc_race_total += table[i].prob3;
 	}
 
+	/* The running totals are out of date */
+	get_mon_num_forget();
+
 	/* No legal monsters */
 	if (alloc_race_total == 0) {
 	    failure++;
@@ -676,7 +780,6 @@ s16b get_mon_num(int level)
 s16b get_mon_num_quick(int level)
 {
     int i;
-    long value;
     alloc_entry *table = alloc_race_table;
 
     /* 
@@ -686,20 +789,22 @@ s16b get_mon_num_quick(int level)
     if (!alloc_race_total)
 	return (get_mon_num(level));
 
+    /* Make the running totals, if they are out of date */
+    if (!race_pick_ready) {
+	u32b total = 0L;
 
-    /* Pick a monster */
-    value = randint0(alloc_race_total);
-
-    /* Find the monster */
-    for (i = 0; i < alloc_race_size; i++) {
-	/* Found the entry */
-	if (value < table[i].prob3)
-	    break;
+	for (i = 0; i < alloc_race_size; i++) {
+	    total += table[i].prob3;
+	    alloc_race_pick.sum[i] = total;
+	}
 
-	/* Decrement */
-	value = value - table[i].prob3;
+	rand_table_guide(&alloc_race_pick, alloc_race_size);
+	race_pick_ready = TRUE;
     }
 
+    /* Pick a monster */
+    i = rand_table_pick(&alloc_race_pick);
+
     /* Result */
     return (table[i].index);
 }
@@ -906,7 +1011,6 @@ void monster_desc(char *desc, size_t max, monster_type * m_ptr, int mode)
     monster_race *r_ptr = &r_info[m_ptr->r_idx];
 
     const char *name = r_ptr->name;
-    char undead_name[40] = "oops";
 
     bool seen, pron;
 
@@ -1037,6 +1141,10 @@ void monster_desc(char *desc, size_t max, monster_type * m_ptr, int mode)
     /* Handle all other visible monster requests */
     else {
 	const char *race_name = NULL;
+	strbuf sb;
+
+	/* Build the name straight into the buffer */
+	strbuf_init(&sb, desc, max);
 
 	/* Get a racial prefix if necessary */
 	if (m_ptr->p_race != NON_RACIAL)
@@ -1044,66 +1152,41 @@ void monster_desc(char *desc, size_t max, monster_type * m_ptr, int mode)
 
 	/* It could be a player ghost. */
 	if (rf_has(r_ptr->flags, RF_PLAYER_GHOST)) {
-	    /* Get the ghost name. */
-	    my_strcpy(desc, ghost_name, max);
-
-	    /* Get the undead name. */
-	    my_strcpy(undead_name, r_ptr->name, max);
-
-	    /* Build the ghost name. */
-	    my_strcat(desc, ", the ", max);
-	    my_strcat(desc, undead_name, max);
+	    /* The ghost name, then the undead name. */
+	    strbuf_puts(&sb, ghost_name);
+	    strbuf_puts(&sb, ", the ");
+	    strbuf_puts(&sb, r_ptr->name);
 	}
 
 	/* It could be a Unique */
 	else if (rf_has(r_ptr->flags, RF_UNIQUE)) {
 	    /* Start with the name (thus nominative and objective) */
-	    my_strcpy(desc, name, max);
-	}
-
-	/* It could be an indefinite monster */
-	else if (mode & 0x08) {
-	    bool vowel;
-	    char first[2];
-
-	    if (race_name)
-		vowel = is_a_vowel(race_name[0]);
-	    else
-		vowel = is_a_vowel(name[0]);
-
-	    /* XXX Check plurality for "some" */
-
-	    /* Indefinite monsters need an indefinite article */
-	    my_strcpy(desc, vowel ? "an " : "a ", max);
-
-	    /* Hack - no capital if there's a race name first */
-	    if (race_name) {
-		my_strcat(desc, race_name, max);
-		my_strcat(desc, " ", max);
-		first[0] = tolower(name[0]);
-		first[1] = '\0';
-		my_strcat(desc, first, max);
-		my_strcat(desc, name + 1, max);
-	    } else
-		my_strcat(desc, name, max);
+	    strbuf_puts(&sb, name);
 	}
 
-	/* It could be a normal, definite, monster */
+	/* It could be a monster needing an article */
 	else {
-	    char first[2];
+	    /* Indefinite monsters need an indefinite article */
+	    if (mode & 0x08) {
+		/* XXX Check plurality for "some" */
+		if (is_a_vowel(race_name ? race_name[0] : name[0]))
+		    strbuf_puts(&sb, "an ");
+		else
+		    strbuf_puts(&sb, "a ");
+	    }
 
 	    /* Definite monsters need a definite article */
-	    my_strcpy(desc, "the ", max);
+	    else
+		strbuf_puts(&sb, "the ");
+
 	    /* Hack - no capital if there's a race name first */
 	    if (race_name) {
-		my_strcat(desc, race_name, max);
-		my_strcat(desc, " ", max);
-		first[0] = tolower(name[0]);
-		first[1] = '\0';
-		my_strcat(desc, first, max);
-		my_strcat(desc, name + 1, max);
+		strbuf_puts(&sb, race_name);
+		strbuf_putc(&sb, ' ');
+		strbuf_putc(&sb, tolower((unsigned char) name[0]));
+		strbuf_puts(&sb, name + 1);
 	    } else
-		my_strcat(desc, name, max);
+		strbuf_puts(&sb, name);
 	}
 
 	/* Handle the Possessive as a special afterthought */
@@ -1111,13 +1194,13 @@ void monster_desc(char *desc, size_t max, monster_type * m_ptr, int mode)
 	    /* XXX Check for trailing "s" */
 
 	    /* Simply append "apostrophe" and "s" */
-	    my_strcat(desc, "'s", max);
+	    strbuf_puts(&sb, "'s");
 	}
 
 	/* Mention "offscreen" monsters XXX XXX */
 	if (!panel_contains(m_ptr->fy, m_ptr->fx)) {
 	    /* Append special notation */
-	    my_strcat(desc, " (offscreen)", max);
+	    strbuf_puts(&sb, " (offscreen)");
 	}
     }
     
@@ -1210,6 +1293,36 @@ void lore_treasure(int m_idx, int num_item, int num_gold)
 
 
 
+/**
+ * Number of calls to update_mon(), for the debug timing commands
+ */
+u32b update_mon_calls = 0;
+
+
+/**
+ * Work out (and save) the distance of a monster from the player, using an
+ * optimized "inline" version of the distance() function.
+ */
+static int update_mon_dist(monster_type * m_ptr)
+{
+    /* Distance components */
+    int dy = ABS(p_ptr->py - m_ptr->fy);
+    int dx = ABS(p_ptr->px - m_ptr->fx);
+
+    /* Approximate distance */
+    int d = (dy > dx) ? (dy + (dx >> 1)) : (dx + (dy >> 1));
+
+    /* Restrict distance */
+    if (d > 255)
+	d = 255;
+
+    /* Save the distance */
+    m_ptr->cdis = d;
+
+    return (d);
+}
+
+
 /**
  * This function updates the monster record of the given monster
  *
@@ -1250,7 +1363,8 @@ void lore_treasure(int m_idx, int num_item, int num_gold)
  * of the primary bottlenecks, along with update_view() and the
  * process_monsters() code, so efficiency is important.
  *
- * Note the optimized "inline" version of the distance() function.
+ * Note the optimized "inline" version of the distance() function, in
+ * update_mon_dist(), which update_monsters() shares.
  *
  * A monster is "visible" to the player if (1) it has been detected
  * by the player, (2) it is close to the player and the player has
@@ -1290,24 +1404,15 @@ void update_mon(int m_idx, bool full)
     bool easy = FALSE;
 
 
-    /* Compute distance */
-    if (full) {
-	int py = p_ptr->py;
-	int px = p_ptr->px;
+    /* Count calls */
+    update_mon_calls++;
 
-	/* Distance components */
-	int dy = (py > fy) ? (py - fy) : (fy - py);
-	int dx = (px > fx) ? (px - fx) : (fx - px);
+    /* Visibility is about to be checked */
+    m_ptr->mflag &= ~(MFLAG_DIRTY);
 
-	/* Approximate distance */
-	d = (dy > dx) ? (dy + (dx >> 1)) : (dx + (dy >> 1));
-
-	/* Restrict distance */
-	if (d > 255)
-	    d = 255;
-
-	/* Save the distance */
-	m_ptr->cdis = d;
+    /* Compute distance */
+    if (full) {
+	d = update_mon_dist(m_ptr);
     }
 
     /* Extract distance */
@@ -1503,22 +1608,70 @@ void update_mon(int m_idx, bool full)
 
 
 /**
- * This function simply updates all the (non-dead) monsters (see above).
+ * The player's senses as they were at the last update_monsters()
+ */
+static struct {
+    bool valid;
+    bool telepathy;
+    bool see_inv;
+    bool blind;
+    bool themed;
+    int see_infra;
+} mon_senses;
+
+/**
+ * This function updates all the (non-dead) monsters (see above).
+ *
+ * A monster which is not seen, not detected, out of telepathy range and
+ * not marked with MFLAG_DIRTY cannot have become visible, so update_mon()
+ * is skipped for it.  update_view() marks the monsters in any grid which
+ * enters or leaves the view, and a moving monster is updated as it moves.
+ * If the player's senses have changed every monster is updated.
  */
 void update_monsters(bool full)
 {
     int i;
 
+    bool esp = (p_ptr->state.telepathy || p_ptr->timed[TMD_TELEPATHY]);
+    bool blind = (p_ptr->timed[TMD_BLIND] ? TRUE : FALSE);
+    bool themed = (p_ptr->themed_level ? TRUE : FALSE);
+    int sight = (themed ? MAX_SIGHT / 2 : MAX_SIGHT);
+    bool all;
+
+    /* Notice changes to the player's senses */
+    all = (!mon_senses.valid || (mon_senses.telepathy != esp)
+	   || (mon_senses.see_inv != p_ptr->state.see_inv)
+	   || (mon_senses.blind != blind) || (mon_senses.themed != themed)
+	   || (mon_senses.see_infra != p_ptr->state.see_infra));
+
+    mon_senses.valid = TRUE;
+    mon_senses.telepathy = esp;
+    mon_senses.see_inv = p_ptr->state.see_inv;
+    mon_senses.blind = blind;
+    mon_senses.themed = themed;
+    mon_senses.see_infra = p_ptr->state.see_infra;
+
     /* Update each (live) monster */
-    for (i = 1; i < m_max; i++) {
-	monster_type *m_ptr = &m_list[i];
+    for (i = 0; i < mon_active_n; i++) {
+	int m_idx = mon_active[i];
+	monster_type *m_ptr = &m_list[m_idx];
 
 	/* Skip dead monsters */
 	if (!m_ptr->r_idx)
 	    continue;
 
+	/* Compute distance */
+	if (full)
+	    (void) update_mon_dist(m_ptr);
+
+	/* Nothing can have changed */
+	if (!all && !m_ptr->ml
+	    && !(m_ptr->mflag & (MFLAG_VIEW | MFLAG_MARK | MFLAG_DIRTY))
+	    && !(esp && (m_ptr->cdis <= sight)))
+	    continue;
+
 	/* Update the monster */
-	update_mon(i, full);
+	update_mon(m_idx, FALSE);
     }
 }
 
@@ -1614,7 +1767,7 @@ bool is_detected(int y, int x)
 	    continue;
 
 	/* Return false if undetected */
-	if (!cave_has(cave_info[yy][xx], CAVE_DTRAP))
+	if (!cave_has(yy, xx, CAVE_DTRAP))
 	    return (FALSE);
     }
 
@@ -1691,7 +1844,7 @@ void monster_swap(int y1, int x1, int y2, int x2)
 	bool old_dtrap, new_dtrap;
 
 	/* Calculate changes in dtrap status */
-	old_dtrap = cave_has(cave_info[y1][x1], CAVE_DTRAP);
+	old_dtrap = cave_has(y1, x1, CAVE_DTRAP);
 	new_dtrap = is_detected(y2, x2);
 
 	/* Note the change in the detect status */
@@ -1783,6 +1936,13 @@ s16b monster_place(int y, int x, monster_type * n_ptr)
 	m_ptr->fy = y;
 	m_ptr->fx = x;
 
+	/* Callers supply any starting energy */
+	mon_energy[m_idx] = 0;
+	mon_moved[m_idx] = FALSE;
+
+	/* Now active */
+	mon_active_add(m_idx);
+
 	/* Update the monster */
 	update_mon(m_idx, TRUE);
 
@@ -1855,7 +2015,8 @@ static bool get_racial_monster(int r_idx)
  */
 static bool place_monster_one(int y, int x, int r_idx, bool slp)
 {
-    int i, r1_idx;
+    int i, r1_idx, m_idx;
+    byte energy;
 
     monster_race *r_ptr;
 
@@ -2042,10 +2203,10 @@ static bool place_monster_one(int y, int x, int r_idx, bool slp)
     /* Force monster to wait for player */
     if (rf_has(r_ptr->flags, RF_FORCE_SLEEP)) {
 	/* Give a random starting energy */
-	n_ptr->energy = 0;
+	energy = 0;
     } else {
 	/* Give a random starting energy */
-	n_ptr->energy = randint0(50);
+	energy = randint0(50);
     }
 
     /* Set the group leader, if there is one */
@@ -2096,7 +2257,7 @@ static bool place_monster_one(int y, int x, int r_idx, bool slp)
 	k = randint0(chance + 20);
 	if ((k > 20) || (stage_map[p_ptr->stage][STAGE_TYPE] == CAVE)
 	    || (p_ptr->themed_level == THEME_WARLORDS)
-	    || cave_has(cave_info[y][x], CAVE_ICKY))
+	    || cave_has(y, x, CAVE_ICKY))
 	    n_ptr->hostile = -1;
 	else
 	    n_ptr->hostile = 0;
@@ -2116,9 +2277,13 @@ static bool place_monster_one(int y, int x, int r_idx, bool slp)
     }
 
     /* Place the monster in the dungeon */
-    if (!monster_place(y, x, n_ptr))
+    m_idx = monster_place(y, x, n_ptr);
+    if (!m_idx)
 	return (FALSE);
 
+    /* Starting energy */
+    mon_energy[m_idx] = energy;
+
     /* Deep unique monsters */
     if ((rf_has(r_ptr->flags, RF_UNIQUE)) && (r_ptr->level > p_ptr->depth)) {
 	/* Message */
@@ -2535,7 +2700,7 @@ bool alloc_monster(int dis, bool slp, bool quick)
 	    continue;
 
 	/* Do not put random monsters in marked rooms. */
-	if ((!character_dungeon) && cave_has(cave_info[y][x], CAVE_TEMP))
+	if ((!character_dungeon) && cave_has(y, x, CAVE_TEMP))
 	    continue;
 
 	/* Accept far away grids */
@@ -2913,7 +3078,7 @@ int assess_shapechange(int m_idx, monster_type * m_ptr)
 
     bitflag summons[RSF_SIZE];
 
-    flags_init(summons, RSF_SIZE, RSF_SUMMON_MASK);
+    rsf_copy(summons, rsf_summon_mask);
     rsf_inter(summons, r_ptr->spell_flags);
 
     /* Pick some possible monsters, using the level calculation */
@@ -212,9 +212,8 @@ static const char *obj_desc_get_basename(const object_type * o_ptr, bool aware)
  * Copy 'src' into 'buf, replacing '#' with 'modstr' (if found), putting a plural
  * in the place indicated by '~' if required, or using alterate...
  */
-static size_t obj_desc_name(char *buf, size_t max, size_t end,
-			    const object_type * o_ptr, bool prefix,
-			    odesc_detail_t mode, bool spoil)
+static void obj_desc_name(strbuf *sb, const object_type * o_ptr, bool prefix,
+			  odesc_detail_t mode, bool spoil)
 {
     object_kind *k_ptr = &k_info[o_ptr->k_idx];
 
@@ -239,14 +238,14 @@ static size_t obj_desc_name(char *buf, size_t max, size_t end,
     /* Add a pseudo-numerical prefix if desired */
     if (prefix) {
 	if (o_ptr->number <= 0) {
-	    strnfcat(buf, max, &end, "no more ");
+	    strbuf_puts(sb, "no more ");
 
 	    /* Pluralise for grammatical correctness */
 	    pluralise = TRUE;
 	} else if (o_ptr->number > 1)
-	    strnfcat(buf, max, &end, "%d ", o_ptr->number);
+	    strbuf_fmt(sb, "%d ", o_ptr->number);
 	else if ((known) && artifact_p(o_ptr))
-	    strnfcat(buf, max, &end, "The ");
+	    strbuf_puts(sb, "The ");
 
 	else if (*basename == '&') {
 	    bool an = FALSE;
@@ -263,9 +262,9 @@ static size_t obj_desc_name(char *buf, size_t max, size_t end,
 	    }
 
 	    if (an)
-		strnfcat(buf, max, &end, "an ");
+		strbuf_puts(sb, "an ");
 	    else
-		strnfcat(buf, max, &end, "a ");
+		strbuf_puts(sb, "a ");
 	}
     }
 
@@ -301,9 +300,9 @@ static size_t obj_desc_name(char *buf, size_t max, size_t end,
 
 	    /* e.g. cutlass-e-s, torch-e-s, box-e-s */
 	    if (prev == 's' || prev == 'h' || prev == 'x')
-		strnfcat(buf, max, &end, "es");
+		strbuf_puts(sb, "es");
 	    else
-		strnfcat(buf, max, &end, "s");
+		strbuf_puts(sb, "s");
 	}
 
 	/* Special plurals */
@@ -319,13 +318,12 @@ static size_t obj_desc_name(char *buf, size_t max, size_t end,
 	    }
 
 	    if (!singular || !plural || !endmark)
-		return end;
+		return;
 
 	    if (!pluralise)
-		strnfcat(buf, max, &end, "%.*s", plural - singular - 1,
-			 singular);
+		strbuf_putn(sb, singular, plural - singular - 1);
 	    else
-		strnfcat(buf, max, &end, "%.*s", endmark - plural, plural);
+		strbuf_putn(sb, plural, endmark - plural);
 
 	    basename = endmark;
 	}
@@ -334,7 +332,7 @@ static size_t obj_desc_name(char *buf, size_t max, size_t end,
 	else if (*basename == '#') {
 	    const char *basename = modstr;
 
-	    while (basename && *basename && (end < max - 1)) {
+	    while (basename && *basename && (sb->end < sb->max - 1)) {
 		/* Special plurals */
 		if (*basename == '|') {
 		    /* e.g. & Wooden T|o|e|rch~ ^ ^^ */
@@ -348,49 +346,56 @@ static size_t obj_desc_name(char *buf, size_t max, size_t end,
 		    }
 
 		    if (!singular || !plural || !endmark)
-			return end;
+			return;
 
 		    if (!pluralise)
-			strnfcat(buf, max, &end, "%.*s", plural - singular - 1,
-				 singular);
+			strbuf_putn(sb, singular, plural - singular - 1);
 		    else
-			strnfcat(buf, max, &end, "%.*s", endmark - plural,
-				 plural);
+			strbuf_putn(sb, plural, endmark - plural);
 
 		    basename = endmark;
 		}
 
-		else
-		    buf[end++] = *basename;
+		/* Copy up to the next special plural at once */
+		else {
+		    size_t n = strcspn(basename, "|");
+
+		    strbuf_putn(sb, basename, n);
+		    basename += n;
+		    continue;
+		}
 
 		basename++;
 	    }
 	}
 
-	else
-	    buf[end++] = *basename;
+	/* Copy up to the next special character at once */
+	else {
+	    size_t n = strcspn(basename, "&~|#");
+
+	    strbuf_putn(sb, basename, n);
+	    basename += n;
+	    continue;
+	}
 
 	basename++;
     }
 
-    /* 0-terminate, just in case XXX */
-    buf[end] = 0;
-
 
 	/** Append extra names of various kinds **/
 
     if ((known) && o_ptr->name1)
-	strnfcat(buf, max, &end, " %s", a_info[o_ptr->name1].name);
+	strbuf_fmt(sb, " %s", a_info[o_ptr->name1].name);
     
     else if ((spoil && o_ptr->name2) || has_ego_properties(o_ptr))
-	strnfcat(buf, max, &end, " %s", e_info[o_ptr->name2].name);
+	strbuf_fmt(sb, " %s", e_info[o_ptr->name2].name);
     
     else if (aware && !artifact_p(o_ptr)
 	     && (k_ptr->flavor || k_ptr->tval == TV_SCROLL)
 	     && ((k_ptr->tval != TV_FOOD) || (k_ptr->sval < SV_FOOD_MIN_FOOD)))
-	strnfcat(buf, max, &end, " of %s", k_ptr->name);
+	strbuf_fmt(sb, " of %s", k_ptr->name);
     
-    return end;
+    return;
 }
 
 /*
@@ -492,26 +497,25 @@ static bool obj_desc_show_armor(const object_type * o_ptr)
     return FALSE;
 }
 
-static size_t obj_desc_chest(const object_type * o_ptr, char *buf, size_t max,
-			     size_t end)
+static void obj_desc_chest(const object_type * o_ptr, strbuf *sb)
 {
     bool known = object_known_p(o_ptr) || (o_ptr->ident & IDENT_STORE);
 
     if (o_ptr->tval != TV_CHEST)
-	return end;
+	return;
     if (!known)
-	return end;
+	return;
 
     /* May be "empty" */
     if (!o_ptr->pval)
-	strnfcat(buf, max, &end, " (empty)");
+	strbuf_puts(sb, " (empty)");
 
     /* May be "disarmed" */
     else if (o_ptr->pval < 0) {
 	if (chest_traps[0 - o_ptr->pval])
-	    strnfcat(buf, max, &end, " (disarmed)");
+	    strbuf_puts(sb, " (disarmed)");
 	else
-	    strnfcat(buf, max, &end, " (unlocked)");
+	    strbuf_puts(sb, " (unlocked)");
     }
 
     /* Describe the traps, if any */
@@ -521,29 +525,29 @@ static size_t obj_desc_chest(const object_type * o_ptr, char *buf, size_t max,
 	switch (chest_traps[o_ptr->pval]) {
 	case 0:
 	{
-	    strnfcat(buf, max, &end, " (Locked)");
+	    strbuf_puts(sb, " (Locked)");
 	    break;
 	}
 	case CHEST_LOSE_STR:
 	case CHEST_LOSE_CON:
 	{
-	    strnfcat(buf, max, &end, " (Poison Needle)");
+	    strbuf_puts(sb, " (Poison Needle)");
 	    break;
 	}
 	case CHEST_POISON:
 	case CHEST_PARALYZE:
 	{
-	    strnfcat(buf, max, &end, " (Gas Trap)");
+	    strbuf_puts(sb, " (Gas Trap)");
 	    break;
 	}
 	case CHEST_SCATTER:
 	{
-	    strnfcat(buf, max, &end, " (A Strange Rune)");
+	    strbuf_puts(sb, " (A Strange Rune)");
 	    break;
 	}
 	case CHEST_EXPLODE:
 	{
-	    strnfcat(buf, max, &end, " (Explosion Device)");
+	    strbuf_puts(sb, " (Explosion Device)");
 	    break;
 	}
 	case CHEST_SUMMON:
@@ -551,27 +555,26 @@ static size_t obj_desc_chest(const object_type * o_ptr, char *buf, size_t max,
 	case CHEST_H_SUMMON:
 	case CHEST_BIRD_STORM:
 	{
-	    strnfcat(buf, max, &end, " (Summoning Runes)");
+	    strbuf_puts(sb, " (Summoning Runes)");
 	    break;
 	}
 	case CHEST_RUNES_OF_EVIL:
 	{
-	    strnfcat(buf, max, &end, " (Gleaming Black Runes)");
+	    strbuf_puts(sb, " (Gleaming Black Runes)");
 	    break;
 	}
 	default:
 	{
-	    strnfcat(buf, max, &end, " (Multiple Traps)");
+	    strbuf_puts(sb, " (Multiple Traps)");
 	    break;
 	}
 	}
     }
     
-    return end;
+    return;
 }
 
-static size_t obj_desc_combat(const object_type * o_ptr, char *buf, size_t max,
-			      size_t end, bool spoil)
+static void obj_desc_combat(const object_type * o_ptr, strbuf *sb, bool spoil)
 {
     bool worn = (o_ptr->ident & IDENT_WORN) || (o_ptr->ident & IDENT_STORE);
 
@@ -588,7 +591,7 @@ static size_t obj_desc_combat(const object_type * o_ptr, char *buf, size_t max,
 	{
 	    /* Only display the damage dice if known */
 	    if (spoil || if_has(o_ptr->id_other, IF_DD_DS))
-		strnfcat(buf, max, &end, " (%dd%d)", o_ptr->dd, o_ptr->ds);
+		strbuf_fmt(sb, " (%dd%d)", o_ptr->dd, o_ptr->ds);
 	    break;
 	}
 
@@ -605,7 +608,7 @@ static size_t obj_desc_combat(const object_type * o_ptr, char *buf, size_t max,
 
 	    /* Append a "power" string */
 	    if (if_has(o_ptr->id_other, IF_DD_DS)) 
-		strnfcat(buf, max, &end, " (x%d)", power);
+		strbuf_fmt(sb, " (x%d)", power);
 	    break;
 	}
     }
@@ -614,28 +617,28 @@ static size_t obj_desc_combat(const object_type * o_ptr, char *buf, size_t max,
     if (obj_desc_show_weapon(o_ptr)) {
 	if (spoil || (if_has(o_ptr->id_other, IF_TO_H) && 
 		      if_has(o_ptr->id_other, IF_TO_D)))
-	    strnfcat(buf, max, &end, " (%+d,%+d)", o_ptr->to_h, 
+	    strbuf_fmt(sb, " (%+d,%+d)", o_ptr->to_h, 
 		     o_ptr->to_d);
 	else if (if_has(o_ptr->id_other, IF_TO_H))
-	    strnfcat(buf, max, &end, " (%+d,?)", o_ptr->to_h);
+	    strbuf_fmt(sb, " (%+d,?)", o_ptr->to_h);
 	else if (if_has(o_ptr->id_other, IF_TO_D))
-	    strnfcat(buf, max, &end, " (?,%+d)", o_ptr->to_d);
+	    strbuf_fmt(sb, " (?,%+d)", o_ptr->to_d);
 	else 
-	    strnfcat(buf, max, &end, " (?,?)");
+	    strbuf_puts(sb, " (?,?)");
     }
 
     else if (obj_desc_show_to_hit(o_ptr)) {
 	if (spoil || if_has(o_ptr->id_other, IF_TO_H)) 
-	    strnfcat(buf, max, &end, " (%+d)", o_ptr->to_h);
+	    strbuf_fmt(sb, " (%+d)", o_ptr->to_h);
 	else
-	    strnfcat(buf, max, &end, " (?)");
+	    strbuf_puts(sb, " (?)");
     }
 
     else if (obj_desc_show_to_dam(o_ptr)) {
 	if (spoil || if_has(o_ptr->id_other, IF_TO_D)) 
-	    strnfcat(buf, max, &end, " (%+d)", o_ptr->to_d);
+	    strbuf_fmt(sb, " (%+d)", o_ptr->to_d);
 	else
-	    strnfcat(buf, max, &end, " (?)");
+	    strbuf_puts(sb, " (?)");
     }
 
     /* Show armor bonuses */
@@ -649,34 +652,32 @@ static size_t obj_desc_combat(const object_type * o_ptr, char *buf, size_t max,
 	
 	if (spoil || (if_has(o_ptr->id_other, IF_AC) && 
 		      if_has(o_ptr->id_other, IF_TO_A))) 
-	    strnfcat(buf, max, &end, " [%d,%+d]", ac, to_a);
+	    strbuf_fmt(sb, " [%d,%+d]", ac, to_a);
 	else if (if_has(o_ptr->id_other, IF_AC))
-	    strnfcat(buf, max, &end, " [%d,?]", ac);
+	    strbuf_fmt(sb, " [%d,?]", ac);
 	else if (if_has(o_ptr->id_other, IF_TO_A))
-	    strnfcat(buf, max, &end, " [?,%+d]", to_a);
+	    strbuf_fmt(sb, " [?,%+d]", to_a);
 	else 
-	    strnfcat(buf, max, &end, " [?,?]");
+	    strbuf_puts(sb, " [?,?]");
     }
     
     /* No base armor, but does increase armor */
     else if (spoil || if_has(o_ptr->id_other, IF_TO_A)) 
-	strnfcat(buf, max, &end, " [%+d]", o_ptr->to_a);
+	strbuf_fmt(sb, " [%+d]", o_ptr->to_a);
 
-    return end;
+    return;
 }
 
-static size_t obj_desc_light(const object_type * o_ptr, char *buf, size_t max,
-			     size_t end)
+static void obj_desc_light(const object_type * o_ptr, strbuf *sb)
 {
     /* Fuelled light sources get number of remaining turns appended */
     if ((o_ptr->tval == TV_LIGHT) && !artifact_p(o_ptr))
-	strnfcat(buf, max, &end, " (%d turns)", o_ptr->pval);
+	strbuf_fmt(sb, " (%d turns)", o_ptr->pval);
 
-    return end;
+    return;
 }
 
-static size_t obj_desc_pval(const object_type * o_ptr, char *buf, size_t max,
-			    size_t end)
+static void obj_desc_pval(const object_type * o_ptr, strbuf *sb)
 {
     int i;
     int num_bonus = 0;
@@ -714,52 +715,51 @@ static size_t obj_desc_pval(const object_type * o_ptr, char *buf, size_t max,
 	    }
 	}
     
-    if (!num_bonus) return end;
+    if (!num_bonus) return;
 
-    strnfcat(buf, max, &end, " <");
+    strbuf_puts(sb, " <");
 
     /* Dump the values */
     for (i = 0; i < num_bonus; i++) {
-	strnfcat(buf, max, &end, "%+d", bonus[i]);
+	strbuf_fmt(sb, "%+d", bonus[i]);
 	if (i < num_bonus - 1)
-	    strnfcat(buf, max, &end, ", ");
+	    strbuf_puts(sb, ", ");
     }
     
     /* Description for single bonuses */
     if (num_bonus == 1) {
 	/* Speed */
 	if (o_ptr->bonus_other[P_BONUS_SPEED] != 0) 
-	    strnfcat(buf, max, &end, " to speed");
+	    strbuf_puts(sb, " to speed");
 
 	    /* Magic mastery */
 	else if (o_ptr->bonus_other[P_BONUS_M_MASTERY] != 0)
-	    strnfcat(buf, max, &end, " to device skill");
+	    strbuf_puts(sb, " to device skill");
 
 	/* Stealth */
 	else if (o_ptr->bonus_other[P_BONUS_STEALTH] != 0)
-	    strnfcat(buf, max, &end, " to stealth");
+	    strbuf_puts(sb, " to stealth");
 
 	/* Searching */
 	else if (o_ptr->bonus_other[P_BONUS_SEARCH] != 0)
-	    strnfcat(buf, max, &end, " to searching");
+	    strbuf_puts(sb, " to searching");
 
 	/* Infravision */
 	else if (o_ptr->bonus_other[P_BONUS_INFRA] != 0)
-	    strnfcat(buf, max, &end, " to infravision");
+	    strbuf_puts(sb, " to infravision");
 
 
 	/* Tunneling */
 	else if (o_ptr->bonus_other[P_BONUS_TUNNEL] != 0)
-	    strnfcat(buf, max, &end, " to digging");
+	    strbuf_puts(sb, " to digging");
     }
 
-    strnfcat(buf, max, &end, ">");
+    strbuf_puts(sb, ">");
 
-    return end;
+    return;
 }
 
-static size_t obj_desc_charges(const object_type * o_ptr, char *buf, size_t max,
-			       size_t end)
+static void obj_desc_charges(const object_type * o_ptr, strbuf *sb)
 {
     object_kind *k_ptr = &k_info[o_ptr->k_idx];
 
@@ -767,7 +767,7 @@ static size_t obj_desc_charges(const object_type * o_ptr, char *buf, size_t max,
 
     /* Wands and Staffs have charges */
     if (aware && (o_ptr->tval == TV_STAFF || o_ptr->tval == TV_WAND))
-	strnfcat(buf, max, &end, " (%d charge%s)", o_ptr->pval,
+	strbuf_fmt(sb, " (%d charge%s)", o_ptr->pval,
 		 PLURAL(o_ptr->pval));
 
     /* Charging things */
@@ -790,20 +790,19 @@ static size_t obj_desc_charges(const object_type * o_ptr, char *buf, size_t max,
 		power = o_ptr->number;
 
 	    /* Display prettily */
-	    strnfcat(buf, max, &end, " (%d charging)", power);
+	    strbuf_fmt(sb, " (%d charging)", power);
 	}
 
 	/* Artifacts, single rods */
 	else if (!(o_ptr->tval == TV_LIGHT && !artifact_p(o_ptr))) {
-	    strnfcat(buf, max, &end, " (charging)");
+	    strbuf_puts(sb, " (charging)");
 	}
     }
 
-    return end;
+    return;
 }
 
-static size_t obj_desc_inscrip(const object_type * o_ptr, char *buf, size_t max,
-			       size_t end)
+static void obj_desc_inscrip(const object_type * o_ptr, strbuf *sb)
 {
     const char *u[4] = { 0, 0, 0, 0 };
     int n = 0;
@@ -833,37 +832,36 @@ static size_t obj_desc_inscrip(const object_type * o_ptr, char *buf, size_t max,
 	int i;
 	for (i = 0; i < n; i++) {
 	    if (i == 0)
-		strnfcat(buf, max, &end, " {");
-	    strnfcat(buf, max, &end, "%s", u[i]);
+		strbuf_puts(sb, " {");
+	    strbuf_puts(sb, u[i]);
 	    if (i < n - 1)
-		strnfcat(buf, max, &end, ", ");
+		strbuf_puts(sb, ", ");
 	}
 
-	strnfcat(buf, max, &end, "}");
+	strbuf_puts(sb, "}");
     }
 
-    return end;
+    return;
 }
 
 
 /* Add "unseen" to the end of unaware items in stores */
-static size_t obj_desc_aware(const object_type * o_ptr, char *buf, size_t max,
-			     size_t end)
+static void obj_desc_aware(const object_type * o_ptr, strbuf *sb)
 {
     if (object_aware_p(o_ptr))
     {
 	if ((o_ptr->discount > 0) && (o_ptr->discount != 80)) 
-	    strnfcat(buf, max, &end, " {%d%% off}", o_ptr->discount);
+	    strbuf_fmt(sb, " {%d%% off}", o_ptr->discount);
     }
     else
     {
 	if ((o_ptr->discount == 0) || (o_ptr->discount == 80)) 
-	    strnfcat(buf, max, &end, " {unseen}");
+	    strbuf_puts(sb, " {unseen}");
 	else
-	    strnfcat(buf, max, &end, " {%d%% off, unseen}", o_ptr->discount);
+	    strbuf_fmt(sb, " {%d%% off, unseen}", o_ptr->discount);
     }
     
-    return end;
+    return;
 }
 
 
@@ -893,7 +891,7 @@ size_t object_desc(char *buf, size_t max, const object_type * o_ptr,
     bool known = object_known_p(o_ptr) || (o_ptr->ident & IDENT_STORE)
 	|| spoil;
 
-    size_t end = 0;
+    strbuf sb;
 
 
     /* We've seen it at least once now we're aware of it */
@@ -913,32 +911,33 @@ size_t object_desc(char *buf, size_t max, const object_type * o_ptr,
 	/** Construct the name **/
 
     /* Copy the base name to the buffer */
-    end = obj_desc_name(buf, max, end, o_ptr, prefix, mode, spoil);
+    strbuf_init(&sb, buf, max);
+    obj_desc_name(&sb, o_ptr, prefix, mode, spoil);
 
     if (mode & ODESC_COMBAT) {
 	if (o_ptr->tval == TV_CHEST)
-	    end = obj_desc_chest(o_ptr, buf, max, end);
+	    obj_desc_chest(o_ptr, &sb);
 	else if (o_ptr->tval == TV_LIGHT)
-	    end = obj_desc_light(o_ptr, buf, max, end);
+	    obj_desc_light(o_ptr, &sb);
 
-	end = obj_desc_combat(o_ptr, buf, max, end, spoil);
+	obj_desc_combat(o_ptr, &sb, spoil);
     }
 
     if (mode & ODESC_EXTRA) {
 	if (spoil || (o_ptr->ident & IDENT_WORN) || 
 	    (o_ptr->ident & IDENT_STORE))
-	    end = obj_desc_pval(o_ptr, buf, max, end);
+	    obj_desc_pval(o_ptr, &sb);
 
-	end = obj_desc_charges(o_ptr, buf, max, end);
+	obj_desc_charges(o_ptr, &sb);
 
 	if (mode & ODESC_STORE) {
-	    end = obj_desc_aware(o_ptr, buf, max, end);
+	    obj_desc_aware(o_ptr, &sb);
 	} else
-	    end = obj_desc_inscrip(o_ptr, buf, max, end);
+	    obj_desc_inscrip(o_ptr, &sb);
     }
 
     if (mode & ODESC_CAPITAL) 
 	my_strcap(buf);
 
-    return end;
+    return sb.end;
 }
@@ -898,7 +898,6 @@ static bool describe_weapon_damage(textblock *tb, const object_type *o_ptr,
     int brand[MAX_P_BRAND], slay[MAX_P_SLAY];
 
     player_state state;
-    object_type inven[INVEN_TOTAL];
 
     /* Abort if we've nothing to say */
     if (mode & OINFO_DUMMY) return FALSE;
@@ -947,11 +946,9 @@ static bool describe_weapon_damage(textblock *tb, const object_type *o_ptr,
      * Get the player's hypothetical state, were they to be
      * wielding this item (setting irrelevant shield state).
      */
-    memcpy(inven, p_ptr->inventory, INVEN_TOTAL * sizeof(object_type));
-    inven[INVEN_WIELD] = *o_ptr;
     state.shield_on_back = FALSE;
 
-    calc_bonuses(inven, &state, TRUE);
+    calc_bonuses_swap(INVEN_WIELD, o_ptr, &state);
 
     show_m_tohit = state.dis_to_h;
     if (if_has(o_ptr->id_other, IF_TO_H) || full)
@@ -1228,8 +1225,6 @@ static bool describe_digger(textblock *tb, const object_type *o_ptr,
 {
     player_state st;
 
-    object_type inven[INVEN_TOTAL];
-
     int sl = wield_slot(o_ptr);
     int i;
 
@@ -1243,18 +1238,16 @@ static bool describe_digger(textblock *tb, const object_type *o_ptr,
 		   (o_ptr->bonus_other[P_BONUS_TUNNEL] == 0)))
 	return FALSE;
 
-    memcpy(inven, p_ptr->inventory, INVEN_TOTAL * sizeof(object_type));
-
     /*
      * Hack -- if we examine a ring that is worn on the right finger,
      * we shouldn't put a copy of it on the left finger before calculating
      * digging skills.
      */
-    if (o_ptr != &p_ptr->inventory[INVEN_RIGHT])
-	inven[sl] = *o_ptr;
-
     st.shield_on_back = FALSE;
-    calc_bonuses(inven, &st, TRUE);
+    if (o_ptr == &p_ptr->inventory[INVEN_RIGHT])
+	calc_bonuses_swap(-1, NULL, &st);
+    else
+	calc_bonuses_swap(sl, o_ptr, &st);
 
     chances[0] = st.skills[SKILL_DIGGING] * 8;
     chances[1] = (st.skills[SKILL_DIGGING] - 10) * 4;
@@ -28,6 +28,14 @@
 #include "squelch.h"
 
 
+/**
+ * The level and chest state that "alloc_kind_pick" was last made for.
+ * A level of -1 means it must be made again.
+ */
+static int kind_pick_level = -1;
+static bool kind_pick_chest = FALSE;
+
+
 /**
  * Apply a "object restriction function" to the "object allocation table"
  */
@@ -53,6 +61,9 @@ errr get_obj_num_prep(void)
 	}
     }
 
+    /* The probabilities must be worked out again */
+    kind_pick_level = -1;
+
     /* Success */
     return (0);
 }
@@ -65,7 +76,9 @@ errr get_obj_num_prep(void)
  * This function uses the "prob2" field of the "object allocation table",
  * and various local information, to calculate the "prob3" field of the
  * same table, which is then used to choose an "appropriate" object, in
- * a relatively efficient manner.
+ * a relatively efficient manner.  The "prob3" values are kept (along with
+ * their running totals in "alloc_kind_pick") until the level, the chest
+ * state or the restriction changes, so a pick takes very few steps.
  *
  * It is (slightly) more likely to acquire an object of the given level
  * than one of a lower level.  This is done by choosing several objects
@@ -80,7 +93,7 @@ s16b get_obj_num(int level)
 
     int k_idx;
 
-    long value, total;
+    u32b total;
 
     object_kind *k_ptr;
 
@@ -95,52 +108,49 @@ s16b get_obj_num(int level)
     }
 
 
-    /* Reset total */
-    total = 0L;
+    /* Process probabilities, if they have changed */
+    if ((level != kind_pick_level) || (opening_chest != kind_pick_chest)) {
+	/* Reset total */
+	total = 0L;
 
-    /* Process probabilities */
-    for (i = 0; i < alloc_kind_size; i++) {
-	/* Objects are sorted by depth */
-	if (table[i].level > level)
-	    break;
+	for (i = 0; i < alloc_kind_size; i++) {
+	    /* Objects are sorted by depth */
+	    if (table[i].level > level)
+		break;
 
-	/* Default */
-	table[i].prob3 = 0;
+	    /* Default */
+	    table[i].prob3 = 0;
 
-	/* Access the index */
-	k_idx = table[i].index;
+	    /* Access the index */
+	    k_idx = table[i].index;
 
-	/* Access the actual kind */
-	k_ptr = &k_info[k_idx];
+	    /* Access the actual kind */
+	    k_ptr = &k_info[k_idx];
 
-	/* Hack -- prevent embedded chests */
-	if (opening_chest && (k_ptr->tval == TV_CHEST))
-	    continue;
+	    /* Accept, but hack -- prevent embedded chests */
+	    if (!opening_chest || (k_ptr->tval != TV_CHEST))
+		table[i].prob3 = table[i].prob2;
 
-	/* Accept */
-	table[i].prob3 = table[i].prob2;
+	    /* Total */
+	    total += table[i].prob3;
+	    alloc_kind_pick.sum[i] = total;
+	}
 
-	/* Total */
-	total += table[i].prob3;
+	/* Ready to pick */
+	rand_table_guide(&alloc_kind_pick, i);
+	kind_pick_level = level;
+	kind_pick_chest = opening_chest;
     }
 
+    total = alloc_kind_pick.total;
+
     /* No legal objects */
     if (total <= 0)
 	return (0);
 
 
     /* Pick an object */
-    value = randint0(total);
-
-    /* Find the object */
-    for (i = 0; i < alloc_kind_size; i++) {
-	/* Found the entry */
-	if (value < table[i].prob3)
-	    break;
-
-	/* Decrement */
-	value = value - table[i].prob3;
-    }
+    i = rand_table_pick(&alloc_kind_pick);
 
 
     /* Power boost */
@@ -157,17 +167,7 @@ s16b get_obj_num(int level)
 	j = i;
 
 	/* Pick an object */
-	value = randint0(total);
-
-	/* Find the object */
-	for (i = 0; i < alloc_kind_size; i++) {
-	    /* Found the entry */
-	    if (value < table[i].prob3)
-		break;
-
-	    /* Decrement */
-	    value = value - table[i].prob3;
-	}
+	i = rand_table_pick(&alloc_kind_pick);
 
 	/* Keep the "best" one */
 	if (table[i].level < table[j].level)
@@ -180,17 +180,7 @@ s16b get_obj_num(int level)
 	j = i;
 
 	/* Pick an object */
-	value = randint0(total);
-
-	/* Find the object */
-	for (i = 0; i < alloc_kind_size; i++) {
-	    /* Found the entry */
-	    if (value < table[i].prob3)
-		break;
-
-	    /* Decrement */
-	    value = value - table[i].prob3;
-	}
+	i = rand_table_pick(&alloc_kind_pick);
 
 	/* Keep the "best" one */
 	if (table[i].level < table[j].level)
@@ -2494,12 +2494,13 @@ void drop_near(object_type * j_ptr, int chance, int y, int x, bool verbose)
 	    /* Location */
 	    ty = y + dy;
 	    tx = x + dx;
-	    f_ptr = &f_info[cave_feat[ty][tx]];
 
 	    /* Skip illegal grids */
 	    if (!in_bounds_fully(ty, tx))
 		continue;
 
+	    f_ptr = &f_info[cave_feat[ty][tx]];
+
 	    /* Require line of sight */
 	    if (!los(y, x, ty, tx))
 		continue;
@@ -33,19 +33,65 @@
  */
 #define MAX_PF_LENGTH 250
 
+/**
+ * Number of grids in the pathfinding window
+ */
+#define PF_GRIDS (MAX_PF_RADIUS * MAX_PF_RADIUS)
+
+/**
+ * Step costs.  Every step takes a game turn, so path length comes first;
+ * the extra point on diagonals breaks ties towards straighter paths.
+ */
+#define PF_COST_STRAIGHT	100
+#define PF_COST_DIAGONAL	101
+
+/**
+ * Search states for grids in the window
+ */
+#define PF_NEW		0
+#define PF_OPEN		1
+#define PF_CLOSED	2
+
 static int terrain[MAX_PF_RADIUS][MAX_PF_RADIUS];
 char pf_result[MAX_PF_LENGTH];
 int pf_result_index;
 
 static int ox, oy, ex, ey;
 
+/*
+ * The search tree.  Grids are indexed as (y - oy) * MAX_PF_RADIUS + (x - ox).
+ * Costs of closed grids are exact, so the tree stays valid for as long as
+ * the player, the level and the player's knowledge of it are unchanged; a
+ * new target only needs the open grids re-keyed and the search continued.
+ */
+static int pf_cost[PF_GRIDS];
+static int pf_steps[PF_GRIDS];
+static byte pf_dir[PF_GRIDS];
+static byte pf_state[PF_GRIDS];
+
+/* The open list, a binary heap of grid indexes keyed on pf_key[] */
+static int pf_heap[PF_GRIDS];
+static int pf_heap_pos[PF_GRIDS];
+static int pf_key[PF_GRIDS];
+static int pf_heap_size;
+
+/* What the current search tree was built from */
+static bool pf_tree_valid = FALSE;
+static s32b pf_tree_turn;
+static int pf_tree_stage;
+static int pf_tree_py, pf_tree_px;
+static bool pf_tree_easy_alter;
+
+/* Grids expanded by the pathfinder, for the debug timing command */
+u32b pf_expanded = 0;
+
 bool is_valid_pf(int y, int x)
 {
     feature_type *f_ptr = NULL;
     int feat = cave_feat[y][x];
 
     /* Hack -- assume unvisited is permitted */
-    if (!cave_has(cave_info[y][x], CAVE_MARK))
+    if (!cave_has(y, x, CAVE_MARK))
 	return (TRUE);
 
     /* Get mimiced feat */
@@ -93,128 +139,265 @@ static void fill_terrain_info(void)
     terrain[p_ptr->py - oy][p_ptr->px - ox] = 1;
 }
 
-#define MARK_DISTANCE(c,d) if ((c <= MAX_PF_LENGTH) && (c > d)) \
-                              { c = d; try_again = (TRUE); }
+/**
+ * Octile distance from a grid to the target, in step cost units.  This
+ * never overestimates and is consistent, so closed grids are final.
+ */
+static int pf_heuristic(int n, int ty, int tx)
+{
+    int dy = ABS(n / MAX_PF_RADIUS - ty);
+    int dx = ABS(n % MAX_PF_RADIUS - tx);
+
+    if (dy > dx)
+	return (PF_COST_STRAIGHT * dy + (PF_COST_DIAGONAL - PF_COST_STRAIGHT) * dx);
+    else
+	return (PF_COST_STRAIGHT * dx + (PF_COST_DIAGONAL - PF_COST_STRAIGHT) * dy);
+}
 
-bool findpath(int y, int x)
+/**
+ * Heap ordering: lowest key first, then the deepest grid, which keeps the
+ * search heading for the target across open floor.
+ */
+static bool pf_heap_before(int a, int b)
 {
-    int i, j, k, dir, starty = 0, startx = 0, start_index;
-    bool try_again;
-    int cur_distance;
-    int findir[] = { 1, 4, 7, 8, 9, 6, 3, 2 };
+    if (pf_key[a] != pf_key[b])
+	return (pf_key[a] < pf_key[b]);
+    return (pf_cost[a] > pf_cost[b]);
+}
 
-    fill_terrain_info();
+static void pf_heap_swap(int i, int j)
+{
+    int tmp = pf_heap[i];
 
-    terrain[p_ptr->py - oy][p_ptr->px - ox] = 1;
+    pf_heap[i] = pf_heap[j];
+    pf_heap[j] = tmp;
+    pf_heap_pos[pf_heap[i]] = i;
+    pf_heap_pos[pf_heap[j]] = j;
+}
 
-    if ((x >= ox) && (x < ex) && (y >= oy) && (y < ey)) {
-	if ((cave_m_idx[y][x] > 0) && (m_list[cave_m_idx[y][x]].ml)) {
-	    terrain[y - oy][x - ox] = MAX_PF_LENGTH;
-	}
-	/* else if (terrain[y - oy][x - ox] != MAX_PF_LENGTH) { bell("Target
-	 * blocked"); return (FALSE); } */
-	terrain[y - oy][x - ox] = MAX_PF_LENGTH;
-    } else {
-	bell("Target out of range.");
-	return (FALSE);
-    }
+static void pf_heap_up(int i)
+{
+    while (i > 0) {
+	int parent = (i - 1) / 2;
 
-    if (terrain[y - oy][x - ox] == -1) {
-	bell("Target space forbidden");
-	return (FALSE);
+	if (!pf_heap_before(pf_heap[i], pf_heap[parent]))
+	    break;
+	pf_heap_swap(i, parent);
+	i = parent;
     }
+}
 
+static void pf_heap_down(int i)
+{
+    while (TRUE) {
+	int best = i;
+	int child = 2 * i + 1;
+
+	if ((child < pf_heap_size)
+	    && pf_heap_before(pf_heap[child], pf_heap[best]))
+	    best = child;
+	child++;
+	if ((child < pf_heap_size)
+	    && pf_heap_before(pf_heap[child], pf_heap[best]))
+	    best = child;
+
+	if (best == i)
+	    break;
+	pf_heap_swap(i, best);
+	i = best;
+    }
+}
 
-    /* 
-     * And now starts the very naive and very 
-     * inefficient pathfinding algorithm
-     */
-    do {
-	try_again = (FALSE);
-	for (j = oy + 1; j < ey - 1; j++)
-	    for (i = ox + 1; i < ex - 1; i++) {
-		cur_distance = terrain[j - oy][i - ox] + 1;
-		if ((cur_distance > 0) && (cur_distance < MAX_PF_LENGTH)) {
-		    for (dir = 1; dir < 10; dir++) {
-			if (dir == 5)
-			    continue;
-			MARK_DISTANCE(terrain[j - oy + ddy[dir]]
-				      [i - ox + ddx[dir]], cur_distance);
-		    }
-		}
-	    }
-	if (terrain[y - oy][x - ox] < MAX_PF_LENGTH)
-	    try_again = (FALSE);
-    } while (try_again);
+static int pf_heap_pop(void)
+{
+    int n = pf_heap[0];
 
-    /* Failure */
-    if (terrain[y - oy][x - ox] == MAX_PF_LENGTH) {
-	bell("Target space unreachable.");
-	return (FALSE);
+    pf_heap_size--;
+    if (pf_heap_size) {
+	pf_heap[0] = pf_heap[pf_heap_size];
+	pf_heap_pos[pf_heap[0]] = 0;
+	pf_heap_down(0);
     }
 
-    /* Success */
-    i = x;
-    j = y;
+    return (n);
+}
 
-    pf_result_index = 0;
+/**
+ * Offer grid n a path through its neighbour in direction dir.
+ */
+static void pf_relax(int from, int n, int dir, int ty, int tx)
+{
+    int cost = pf_cost[from] + (((dir & 0x01) == 0) ? PF_COST_STRAIGHT :
+				PF_COST_DIAGONAL);
 
-    while ((i != p_ptr->px) || (j != p_ptr->py)) {
-	int xdiff = i - p_ptr->px, ydiff = j - p_ptr->py;
+    if (pf_state[n] == PF_CLOSED)
+	return;
+    if ((pf_state[n] == PF_OPEN) && (pf_cost[n] <= cost))
+	return;
 
-	cur_distance = terrain[j - oy][i - ox] - 1;
+    pf_cost[n] = cost;
+    pf_steps[n] = pf_steps[from] + 1;
+    pf_dir[n] = dir;
+    pf_key[n] = cost + pf_heuristic(n, ty, tx);
 
-	/* Starting direction */
-	if (xdiff < 0)
-	    startx = 1;
-	else if (xdiff > 0)
-	    startx = -1;
-	else
-	    startx = 0;
+    if (pf_state[n] == PF_NEW) {
+	pf_state[n] = PF_OPEN;
+	pf_heap[pf_heap_size] = n;
+	pf_heap_pos[n] = pf_heap_size;
+	pf_heap_size++;
+    }
+    pf_heap_up(pf_heap_pos[n]);
+}
 
-	if (ydiff < 0)
-	    starty = 1;
-	else if (ydiff > 0)
-	    starty = -1;
-	else
-	    starty = 0;
+/**
+ * Start a new search tree at the player.
+ */
+static void pf_tree_reset(void)
+{
+    int start = (p_ptr->py - oy) * MAX_PF_RADIUS + (p_ptr->px - ox);
+
+    memset(pf_state, PF_NEW, sizeof(pf_state));
+    pf_heap_size = 0;
+
+    pf_cost[start] = 0;
+    pf_steps[start] = 0;
+    pf_dir[start] = 5;
+    pf_key[start] = 0;
+    pf_state[start] = PF_OPEN;
+    pf_heap[0] = start;
+    pf_heap_pos[start] = 0;
+    pf_heap_size = 1;
+
+    pf_tree_valid = TRUE;
+    pf_tree_turn = turn;
+    pf_tree_stage = p_ptr->stage;
+    pf_tree_py = p_ptr->py;
+    pf_tree_px = p_ptr->px;
+    pf_tree_easy_alter = OPT(easy_alter);
+}
 
-	for (dir = 1; dir < 10; dir++)
-	    if ((ddx[dir] == startx) && (ddy[dir] == starty))
-		break;
+/**
+ * Grow the search tree until the target grid (ty, tx) in window
+ * co-ordinates is closed.  The target is always allowed as a last step,
+ * even if the player knows it cannot be entered, but is never searched
+ * through unless it is passable.
+ */
+static bool pf_search(int ty, int tx)
+{
+    int target = ty * MAX_PF_RADIUS + tx;
+    int wid = ex - ox, hgt = ey - oy;
+    int i, dir;
 
-	/* Should never happend */
-	if ((dir % 5) == 0) {
-	    bell("Wtf ?");
-	    return (FALSE);
-	}
+    /* Re-key the open list for the new target */
+    for (i = 0; i < pf_heap_size; i++) {
+	int n = pf_heap[i];
 
-	for (start_index = 0; findir[start_index % 8] != dir; start_index++);
-
-	for (k = 0; k < 5; k++) {
-	    dir = findir[(start_index + k) % 8];
-	    if (terrain[j - oy + ddy[dir]][i - ox + ddx[dir]]
-		== cur_distance)
-		break;
-	    dir = findir[(8 + start_index - k) % 8];
-	    if (terrain[j - oy + ddy[dir]][i - ox + ddx[dir]]
-		== cur_distance)
-		break;
+	pf_key[n] = pf_cost[n] + pf_heuristic(n, ty, tx);
+    }
+    for (i = pf_heap_size / 2 - 1; i >= 0; i--)
+	pf_heap_down(i);
+
+    /* An impassable target may already border the tree */
+    if ((terrain[ty][tx] < 0) && (pf_state[target] != PF_CLOSED)) {
+	for (dir = 1; dir < 10; dir++) {
+	    int y = ty - ddy[dir], x = tx - ddx[dir];
+	    int from = y * MAX_PF_RADIUS + x;
+
+	    if ((dir == 5) || (y < 0) || (y >= hgt) || (x < 0) || (x >= wid))
+		continue;
+	    if ((pf_state[from] == PF_CLOSED) && (terrain[y][x] >= 0)
+		&& (pf_steps[from] < MAX_PF_LENGTH - 2))
+		pf_relax(from, target, dir, ty, tx);
 	}
+    }
 
-	/* Should never happend */
-	if (k == 5) {
-	    bell("Heyyy !");
-	    return (FALSE);
-	}
+    while ((pf_state[target] != PF_CLOSED) && pf_heap_size) {
+	int n = pf_heap_pop();
+	int y = n / MAX_PF_RADIUS, x = n % MAX_PF_RADIUS;
+
+	pf_state[n] = PF_CLOSED;
+
+	/* Impassable grids end paths, and the window edge is not searched */
+	if (terrain[y][x] < 0)
+	    continue;
+	if ((y == 0) || (y >= hgt - 1) || (x == 0) || (x >= wid - 1))
+	    continue;
+
+	/* Paths are limited in length */
+	if (pf_steps[n] >= MAX_PF_LENGTH - 2)
+	    continue;
+
+	pf_expanded++;
+
+	for (dir = 1; dir < 10; dir++) {
+	    int next = n + ddy[dir] * MAX_PF_RADIUS + ddx[dir];
+
+	    if (dir == 5)
+		continue;
 
-	pf_result[pf_result_index++] = '0' + (char) (10 - dir);
-	i += ddx[dir];
-	j += ddy[dir];
-	starty = 0;
-	startx = 0;
+	    /* Only the target may be impassable */
+	    if ((terrain[y + ddy[dir]][x + ddx[dir]] < 0) && (next != target))
+		continue;
+
+	    pf_relax(n, next, dir, ty, tx);
+	}
     }
+
+    return (pf_state[target] == PF_CLOSED);
+}
+
+/**
+ * Find a path from the player to grid (y, x), leaving it in pf_result[]
+ * (last step first) with pf_result_index at the first step.  Returns the
+ * path length, PF_OUT_OF_RANGE if the grid is beyond the pathfinding
+ * window, or PF_UNREACHABLE.
+ */
+int path_to_grid(int y, int x)
+{
+    int n;
+
+    fill_terrain_info();
+
+    if ((x < ox) || (x >= ex) || (y < oy) || (y >= ey))
+	return (PF_OUT_OF_RANGE);
+
+    /* Start again unless the old search tree still describes this map */
+    if (!pf_tree_valid || (pf_tree_turn != turn)
+	|| (pf_tree_stage != p_ptr->stage) || (pf_tree_py != p_ptr->py)
+	|| (pf_tree_px != p_ptr->px)
+	|| (pf_tree_easy_alter != OPT(easy_alter)))
+	pf_tree_reset();
+
+    if (!pf_search(y - oy, x - ox))
+	return (PF_UNREACHABLE);
+
+    /* Walk back from the target, recording the step into each grid */
+    pf_result_index = 0;
+    for (n = (y - oy) * MAX_PF_RADIUS + (x - ox); pf_dir[n] != 5;
+	 n -= ddy[pf_dir[n]] * MAX_PF_RADIUS + ddx[pf_dir[n]])
+	pf_result[pf_result_index++] = '0' + (char) pf_dir[n];
+
     pf_result_index--;
+    return (pf_result_index + 1);
+}
+
+/**
+ * Find a path to (y, x) for the pathfind command, complaining on failure.
+ */
+bool findpath(int y, int x)
+{
+    int len = path_to_grid(y, x);
+
+    if (len == PF_OUT_OF_RANGE) {
+	bell("Target out of range.");
+	return (FALSE);
+    }
+
+    if (len == PF_UNREACHABLE) {
+	bell("Target space unreachable.");
+	return (FALSE);
+    }
+
     return (TRUE);
 }
 
@@ -241,7 +424,7 @@ static int see_wall(int dir, int y, int x)
 	return (FALSE);
 
     /* Unknown walls are not known walls */
-    if (!cave_has(cave_info[y][x], CAVE_MARK))
+    if (!cave_has(y, x, CAVE_MARK))
 	return (FALSE);
 
     /* Default */
@@ -263,7 +446,7 @@ static int see_nothing(int dir, int y, int x)
 	return (TRUE);
 
     /* Memorized grids are always known */
-    if (cave_has(cave_info[y][x], CAVE_MARK))
+    if (cave_has(y, x, CAVE_MARK))
 	return (FALSE);
 
     /* Default */
@@ -810,7 +993,7 @@ static bool run_test(void)
 	inv = TRUE;
 
 	/* Check memorized grids */
-	if (cave_has(cave_info[row][col], CAVE_MARK)) 
+	if (cave_has(row, col, CAVE_MARK)) 
 	{
 	    bool notice = TRUE;
 
@@ -916,7 +1099,7 @@ static bool run_test(void)
 
 	    /* Unknown grid or non-wall */
 	    /* Was: cave_floor_bold(row, col) */
-	    if (!cave_has(cave_info[row][col], CAVE_MARK)
+	    if (!cave_has(row, col, CAVE_MARK)
 		|| !tf_has(f_ptr->flags, TF_ROCK))
 	    {
 		/* Looking to break right */
@@ -943,7 +1126,7 @@ static bool run_test(void)
 
 	    /* Unknown grid or non-wall */
 	    /* Was: cave_floor_bold(row, col) */
-	    if (!cave_has(cave_info[row][col], CAVE_MARK)
+	    if (!cave_has(row, col, CAVE_MARK)
 		|| !tf_has(f_ptr->flags, TF_ROCK))
 	    {
 		/* Looking to break left */
@@ -1097,7 +1280,7 @@ void run_step(int dir)
 		x = p_ptr->px + ddx[pf_result[pf_result_index] - '0'];
 
 		/* Known wall */
-		if (cave_has(cave_info[y][x], CAVE_MARK) && !is_valid_pf(y, x))
+		if (cave_has(y, x, CAVE_MARK) && !is_valid_pf(y, x))
 		{
 		    disturb(0, 0);
 		    p_ptr->running_withpathfind = FALSE;
@@ -1118,7 +1301,7 @@ void run_step(int dir)
 		x = p_ptr->px + ddx[pf_result[pf_result_index] - '0'];
 
 		/* Known wall */
-		if (cave_has(cave_info[y][x], CAVE_MARK) && !is_valid_pf(y, x))
+		if (cave_has(y, x, CAVE_MARK) && !is_valid_pf(y, x))
 		{
 		    disturb(0, 0);
 		    p_ptr->running_withpathfind = FALSE;
@@ -1130,7 +1313,7 @@ void run_step(int dir)
 		x = x + ddx[pf_result[pf_result_index - 1] - '0'];
 
 		/* Known wall */
-		if (cave_has(cave_info[y][x], CAVE_MARK) && !is_valid_pf(y, x))
+		if (cave_has(y, x, CAVE_MARK) && !is_valid_pf(y, x))
 		{
 		    p_ptr->running_withpathfind = FALSE;
 
@@ -1974,6 +1974,300 @@ static void shape_change_main(player_state *state)
 
 
 
+/**
+ * Set the player's state from object and curse flags
+ */
+static void calc_flag_state(player_state *state, const bitflag *flags_obj,
+			    const bitflag *flags_curse)
+{
+    /* Object flags */
+    if (of_has(flags_obj, OF_SUSTAIN_STR))
+	state->sustain_str = TRUE;
+    if (of_has(flags_obj, OF_SUSTAIN_INT))
+	state->sustain_int = TRUE;
+    if (of_has(flags_obj, OF_SUSTAIN_WIS))
+	state->sustain_wis = TRUE;
+    if (of_has(flags_obj, OF_SUSTAIN_DEX))
+	state->sustain_dex = TRUE;
+    if (of_has(flags_obj, OF_SUSTAIN_CON))
+	state->sustain_con = TRUE;
+    if (of_has(flags_obj, OF_SUSTAIN_CHR))
+	state->sustain_chr = TRUE;
+    if (of_has(flags_obj, OF_SLOW_DIGEST))
+	state->slow_digest = TRUE;
+    if (of_has(flags_obj, OF_FEATHER))
+	state->ffall = TRUE;
+    if (of_has(flags_obj, OF_LIGHT))
+	state->light = TRUE;
+    if (of_has(flags_obj, OF_REGEN))
+	state->regenerate = TRUE;
+    if (of_has(flags_obj, OF_TELEPATHY))
+	state->telepathy = TRUE;
+    if (of_has(flags_obj, OF_SEE_INVIS))
+	state->see_inv = TRUE;
+    if (of_has(flags_obj, OF_FREE_ACT))
+	state->free_act = TRUE;
+    if (of_has(flags_obj, OF_HOLD_LIFE))
+	state->hold_life = TRUE;
+    if (of_has(flags_obj, OF_BLESSED))
+	state->bless_blade = TRUE;
+    if (of_has(flags_obj, OF_IMPACT))
+	state->impact = TRUE;
+    if (of_has(flags_obj, OF_FEARLESS))
+	state->no_fear = TRUE;
+    if (of_has(flags_obj, OF_SEEING))
+	state->no_blind = TRUE;
+    if (of_has(flags_obj, OF_DARKNESS))
+	state->darkness = TRUE;
+
+    /* Curse flags */
+    if (cf_has(flags_curse, CF_TELEPORT))
+	state->teleport = TRUE;
+    if (cf_has(flags_curse, CF_NO_TELEPORT))
+	state->no_teleport = TRUE;
+    if (cf_has(flags_curse, CF_AGGRO_PERM))
+	state->aggravate = TRUE;
+    if (cf_has(flags_curse, CF_AGGRO_RAND))
+	state->rand_aggro = TRUE;
+    if (cf_has(flags_curse, CF_SLOW_REGEN))
+	state->slow_regen = TRUE;
+    if (cf_has(flags_curse, CF_AFRAID))
+	state->fear = TRUE;
+    if (cf_has(flags_curse, CF_HUNGRY))
+	state->fast_digest = TRUE;
+    if (cf_has(flags_curse, CF_POIS_RAND))
+	state->rand_pois = TRUE;
+    if (cf_has(flags_curse, CF_POIS_RAND_BAD))
+	state->rand_pois_bad = TRUE;
+    if (cf_has(flags_curse, CF_CUT_RAND))
+	state->rand_cuts = TRUE;
+    if (cf_has(flags_curse, CF_CUT_RAND_BAD))
+	state->rand_cuts_bad = TRUE;
+    if (cf_has(flags_curse, CF_HALLU_RAND))
+	state->rand_hallu = TRUE;
+    if (cf_has(flags_curse, CF_DROP_WEAPON))
+	state->drop_weapon = TRUE;
+    if (cf_has(flags_curse, CF_ATTRACT_DEMON))
+	state->attract_demon = TRUE;
+    if (cf_has(flags_curse, CF_ATTRACT_UNDEAD))
+	state->attract_undead = TRUE;
+    if (cf_has(flags_curse, CF_PARALYZE))
+	state->rand_paral = TRUE;
+    if (cf_has(flags_curse, CF_PARALYZE_ALL))
+	state->rand_paral_all = TRUE;
+    if (cf_has(flags_curse, CF_DRAIN_EXP))
+	state->drain_exp = TRUE;
+    if (cf_has(flags_curse, CF_DRAIN_MANA))
+	state->drain_mana = TRUE;
+    if (cf_has(flags_curse, CF_DRAIN_STAT))
+	state->drain_stat = TRUE;
+    if (cf_has(flags_curse, CF_DRAIN_CHARGE))
+	state->drain_charge = TRUE;
+}
+
+
+
+/**
+ * What one worn object adds to the player's state, as far as that depends
+ * only on the object.  Armour class, resistances and the displayed bonuses
+ * depend on the slot, the order or the player's knowledge, and are left to
+ * calc_bonuses_aux().
+ */
+typedef struct slot_bonus {
+    int stat_add[A_MAX];
+    int stealth;
+    int search;
+    int digging;
+    int device;
+    int see_infra;
+    int pspeed;
+    int extra_shots;
+    int extra_might;
+    int to_h;
+    int to_d;
+    bitflag flags_obj[OF_SIZE];
+    bitflag flags_curse[CF_SIZE];
+} slot_bonus;
+
+/**
+ * Count of bonus updates; anything which changes the equipment asks for
+ * one, so the cache below is good until the count moves on.
+ */
+static u32b equip_gen = 1;
+
+/**
+ * The bonuses of each equipment slot, and their total, as at update
+ * "gen".
+ */
+static struct {
+    u32b gen;
+    slot_bonus slot[INVEN_TOTAL];
+    slot_bonus total;
+} equip_cache;
+
+/**
+ * Work out the bonuses of object "o_ptr" worn in equipment slot "slot".
+ */
+static void slot_bonus_calc(const object_type *o_ptr, int slot,
+			    slot_bonus *sb)
+{
+    int j;
+
+    WIPE(sb, slot_bonus);
+
+    /* Skip non-objects */
+    if (!o_ptr->k_idx)
+	return;
+
+    for (j = 0; j < A_MAX; j++)
+	sb->stat_add[j] = o_ptr->bonus_stat[j];
+    sb->stealth = o_ptr->bonus_other[P_BONUS_STEALTH];
+
+    /* Searching ability and frequency (factor of five) */
+    sb->search = o_ptr->bonus_other[P_BONUS_SEARCH] * 5;
+
+    /* Digging (factor of 20) */
+    sb->digging = o_ptr->bonus_other[P_BONUS_TUNNEL] * 20;
+    sb->device = 10 * o_ptr->bonus_other[P_BONUS_M_MASTERY];
+    sb->see_infra = o_ptr->bonus_other[P_BONUS_INFRA];
+    sb->pspeed = o_ptr->bonus_other[P_BONUS_SPEED];
+
+    /* Shots and might.  Altered in Oangband. */
+    sb->extra_shots = o_ptr->bonus_other[P_BONUS_SHOTS];
+    sb->extra_might = o_ptr->bonus_other[P_BONUS_MIGHT];
+
+    /* Hack -- "weapon" and "bow" bonuses are not applied */
+    if ((slot != INVEN_WIELD) && (slot != INVEN_BOW)) {
+	sb->to_h = o_ptr->to_h;
+	sb->to_d = o_ptr->to_d;
+    }
+
+    of_copy(sb->flags_obj, o_ptr->flags_obj);
+    cf_copy(sb->flags_curse, o_ptr->flags_curse);
+}
+
+/**
+ * Add (sign 1) or take away (sign -1) slot bonuses "sb" to or from
+ * "total".  Flags can only be added.
+ */
+static void slot_bonus_add(slot_bonus *total, const slot_bonus *sb, int sign)
+{
+    int j;
+
+    for (j = 0; j < A_MAX; j++)
+	total->stat_add[j] += sign * sb->stat_add[j];
+    total->stealth += sign * sb->stealth;
+    total->search += sign * sb->search;
+    total->digging += sign * sb->digging;
+    total->device += sign * sb->device;
+    total->see_infra += sign * sb->see_infra;
+    total->pspeed += sign * sb->pspeed;
+    total->extra_shots += sign * sb->extra_shots;
+    total->extra_might += sign * sb->extra_might;
+    total->to_h += sign * sb->to_h;
+    total->to_d += sign * sb->to_d;
+
+    if (sign > 0) {
+	of_union(total->flags_obj, sb->flags_obj);
+	cf_union(total->flags_curse, sb->flags_curse);
+    }
+}
+
+/**
+ * Get the total bonuses of the equipment in "inventory", with slot
+ * "swap_slot" (if not negative) holding "swap" instead.
+ *
+ * For the player's own equipment the slot bonuses are kept from one call
+ * to the next, and a swap only changes the one slot; the cache is made
+ * again after each bonus update, and is not used while one is pending.
+ */
+static void equip_bonus(object_type inventory[], int swap_slot,
+			const object_type *swap, slot_bonus *total)
+{
+    int i;
+    slot_bonus sb;
+
+    /* Some other equipment, or the cache may be out of date */
+    if ((inventory != p_ptr->inventory) || (p_ptr->update & (PU_BONUS))) {
+	WIPE(total, slot_bonus);
+	for (i = INVEN_WIELD; i < INVEN_TOTAL; i++) {
+	    slot_bonus_calc((i == swap_slot) ? swap : &inventory[i], i, &sb);
+	    slot_bonus_add(total, &sb, 1);
+	}
+	return;
+    }
+
+    /* Make the cache again after an update */
+    if (equip_cache.gen != equip_gen) {
+	WIPE(&equip_cache.total, slot_bonus);
+	for (i = INVEN_WIELD; i < INVEN_TOTAL; i++) {
+	    slot_bonus_calc(&inventory[i], i, &equip_cache.slot[i]);
+	    slot_bonus_add(&equip_cache.total, &equip_cache.slot[i], 1);
+	}
+	equip_cache.gen = equip_gen;
+    }
+
+    *total = equip_cache.total;
+
+    /* Nothing swapped */
+    if (swap_slot < 0)
+	return;
+
+    /* Swap the one slot */
+    slot_bonus_calc(swap, swap_slot, &sb);
+    slot_bonus_add(total, &equip_cache.slot[swap_slot], -1);
+    slot_bonus_add(total, &sb, 1);
+
+    /* The flags have to be gathered again without the old object */
+    of_copy(total->flags_obj, sb.flags_obj);
+    cf_copy(total->flags_curse, sb.flags_curse);
+    for (i = INVEN_WIELD; i < INVEN_TOTAL; i++) {
+	if (i == swap_slot)
+	    continue;
+	of_union(total->flags_obj, equip_cache.slot[i].flags_obj);
+	cf_union(total->flags_curse, equip_cache.slot[i].flags_curse);
+    }
+}
+
+/**
+ * Does object "o_ptr" change any resistance?
+ */
+static bool slot_has_resist(const object_type *o_ptr)
+{
+    int j;
+
+    for (j = 0; j < MAX_P_RES; j++)
+	if (o_ptr->percent_res[j] != RES_LEVEL_BASE)
+	    return TRUE;
+
+    return FALSE;
+}
+
+/**
+ * Get the armour class and bonus to it that object "o_ptr" gives in
+ * equipment slot "slot".  Shields worn on back are penalized.  Shield and
+ * Armor masters benefit.
+ */
+static void slot_armour(const object_type *o_ptr, int slot,
+			bool shield_on_back, int *ac, int *to_a)
+{
+    if ((slot == INVEN_ARM) && shield_on_back)
+	*ac = o_ptr->ac / 3;
+    else if ((slot == INVEN_ARM) && (player_has(PF_SHIELD_MAST)))
+	*ac = o_ptr->ac * 2;
+    else if ((slot == INVEN_BODY) && (player_has(PF_ARMOR_MAST)))
+	*ac = (o_ptr->ac * 5) / 3;
+    else
+	*ac = o_ptr->ac;
+
+    if ((slot == INVEN_ARM) && shield_on_back)
+	*to_a = o_ptr->to_a / 2;
+    else
+	*to_a = o_ptr->to_a;
+}
+
+
+
 /**
  * Calculate the players current "state", taking into account
  * not only race/class intrinsics, but also objects being worn
@@ -2002,19 +2296,24 @@ static void shape_change_main(player_state *state)
  *
  * This function induces various "status" messages.
  */
-extern void calc_bonuses(object_type inventory[], player_state *state, 
-			 bool inspect)
+static void calc_bonuses_aux(object_type inventory[], int swap_slot,
+			     const object_type *swap, player_state *state)
 {
     int i, j, hold;
 
-    int temp_armour;
+    int temp_armour, temp_to_a;
 
     int extra_shots = 0;
     int extra_might = 0;
 
     bool enhance = FALSE;
 
-    object_type *o_ptr;
+    const object_type *o_ptr;
+
+    /* Bonuses and flags from the equipment */
+    slot_bonus bonus;
+    bitflag flags_obj[OF_SIZE];
+    bitflag flags_curse[CF_SIZE];
 
     /*** Reset ***/
 
@@ -2136,90 +2435,8 @@ extern void calc_bonuses(object_type inventory[], player_state *state,
 
     /*** Analyze player ***/
 
-    /* Object flags */
-    if (of_has(rp_ptr->flags_obj, OF_SUSTAIN_STR))
-	state->sustain_str = TRUE;
-    if (of_has(rp_ptr->flags_obj, OF_SUSTAIN_INT))
-	state->sustain_int = TRUE;
-    if (of_has(rp_ptr->flags_obj, OF_SUSTAIN_WIS))
-	state->sustain_wis = TRUE;
-    if (of_has(rp_ptr->flags_obj, OF_SUSTAIN_DEX))
-	state->sustain_dex = TRUE;
-    if (of_has(rp_ptr->flags_obj, OF_SUSTAIN_CON))
-	state->sustain_con = TRUE;
-    if (of_has(rp_ptr->flags_obj, OF_SUSTAIN_CHR))
-	state->sustain_chr = TRUE;
-    if (of_has(rp_ptr->flags_obj, OF_SLOW_DIGEST))
-	state->slow_digest = TRUE;
-    if (of_has(rp_ptr->flags_obj, OF_FEATHER))
-	state->ffall = TRUE;
-    if (of_has(rp_ptr->flags_obj, OF_LIGHT))
-	state->light = TRUE;
-    if (of_has(rp_ptr->flags_obj, OF_REGEN))
-	state->regenerate = TRUE;
-    if (of_has(rp_ptr->flags_obj, OF_TELEPATHY))
-	state->telepathy = TRUE;
-    if (of_has(rp_ptr->flags_obj, OF_SEE_INVIS))
-	state->see_inv = TRUE;
-    if (of_has(rp_ptr->flags_obj, OF_FREE_ACT))
-	state->free_act = TRUE;
-    if (of_has(rp_ptr->flags_obj, OF_HOLD_LIFE))
-	state->hold_life = TRUE;
-    if (of_has(rp_ptr->flags_obj, OF_BLESSED))
-	state->bless_blade = TRUE;
-    if (of_has(rp_ptr->flags_obj, OF_IMPACT))
-	state->impact = TRUE;
-    if (of_has(rp_ptr->flags_obj, OF_FEARLESS))
-	state->no_fear = TRUE;
-    if (of_has(rp_ptr->flags_obj, OF_SEEING))
-	state->no_blind = TRUE;
-    if (of_has(rp_ptr->flags_obj, OF_DARKNESS))
-	state->darkness = TRUE;
-
-
-    /* Curse flags */
-    if (cf_has(rp_ptr->flags_curse, CF_TELEPORT))
-	state->teleport = TRUE;
-    if (cf_has(rp_ptr->flags_curse, CF_NO_TELEPORT))
-	state->no_teleport = TRUE;
-    if (cf_has(rp_ptr->flags_curse, CF_AGGRO_PERM))
-	state->aggravate = TRUE;
-    if (cf_has(rp_ptr->flags_curse, CF_AGGRO_RAND))
-	state->rand_aggro = TRUE;
-    if (cf_has(rp_ptr->flags_curse, CF_SLOW_REGEN))
-	state->slow_regen = TRUE;
-    if (cf_has(rp_ptr->flags_curse, CF_AFRAID))
-	state->fear = TRUE;
-    if (cf_has(rp_ptr->flags_curse, CF_HUNGRY))
-	state->fast_digest = TRUE;
-    if (cf_has(rp_ptr->flags_curse, CF_POIS_RAND))
-	state->rand_pois = TRUE;
-    if (cf_has(rp_ptr->flags_curse, CF_POIS_RAND_BAD))
-	state->rand_pois_bad = TRUE;
-    if (cf_has(rp_ptr->flags_curse, CF_CUT_RAND))
-	state->rand_cuts = TRUE;
-    if (cf_has(rp_ptr->flags_curse, CF_CUT_RAND_BAD))
-	state->rand_cuts_bad = TRUE;
-    if (cf_has(rp_ptr->flags_curse, CF_HALLU_RAND))
-	state->rand_hallu = TRUE;
-    if (cf_has(rp_ptr->flags_curse, CF_DROP_WEAPON))
-	state->drop_weapon = TRUE;
-    if (cf_has(rp_ptr->flags_curse, CF_ATTRACT_DEMON))
-	state->attract_demon = TRUE;
-    if (cf_has(rp_ptr->flags_curse, CF_ATTRACT_UNDEAD))
-	state->attract_undead = TRUE;
-    if (cf_has(rp_ptr->flags_curse, CF_PARALYZE))
-	state->rand_paral = TRUE;
-    if (cf_has(rp_ptr->flags_curse, CF_PARALYZE_ALL))
-	state->rand_paral_all = TRUE;
-    if (cf_has(rp_ptr->flags_curse, CF_DRAIN_EXP))
-	state->drain_exp = TRUE;
-    if (cf_has(rp_ptr->flags_curse, CF_DRAIN_MANA))
-	state->drain_mana = TRUE;
-    if (cf_has(rp_ptr->flags_curse, CF_DRAIN_STAT))
-	state->drain_stat = TRUE;
-    if (cf_has(rp_ptr->flags_curse, CF_DRAIN_CHARGE))
-	state->drain_charge = TRUE;
+    /* Object and curse flags */
+    calc_flag_state(state, rp_ptr->flags_obj, rp_ptr->flags_curse);
 
     /* Resistances */
     for (i = 0; i < MAX_P_RES; i++) {
@@ -2281,175 +2498,57 @@ extern void calc_bonuses(object_type inventory[], player_state *state,
 
   /*** Analyze equipment ***/
 
-    /* Scan the equipment */
+    /* Add up the bonuses of the equipment */
+    equip_bonus(inventory, swap_slot, swap, &bonus);
+
+    for (j = 0; j < A_MAX; j++)
+	state->stat_add[j] += bonus.stat_add[j];
+    state->skills[SKILL_STEALTH] += bonus.stealth;
+    state->skills[SKILL_SEARCH] += bonus.search;
+    state->skills[SKILL_SEARCH_FREQUENCY] += bonus.search;
+    state->see_infra += bonus.see_infra;
+    state->skills[SKILL_DIGGING] += bonus.digging;
+    state->pspeed += bonus.pspeed;
+    state->skills[SKILL_DEVICE] += bonus.device;
+    extra_shots += bonus.extra_shots;
+    extra_might += bonus.extra_might;
+    state->to_h += bonus.to_h;
+    state->to_d += bonus.to_d;
+    of_copy(flags_obj, bonus.flags_obj);
+    cf_copy(flags_curse, bonus.flags_curse);
+
+    /* Scan the equipment for what depends on the slot or on knowledge */
     for (i = INVEN_WIELD; i < INVEN_TOTAL; i++) {
-	//	o_ptr = &p_ptr->inventory[i];
-	o_ptr = &(inventory[i]);
+	o_ptr = (i == swap_slot) ? swap : &inventory[i];
+
 	/* Skip non-objects */
 	if (!o_ptr->k_idx)
 	    continue;
 
-	/* Affect stats */
-	for (j = 0; j < A_MAX; j++)
-	    state->stat_add[j] += o_ptr->bonus_stat[j];
-
-	/* Affect stealth */
-	state->skills[SKILL_STEALTH] +=
-	    o_ptr->bonus_other[P_BONUS_STEALTH];
-
-	/* Affect searching ability (factor of five) */
-	state->skills[SKILL_SEARCH] +=
-	    (o_ptr->bonus_other[P_BONUS_SEARCH] * 5);
-
-	/* Affect searching frequency (factor of five) */
-	state->skills[SKILL_SEARCH_FREQUENCY] +=
-	    (o_ptr->bonus_other[P_BONUS_SEARCH] * 5);
-
-	/* Affect infravision */
-	state->see_infra += o_ptr->bonus_other[P_BONUS_INFRA];
-
-	/* Affect digging (factor of 20) */
-	state->skills[SKILL_DIGGING] +=
-	    (o_ptr->bonus_other[P_BONUS_TUNNEL] * 20);
-
-	/* Affect speed */
-	state->pspeed += o_ptr->bonus_other[P_BONUS_SPEED];
-
-	state->skills[SKILL_DEVICE] +=
-	    10 * o_ptr->bonus_other[P_BONUS_M_MASTERY];
-
-	/* Affect shots.  Altered in Oangband. */
-	extra_shots += o_ptr->bonus_other[P_BONUS_SHOTS];
-
-	/* Affect might.  Altered in Oangband. */
-	extra_might += o_ptr->bonus_other[P_BONUS_MIGHT];
-
-	/* Object flags */
-	if (of_has(o_ptr->flags_obj, OF_SUSTAIN_STR))
-	    state->sustain_str = TRUE;
-	if (of_has(o_ptr->flags_obj, OF_SUSTAIN_INT))
-	    state->sustain_int = TRUE;
-	if (of_has(o_ptr->flags_obj, OF_SUSTAIN_WIS))
-	    state->sustain_wis = TRUE;
-	if (of_has(o_ptr->flags_obj, OF_SUSTAIN_DEX))
-	    state->sustain_dex = TRUE;
-	if (of_has(o_ptr->flags_obj, OF_SUSTAIN_CON))
-	    state->sustain_con = TRUE;
-	if (of_has(o_ptr->flags_obj, OF_SUSTAIN_CHR))
-	    state->sustain_chr = TRUE;
-	if (of_has(o_ptr->flags_obj, OF_SLOW_DIGEST))
-	    state->slow_digest = TRUE;
-	if (of_has(o_ptr->flags_obj, OF_FEATHER))
-	    state->ffall = TRUE;
-	if (of_has(o_ptr->flags_obj, OF_LIGHT))
-	    state->light = TRUE;
-	if (of_has(o_ptr->flags_obj, OF_REGEN))
-	    state->regenerate = TRUE;
-	if (of_has(o_ptr->flags_obj, OF_TELEPATHY))
-	    state->telepathy = TRUE;
-	if (of_has(o_ptr->flags_obj, OF_SEE_INVIS))
-	    state->see_inv = TRUE;
-	if (of_has(o_ptr->flags_obj, OF_FREE_ACT))
-	    state->free_act = TRUE;
-	if (of_has(o_ptr->flags_obj, OF_HOLD_LIFE))
-	    state->hold_life = TRUE;
-	if (of_has(o_ptr->flags_obj, OF_FEARLESS))
-	    state->no_fear = TRUE;
-	if (of_has(o_ptr->flags_obj, OF_SEEING))
-	    state->no_blind = TRUE;
-	if (of_has(o_ptr->flags_obj, OF_IMPACT))
-	    state->impact = TRUE;
-	if (of_has(o_ptr->flags_obj, OF_BLESSED))
-	    state->bless_blade = TRUE;
-	if (of_has(o_ptr->flags_obj, OF_DARKNESS))
-	    state->darkness = TRUE;
-
-	/* Bad flags */
-	if (cf_has(o_ptr->flags_curse, CF_TELEPORT))
-	    state->teleport = TRUE;
-	if (cf_has(o_ptr->flags_curse, CF_NO_TELEPORT))
-	    state->no_teleport = TRUE;
-	if (cf_has(o_ptr->flags_curse, CF_AGGRO_PERM))
-	    state->aggravate = TRUE;
-	if (cf_has(o_ptr->flags_curse, CF_AGGRO_RAND))
-	    state->rand_aggro = TRUE;
-	if (cf_has(o_ptr->flags_curse, CF_SLOW_REGEN))
-	    state->slow_regen = TRUE;
-	if (cf_has(o_ptr->flags_curse, CF_AFRAID))
-	    state->fear = TRUE;
-	if (cf_has(o_ptr->flags_curse, CF_HUNGRY))
-	    state->fast_digest = TRUE;
-	if (cf_has(o_ptr->flags_curse, CF_POIS_RAND))
-	    state->rand_pois = TRUE;
-	if (cf_has(o_ptr->flags_curse, CF_POIS_RAND_BAD))
-	    state->rand_pois_bad = TRUE;
-	if (cf_has(o_ptr->flags_curse, CF_CUT_RAND))
-	    state->rand_cuts = TRUE;
-	if (cf_has(o_ptr->flags_curse, CF_CUT_RAND_BAD))
-	    state->rand_cuts_bad = TRUE;
-	if (cf_has(o_ptr->flags_curse, CF_HALLU_RAND))
-	    state->rand_hallu = TRUE;
-	if (cf_has(o_ptr->flags_curse, CF_DROP_WEAPON))
-	    state->drop_weapon = TRUE;
-	if (cf_has(o_ptr->flags_curse, CF_ATTRACT_DEMON))
-	    state->attract_demon = TRUE;
-	if (cf_has(o_ptr->flags_curse, CF_ATTRACT_UNDEAD))
-	    state->attract_undead = TRUE;
-	if (cf_has(o_ptr->flags_curse, CF_PARALYZE))
-	    state->rand_paral = TRUE;
-	if (cf_has(o_ptr->flags_curse, CF_PARALYZE_ALL))
-	    state->rand_paral_all = TRUE;
-	if (cf_has(o_ptr->flags_curse, CF_DRAIN_EXP))
-	    state->drain_exp = TRUE;
-	if (cf_has(o_ptr->flags_curse, CF_DRAIN_MANA))
-	    state->drain_mana = TRUE;
-	if (cf_has(o_ptr->flags_curse, CF_DRAIN_STAT))
-	    state->drain_stat = TRUE;
-	if (cf_has(o_ptr->flags_curse, CF_DRAIN_CHARGE))
-	    state->drain_charge = TRUE;
-
-
-	for (j = 0; j < MAX_P_RES; j++)
-	    apply_resist(&state->res_list[j], o_ptr->percent_res[j]);
-
-	/* Known resistance and immunity flags */
-	for (j = 0; j < MAX_P_RES; j++)
-	    if (if_has(o_ptr->id_other, OBJECT_ID_BASE_RESIST + j))
-		apply_resist(&state->dis_res_list[j],
-			     o_ptr->percent_res[j]);
-	/* End item resistances; do bounds check on resistance levels */
-	resistance_limits(state);
-
-	/* 
-	 * Modify the base armor class.   Shields worn on back are penalized. 
-	 * Shield and Armor masters benefit.
-	 */
-	if ((i == INVEN_ARM) && (state->shield_on_back))
-	    temp_armour = o_ptr->ac / 3;
-	else if ((i == INVEN_ARM) && (player_has(PF_SHIELD_MAST)))
-	    temp_armour = o_ptr->ac * 2;
-	else if ((i == INVEN_BODY) && (player_has(PF_ARMOR_MAST)))
-	    temp_armour = (o_ptr->ac * 5) / 3;
-	else
-	    temp_armour = o_ptr->ac;
-
-	state->ac += temp_armour;
+	/* Resistances apply in order, but most objects have none */
+	if (slot_has_resist(o_ptr)) {
+	    for (j = 0; j < MAX_P_RES; j++)
+		apply_resist(&state->res_list[j], o_ptr->percent_res[j]);
 
-	/* The base armor class is always known */
-	state->dis_ac += temp_armour;
+	    /* Known resistance and immunity flags */
+	    for (j = 0; j < MAX_P_RES; j++)
+		if (if_has(o_ptr->id_other, OBJECT_ID_BASE_RESIST + j))
+		    apply_resist(&state->dis_res_list[j],
+				 o_ptr->percent_res[j]);
 
-	/* Apply the bonuses to armor class.  Shields worn on back are
-	 * penalized. */
-	if ((state->shield_on_back) && (i == INVEN_ARM))
-	    temp_armour = o_ptr->to_a / 2;
-	else
-	    temp_armour = o_ptr->to_a;
+	    /* End item resistances; do bounds check on resistance levels */
+	    resistance_limits(state);
+	}
 
-	state->to_a += temp_armour;
+	/* Armour class; the base armor class is always known */
+	slot_armour(o_ptr, i, state->shield_on_back, &temp_armour, &temp_to_a);
+	state->ac += temp_armour;
+	state->dis_ac += temp_armour;
+	state->to_a += temp_to_a;
 
 	/* Apply the mental bonuses to armor class, if known */
 	if (if_has(o_ptr->id_other, IF_TO_A))
-	    state->dis_to_a += temp_armour;
+	    state->dis_to_a += temp_to_a;
 
 	/* Hack -- do not apply "weapon" bonuses */
 	if (i == INVEN_WIELD)
@@ -2459,10 +2558,6 @@ extern void calc_bonuses(object_type inventory[], player_state *state,
 	if (i == INVEN_BOW)
 	    continue;
 
-	/* Apply the bonuses to hit/damage */
-	state->to_h += o_ptr->to_h;
-	state->to_d += o_ptr->to_d;
-
 	/* Apply the mental bonuses tp hit/damage, if known */
 	if (if_has(o_ptr->id_other, IF_TO_H))
 	    state->dis_to_h += o_ptr->to_h;
@@ -2470,6 +2565,9 @@ extern void calc_bonuses(object_type inventory[], player_state *state,
 	    state->dis_to_d += o_ptr->to_d;
     }
 
+    /* Apply the equipment flags */
+    calc_flag_state(state, flags_obj, flags_curse);
+
     /* Hack -- clear a few flags for certain races. */
 
     /* The dark elf's saving grace */
@@ -2503,7 +2601,7 @@ extern void calc_bonuses(object_type inventory[], player_state *state,
     /* Unlight stealth boost */
     if (player_has(PF_UNLIGHT)) {
 	if ((p_ptr->cur_light <= 0) && (!is_daylight)
-	    && !cave_has(cave_info[p_ptr->py][p_ptr->px], CAVE_GLOW))
+	    && !cave_has(p_ptr->py, p_ptr->px, CAVE_GLOW))
 	    state->skills[SKILL_STEALTH] += 6;
 	else
 	    state->skills[SKILL_STEALTH] += 3;
@@ -2954,8 +3052,7 @@ extern void calc_bonuses(object_type inventory[], player_state *state,
   /*** Analyze current bow ***/
 
     /* Examine the "current bow" */
-    //o_ptr = &p_ptr->inventory[INVEN_BOW];
-    o_ptr = &(inventory[INVEN_BOW]);
+    o_ptr = (swap_slot == INVEN_BOW) ? swap : &inventory[INVEN_BOW];
     /* Assume not heavy */
     state->heavy_shoot = FALSE;
 
@@ -3077,8 +3174,7 @@ extern void calc_bonuses(object_type inventory[], player_state *state,
   /*** Analyze weapon ***/
 
     /* Examine the "current weapon" */
-    //o_ptr = &p_ptr->inventory[INVEN_WIELD];
-    o_ptr = &(inventory[INVEN_WIELD]);
+    o_ptr = (swap_slot == INVEN_WIELD) ? swap : &inventory[INVEN_WIELD];
 
     /* Assume that the player is not a Priest wielding an edged weapon. */
     state->icky_wield = FALSE;
@@ -3149,6 +3245,25 @@ extern void calc_bonuses(object_type inventory[], player_state *state,
 
 }
 
+/**
+ * Calculate the player's state with the given equipment.
+ */
+void calc_bonuses(object_type inventory[], player_state *state, bool inspect)
+{
+    calc_bonuses_aux(inventory, -1, NULL, state);
+}
+
+/**
+ * Calculate what the player's state would be if equipment slot "slot" held
+ * the object "o_ptr", reading it in place of that slot rather than copying
+ * and changing the real equipment; only that slot's bonuses are worked out
+ * again.  A negative slot gives the state with the current equipment.
+ */
+void calc_bonuses_swap(int slot, const object_type *o_ptr, player_state *state)
+{
+    calc_bonuses_aux(p_ptr->inventory, slot, o_ptr, state);
+}
+
 /*
  * Calculate bonuses, and print various things on changes.
  */
@@ -3162,6 +3277,9 @@ static void update_bonuses(void)
     
     /*** Calculate bonuses ***/
     
+    /* The equipment may have changed */
+    equip_gen++;
+
     calc_bonuses(p_ptr->inventory, &p_ptr->state, FALSE);
     
     
@@ -3199,12 +3317,24 @@ static void update_bonuses(void)
 		} else
 		    state->shield_on_back = FALSE;
 
-		/* Hack - recalculate bonuses again. */
+		/* Only the shield's armour changes, so move it across */
 		if (old.shield_on_back !=
 		    state->shield_on_back) {
+		    int ac, to_a, new_ac, new_to_a;
+
 		    /* do not check strength again */
 		    old.stat_ind[i] = state->stat_ind[i];
-		    calc_bonuses(p_ptr->inventory, &p_ptr->state, FALSE);
+
+		    o_ptr = &p_ptr->inventory[INVEN_ARM];
+		    slot_armour(o_ptr, INVEN_ARM, old.shield_on_back, &ac,
+				&to_a);
+		    slot_armour(o_ptr, INVEN_ARM, state->shield_on_back,
+				&new_ac, &new_to_a);
+		    state->ac += new_ac - ac;
+		    state->dis_ac += new_ac - ac;
+		    state->to_a += new_to_a - to_a;
+		    if (if_has(o_ptr->id_other, IF_TO_A))
+			state->dis_to_a += new_to_a - to_a;
 		}
 	    }
 
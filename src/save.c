@@ -18,6 +18,7 @@
  */
 
 #include "angband.h"
+#include "cave.h"
 #include "squelch.h"
 #include "history.h"
 #include "monster.h"
@@ -119,8 +120,9 @@ static void wr_item(object_type *o_ptr)
 /**
  * Write a "monster" record
  */
-static void wr_monster(monster_type *m_ptr)
+static void wr_monster(int m_idx)
 {
+    monster_type *m_ptr = &m_list[m_idx];
     monster_race *r_ptr = &r_info[m_ptr->r_idx];
 
     /* Special treatment for player ghosts */
@@ -135,7 +137,7 @@ static void wr_monster(monster_type *m_ptr)
     wr_s16b(m_ptr->maxhp);
     wr_s16b(m_ptr->csleep);
     wr_byte(m_ptr->mspeed);
-    wr_byte(m_ptr->energy);
+    wr_byte(mon_energy[m_idx]);
     wr_byte(m_ptr->stunned);
     wr_byte(m_ptr->confused);
     wr_byte(m_ptr->monfear);
@@ -903,7 +905,7 @@ void wr_dungeon(void)
 	    for (x = 0; x < DUNGEON_WID; x++)
 	    {
 		/* Extract the important cave_info flags */
-		tmp8u = cave_info[y][x][i];
+		tmp8u = cave_info_byte(y, x, i);
 	  
 		/* If the run is broken, or too full, flush it */
 		if ((tmp8u != prev_char) || (count == MAX_UCHAR))
@@ -1019,10 +1021,8 @@ void wr_monsters(void)
     /* Dump the monsters */
     for (i = 1; i < m_max; i++)
     {
-	monster_type *m_ptr = &m_list[i];
-      
 	/* Dump it */
-	wr_monster(m_ptr);
+	wr_monster(i);
     }
 
     /* Expansion */
@@ -17,8 +17,13 @@
  */
 #include <errno.h>
 #include "angband.h"
+#include "game-event.h"
 #include "savefile.h"
 
+#ifdef SET_UID
+# include <sys/wait.h>
+#endif
+
 
 /** Magic bits at beginning of savefile */
 static const byte savefile_magic[4] = { 83, 97, 118, 101 };
@@ -72,6 +77,43 @@ static u32b buffer_check;
 
 #define SAVEFILE_HEAD_SIZE		28
 
+/*
+ * Block codecs.  The codec a block was written with is kept in the top
+ * byte of its version in the block header; older savefiles always have
+ * zero there, and so load as they always did.
+ */
+#define BLOCK_CODEC_RAW		0
+#define BLOCK_CODEC_LZ		1
+
+#define BLOCK_CODEC_SHIFT	24
+#define BLOCK_VERSION_MASK	0x00FFFFFFL
+
+/*
+ * The LZ codec.  A packed block starts with its unpacked size (4 bytes),
+ * followed by a series of items, each starting with a control byte "c":
+ *  - c < 0x80: a run of (c + 1) literal bytes follows;
+ *  - c >= 0x80: copy ((c & 0x7F) + LZ_MIN_MATCH) bytes from an earlier
+ *    point in the output, given by the next 2 bytes as a distance back.
+ * Copies may overlap what they write, so a long run of one value (as in
+ * most of the dungeon and lore blocks) costs 3 bytes per LZ_MAX_MATCH.
+ */
+#define LZ_MIN_MATCH		3
+#define LZ_MAX_MATCH		(0x7F + LZ_MIN_MATCH)
+#define LZ_MAX_LITERAL		0x80
+#define LZ_MAX_DISTANCE		0xFFFF
+#define LZ_HASH_BITS		12
+
+/*
+ * No block unpacks to more than this; a bigger size in a packed block
+ * means the savefile is damaged, and nothing is allocated for it.
+ */
+#define LZ_MAX_BLOCK		0x1000000L
+
+#ifdef SET_UID
+/** The process writing a background save, or 0 if there is none */
+static pid_t save_pid = 0;
+#endif
+
 
 /** Utility **/
 
@@ -230,6 +272,199 @@ void pad_bytes(int n)
 
 
 
+/*** Block codec ***/
+
+/*
+ * Flush the literals in[start..end) to out[], which has room for "max"
+ * bytes, returning the new length or zero if they do not fit.
+ */
+static u32b lz_literals(const byte *in, u32b start, u32b end, byte *out,
+			u32b o, u32b max)
+{
+    while (start < end)
+    {
+	u32b n = MIN(end - start, LZ_MAX_LITERAL);
+
+	if (o + 1 + n > max) return 0;
+
+	out[o++] = (byte)(n - 1);
+	memcpy(out + o, in + start, n);
+	o += n;
+	start += n;
+    }
+
+    return o;
+}
+
+/*
+ * Pack "len" bytes of "in" into "out", which has room for "max" bytes.
+ * Returns the packed length, or zero if the packed block would not fit
+ * (short literal runs between copies can make it bigger than "len").
+ */
+static u32b lz_pack(const byte *in, u32b len, byte *out, u32b max)
+{
+    static u32b head[1 << LZ_HASH_BITS];
+    u32b i = 0, lit = 0, o = 0;
+
+    if (max < 4) return 0;
+
+    /* Unpacked size */
+    out[o++] = (byte)(len & 0xFF);
+    out[o++] = (byte)((len >> 8) & 0xFF);
+    out[o++] = (byte)((len >> 16) & 0xFF);
+    out[o++] = (byte)((len >> 24) & 0xFF);
+
+    /* Positions are stored plus one, so zero is "none" */
+    memset(head, 0, sizeof(head));
+
+    while (i + LZ_MIN_MATCH <= len)
+    {
+	u32b h = ((in[i] << 16) | (in[i + 1] << 8) | in[i + 2]) * 2654435761UL;
+	u32b cand, n, dist;
+
+	h >>= (32 - LZ_HASH_BITS);
+	cand = head[h];
+	head[h] = i + 1;
+
+	/* Look for a match with the last occurrence of these 3 bytes */
+	if (!cand || (i - (cand - 1) > LZ_MAX_DISTANCE) ||
+	    memcmp(in + cand - 1, in + i, LZ_MIN_MATCH))
+	{
+	    i++;
+	    continue;
+	}
+
+	dist = i - (cand - 1);
+	n = LZ_MIN_MATCH;
+	while ((i + n < len) && (n < LZ_MAX_MATCH) &&
+	       (in[i + n] == in[i + n - dist]))
+	    n++;
+
+	/* Write out what came before, then the copy */
+	o = lz_literals(in, lit, i, out, o, max);
+	if (!o || (o + 3 > max)) return 0;
+
+	out[o++] = (byte)(0x80 | (n - LZ_MIN_MATCH));
+	out[o++] = (byte)(dist & 0xFF);
+	out[o++] = (byte)(dist >> 8);
+
+	i += n;
+	lit = i;
+    }
+
+    return lz_literals(in, lit, len, out, o, max);
+}
+
+/*
+ * Unpack "len" bytes of packed data into a newly allocated buffer.
+ * Returns NULL if the data is damaged.
+ */
+static byte *lz_unpack(const byte *in, u32b len, u32b *out_len)
+{
+    u32b i = 4, o = 0, size;
+    byte *out;
+
+    if (len < 4) return NULL;
+
+    size = ((u32b) in[0]) | ((u32b) in[1] << 8) | ((u32b) in[2] << 16) |
+	((u32b) in[3] << 24);
+    if (size > LZ_MAX_BLOCK) return NULL;
+
+    out = mem_alloc(size ? size : 1);
+
+    while (i < len)
+    {
+	byte c = in[i++];
+
+	/* Literals */
+	if (c < 0x80)
+	{
+	    u32b n = c + 1;
+
+	    if ((i + n > len) || (o + n > size)) break;
+
+	    memcpy(out + o, in + i, n);
+	    i += n;
+	    o += n;
+	}
+
+	/* Copy */
+	else
+	{
+	    u32b n = (c & 0x7F) + LZ_MIN_MATCH, dist;
+
+	    if (i + 2 > len) break;
+
+	    dist = in[i] | (in[i + 1] << 8);
+	    i += 2;
+
+	    if (!dist || (dist > o) || (o + n > size)) break;
+
+	    for (; n; n--, o++)
+		out[o] = out[o - dist];
+	}
+    }
+
+    /* Must have used up everything, exactly */
+    if ((i != len) || (o != size))
+    {
+	mem_free(out);
+	return NULL;
+    }
+
+    *out_len = size;
+    return out;
+}
+
+/*
+ * Bytes past the room given to lz_pack() which savefile_check_codec()
+ * watches for stray writes.
+ */
+#define LZ_CHECK_GUARD		64
+
+/*
+ * Pack and unpack "len" bytes of "in" as try_save() and try_load() would,
+ * checking that the packer stays within its room and that the block comes
+ * back unchanged.  The packed length, or zero for a block which would be
+ * stored raw, goes in "packed_len".
+ */
+bool savefile_check_codec(const byte *in, u32b len, u32b *packed_len)
+{
+    byte *packed = mem_alloc(len + LZ_CHECK_GUARD);
+    byte *out;
+    u32b n, out_len = 0;
+    bool ok = TRUE;
+    int j;
+
+    memset(packed + len, 0xA5, LZ_CHECK_GUARD);
+
+    n = lz_pack(in, len, packed, len);
+
+    /* Nothing written past the room */
+    for (j = 0; j < LZ_CHECK_GUARD; j++)
+	if (packed[len + j] != 0xA5) ok = FALSE;
+
+    /* Comes back as it went in */
+    if (ok && n)
+    {
+	out = lz_unpack(packed, n, &out_len);
+
+	if (!out || (out_len != len) || memcmp(out, in, len))
+	    ok = FALSE;
+
+	mem_free(out);
+    }
+
+    mem_free(packed);
+
+    /* Blocks which do not shrink are stored raw */
+    *packed_len = (n < len) ? n : 0;
+    return ok;
+}
+
+
+
+
 /*** ****/
 
 
@@ -237,6 +472,8 @@ static bool try_save(ang_file *file)
 {
     byte savefile_head[SAVEFILE_HEAD_SIZE];
     size_t i, pos;
+    byte *packed = NULL;
+    u32b packed_size = 0;
 
     /* Start off the buffer */
     buffer = mem_alloc(BUFFER_INITIAL_SIZE);
@@ -244,10 +481,34 @@ static bool try_save(ang_file *file)
 
     for (i = 0; i < N_ELEMENTS(savefile_blocks); i++)
     {
+	u32b version = savefile_blocks[i].cur_ver;
+	byte *data = buffer;
+	u32b size;
+
 	buffer_pos = 0;
 	buffer_check = 0;
 
 	savefile_blocks[i].saver();
+	size = buffer_pos;
+
+	/* Pack the block, if that makes it smaller */
+	if (packed_size < buffer_pos)
+	{
+	    packed_size = buffer_pos;
+	    packed = mem_realloc(packed, packed_size);
+	}
+
+	if (buffer_pos)
+	{
+	    u32b n = lz_pack(buffer, buffer_pos, packed, buffer_pos);
+
+	    if (n && (n < buffer_pos))
+	    {
+		version |= ((u32b) BLOCK_CODEC_LZ << BLOCK_CODEC_SHIFT);
+		data = packed;
+		size = n;
+	    }
+	}
 
 	/* 16-byte block name */
 	pos = my_strcpy((char *)savefile_head,
@@ -256,19 +517,19 @@ static bool try_save(ang_file *file)
 	while (pos < 16)
 	    savefile_head[pos++] = 0;
 
-	/* 4-byte block version */
-	savefile_head[pos++] = (savefile_blocks[i].cur_ver & 0xFF);
-	savefile_head[pos++] = ((savefile_blocks[i].cur_ver >> 8) & 0xFF);
-	savefile_head[pos++] = ((savefile_blocks[i].cur_ver >> 16) & 0xFF);
-	savefile_head[pos++] = ((savefile_blocks[i].cur_ver >> 24) & 0xFF);
+	/* 4-byte block version, and codec */
+	savefile_head[pos++] = (version & 0xFF);
+	savefile_head[pos++] = ((version >> 8) & 0xFF);
+	savefile_head[pos++] = ((version >> 16) & 0xFF);
+	savefile_head[pos++] = ((version >> 24) & 0xFF);
 
-	/* 4-byte block size */
-	savefile_head[pos++] = (buffer_pos & 0xFF);
-	savefile_head[pos++] = ((buffer_pos >> 8) & 0xFF);
-	savefile_head[pos++] = ((buffer_pos >> 16) & 0xFF);
-	savefile_head[pos++] = ((buffer_pos >> 24) & 0xFF);
+	/* 4-byte block size, as stored */
+	savefile_head[pos++] = (size & 0xFF);
+	savefile_head[pos++] = ((size >> 8) & 0xFF);
+	savefile_head[pos++] = ((size >> 16) & 0xFF);
+	savefile_head[pos++] = ((size >> 24) & 0xFF);
 
-	/* 4-byte block checksum */
+	/* 4-byte block checksum, of the unpacked data */
 	savefile_head[pos++] = (buffer_check & 0xFF);
 	savefile_head[pos++] = ((buffer_check >> 8) & 0xFF);
 	savefile_head[pos++] = ((buffer_check >> 16) & 0xFF);
@@ -278,14 +539,15 @@ static bool try_save(ang_file *file)
 
 	file_write(file, (char *)savefile_head, SAVEFILE_HEAD_SIZE);
 
-	file_write(file, (char *)buffer, buffer_pos);
+	file_write(file, (char *)data, size);
 
 	/* pad to 4 byte multiples */
-	if (buffer_pos % 4)
-	    file_write(file, "xxx", 4 - (buffer_pos % 4));
+	if (size % 4)
+	    file_write(file, "xxx", 4 - (size % 4));
     }
 
     mem_free(buffer);
+    mem_free(packed);
 
     return TRUE;
 }
@@ -294,7 +556,8 @@ static bool try_save(ang_file *file)
 static bool try_load(ang_file *file)
 {
     byte savefile_head[SAVEFILE_HEAD_SIZE];
-    u32b block_version, block_size;
+    u32b block_version, block_size, stored_size;
+    int codec;
 
     while (TRUE)
     {
@@ -330,11 +593,16 @@ static bool try_load(ang_file *file)
 	    ((u32b) savefile_head[18] << 16) |
 	    ((u32b) savefile_head[19] << 24);
 
+	/* The codec is kept in the top byte */
+	codec = block_version >> BLOCK_CODEC_SHIFT;
+	block_version &= BLOCK_VERSION_MASK;
+
 	/* 4-byte block size */
 	block_size = ((u32b) savefile_head[20]) |
 	    ((u32b) savefile_head[21] << 8) |
 	    ((u32b) savefile_head[22] << 16) |
 	    ((u32b) savefile_head[23] << 24);
+	stored_size = block_size;
 
 	/* pad to 4 bytes */
 	if (block_size % 4)
@@ -349,6 +617,29 @@ static bool try_load(ang_file *file)
 	size = file_read(file, (char *) buffer, block_size);
 	assert(size == block_size);
 
+	/* Unpack it */
+	if (codec == BLOCK_CODEC_LZ)
+	{
+	    byte *packed = buffer;
+
+	    buffer = lz_unpack(packed, stored_size, &buffer_size);
+	    mem_free(packed);
+
+	    if (!buffer)
+	    {
+		note("Damaged savefile block!");
+		return -1;
+	    }
+	}
+
+	/* Unknown codec */
+	else if (codec != BLOCK_CODEC_RAW)
+	{
+	    note("Savefile block in an unknown format!");
+	    mem_free(buffer);
+	    return -1;
+	}
+
 	/* Try loading */
 	if (savefile_blocks[i].loader(block_version))
 	    return -1;
@@ -372,6 +663,9 @@ bool savefile_save(const char *path)
     char new_savefile[1024];
     char old_savefile[1024];
 
+    /* Let any background save finish first */
+    savefile_save_done(TRUE);
+
     /* New savefile */
     strnfmt(new_savefile, sizeof(new_savefile), "%s.new", path);
     strnfmt(old_savefile, sizeof(old_savefile), "%s.old", path);
@@ -431,6 +725,80 @@ bool savefile_save(const char *path)
 
 
 
+/*
+ * Save the player in a savefile from a forked copy of the game.
+ *
+ * The fork itself is the snapshot: the child has a copy-on-write image of
+ * the game as it is now, and writes and renames the savefile just as
+ * savefile_save() does, while the game carries on.  Only one background
+ * save runs at a time, and a normal save waits for it.
+ *
+ * Where there is no fork(), or it fails, the save is made at once.
+ */
+bool savefile_save_background(const char *path)
+{
+#ifdef SET_UID
+    pid_t pid;
+
+    /* Let any earlier background save finish first */
+    savefile_save_done(TRUE);
+
+    pid = fork();
+
+    /* The child saves and leaves, without touching the parent's terminal
+     * or buffered files */
+    if (pid == 0)
+	_exit(savefile_save(path) ? 0 : 1);
+
+    if (pid > 0)
+    {
+	save_pid = pid;
+	return TRUE;
+    }
+#endif
+
+    /* Save now */
+    if (!savefile_save(path))
+	return FALSE;
+
+    event_signal_flag(EVENT_SAVED, TRUE);
+    return TRUE;
+}
+
+
+/*
+ * Check on (or, if "wait" is set, wait for) a background save, and
+ * signal its outcome if it has finished.
+ *
+ * The game may have moved on since the save was started, so a successful
+ * background save does not count as "character_saved".
+ */
+bool savefile_save_done(bool wait)
+{
+#ifdef SET_UID
+    int status;
+    pid_t pid;
+
+    if (!save_pid) return TRUE;
+
+    do
+    {
+	pid = waitpid(save_pid, &status, wait ? 0 : WNOHANG);
+    } while ((pid < 0) && (errno == EINTR));
+
+    /* Still writing */
+    if (pid == 0) return FALSE;
+
+    save_pid = 0;
+    event_signal_flag(EVENT_SAVED, (pid > 0) && WIFEXITED(status) &&
+		      (WEXITSTATUS(status) == 0));
+#endif
+
+    return TRUE;
+}
+
+
+
 /*
  * Attempt to Load a "savefile"
  *
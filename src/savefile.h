@@ -13,6 +13,26 @@ bool savefile_load(const char *path);
  */
 bool savefile_save(const char *path);
 
+/**
+ * Start saving to the given location, leaving the writing to a background
+ * process where possible.  Returns FALSE if the save could not be started.
+ * EVENT_SAVED is signalled with the outcome once it is finished.
+ */
+bool savefile_save_background(const char *path);
+
+/**
+ * Check whether a background save has finished, or wait for it to if
+ * `wait` is set.  Returns TRUE if there is no background save running.
+ */
+bool savefile_save_done(bool wait);
+
+/**
+ * Pack and unpack `len` bytes of `in` with the savefile block codec, and
+ * check that they come back unchanged.  The packed length (zero if the
+ * block would be stored raw) is put in `packed_len`.
+ */
+bool savefile_check_codec(const byte *in, u32b len, u32b *packed_len);
+
 
 
 /*** Ignore these ***/
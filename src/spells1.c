@@ -138,6 +138,9 @@ s16b poly_r_idx(int base_idx, bool shapechange)
 	alloc_race_total += table[i].prob3;
     }
 
+    /* The running totals are out of date */
+    get_mon_num_forget();
+
     /* No legal monsters */
     if (alloc_race_total == 0) {
 	return (base_idx);
@@ -236,7 +239,7 @@ void teleport_away(int m_idx, int dis)
     monster_swap(oy, ox, ny, nx);
 
     /* Clear the cave_temp flag (the "project()" code may have set it). */
-    cave_off(cave_info[ny][nx], CAVE_TEMP);
+    cave_off(ny, nx, CAVE_TEMP);
 }
 
 
@@ -485,7 +488,7 @@ static void thrust_away(int who, int t_y, int t_x, int grids_away)
     }
 
     /* Clear the cave_temp flag (the "project()" code may have set it). */
-    cave_off(cave_info[y][x], CAVE_TEMP);
+    cave_off(y, x, CAVE_TEMP);
 }
 
 /**
@@ -557,7 +560,7 @@ void teleport_player(int dis, bool safe)
 		    continue;
 
 		/* No teleporting into vaults and such */
-		if (cave_has(cave_info[y][x], CAVE_ICKY))
+		if (cave_has(y, x, CAVE_ICKY))
 		    continue;
 	    } else {
 		/* Require any terrain capable of holding the player. */
@@ -633,7 +636,7 @@ void teleport_player(int dis, bool safe)
     }
 
     /* Clear the cave_temp flag (the "project()" code may have set it). */
-    cave_off(cave_info[y][x], CAVE_TEMP);
+    cave_off(y, x, CAVE_TEMP);
 
     /* Handle stuff XXX XXX XXX */
     if (safe)
@@ -772,7 +775,7 @@ void teleport_player_to(int ny, int nx, bool friendly)
     monster_swap(py, px, y, x);
 
     /* Clear the cave_temp flag (the "project()" code may have set it). */
-    cave_off(cave_info[y][x], CAVE_TEMP);
+    cave_off(y, x, CAVE_TEMP);
 
     /* Handle stuff XXX XXX XXX */
     handle_stuff(p_ptr);
@@ -3009,7 +3012,7 @@ static bool project_f(int who, int y, int x, int dist, int dam, int typ)
 	{
 	    /* Mark the lava grid for (possible) later alteration. */
 	    if (tf_has(f_ptr->flags, TF_FREEZE) && (dist <= 1))
-		cave_on(cave_info[y][x], CAVE_TEMP);
+		cave_on(y, x, CAVE_TEMP);
 	    break;
 	}
 
@@ -3021,7 +3024,7 @@ static bool project_f(int who, int y, int x, int dist, int dam, int typ)
 	{
 	    if (dist <= 1) {
 		/* Mark the grid for (possible) later alteration. */
-		cave_on(cave_info[y][x], CAVE_TEMP);
+		cave_on(y, x, CAVE_TEMP);
 	    }
 	    break;
 	}
@@ -3033,7 +3036,7 @@ static bool project_f(int who, int y, int x, int dist, int dam, int typ)
 	    if (dist <= 1) {
 		/* Mark the floor grid for (possible) later alteration. */
 		if (tf_has(f_ptr->flags, TF_FLOOR))
-		    cave_on(cave_info[y][x], CAVE_TEMP);
+		    cave_on(y, x, CAVE_TEMP);
 	    }
 	    break;
 	}
@@ -3043,7 +3046,7 @@ static bool project_f(int who, int y, int x, int dist, int dam, int typ)
 	{
 	    if (dist <= 1) {
 		/* Mark the grid for (possible) later alteration. */
-		cave_on(cave_info[y][x], CAVE_TEMP);
+		cave_on(y, x, CAVE_TEMP);
 	    }
 	    break;
 	}
@@ -3111,7 +3114,7 @@ static bool project_f(int who, int y, int x, int dist, int dam, int typ)
 		}
 
 		/* Forget the door */
-		cave_off(cave_info[y][x], CAVE_MARK);
+		cave_off(y, x, CAVE_MARK);
 
 		/* Destroy the feature */
 		if (outside)
@@ -3144,13 +3147,13 @@ static bool project_f(int who, int y, int x, int dist, int dam, int typ)
 		/* Granite */
 		if (tf_has(f_ptr->flags, TF_GRANITE)) {
 		    /* Message */
-		    if (cave_has(cave_info[y][x], CAVE_MARK)) {
+		    if (cave_has(y, x, CAVE_MARK)) {
 			msg("The wall turns into mud.");
 			obvious = TRUE;
 		    }
 
 		    /* Forget the wall */
-		    cave_off(cave_info[y][x], CAVE_MARK);
+		    cave_off(y, x, CAVE_MARK);
 
 		    /* Destroy the wall */
 		    if (outside)
@@ -3163,7 +3166,7 @@ static bool project_f(int who, int y, int x, int dist, int dam, int typ)
 		else if (tf_has(f_ptr->flags, TF_GOLD))
 		{
 		    /* Message */
-		    if (cave_has(cave_info[y][x], CAVE_MARK)) 
+		    if (cave_has(y, x, CAVE_MARK)) 
 		    {
 			msg("The vein turns into mud.");
 			msg("You have found something!");
@@ -3171,7 +3174,7 @@ static bool project_f(int who, int y, int x, int dist, int dam, int typ)
 		    }
 
 		    /* Forget the wall */
-		    cave_off(cave_info[y][x], CAVE_MARK);
+		    cave_off(y, x, CAVE_MARK);
 
 		    /* Destroy the wall */
 		    if (outside)
@@ -3188,13 +3191,13 @@ static bool project_f(int who, int y, int x, int dist, int dam, int typ)
 			 tf_has(f_ptr->flags, TF_QUARTZ))
 		{
 		    /* Message */
-		    if (cave_has(cave_info[y][x], CAVE_MARK)) {
+		    if (cave_has(y, x, CAVE_MARK)) {
 			msg("The vein turns into mud.");
 			obvious = TRUE;
 		    }
 
 		    /* Forget the wall */
-		    cave_off(cave_info[y][x], CAVE_MARK);
+		    cave_off(y, x, CAVE_MARK);
 
 		    /* Destroy the wall */
 		    if (outside)
@@ -3207,14 +3210,14 @@ static bool project_f(int who, int y, int x, int dist, int dam, int typ)
 		else if (tf_has(f_ptr->flags, TF_ROCK))
 		{
 		    /* Message */
-		    if (cave_has(cave_info[y][x], CAVE_MARK)) 
+		    if (cave_has(y, x, CAVE_MARK)) 
 		    {
 			msg("The rubble turns into mud.");
 			obvious = TRUE;
 		    }
 
 		    /* Forget the wall */
-		    cave_off(cave_info[y][x], CAVE_MARK);
+		    cave_off(y, x, CAVE_MARK);
 
 		    /* Destroy the rubble */
 		    if (outside)
@@ -3239,13 +3242,13 @@ static bool project_f(int who, int y, int x, int dist, int dam, int typ)
 	    /* Destroy doors (and secret doors) */
 	    else if (tf_has(f_ptr->flags, TF_DOOR_ANY)) {
 		/* Hack -- special message */
-		if (cave_has(cave_info[y][x], CAVE_MARK)) {
+		if (cave_has(y, x, CAVE_MARK)) {
 		    msg("The door turns into mud!");
 		    obvious = TRUE;
 		}
 
 		/* Forget the wall */
-		cave_off(cave_info[y][x], CAVE_MARK);
+		cave_off(y, x, CAVE_MARK);
 
 		/* Destroy the feature */
 		if (outside)
@@ -3274,7 +3277,7 @@ static bool project_f(int who, int y, int x, int dist, int dam, int typ)
 	    cave_set_feat(y, x, FEAT_DOOR_HEAD + 0x00);
 
 	    /* Observe */
-	    if (cave_has(cave_info[y][x], CAVE_MARK))
+	    if (cave_has(y, x, CAVE_MARK))
 		obvious = TRUE;
 
 	    /* Update the visuals */
@@ -3315,7 +3318,7 @@ static bool project_f(int who, int y, int x, int dist, int dam, int typ)
     case GF_LIGHT:
 	{
 	    /* Turn on the light */
-	    cave_on(cave_info[y][x], CAVE_GLOW);
+	    cave_on(y, x, CAVE_GLOW);
 
 	    /* Grid is in line of sight */
 	    if (player_has_los_bold(y, x)) {
@@ -3335,14 +3338,14 @@ static bool project_f(int who, int y, int x, int dist, int dam, int typ)
     case GF_DARK:
 	{
 	    /* Turn off the light */
-	    cave_off(cave_info[y][x], CAVE_GLOW);
+	    cave_off(y, x, CAVE_GLOW);
 
 	    /* Hack -- Forget "boring" grids */
 	    if (tf_has(f_ptr->flags, TF_FLOOR)
-		&& !cave_has(cave_info[y][x], CAVE_TRAP))
+		&& !cave_has(y, x, CAVE_TRAP))
 	    {
 		/* Forget */
-		cave_off(cave_info[y][x], CAVE_MARK);
+		cave_off(y, x, CAVE_MARK);
 	    }
 
 	    /* Grid is in line of sight */
@@ -4434,7 +4437,7 @@ static bool project_m(int who, int y, int x, int dam, int typ, int flg)
 	    }
 
 	    /* Mark grid for later processing. */
-	    cave_on(cave_info[y][x], CAVE_TEMP);
+	    cave_on(y, x, CAVE_TEMP);
 
 	    break;
 	}
@@ -4455,7 +4458,7 @@ static bool project_m(int who, int y, int x, int dam, int typ, int flg)
 	    }
 
 	    /* Mark grid for later processing. */
-	    cave_on(cave_info[y][x], CAVE_TEMP);
+	    cave_on(y, x, CAVE_TEMP);
 
 	    break;
 	}
@@ -4517,7 +4520,7 @@ static bool project_m(int who, int y, int x, int dam, int typ, int flg)
 	    }
 
 	    /* Mark grid for later processing. */
-	    cave_on(cave_info[y][x], CAVE_TEMP);
+	    cave_on(y, x, CAVE_TEMP);
 
 	    break;
 	}
@@ -4537,7 +4540,7 @@ static bool project_m(int who, int y, int x, int dam, int typ, int flg)
 	    }
 
 	    /* Mark grid for later processing. */
-	    cave_on(cave_info[y][x], CAVE_TEMP);
+	    cave_on(y, x, CAVE_TEMP);
 
 	    break;
 	}
@@ -4584,7 +4587,7 @@ static bool project_m(int who, int y, int x, int dam, int typ, int flg)
 	    }
 
 	    /* Mark grid for later processing. */
-	    cave_on(cave_info[y][x], CAVE_TEMP);
+	    cave_on(y, x, CAVE_TEMP);
 
 	    break;
 	}
@@ -4651,8 +4654,7 @@ static bool project_m(int who, int y, int x, int dam, int typ, int flg)
 		dam *= 3;
 		dam /= 14 + randint0(3);
 	    } 
-	    else if (flags_test(r_ptr->spell_flags, RSF_SIZE, RSF_BREATH_MASK,
-				FLAG_END)) 
+	    else if (rsf_is_inter(r_ptr->spell_flags, rsf_breath_mask)) 
 	    {
 		dam *= 13;
 		dam /= 14 + randint0(3);
@@ -5079,7 +5081,7 @@ static bool project_m(int who, int y, int x, int dam, int typ, int flg)
     case GF_AWAY_UNDEAD:
 	{
 	    /* Mark grid for later processing. */
-	    cave_on(cave_info[y][x], CAVE_TEMP);
+	    cave_on(y, x, CAVE_TEMP);
 
 	    /* No damage */
 	    dam = 0;
@@ -5091,7 +5093,7 @@ static bool project_m(int who, int y, int x, int dam, int typ, int flg)
     case GF_AWAY_EVIL:
 	{
 	    /* Mark grid for later processing. */
-	    cave_on(cave_info[y][x], CAVE_TEMP);
+	    cave_on(y, x, CAVE_TEMP);
 
 	    /* No damage */
 	    dam = 0;
@@ -5104,7 +5106,7 @@ static bool project_m(int who, int y, int x, int dam, int typ, int flg)
     case GF_AWAY_ALL:
 	{
 	    /* Mark grid for later processing. */
-	    cave_on(cave_info[y][x], CAVE_TEMP);
+	    cave_on(y, x, CAVE_TEMP);
 
 	    /* No damage */
 	    dam = 0;
@@ -5988,7 +5990,7 @@ static bool project_p(int who, int d, int y, int x, int dam, int typ)
     }
 
     /* Hack - Darkness protects those who serve it. */
-    if (!cave_has(cave_info[p_ptr->py][p_ptr->px], CAVE_GLOW) && (!is_daylight)
+    if (!cave_has(p_ptr->py, p_ptr->px, CAVE_GLOW) && (!is_daylight)
 	&& (p_ptr->cur_light <= 0) && (player_has(PF_UNLIGHT)))
 	terrain_adjustment -= dam / 4;
 
@@ -6975,7 +6977,7 @@ static bool project_p(int who, int d, int y, int x, int dam, int typ)
 	    take_hit(dam, killer);
 
 	    /* Mark grid for later processing. */
-	    cave_on(cave_info[y][x], CAVE_TEMP);
+	    cave_on(y, x, CAVE_TEMP);
 
 	    break;
 	}
@@ -6998,7 +7000,7 @@ static bool project_p(int who, int d, int y, int x, int dam, int typ)
 	    take_hit(dam, killer);
 
 	    /* Mark grid for later processing. */
-	    cave_on(cave_info[y][x], CAVE_TEMP);
+	    cave_on(y, x, CAVE_TEMP);
 
 	    break;
 	}
@@ -7070,7 +7072,7 @@ static bool project_p(int who, int d, int y, int x, int dam, int typ)
 		notice_other(IF_RES_CONFU, 0);
 
 	    /* Mark grid for later processing. */
-	    cave_on(cave_info[y][x], CAVE_TEMP);
+	    cave_on(y, x, CAVE_TEMP);
 
 	    break;
 	}
@@ -7087,7 +7089,7 @@ static bool project_p(int who, int d, int y, int x, int dam, int typ)
 	    take_hit(dam, killer);
 
 	    /* Mark grid for later processing. */
-	    cave_on(cave_info[y][x], CAVE_TEMP);
+	    cave_on(y, x, CAVE_TEMP);
 
 	    break;
 	}
@@ -7137,7 +7139,7 @@ static bool project_p(int who, int d, int y, int x, int dam, int typ)
 	    take_hit(dam, killer);
 
 	    /* Mark grid for later processing. */
-	    cave_on(cave_info[y][x], CAVE_TEMP);
+	    cave_on(y, x, CAVE_TEMP);
 
 	    break;
 	}
@@ -7302,7 +7304,7 @@ static bool project_p(int who, int d, int y, int x, int dam, int typ)
 	    }
 
 	    /* Mark grid for later processing. */
-	    cave_on(cave_info[y][x], CAVE_TEMP);
+	    cave_on(y, x, CAVE_TEMP);
 
 	    /* Drain Exp */
 	    if (!p_resist_good(P_RES_CHAOS) || !p_resist_good(P_RES_NETHR)) {
@@ -7421,11 +7423,11 @@ static bool project_t(int who, int y, int x, int dam, int typ, int flg)
     const char *note = NULL;
 
     /* Only process marked grids. */
-    if (!cave_has(cave_info[y][x], CAVE_TEMP))
+    if (!cave_has(y, x, CAVE_TEMP))
 	return (FALSE);
 
     /* Clear the cave_temp flag. */
-    cave_off(cave_info[y][x], CAVE_TEMP);
+    cave_off(y, x, CAVE_TEMP);
 
 
     /* Projection will be affecting a player. */
@@ -7471,7 +7473,7 @@ static bool project_t(int who, int y, int x, int dam, int typ, int flg)
 		{
 
 		    /* Forget the lava */
-		    cave_off(cave_info[y][x], CAVE_MARK);
+		    cave_off(y, x, CAVE_MARK);
 
 		    /* Destroy the lava */
 		    if (randint1(3) != 1)
@@ -7503,7 +7505,7 @@ static bool project_t(int who, int y, int x, int dam, int typ, int flg)
 		    || (cave_feat[y][x] == FEAT_RUBBLE)) {
 
 		    /* Forget the floor or rubble. */
-		    cave_off(cave_info[y][x], CAVE_MARK);
+		    cave_off(y, x, CAVE_MARK);
 
 		    /* Make lava. */
 		    cave_set_feat(y, x, FEAT_LAVA);
@@ -7531,7 +7533,7 @@ static bool project_t(int who, int y, int x, int dam, int typ, int flg)
 		 * evaporate, as Smaug found out the hard way. */
 		if (dam > randint1(600 + k * 300) + 200) {
 		    /* Forget the water */
-		    cave_off(cave_info[y][x], CAVE_MARK);
+		    cave_off(y, x, CAVE_MARK);
 
 		    /* Destroy the water */
 		    if (outside)
@@ -7545,7 +7547,7 @@ static bool project_t(int who, int y, int x, int dam, int typ, int flg)
 	    if ((tf_has(f_ptr->flags, TF_TREE)) && 
 		(dam > randint1(400) + 100)) {
 		/* Forget the tree */
-		cave_off(cave_info[y][x], CAVE_MARK);
+		cave_off(y, x, CAVE_MARK);
 
 		/* Destroy the tree */
 		if (outside)
@@ -7660,7 +7662,7 @@ static bool project_t(int who, int y, int x, int dam, int typ, int flg)
 		/* If enough water available, make pool. */
 		if ((dam + (k * 20)) > 100 + (randint0(400))) {
 		    /* Forget the floor */
-		    cave_off(cave_info[y][x], CAVE_MARK);
+		    cave_off(y, x, CAVE_MARK);
 
 		    /* Create water */
 		    cave_set_feat(y, x, FEAT_WATER);
@@ -8589,7 +8591,7 @@ bool project(int who, int rad, int y, int x, int dam, int typ, int flg,
 	x = gx[i];
 
 	/* Grid must be marked. */
-	if (!cave_has(cave_info[y][x], CAVE_TEMP))
+	if (!cave_has(y, x, CAVE_TEMP))
 	    continue;
 
 	/* Affect marked grid */
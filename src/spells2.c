@@ -485,7 +485,7 @@ void dimen_door(void)
 
     /* Test for empty floor, forbid vaults or too large a distance, and insure
      * that this spell is never certain. */
-    if (!cave_empty_bold(ny, nx) || cave_has(cave_info[ny][nx], CAVE_ICKY)
+    if (!cave_empty_bold(ny, nx) || cave_has(ny, nx, CAVE_ICKY)
 	|| (distance(ny, nx, p_ptr->py, p_ptr->px) > 25)
 	|| (randint0(p_ptr->lev) == 0)) {
 	msg("You fail to exit the astral plane correctly!");
@@ -1571,7 +1571,7 @@ bool detect_traps(int range, bool show)
 		}
 
 		/* Mark grid as detected */
-		cave_on(cave_info[y][x], CAVE_DTRAP);
+		cave_on(y, x, CAVE_DTRAP);
 	    }
 	}
     }
@@ -1633,7 +1633,7 @@ bool detect_doors(int range, bool show)
 		if (tf_has(f_ptr->flags, TF_DOOR_ANY)) 
 		{
 		    /* Hack -- Memorize */
-		    cave_on(cave_info[y][x], CAVE_MARK);
+		    cave_on(y, x, CAVE_MARK);
 
 		    /* Redraw */
 		    light_spot(y, x);
@@ -1693,7 +1693,7 @@ bool detect_stairs(int range, bool show)
 		    tf_has(f_ptr->flags, TF_PATH))
 		{
 		    /* Hack -- Memorize */
-		    cave_on(cave_info[y][x], CAVE_MARK);
+		    cave_on(y, x, CAVE_MARK);
 
 		    /* Redraw */
 		    light_spot(y, x);
@@ -1765,7 +1765,7 @@ bool detect_treasure(int range, bool show)
 		    || (cave_feat[y][x] == FEAT_QUARTZ_K)) 
 		{
 		    /* Hack -- Memorize */
-		    cave_on(cave_info[y][x], CAVE_MARK);
+		    cave_on(y, x, CAVE_MARK);
 
 		    /* Redraw */
 		    light_spot(y, x);
@@ -2352,7 +2352,7 @@ bool detect_monsters_living(int range, bool show)
 	    /* Notice trees */
 	    if (tf_has(f_ptr->flags, TF_TREE)) {
 		/* Mark it */
-		cave_on(cave_info[y][x], CAVE_MARK);
+		cave_on(y, x, CAVE_MARK);
 
 		/* Count it */
 		num++;
@@ -3783,7 +3783,7 @@ void do_starlight(int burst_number, int dam, bool strong)
     feature_type *f_ptr;
 
     /* Is the player in a square already magically lit? */
-    bool player_lit = cave_has(cave_info[p_ptr->py][p_ptr->px], CAVE_GLOW);
+    bool player_lit = cave_has(p_ptr->py, p_ptr->px, CAVE_GLOW);
 
     for (i = 0; i < burst_number; i++) {
 	/* First, we find the spot. */
@@ -3817,7 +3817,7 @@ void do_starlight(int burst_number, int dam, bool strong)
 	/* Then we hit the spot. */
 
 	/* Confusing to be suddenly lit up. */
-	if (!cave_has(cave_info[y][x], CAVE_GLOW))
+	if (!cave_has(y, x, CAVE_GLOW))
 	    fire_meteor(-1, GF_CONFU, y, x, dam, strong ? 1 : 0, FALSE);
 
 	/* The actual burst of light. */
@@ -4471,7 +4471,7 @@ bool genocide(void)
 	    continue;
 
 	/* Ignore monsters in icky squares */
-	if (cave_has(cave_info[m_ptr->fy][m_ptr->fx], CAVE_ICKY))
+	if (cave_has(m_ptr->fy, m_ptr->fx, CAVE_ICKY))
 	    continue;
 
 	/* Delete the monster */
@@ -4510,7 +4510,7 @@ bool mass_genocide(void)
 	    continue;
 
 	/* Ignore monsters in icky squares */
-	if (cave_has(cave_info[m_ptr->fy][m_ptr->fx], CAVE_ICKY))
+	if (cave_has(m_ptr->fy, m_ptr->fx, CAVE_ICKY))
 	    continue;
 
 	/* Delete the monster */
@@ -4618,15 +4618,15 @@ void destroy_area(int y1, int x1, int r, bool full)
 		continue;
 
 	    /* Ignore icky squares */
-	    if (cave_has(cave_info[y][x], CAVE_ICKY))
+	    if (cave_has(y, x, CAVE_ICKY))
 		continue;
 
 	    /* Lose room */
-	    cave_off(cave_info[y][x], CAVE_ROOM);
+	    cave_off(y, x, CAVE_ROOM);
 
 	    /* Lose light and knowledge */
-	    cave_off(cave_info[y][x], CAVE_MARK);
-	    cave_off(cave_info[y][x], CAVE_GLOW);
+	    cave_off(y, x, CAVE_MARK);
+	    cave_off(y, x, CAVE_GLOW);
 
 	    /* Hack -- Notice player affect */
 	    if (cave_m_idx[y][x] < 0) {
@@ -4777,11 +4777,11 @@ void earthquake(int cy, int cx, int r, bool volcano)
 		continue;
 
 	    /* Lose room */
-	    cave_off(cave_info[yy][xx], CAVE_ROOM);
+	    cave_off(yy, xx, CAVE_ROOM);
 
 	    /* Lose light and knowledge */
-	    cave_off(cave_info[yy][xx], CAVE_MARK);
-	    cave_off(cave_info[yy][xx], CAVE_GLOW);
+	    cave_off(yy, xx, CAVE_MARK);
+	    cave_off(yy, xx, CAVE_GLOW);
 
 	    /* Count total, water, lava and void grids */
 	    total++;
@@ -5213,7 +5213,7 @@ bool tremor(void)
 	nx = tx;
 
 	/* Test for empty floor and line of sight, forbid vaults */
-	if (cave_empty_bold(ny, nx) && !cave_has(cave_info[ny][nx], CAVE_ICKY)
+	if (cave_empty_bold(ny, nx) && !cave_has(ny, nx, CAVE_ICKY)
 	    && (player_has_los_bold(ny, nx)))
 	    valid_grid = TRUE;
     }
@@ -5250,10 +5250,10 @@ static void cave_temp_room_light(void)
 	int x = temp_x[i];
 
 	/* No longer in the array */
-	cave_off(cave_info[y][x], CAVE_TEMP);
+	cave_off(y, x, CAVE_TEMP);
 
 	/* Perma-Light */
-	cave_on(cave_info[y][x], CAVE_GLOW);
+	cave_on(y, x, CAVE_GLOW);
     }
 
     /* Fully update the visuals */
@@ -5333,17 +5333,17 @@ static void cave_temp_room_unlight(void)
 	feature_type *f_ptr = &f_info[cave_feat[y][x]];
 
 	/* No longer in the array */
-	cave_off(cave_info[y][x], CAVE_TEMP);
+	cave_off(y, x, CAVE_TEMP);
 
 	/* Darken the grid */
-	cave_off(cave_info[y][x], CAVE_GLOW);
+	cave_off(y, x, CAVE_GLOW);
 
 	/* Hack -- Forget "boring" grids */
 	if (tf_has(f_ptr->flags, TF_FLOOR) && 
-	    !cave_has(cave_info[y][x], CAVE_TRAP))
+	    !cave_has(y, x, CAVE_TRAP))
 	{
 	    /* Forget the grid */
-	    cave_off(cave_info[y][x], CAVE_MARK);
+	    cave_off(y, x, CAVE_MARK);
 	}
     }
 
@@ -5379,11 +5379,11 @@ static void cave_temp_room_aux(int y, int x)
 	return;
 
     /* Avoid infinite recursion */
-    if (cave_has(cave_info[y][x], CAVE_TEMP))
+    if (cave_has(y, x, CAVE_TEMP))
 	return;
 
     /* Do not "leave" the current room */
-    if (!cave_has(cave_info[y][x], CAVE_ROOM))
+    if (!cave_has(y, x, CAVE_ROOM))
 	return;
 
     /* Paranoia -- verify space */
@@ -5391,7 +5391,7 @@ static void cave_temp_room_aux(int y, int x)
 	return;
 
     /* Mark the grid as "seen" */
-    cave_on(cave_info[y][x], CAVE_TEMP);
+    cave_on(y, x, CAVE_TEMP);
 
     /* Add it to the "seen" set */
     temp_y[temp_n] = y;
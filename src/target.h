@@ -14,6 +14,7 @@ bool target_set_interactive(int mode, int x, int y);
 bool get_aim_dir(int *dp);
 void target_get(s16b *col, s16b *row);
 s16b target_get_monster(void);
+s16b target_get_object(void);
 bool target_is_set(void);
 
 #endif /* !TARGET_H */
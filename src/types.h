@@ -47,9 +47,9 @@
 
 
 /**
- * An array of 256 cave bitflag arrays
+ * A bitplane holding one cave flag for every grid
  */
-typedef bitflag grid_256[256][CAVE_SIZE];
+typedef u64b cave_plane[DUNGEON_HGT][CAVE_WORDS];
 
 /**
  * An array of DUNGEON_WID byte's
@@ -61,6 +61,11 @@ typedef byte byte_wid[DUNGEON_WID];
  */
 typedef s16b s16b_wid[DUNGEON_WID];
 
+/**
+ * An array of DUNGEON_WID s32b's
+ */
+typedef s32b s32b_wid[DUNGEON_WID];
+
 /**
  * An array of NUM_STAGES u16b's
  */
@@ -695,7 +700,6 @@ typedef struct {
     s16b csleep;	/**< Inactive counter */
 
     byte mspeed;	/**< Monster "speed" */
-    byte energy;	/**< Monster "energy" */
 
     byte stunned;	/**< Monster is stunned */
     byte confused;	/**< Monster is confused */
@@ -732,8 +736,6 @@ typedef struct {
 
     byte mana;		/**< Current mana level */
 
-    bool moved;		/**< Monster has moved this turn */
-
     byte p_race;	/**< Player-type race for race-based monsters */
     byte old_p_race;	/**< Old player-type race for shapechanged monsters */
     s16b hostile;	/**< Who the monster is hostile to (group id) */
@@ -319,6 +319,17 @@ ui_event inkey_ex(void)
 
 	term *old = Term;
 
+	bool scanning = (inkey_scan != SCAN_OFF);
+
+	/* A replay supplies the keys itself */
+	if (cmd_replaying())
+	{
+		ke = cmd_replay_key(scanning);
+		inkey_flag = FALSE;
+		inkey_scan = 0;
+		return (ke);
+	}
+
 	/* Delayed flush */
 	if (inkey_xtra) {
 		Term_flush();
@@ -357,6 +368,7 @@ ui_event inkey_ex(void)
 		}
 
 		/* Accept result */
+		cmd_record_key(&ke, scanning);
 		return (ke);
 	}
 
@@ -472,6 +484,8 @@ ui_event inkey_ex(void)
 	/* Restore the cursor */
 	Term_set_cursor(cursor_state);
 
+	/* Note the key for any recording */
+	cmd_record_key(&ke, scanning);
 
 	/* Cancel the various "global parameters" */
 	inkey_flag = FALSE;
@@ -614,7 +628,12 @@ static void msg_flush(int x)
 	Term_putstr(x, 0, -1, a, "-more-");
 
 	if ((!OPT(auto_more)) && !keymap_auto_more)
+	{
+		/* The key only dismisses the prompt, so is not recorded */
+		cmd_record_pause(TRUE);
 		anykey();
+		cmd_record_pause(FALSE);
+	}
 
 	/* Clear the line */
 	Term_erase(0, 0, 255);
@@ -649,11 +668,10 @@ static int message_column = 0;
  * Hack -- Note that "msg("%s", NULL)" will clear the top line even if no
  * messages are pending.
  */
-static void msg_print_aux(u16b type, const char *msg)
+static void msg_print_aux(u16b type, char *msg, size_t len)
 {
 	int n;
 	char *t;
-	char buf[1024];
 	byte color;
 	int w, h;
 
@@ -667,7 +685,7 @@ static void msg_print_aux(u16b type, const char *msg)
 	if (!msg_flag) message_column = 0;
 
 	/* Message Length */
-	n = (msg ? strlen(msg) : 0);
+	n = (msg ? (int)len : 0);
 
 	/* Hack -- flush when requested or needed */
 	if (message_column && (!msg || ((message_column + n) > (w - 8))))
@@ -692,16 +710,13 @@ static void msg_print_aux(u16b type, const char *msg)
 
 	/* Memorize the message (if legal) */
 	if (character_generated && !(p_ptr->is_dead))
-		message_add(msg, type);
+		message_add_len(msg, len, type);
 
 	/* Window stuff */
 	p_ptr->redraw |= (PR_MESSAGE);
 
-	/* Copy it */
-	my_strcpy(buf, msg, sizeof(buf));
-
-	/* Analyze the buffer */
-	t = buf;
+	/* Analyze the caller's buffer, which may be split in place */
+	t = msg;
 
 	/* Get the color of the message */
 	color = message_type_color(type);
@@ -763,29 +778,31 @@ void msg(const char *fmt, ...)
 	va_list vp;
 
 	char buf[1024];
+	size_t len;
 
 	/* Begin the Varargs Stuff */
 	va_start(vp, fmt);
 
 	/* Format the args, save the length */
-	(void)vstrnfmt(buf, sizeof(buf), fmt, vp);
+	len = vstrnfmt(buf, sizeof(buf), fmt, vp);
 
 	/* End the Varargs Stuff */
 	va_end(vp);
 
 	/* Display */
-	msg_print_aux(MSG_GENERIC, buf);
+	msg_print_aux(MSG_GENERIC, buf, len);
 }
 
 void msgt(unsigned int type, const char *fmt, ...)
 {
 	va_list vp;
 	char buf[1024];
+	size_t len;
 	va_start(vp, fmt);
-	vstrnfmt(buf, sizeof(buf), fmt, vp);
+	len = vstrnfmt(buf, sizeof(buf), fmt, vp);
 	va_end(vp);
 	sound(type);
-	msg_print_aux(type, buf);
+	msg_print_aux(type, buf, len);
 }
 
 /*
@@ -474,13 +474,6 @@ u16b *temp_g;
 byte *temp_y;
 byte *temp_x;
 
-/* 
- * Arrays[NUM_STAGES][NUM_STAGES] of numbers of paths between nearby stages
- */
-u16b (*adjacency)[NUM_STAGES];
-u16b (*stage_path)[NUM_STAGES];
-u16b (*temp_path)[NUM_STAGES];
-
 /** 
  * Array[NUM_STAGES][32] of racial probability boosts for each stage; will need
  * to be expanded if z_info->p_max goes above 32.
@@ -491,12 +484,12 @@ u16b (*race_prob)[NUM_STAGES];
 byte *dummy;
 
 /**
- * Array[DUNGEON_HGT][256] of cave grid info flags (padded)
+ * Array[CAVE_MAX] of cave grid info flag bitplanes
  *
- * These arrays are padded to a width of 256 to allow fast access to elements
- * in the array via "grid" values (see the GRID() macros).
+ * Each flag has its own plane, with one bit per grid, so that a flag can
+ * be set or cleared across the whole level a word at a time.
  */
-bitflag (*cave_info)[256][CAVE_SIZE];
+cave_plane *cave_info;
 
 /**
  * Array[DUNGEON_HGT][DUNGEON_WID] of cave grid feature codes
@@ -539,26 +532,23 @@ byte (*cave_cost)[DUNGEON_WID];
  * Array[DUNGEON_HGT][DUNGEON_WID] of cave grid flow "when" stamps.
  * Used to store character scent trails.
  */
-byte (*cave_when)[DUNGEON_WID];
+s32b (*cave_when)[DUNGEON_WID];
 
 /**
  * Current scent age marker.  Counts down from 250 to 0 and then loops.
  */
 int scent_when = 250;
 
-
-/*
- * Centerpoints of the last flow (noise) rebuild and the last flow update.
+/**
+ * Scent clock, which counts up every time scent is laid.  It starts high
+ * enough that no scent stamp is zero.
  */
-int flow_center_y;
-int flow_center_x;
-int update_center_y;
-int update_center_x;
+s32b scent_turn = SMELL_STRENGTH;
 
 /**
- * Flow cost at the center grid of the current update.
+ * The scent clock when the age marker last looped.
  */
-int cost_at_center = 0;
+s32b scent_loop = 0;
 
 
 /**
@@ -576,6 +566,20 @@ object_type *o_list;
  */
 monster_type *m_list;
 
+/**
+ * Array[z_info->m_max] of monster energy, and of "has moved this turn"
+ * flags.  These are kept out of m_list so that the scheduling pass in
+ * process_monsters() does not have to touch every monster record.
+ */
+byte *mon_energy;
+bool *mon_moved;
+
+/**
+ * Array[z_info->m_max] of the indexes of live monsters, in increasing order
+ */
+s16b *mon_active;
+s16b mon_active_n = 0;
+
 /**
  * Array[z_info->m_max] of monster lore
  */
@@ -606,6 +610,11 @@ s16b alloc_kind_size;
  */
 alloc_entry *alloc_kind_table;
 
+/**
+ * Picks entries from "alloc_kind_table", by their "prob3" values
+ */
+rand_table alloc_kind_pick;
+
 /**
  * The size of the "alloc_ego_table"
  */
@@ -631,6 +640,11 @@ alloc_entry *alloc_race_table;
  */
 u32b alloc_race_total;
 
+/**
+ * Picks entries from "alloc_race_table", by their "prob3" values
+ */
+rand_table alloc_race_pick;
+
 /*
  * Specify attr/char pairs for visual special effects for project()
  */
@@ -1087,6 +1101,17 @@ void (*sound_hook)(int sound);
 autoinscription *inscriptions = 0;
 u16b inscriptions_count = 0;
 
+/*
+ * Monster spell masks, built once from the RSF_*_MASK lists at startup so
+ * the AI can use them with the whole-set flag operations.
+ */
+bitflag rsf_breath_mask[RSF_SIZE];
+bitflag rsf_harass_mask[RSF_SIZE];
+bitflag rsf_bolt_mask[RSF_SIZE];
+bitflag rsf_archery_mask[RSF_SIZE];
+bitflag rsf_no_player_mask[RSF_SIZE];
+bitflag rsf_summon_mask[RSF_SIZE];
+
 /* Delay in centiseconds before moving to allow another keypress */
 /* Zero means normal instant movement. */
 u16b lazymove_delay = 0;
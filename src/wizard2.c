@@ -22,6 +22,7 @@
 #include "cmds.h"
 #include "files.h"
 #include "monster.h"
+#include "savefile.h"
 #include "spells.h"
 #include "target.h"
 #include "ui-menu.h"
@@ -176,15 +177,16 @@ static void do_cmd_wiz_hack_ben(void)
 	    /* Actual cost values */
 	    else {
 		int j;
+		int center = flow_center_cost(FLOW_NOISE);
 		struct keypress key;
 
-		for (i = cost_at_center - 2; i <= 100 + NOISE_STRENGTH; ++i) {
+		for (i = center - 2; i <= 100 + NOISE_STRENGTH; ++i) {
 		    /* First show grids with no scent */
-		    if (i == cost_at_center - 2)
+		    if (i == center - 2)
 			j = 0;
 
 		    /* Then show specially marked grids (bug-checking) */
-		    else if (i == cost_at_center - 1)
+		    else if (i == center - 1)
 			j = 255;
 
 		    /* Then show standard grids */
@@ -1744,6 +1746,7 @@ static void do_cmd_wiz_query(void)
     struct keypress cmd;
 
     u16b mask = 0x00;
+    int flag = 0;
 
 
     /* Get a "debug command" */
@@ -1778,28 +1781,28 @@ static void do_cmd_wiz_query(void)
 	break;
 
     case 'm':
-	mask |= (CAVE_MARK);
+	flag = CAVE_MARK;
 	break;
     case 'g':
-	mask |= (CAVE_GLOW);
+	flag = CAVE_GLOW;
 	break;
     case 'r':
-	mask |= (CAVE_ROOM);
+	flag = CAVE_ROOM;
 	break;
     case 'i':
-	mask |= (CAVE_ICKY);
+	flag = CAVE_ICKY;
 	break;
     case 's':
-	mask |= (CAVE_SEEN);
+	flag = CAVE_SEEN;
 	break;
     case 'v':
-	mask |= (CAVE_VIEW);
+	flag = CAVE_VIEW;
 	break;
     case 't':
-	mask |= (CAVE_TEMP);
+	flag = CAVE_TEMP;
 	break;
     case 'w':
-	mask |= (CAVE_WALL);
+	flag = CAVE_WALL;
 	break;
     }
 
@@ -1810,11 +1813,15 @@ static void do_cmd_wiz_query(void)
 	    feature_type *f_ptr = &f_info[cave_feat[y][x]];
 
 	    /* Given mask, show only those grids */
-	    if (mask && !(cave_info[y][x][0] & mask))
+	    if (mask && !(cave_info_byte(y, x, 0) & mask))
 		continue;
 
-	    /* Given no mask, show unknown grids */
-	    if (!mask && (cave_info[y][x][0] & (CAVE_MARK)))
+	    /* Given flag, show only those grids */
+	    if (flag && !cave_has(y, x, flag))
+		continue;
+
+	    /* Given neither, show unknown grids */
+	    if (!mask && !flag && cave_has(y, x, CAVE_MARK))
 		continue;
 
 	    /* Color */
@@ -1841,6 +1848,871 @@ static void do_cmd_wiz_query(void)
 }
 
 
+/**
+ * Time the pathfinder on the current level.
+ *
+ * Paths are found between random pairs of floor grids, with a few nearby
+ * targets tried from each start to exercise reuse of the search tree.
+ */
+static void do_cmd_wiz_time_pathfind(void)
+{
+    int py = p_ptr->py;
+    int px = p_ptr->px;
+
+    int i, j, found = 0, tries = 0;
+    u32b expanded = pf_expanded;
+    clock_t start;
+
+    start = clock();
+
+    for (i = 0; i < 250; i++) {
+	int y, x;
+
+	/* Pick a start */
+	y = randint1(DUNGEON_HGT - 2);
+	x = randint1(DUNGEON_WID - 2);
+	if (!tf_has(f_info[cave_feat[y][x]].flags, TF_PASSABLE))
+	    continue;
+
+	/* Pretend the player is there */
+	p_ptr->py = y;
+	p_ptr->px = x;
+
+	/* Head for a target and some near it */
+	for (j = 0; j < 4; j++) {
+	    int ty = y + rand_spread(0, 20) + rand_spread(0, j);
+	    int tx = x + rand_spread(0, 20) + rand_spread(0, j);
+
+	    if (!in_bounds_fully(ty, tx))
+		continue;
+
+	    tries++;
+	    if (path_to_grid(ty, tx) >= 0)
+		found++;
+	}
+    }
+
+    /* Put the player back */
+    p_ptr->py = py;
+    p_ptr->px = px;
+
+    msg("%d paths (%d found) in %ld ms, %lu grids expanded.", tries, found,
+	(long) ((clock() - start) * 1000 / CLOCKS_PER_SEC),
+	(unsigned long) (pf_expanded - expanded));
+}
+
+
+/**
+ * Snapshot the view flags around (y, x) for do_cmd_wiz_check_view().
+ */
+static void wiz_view_snapshot(byte snap[41][41], int y, int x)
+{
+    int dy, dx;
+
+    for (dy = -20; dy <= 20; dy++) {
+	for (dx = -20; dx <= 20; dx++) {
+	    int yy = y + dy, xx = x + dx;
+
+	    snap[dy + 20][dx + 20] = 0;
+	    if (!in_bounds(yy, xx))
+		continue;
+	    if (cave_has(yy, xx, CAVE_VIEW))
+		snap[dy + 20][dx + 20] |= 0x01;
+	    if (cave_has(yy, xx, CAVE_SEEN))
+		snap[dy + 20][dx + 20] |= 0x02;
+	}
+    }
+}
+
+
+/**
+ * Check the incremental view against a full recalculation, and time both.
+ *
+ * The view is taken from random floor grids, with a nearby grid briefly
+ * turned to rubble or floor so that partial rescans are exercised.
+ */
+static void do_cmd_wiz_check_view(void)
+{
+    int py = p_ptr->py;
+    int px = p_ptr->px;
+
+    byte fast[41][41], full[41][41];
+    int i, tries = 0, bad = 0;
+    clock_t fast_time = 0, full_time = 0, start;
+
+    for (i = 0; i < 200; i++) {
+	int y = randint1(DUNGEON_HGT - 2);
+	int x = randint1(DUNGEON_WID - 2);
+	int ty = y + rand_spread(0, 8);
+	int tx = x + rand_spread(0, 8);
+	int feat;
+	bool mark;
+
+	if (!tf_has(f_info[cave_feat[y][x]].flags, TF_PASSABLE))
+	    continue;
+	if (!in_bounds_fully(ty, tx) || ((ty == y) && (tx == x)))
+	    continue;
+
+	/* Look from the new grid */
+	p_ptr->py = y;
+	p_ptr->px = x;
+	update_view();
+
+	/* Change a grid, and look again */
+	feat = cave_feat[ty][tx];
+	mark = cave_has(ty, tx, CAVE_MARK);
+	cave_set_feat(ty, tx, tf_has(f_info[feat].flags, TF_LOS) ?
+		      FEAT_RUBBLE : FEAT_FLOOR);
+
+	start = clock();
+	update_view();
+	fast_time += clock() - start;
+	wiz_view_snapshot(fast, y, x);
+
+	start = clock();
+	update_view_full();
+	full_time += clock() - start;
+	wiz_view_snapshot(full, y, x);
+
+	tries++;
+	if (memcmp(fast, full, sizeof(fast)))
+	    bad++;
+
+	/* Put the grid back */
+	cave_set_feat(ty, tx, feat);
+	if (!mark)
+	    cave_off(ty, tx, CAVE_MARK);
+    }
+
+    /* Put the player back */
+    p_ptr->py = py;
+    p_ptr->px = px;
+    forget_view();
+    update_view();
+
+    msg("%d views, %d mismatched; incremental %ld ms, full %ld ms.", tries,
+	bad, (long) (fast_time * 1000 / CLOCKS_PER_SEC),
+	(long) (full_time * 1000 / CLOCKS_PER_SEC));
+}
+
+
+/**
+ * Count update_mon() calls per player move, and check the result against
+ * updating every monster.
+ *
+ * The player is moved to random floor grids, as in do_cmd_wiz_check_view(),
+ * and now and then has telepathy, blindness or the light radius changed
+ * before the move.
+ */
+static void do_cmd_wiz_count_update_mon(void)
+{
+    int py = p_ptr->py;
+    int px = p_ptr->px;
+    s16b esp = p_ptr->timed[TMD_TELEPATHY];
+    s16b blind = p_ptr->timed[TMD_BLIND];
+    s16b light = p_ptr->cur_light;
+
+    int i, j, moves = 0, bad = 0, live = 0;
+    u32b calls = 0;
+    clock_t fast_time = 0, full_time = 0, start_time;
+    byte *seen;
+
+    for (j = 1; j < m_max; j++)
+	if (m_list[j].r_idx)
+	    live++;
+
+    seen = C_ZNEW(m_max, byte);
+
+    for (i = 0; i < 200; i++) {
+	int y = randint1(DUNGEON_HGT - 2);
+	int x = randint1(DUNGEON_WID - 2);
+	u32b start;
+
+	if (!tf_has(f_info[cave_feat[y][x]].flags, TF_PASSABLE))
+	    continue;
+	if (cave_m_idx[y][x])
+	    continue;
+
+	/* Change the player's senses */
+	if (one_in_(4))
+	    p_ptr->timed[TMD_TELEPATHY] = (p_ptr->timed[TMD_TELEPATHY] ? 0 : 1);
+	if (one_in_(6))
+	    p_ptr->timed[TMD_BLIND] = (p_ptr->timed[TMD_BLIND] ? 0 : 1);
+	if (one_in_(4))
+	    p_ptr->cur_light = randint0(4);
+
+	/* Move, as far as the view and the monsters are concerned */
+	p_ptr->py = y;
+	p_ptr->px = x;
+	update_view();
+
+	start = update_mon_calls;
+	start_time = clock();
+	update_monsters(TRUE);
+	fast_time += clock() - start_time;
+	calls += update_mon_calls - start;
+	moves++;
+
+	/* Check against a full update */
+	for (j = 1; j < m_max; j++)
+	    seen[j] = (m_list[j].ml ? 0x01 : 0) |
+		(m_list[j].mflag & (MFLAG_VIEW));
+	start_time = clock();
+	for (j = 1; j < m_max; j++) {
+	    if (!m_list[j].r_idx)
+		continue;
+	    update_mon(j, TRUE);
+	}
+	full_time += clock() - start_time;
+	for (j = 1; j < m_max; j++) {
+	    if (!m_list[j].r_idx)
+		continue;
+	    if (seen[j] != ((m_list[j].ml ? 0x01 : 0) |
+			    (m_list[j].mflag & (MFLAG_VIEW))))
+		bad++;
+	}
+    }
+
+    FREE(seen);
+
+    /* Put the player back */
+    p_ptr->py = py;
+    p_ptr->px = px;
+    p_ptr->timed[TMD_TELEPATHY] = esp;
+    p_ptr->timed[TMD_BLIND] = blind;
+    p_ptr->cur_light = light;
+    forget_view();
+    update_view();
+    update_monsters(TRUE);
+
+    /* Per move */
+    if (moves) {
+	calls /= moves;
+	fast_time = fast_time * 1000000 / CLOCKS_PER_SEC / moves;
+	full_time = full_time * 1000000 / CLOCKS_PER_SEC / moves;
+    }
+
+    msg("%d moves, %d monsters, %d mismatched; per move %ld update_mon() calls (was %d), %ld us (full %ld us).",
+	moves, live, bad, (long) calls, live, (long) fast_time,
+	(long) full_time);
+}
+
+
+/**
+ * The cave flags of one row in the old layout, a flag set per grid.
+ */
+typedef bitflag wiz_grid_256[256][CAVE_SIZE];
+
+/**
+ * Time a whole-level cave flag pass in the old layout, a flag set per grid,
+ * against the same pass on the bitplanes.
+ *
+ * Each pass copies CAVE_ROOM into CAVE_TEMP, counts it and clears it again;
+ * CAVE_TEMP is only used during level generation, so it is free here.  The
+ * old layout is a copy of the current level's flags.
+ */
+static void do_cmd_wiz_time_cave(void)
+{
+    wiz_grid_256 *old_info;
+    size_t n;
+    int i, y, x, grid_n = 0, plane_n = 0;
+    clock_t grid_time, plane_time, start;
+
+    if (!cave_flag_count(CAVE_ROOM)) {
+	msg("There are no room grids on this level.");
+	return;
+    }
+
+    /* Copy the level into the old layout */
+    old_info = C_ZNEW(DUNGEON_HGT, wiz_grid_256);
+    for (y = 0; y < DUNGEON_HGT; y++)
+	for (x = 0; x < DUNGEON_WID; x++)
+	    for (n = 0; n < CAVE_SIZE; n++)
+		old_info[y][x][n] = cave_info_byte(y, x, n);
+
+    start = clock();
+    for (i = 0; i < 200; i++) {
+	grid_n = 0;
+	for (y = 0; y < DUNGEON_HGT; y++) {
+	    for (x = 0; x < DUNGEON_WID; x++) {
+		if (flag_has_dbg(old_info[y][x], CAVE_SIZE, CAVE_ROOM,
+				 "old_info", "CAVE_ROOM"))
+		    flag_on_dbg(old_info[y][x], CAVE_SIZE, CAVE_TEMP,
+				"old_info", "CAVE_TEMP");
+		if (flag_has_dbg(old_info[y][x], CAVE_SIZE, CAVE_TEMP,
+				 "old_info", "CAVE_TEMP"))
+		    grid_n++;
+	    }
+	}
+	for (y = 0; y < DUNGEON_HGT; y++) {
+	    for (x = 0; x < DUNGEON_WID; x++) {
+		flag_off(old_info[y][x], CAVE_SIZE, CAVE_TEMP);
+	    }
+	}
+    }
+    grid_time = clock() - start;
+
+    FREE(old_info);
+
+    start = clock();
+    for (i = 0; i < 200; i++) {
+	cave_flag_union(CAVE_TEMP, CAVE_ROOM);
+	plane_n = cave_flag_count(CAVE_TEMP);
+	cave_flag_wipe(CAVE_TEMP);
+    }
+    plane_time = clock() - start;
+
+    msg("%d/%d room grids; per-grid layout %ld ms, bitplanes %ld ms.",
+	grid_n, plane_n, (long) (grid_time * 1000 / CLOCKS_PER_SEC),
+	(long) (plane_time * 1000 / CLOCKS_PER_SEC));
+}
+
+
+/**
+ * Snapshot one flow layer for do_cmd_wiz_time_flow().
+ */
+static void wiz_flow_snapshot(byte snap[DUNGEON_HGT][DUNGEON_WID], int layer)
+{
+    int y, x;
+
+    for (y = 0; y < DUNGEON_HGT; y++)
+	for (x = 0; x < DUNGEON_WID; x++)
+	    snap[y][x] = flow_cost(layer, y, x);
+}
+
+
+/**
+ * Time the flow layers, and check their repair after terrain changes.
+ *
+ * Each layer is rebuilt from scratch, then all of them are updated while
+ * the character takes a random walk.  Finally grids near the character
+ * are changed to another terrain, and each repaired layer is compared
+ * with a full rebuild.
+ */
+static void do_cmd_wiz_time_flow(void)
+{
+    static byte fast[DUNGEON_HGT][DUNGEON_WID], full[DUNGEON_HGT][DUNGEON_WID];
+    static const int feats[] = { FEAT_FLOOR, FEAT_RUBBLE, FEAT_DOOR_HEAD,
+				 FEAT_WALL_EXTRA, FEAT_PERM_EXTRA, FEAT_WATER };
+
+    int py = p_ptr->py;
+    int px = p_ptr->px;
+
+    int i, layer, steps = 0, tries = 0, bad = 0;
+    clock_t build_time, walk_time, fix_time = 0, start;
+
+    /* Rebuild */
+    start = clock();
+    for (i = 0; i < 100; i++)
+	for (layer = 0; layer < FLOW_MAX; layer++)
+	    flow_rebuild(layer);
+    build_time = clock() - start;
+
+    /* Walk about */
+    start = clock();
+    for (i = 0; i < 500; i++) {
+	int d = randint0(8);
+	int y = p_ptr->py + ddy_ddd[d];
+	int x = p_ptr->px + ddx_ddd[d];
+
+	/* Keep every layer in use */
+	for (layer = 0; layer < FLOW_MAX; layer++)
+	    (void) flow_cost(layer, p_ptr->py, p_ptr->px);
+
+	if (!in_bounds_fully(y, x) ||
+	    !tf_has(f_info[cave_feat[y][x]].flags, TF_PASSABLE))
+	    continue;
+
+	p_ptr->py = y;
+	p_ptr->px = x;
+	update_noise();
+	steps++;
+    }
+    walk_time = clock() - start;
+
+    /* Put the player back */
+    p_ptr->py = py;
+    p_ptr->px = px;
+
+    /* Change terrain */
+    for (i = 0; i < 300; i++) {
+	int y = py + rand_spread(0, 20);
+	int x = px + rand_spread(0, 20);
+	int feat;
+	bool mark;
+
+	layer = i % FLOW_MAX;
+	if (!in_bounds_fully(y, x) || ((y == py) && (x == px)))
+	    continue;
+
+	flow_rebuild(layer);
+	feat = cave_feat[y][x];
+	mark = cave_has(y, x, CAVE_MARK);
+
+	start = clock();
+	cave_set_feat(y, x, feats[randint0(N_ELEMENTS(feats))]);
+	fix_time += clock() - start;
+	wiz_flow_snapshot(fast, layer);
+
+	flow_rebuild(layer);
+	wiz_flow_snapshot(full, layer);
+
+	tries++;
+	if (memcmp(fast, full, sizeof(fast)))
+	    bad++;
+
+	/* Put the grid back */
+	cave_set_feat(y, x, feat);
+	if (!mark)
+	    cave_off(y, x, CAVE_MARK);
+    }
+
+    /* Start again */
+    for (layer = 0; layer < FLOW_MAX; layer++)
+	flow_rebuild(layer);
+
+    msg("%d monsters.  Rebuilds %ld us, walk %ld us a step, %d repairs (%d mismatched) %ld us.",
+	mon_active_n, (long) (build_time * 10000 / CLOCKS_PER_SEC / FLOW_MAX),
+	(long) (steps ? walk_time * 1000000 / CLOCKS_PER_SEC / steps : 0),
+	tries, bad, (long) (tries ? fix_time * 1000000 / CLOCKS_PER_SEC / tries : 0));
+}
+
+
+/**
+ * Time finding which monsters can cast at the player, with remembered
+ * projection paths, against tracing every path afresh.
+ */
+static void do_cmd_wiz_time_projectable(void)
+{
+    byte *proj = C_ZNEW(z_info->m_max, byte);
+    u16b path_g[MAX_RANGE_LGE];
+    int py = p_ptr->py;
+    int px = p_ptr->px;
+    int i, j, n, y, x, num = 0, bad = 0;
+    clock_t cache_time, trace_time, start;
+
+    start = clock();
+    for (j = 0; j < 1000; j++) {
+	num = 0;
+	for (i = 0; i < mon_active_n; i++) {
+	    monster_type *m_ptr = &m_list[mon_active[i]];
+
+	    proj[mon_active[i]] = projectable(m_ptr->fy, m_ptr->fx, py, px,
+					      PROJECT_CHCK);
+	    if (proj[mon_active[i]] != PROJECT_NO)
+		num++;
+	}
+    }
+    cache_time = clock() - start;
+
+    start = clock();
+    for (j = 0; j < 1000; j++) {
+	for (i = 0; i < mon_active_n; i++) {
+	    monster_type *m_ptr = &m_list[mon_active[i]];
+	    byte path = PROJECT_NO;
+
+	    n = project_path(path_g, MAX_RANGE, m_ptr->fy, m_ptr->fx, py, px,
+			     PROJECT_CHCK);
+	    if (n) {
+		y = GRID_Y(path_g[ABS(n) - 1]);
+		x = GRID_X(path_g[ABS(n) - 1]);
+		if ((y == py) && (x == px))
+		    path = ((n > 0) ? PROJECT_CLEAR : PROJECT_NOT_CLEAR);
+	    }
+
+	    if ((j == 0) && (path != proj[mon_active[i]]))
+		bad++;
+	}
+    }
+    trace_time = clock() - start;
+
+    FREE(proj);
+
+    msg("%d of %d monsters can cast (%d mismatched); remembered %ld ms, traced %ld ms.",
+	num, mon_active_n, bad, (long) (cache_time * 1000 / CLOCKS_PER_SEC),
+	(long) (trace_time * 1000 / CLOCKS_PER_SEC));
+}
+
+
+/**
+ * Time redrawing the main window as it scrolls sideways, a frame at a time,
+ * which changes nearly every grid on every frame.
+ */
+static void do_cmd_wiz_time_scroll(void)
+{
+    int frame, y, x, w, h;
+    clock_t start, scroll_time;
+
+    Term_get_size(&w, &h);
+    screen_save();
+
+    start = clock();
+    for (frame = 0; frame < 200; frame++) {
+	for (y = 1; y < h - 1; y++) {
+	    for (x = 0; x < w; x++) {
+		int k = (x + frame + 7 * y) % 97;
+
+		if (k < 40)
+		    Term_putch(x, y, TERM_L_UMBER, '#');
+		else if (k < 70)
+		    Term_putch(x, y, TERM_WHITE, '.');
+		else
+		    Term_putch(x, y, TERM_GREEN, 'a' + k % 26);
+	    }
+	}
+	Term_fresh();
+    }
+    scroll_time = clock() - start;
+
+    screen_load();
+
+    msg("Scrolled 200 frames, %ld us a frame (%s).",
+	(long) (scroll_time * 5000 / CLOCKS_PER_SEC),
+	Term->text_batch_hook ? "batched" : "row by row");
+}
+
+
+/**
+ * Time interning inscriptions, as loading a savefile full of inscribed
+ * items does, against the old scan of the whole quark table.
+ *
+ * The inscriptions are left in the quark table, which is not saved.
+ */
+static void do_cmd_wiz_time_quarks(void)
+{
+    char buf[20];
+    int i, j, found = 0;
+    quark_t q;
+    clock_t hash_time, scan_time, start;
+
+    start = clock();
+    for (j = 0; j < 10; j++) {
+	for (i = 0; i < 2000; i++) {
+	    strnfmt(buf, sizeof(buf), "@r%d=g", i);
+	    quark_add(buf);
+	}
+    }
+    hash_time = clock() - start;
+
+    start = clock();
+    for (j = 0; j < 10; j++) {
+	for (i = 0; i < 2000; i++) {
+	    strnfmt(buf, sizeof(buf), "@r%d=g", i);
+	    for (q = 1; quark_str(q); q++) {
+		if (streq(quark_str(q), buf)) {
+		    found++;
+		    break;
+		}
+	    }
+	}
+    }
+    scan_time = clock() - start;
+
+    msg("%d inscriptions interned; hashed %ld ms, scanned %ld ms.", found,
+	(long) (hash_time * 1000 / CLOCKS_PER_SEC),
+	(long) (scan_time * 1000 / CLOCKS_PER_SEC));
+}
+
+
+/**
+ * Time the text of a 1000-message melee exchange with the first monster on
+ * the level, and count the heap allocations it makes.
+ *
+ * Each round names the monster and the wielded weapon, formats a line each
+ * way and adds both to the message log, as msg() does; nothing is drawn.
+ */
+static void do_cmd_wiz_time_messages(void)
+{
+    object_type *o_ptr = &p_ptr->inventory[INVEN_WIELD];
+    monster_type *m_ptr;
+    char m_name[80], o_name[80], buf[1024];
+    unsigned long allocs;
+    size_t len;
+    clock_t start;
+    int i;
+
+    if (!mon_active_n) {
+	msg("There are no monsters on this level.");
+	return;
+    }
+    m_ptr = &m_list[mon_active[0]];
+
+    allocs = mem_allocs;
+    start = clock();
+    for (i = 0; i < 500; i++) {
+	monster_desc(m_name, sizeof(m_name), m_ptr, 0x88);
+	object_desc(o_name, sizeof(o_name), o_ptr, ODESC_BASE);
+	len = strnfmt(buf, sizeof(buf), "You hit %s with your %s (%d).",
+		      m_name, o_name, i);
+	message_add_len(buf, len, MSG_HIT);
+
+	monster_desc(m_name, sizeof(m_name), m_ptr, 0x100);
+	len = strnfmt(buf, sizeof(buf), "%s bites you (%d).", m_name, i);
+	message_add_len(buf, len, MSG_GENERIC);
+    }
+
+    msg("1000 messages in %ld ms, with %lu heap allocations.",
+	(long) ((clock() - start) * 1000 / CLOCKS_PER_SEC),
+	mem_allocs - allocs);
+}
+
+
+/**
+ * Check the whole-set flag operations against a byte at a time on random
+ * sets of the given size, and return the number of disagreements.
+ */
+static int wiz_check_flags(size_t size)
+{
+    bitflag a[32], b[32], c[32], want[32];
+    bool have_delta, want_delta;
+    int n, wrong = 0;
+    size_t i;
+
+    for (n = 0; n < 1000; n++) {
+	for (i = 0; i < size; i++) {
+	    a[i] = randint0(256);
+	    b[i] = one_in_(4) ? a[i] : randint0(256);
+	}
+
+	/* Tests */
+	want_delta = FALSE;
+	for (i = 0; i < size; i++)
+	    if (a[i] & b[i]) want_delta = TRUE;
+	if (flag_is_inter(a, b, size) != want_delta) wrong++;
+
+	want_delta = TRUE;
+	for (i = 0; i < size; i++)
+	    if (~a[i] & b[i]) want_delta = FALSE;
+	if (flag_is_subset(a, b, size) != want_delta) wrong++;
+
+	want_delta = TRUE;
+	for (i = 0; i < size; i++)
+	    if (a[i] & b[i]) want_delta = FALSE;
+	flag_copy(c, a, size);
+	flag_inter(c, b, size);
+	if (flag_is_empty(c, size) != want_delta) wrong++;
+
+	/* Union */
+	want_delta = FALSE;
+	for (i = 0; i < size; i++) {
+	    if (~a[i] & b[i]) want_delta = TRUE;
+	    want[i] = a[i] | b[i];
+	}
+	flag_copy(c, a, size);
+	have_delta = flag_union(c, b, size);
+	if ((have_delta != want_delta) || !flag_is_equal(c, want, size))
+	    wrong++;
+
+	/* Intersection */
+	want_delta = FALSE;
+	for (i = 0; i < size; i++) {
+	    if (a[i] != b[i]) want_delta = TRUE;
+	    want[i] = a[i] & b[i];
+	}
+	flag_copy(c, a, size);
+	have_delta = flag_inter(c, b, size);
+	if ((have_delta != want_delta) || !flag_is_equal(c, want, size))
+	    wrong++;
+
+	/* Difference */
+	want_delta = FALSE;
+	for (i = 0; i < size; i++) {
+	    if (a[i] & b[i]) want_delta = TRUE;
+	    want[i] = a[i] & ~b[i];
+	}
+	flag_copy(c, a, size);
+	have_delta = flag_diff(c, b, size);
+	if ((have_delta != want_delta) || !flag_is_equal(c, want, size))
+	    wrong++;
+
+	/* Negation */
+	for (i = 0; i < size; i++)
+	    want[i] = ~a[i];
+	flag_copy(c, a, size);
+	flag_negate(c, size);
+	if (!flag_is_equal(c, want, size) || flag_is_full(c, size) !=
+	    flag_is_empty(a, size))
+	    wrong++;
+    }
+
+    return wrong;
+}
+
+/**
+ * Check the flag set operations, then time the monster breath test over
+ * every race, built from the mask list each time and from the prepared
+ * mask.
+ */
+static void do_cmd_wiz_time_flags(void)
+{
+    int wrong, i, n, found = 0, found_mask = 0;
+    clock_t start;
+    long ms_list, ms_mask;
+
+    wrong = wiz_check_flags(OF_SIZE) + wiz_check_flags(RF_SIZE) +
+	wiz_check_flags(RSF_SIZE) + wiz_check_flags(TF_SIZE) +
+	wiz_check_flags(1) + wiz_check_flags(32);
+
+    start = clock();
+    for (n = 0; n < 100; n++)
+	for (i = 1; i < z_info->r_max; i++)
+	    if (flags_test(r_info[i].spell_flags, RSF_SIZE, RSF_BREATH_MASK,
+			   FLAG_END))
+		found++;
+    ms_list = (long) ((clock() - start) * 1000 / CLOCKS_PER_SEC);
+
+    start = clock();
+    for (n = 0; n < 100; n++)
+	for (i = 1; i < z_info->r_max; i++)
+	    if (rsf_is_inter(r_info[i].spell_flags, rsf_breath_mask))
+		found_mask++;
+    ms_mask = (long) ((clock() - start) * 1000 / CLOCKS_PER_SEC);
+
+    msg("Flag sets: %d wrong.  Breaths: list %ld ms, mask %ld ms%s.",
+	wrong, ms_list, ms_mask, (found == found_mask) ? "" : " (differ!)");
+}
+
+
+/**
+ * Output file for do_cmd_wiz_memory()
+ */
+static ang_file *wiz_mem_file;
+
+static void wiz_mem_line(const char *line)
+{
+    file_putf(wiz_mem_file, "%s\n", line);
+}
+
+/**
+ * Dump the memory statistics to a file, and show it.
+ */
+static void do_cmd_wiz_memory(void)
+{
+    char buf[1024];
+
+    path_build(buf, sizeof(buf), ANGBAND_DIR_USER, "memstats.txt");
+    wiz_mem_file = file_open(buf, MODE_WRITE, FTYPE_TEXT);
+    if (!wiz_mem_file) {
+	msg("Cannot create '%s'.", buf);
+	return;
+    }
+
+    mem_stats_dump(wiz_mem_line);
+    file_close(wiz_mem_file);
+
+    screen_save();
+    show_file(buf, "Memory in use", 0, 0);
+    screen_load();
+}
+
+
+/**
+ * Check that the savefile block codec gives back what it was given, on
+ * blocks which pack well, blocks which do not, and blocks which would
+ * pack to more than they started as (a short literal before each copy).
+ */
+static void do_cmd_wiz_check_codec(void)
+{
+    byte *block = C_ZNEW(4096, byte);
+    u32b packed, worst = 0;
+    int i, kind, len, tries = 0, bad = 0;
+
+    for (kind = 0; kind < 4; kind++) {
+	for (len = 0; len <= 4096; len += (len < 16) ? 1 : 509) {
+	    for (i = 0; i < len; i++) {
+		switch (kind) {
+		case 0:
+		    block[i] = 0;
+		    break;
+		case 1:
+		    block[i] = (byte) randint0(256);
+		    break;
+		case 2:
+		    block[i] = (byte) ((i % 37 < 20) ? i / 37 : 0);
+		    break;
+		default:
+		    /* "X 01 02 03", with a different X each time */
+		    block[i] = (byte) ((i % 4) ? (i % 4) : (i / 4) + 4);
+		    break;
+		}
+	    }
+
+	    tries++;
+	    if (!savefile_check_codec(block, len, &packed))
+		bad++;
+	    if ((kind == 3) && (len > 16) && (packed > worst))
+		worst = packed;
+	}
+    }
+
+    FREE(block);
+
+    msg("%d blocks packed and unpacked, %d failed; worst case packed to %lu bytes.",
+	tries, bad, (unsigned long) worst);
+}
+
+
+/**
+ * Time some of the engine's busier routines.
+ */
+static void do_cmd_wiz_timing(void)
+{
+    struct keypress cmd;
+
+    /* Get a "debug command" */
+    if (!get_com("Time: P)ath V)iew M)onsters C)ave Q)uarks T)ext fL)ags F)low B)olts S)croll Z)ip: ",
+		 &cmd))
+	return;
+
+    switch (cmd.code) {
+    case 'Z':
+    case 'z':
+	do_cmd_wiz_check_codec();
+	break;
+    case 'S':
+    case 's':
+	do_cmd_wiz_time_scroll();
+	break;
+    case 'B':
+    case 'b':
+	do_cmd_wiz_time_projectable();
+	break;
+    case 'F':
+    case 'f':
+	do_cmd_wiz_time_flow();
+	break;
+    case 'Q':
+    case 'q':
+	do_cmd_wiz_time_quarks();
+	break;
+    case 'T':
+    case 't':
+	do_cmd_wiz_time_messages();
+	break;
+    case 'L':
+    case 'l':
+	do_cmd_wiz_time_flags();
+	break;
+    case 'C':
+    case 'c':
+	do_cmd_wiz_time_cave();
+	break;
+    case 'P':
+    case 'p':
+	do_cmd_wiz_time_pathfind();
+	break;
+    case 'V':
+    case 'v':
+	do_cmd_wiz_check_view();
+	break;
+    case 'M':
+    case 'm':
+	do_cmd_wiz_count_update_mon();
+	break;
+    }
+}
+
+
 
 #ifdef ALLOW_SPOILERS
 
@@ -1894,6 +2766,13 @@ void do_cmd_debug(void)
 
 #endif
 
+	/* Memory statistics */
+    case 'M':
+	{
+	    do_cmd_wiz_memory();
+	    break;
+	}
+
 	/* Hack -- Help */
     case '?':
 	{
@@ -1915,6 +2794,13 @@ void do_cmd_debug(void)
 	    break;
 	}
 
+	/* Time engine routines */
+    case 'B':
+	{
+	    do_cmd_wiz_timing();
+	    break;
+	}
+
 	/* Create any object */
     case 'c':
 	{
@@ -1120,7 +1120,7 @@ static size_t prt_state(int row, int col)
 static size_t prt_dtrap(int row, int col)
 {
     /* The player is in a trap-detected grid */
-    if (cave_has(cave_info[p_ptr->py][p_ptr->px], CAVE_DTRAP)) {
+    if (cave_has(p_ptr->py, p_ptr->px, CAVE_DTRAP)) {
 	/* The player is on the border */
 	if (dtrap_edge(p_ptr->py, p_ptr->px))
 	    c_put_str(TERM_YELLOW, "DTrap", row, col);
@@ -2103,6 +2103,14 @@ static void check_panel(game_event_type type, game_event_data * data,
     verify_panel();
 }
 
+static void check_saved(game_event_type type, game_event_data * data,
+			void *user)
+{
+    /* Background saves say nothing unless they fail */
+    if (!data->flag)
+	msg("Saving game... failed!");
+}
+
 extern game_event_handler ui_enter_birthscreen;
 
 /* ------------------------------------------------------------------------
@@ -2147,6 +2155,9 @@ static void ui_enter_game(game_event_type type, game_event_data * data,
 #endif
     /* Check if the panel should shift when the player's moved */
     event_add_handler(EVENT_PLAYERMOVED, check_panel, NULL);
+
+    /* Report failed background saves */
+    event_add_handler(EVENT_SAVED, check_saved, NULL);
 }
 
 static void ui_leave_game(game_event_type type, game_event_data * data,
@@ -2172,6 +2183,9 @@ static void ui_leave_game(game_event_type type, game_event_data * data,
 #endif
     /* Check if the panel should shift when the player's moved */
     event_remove_handler(EVENT_PLAYERMOVED, check_panel, NULL);
+
+    /* Report failed background saves */
+    event_remove_handler(EVENT_SAVED, check_saved, NULL);
 }
 
 errr textui_get_cmd(cmd_context context, bool wait)
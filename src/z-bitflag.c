@@ -18,6 +18,34 @@
 
 #include "z-bitflag.h"
 
+/*
+ * Whole-set operations work a machine word at a time, and then a byte at a
+ * time on whatever is left.  Flag sets are byte arrays inside structures,
+ * with no particular alignment, so words are loaded and stored through
+ * memcpy(), which compilers turn into single unaligned moves.  Every set
+ * size in use (OF_SIZE, RF_SIZE, RSF_SIZE, TF_SIZE and the rest) is at most
+ * a few words, so the loops are short.
+ */
+typedef unsigned long flag_word;
+
+#define FLAG_WORD_SIZE	sizeof(flag_word)
+
+static flag_word flag_load(const bitflag *flags)
+{
+	flag_word w;
+
+	memcpy(&w, flags, FLAG_WORD_SIZE);
+	return w;
+}
+
+static void flag_store(bitflag *flags, flag_word w)
+{
+	memcpy(flags, &w, FLAG_WORD_SIZE);
+}
+
+/* The largest flag set flags_mask() will build a mask for */
+#define FLAG_MASK_MAX	32
+
 
 /**
  * Tests if a flag is "on" in a bitflag set.
@@ -95,7 +123,10 @@ bool flag_is_empty(const bitflag *flags, const size_t size)
 {
 	size_t i;
 
-	for (i = 0; i < size; i++)
+	for (i = 0; i + FLAG_WORD_SIZE <= size; i += FLAG_WORD_SIZE)
+		if (flag_load(flags + i)) return FALSE;
+
+	for (; i < size; i++)
 		if (flags[i] > 0) return FALSE;
 
 	return TRUE;
@@ -112,7 +143,10 @@ bool flag_is_full(const bitflag *flags, const size_t size)
 {
 	size_t i;
 
-	for (i = 0; i < size; i++)
+	for (i = 0; i + FLAG_WORD_SIZE <= size; i += FLAG_WORD_SIZE)
+		if (flag_load(flags + i) != (flag_word) -1) return FALSE;
+
+	for (; i < size; i++)
 		if (flags[i] != (bitflag) -1) return FALSE;
 
 	return TRUE;
@@ -129,7 +163,10 @@ bool flag_is_inter(const bitflag *flags1, const bitflag *flags2, const size_t si
 {
 	size_t i;
 
-	for (i = 0; i < size; i++)
+	for (i = 0; i + FLAG_WORD_SIZE <= size; i += FLAG_WORD_SIZE)
+		if (flag_load(flags1 + i) & flag_load(flags2 + i)) return TRUE;
+
+	for (; i < size; i++)
 		if (flags1[i] & flags2[i]) return TRUE;
 
 	return FALSE;
@@ -146,7 +183,10 @@ bool flag_is_subset(const bitflag *flags1, const bitflag *flags2, const size_t s
 {
 	size_t i;
 
-	for (i = 0; i < size; i++)
+	for (i = 0; i + FLAG_WORD_SIZE <= size; i += FLAG_WORD_SIZE)
+		if (~flag_load(flags1 + i) & flag_load(flags2 + i)) return FALSE;
+
+	for (; i < size; i++)
 		if (~flags1[i] & flags2[i]) return FALSE;
 
 	return TRUE;
@@ -259,8 +299,11 @@ void flag_setall(bitflag *flags, const size_t size)
 void flag_negate(bitflag *flags, const size_t size)
 {
 	size_t i;
-	
-	for (i = 0; i < size; i++)
+
+	for (i = 0; i + FLAG_WORD_SIZE <= size; i += FLAG_WORD_SIZE)
+		flag_store(flags + i, ~flag_load(flags + i));
+
+	for (; i < size; i++)
 		flags[i] = ~flags[i];
 }
 
@@ -287,17 +330,27 @@ void flag_copy(bitflag *flags1, const bitflag *flags2, const size_t size)
 bool flag_union(bitflag *flags1, const bitflag *flags2, const size_t size)
 {
 	size_t i;
-	bool delta = FALSE;
+	flag_word delta = 0;
 
-	for (i = 0; i < size; i++)
+	for (i = 0; i + FLAG_WORD_SIZE <= size; i += FLAG_WORD_SIZE)
 	{
+		flag_word w1 = flag_load(flags1 + i);
+		flag_word w2 = flag_load(flags2 + i);
+
 		/* !flag_is_subset() */
-		if (~flags1[i] & flags2[i]) delta = TRUE;
+		delta |= ~w1 & w2;
+
+		flag_store(flags1 + i, w1 | w2);
+	}
+
+	for (; i < size; i++)
+	{
+		delta |= ~flags1[i] & flags2[i];
 
 		flags1[i] |= flags2[i];
 	}
 
-	return delta;
+	return delta ? TRUE : FALSE;
 }
 
 
@@ -335,18 +388,27 @@ bool flag_comp_union(bitflag *flags1, const bitflag *flags2, const size_t size)
 bool flag_inter(bitflag *flags1, const bitflag *flags2, const size_t size)
 {
 	size_t i;
-	bool delta = FALSE;
+	flag_word delta = 0;
 
-	for (i = 0; i < size; i++)
+	for (i = 0; i + FLAG_WORD_SIZE <= size; i += FLAG_WORD_SIZE)
 	{
+		flag_word w1 = flag_load(flags1 + i);
+		flag_word w2 = flag_load(flags2 + i);
+
 		/* !flag_is_equal() */
-		if (!(flags1[i] == flags2[i])) delta = TRUE;
+		delta |= w1 ^ w2;
 
-		flags1[i] &= flags2[i];
+		flag_store(flags1 + i, w1 & w2);
 	}
 
-	return delta;
+	for (; i < size; i++)
+	{
+		delta |= flags1[i] ^ flags2[i];
 
+		flags1[i] &= flags2[i];
+	}
+
+	return delta ? TRUE : FALSE;
 }
 
 
@@ -360,17 +422,27 @@ bool flag_inter(bitflag *flags1, const bitflag *flags2, const size_t size)
 bool flag_diff(bitflag *flags1, const bitflag *flags2, const size_t size)
 {
 	size_t i;
-	bool delta = FALSE;
+	flag_word delta = 0;
 
-	for (i = 0; i < size; i++)
+	for (i = 0; i + FLAG_WORD_SIZE <= size; i += FLAG_WORD_SIZE)
 	{
+		flag_word w1 = flag_load(flags1 + i);
+		flag_word w2 = flag_load(flags2 + i);
+
 		/* flag_is_inter() */
-		if (flags1[i] & flags2[i]) delta = TRUE;
+		delta |= w1 & w2;
+
+		flag_store(flags1 + i, w1 & ~w2);
+	}
+
+	for (; i < size; i++)
+	{
+		delta |= flags1[i] & flags2[i];
 
 		flags1[i] &= ~flags2[i];
 	}
 
-	return delta;
+	return delta ? TRUE : FALSE;
 }
 
 
@@ -575,12 +647,13 @@ bool flags_mask(bitflag *flags, const size_t size, ...)
 {
 	int f;
 	va_list args;
-	bool delta = FALSE;
 
-	bitflag *mask;
+	bitflag mask[FLAG_MASK_MAX];
+
+	assert(size <= FLAG_MASK_MAX);
 
 	/* Build the mask */
-	mask = C_ZNEW(size, bitflag);
+	flag_wipe(mask, size);
 
 	va_start(args, size);
 
@@ -590,11 +663,5 @@ bool flags_mask(bitflag *flags, const size_t size, ...)
 
 	va_end(args);
 
-	delta = flag_inter(flags, mask, size);
-
-	/* Free the mask */
-
-	FREE(mask);
-
-	return delta;
+	return flag_inter(flags, mask, size);
 }
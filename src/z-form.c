@@ -230,6 +230,24 @@ size_t vstrnfmt(char *buf, size_t max, const char *fmt, va_list vp)
 		/* Skip the "percent" */
 		s++;
 
+		/* Plain "%s" is copied straight into the buffer */
+		if (*s == 's')
+		{
+			const char *arg = va_arg(vp, const char *);
+
+			/* Hack -- convert NULL to EMPTY */
+			if (!arg) arg = "";
+
+			/* Copy the argument */
+			while (*arg && (n < max-1)) buf[n++] = *arg++;
+
+			/* Skip the "s" */
+			s++;
+
+			/* Continue */
+			continue;
+		}
+
 		/* Pre-process "%%" */
 		if (*s == '%')
 		{
@@ -626,6 +644,91 @@ void strnfcat(char *str, size_t max, size_t *end, const char *fmt, ...)
 }
 
 
+/*
+ * Start building a string in "buf", which holds "max" bytes
+ */
+void strbuf_init(strbuf *sb, char *buf, size_t max)
+{
+	assert(max);
+
+	sb->buf = buf;
+	sb->max = max;
+	sb->end = 0;
+	buf[0] = '\0';
+}
+
+
+/*
+ * Append a character to a string being built
+ */
+void strbuf_putc(strbuf *sb, char c)
+{
+	/* No room */
+	if (sb->end + 1 >= sb->max) return;
+
+	sb->buf[sb->end++] = c;
+	sb->buf[sb->end] = '\0';
+}
+
+
+/*
+ * Append the first "n" characters of "str" (which must have that many)
+ * to a string being built
+ */
+void strbuf_putn(strbuf *sb, const char *str, size_t n)
+{
+	/* Paranoia */
+	if (sb->end >= sb->max) return;
+
+	/* Cut it short if need be */
+	if (n > sb->max - 1 - sb->end) n = sb->max - 1 - sb->end;
+
+	memcpy(sb->buf + sb->end, str, n);
+	sb->end += n;
+	sb->buf[sb->end] = '\0';
+}
+
+
+/*
+ * Append a string to a string being built
+ */
+void strbuf_puts(strbuf *sb, const char *str)
+{
+	char *t = sb->buf + sb->end;
+	char *stop = sb->buf + sb->max - 1;
+
+	/* Paranoia */
+	if (sb->end >= sb->max) return;
+
+	/* Copy until the string or the room runs out */
+	while (*str && (t < stop)) *t++ = *str++;
+	*t = '\0';
+
+	sb->end = t - sb->buf;
+}
+
+
+/*
+ * Append a formatted string to a string being built
+ */
+void strbuf_vfmt(strbuf *sb, const char *fmt, va_list vp)
+{
+	/* Paranoia */
+	if (sb->end >= sb->max) return;
+
+	sb->end += vstrnfmt(sb->buf + sb->end, sb->max - sb->end, fmt, vp);
+}
+
+void strbuf_fmt(strbuf *sb, const char *fmt, ...)
+{
+	va_list vp;
+
+	va_start(vp, fmt);
+	strbuf_vfmt(sb, fmt, vp);
+	va_end(vp);
+}
+
+
 static char *format_buf = NULL;
 static size_t format_len = 0;
 
@@ -23,6 +23,20 @@
 #endif
 
 
+/*
+ * A string being built in a buffer owned by the caller, usually on the
+ * stack.  "end" is the length of the string so far, so appending never
+ * needs to look for the end of the string again.  The buffer is always
+ * kept terminated, and anything which does not fit is cut off.
+ */
+typedef struct strbuf
+{
+	char *buf;
+	size_t max;
+	size_t end;
+} strbuf;
+
+
 /**** Available Functions ****/
 
 /* Format arguments into given bounded-length buffer */
@@ -40,6 +54,22 @@ extern void vformat_kill(void);
 /* Append a formatted string to another string */
 extern void strnfcat(char *str, size_t max, size_t *end, const char *fmt, ...);
 
+/* Start building a string in a given buffer */
+extern void strbuf_init(strbuf *sb, char *buf, size_t max);
+
+/* Append a character to a string being built */
+extern void strbuf_putc(strbuf *sb, char c);
+
+/* Append the first "n" characters of a string to a string being built */
+extern void strbuf_putn(strbuf *sb, const char *str, size_t n);
+
+/* Append a string to a string being built */
+extern void strbuf_puts(strbuf *sb, const char *str);
+
+/* Append a formatted string to a string being built */
+extern void strbuf_vfmt(strbuf *sb, const char *fmt, va_list vp);
+extern void strbuf_fmt(strbuf *sb, const char *fmt, ...);
+
 /* Simple interface to "vformat()" */
 extern char *format(const char *fmt, ...);
 
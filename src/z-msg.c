@@ -18,11 +18,19 @@
 #include "z-term.h"
 #include "z-msg.h"
 
+/*
+ * Messages are kept in a ring of "max" records, newest at "head".  Their
+ * text lives in a circular byte arena, written in the same order as the
+ * records; when the arena comes round to the oldest messages' text, those
+ * messages are dropped.  The arena holds a full ring of messages of up to
+ * 64 characters each.
+ */
+#define MSG_ARENA_SIZE	131072
+
 typedef struct _message_t
 {
-	char *str;
-	struct _message_t *newer;
-	struct _message_t *older;
+	u32b offset;
+	u32b len;
 	u16b type;
 	u16b count;
 } message_t;
@@ -36,9 +44,11 @@ typedef struct _msgcolor_t
 
 typedef struct _msgqueue_t
 {
-	message_t *head;
-	message_t *tail;
+	message_t *ring;
+	char *arena;
+	u32b arena_pos;
 	msgcolor_t *colors;
+	u32b head;
 	u32b count;
 	u32b max;
 } msgqueue_t;
@@ -50,6 +60,8 @@ errr messages_init(void)
 {
 	messages = ZNEW(msgqueue_t);
 	messages->max = 2048;
+	messages->ring = C_ZNEW(messages->max, message_t);
+	messages->arena = C_ZNEW(MSG_ARENA_SIZE, char);
 	return 0;
 }
 
@@ -57,16 +69,6 @@ void messages_free(void)
 {
 	msgcolor_t *c = messages->colors;
 	msgcolor_t *nextc;
-	message_t *m = messages->head;
-	message_t *nextm;
-
-	while (m)
-	{
-		nextm = m->older;
-		FREE(m->str);
-		FREE(m);
-		m = nextm;
-	}
 
 	while (c)
 	{
@@ -75,6 +77,8 @@ void messages_free(void)
 		c = nextc;
 	}
 
+	FREE(messages->ring);
+	FREE(messages->arena);
 	FREE(messages);
 }
 
@@ -85,60 +89,94 @@ u16b messages_num(void)
 
 /* Functions for individual messages */
 
-void message_add(const char *str, u16b type)
+static message_t *message_get(u16b age)
 {
-	message_t *m;
+	if (age >= messages->count)
+		return NULL;
+
+	return &messages->ring[(messages->head + messages->max - age) %
+			       messages->max];
+}
 
-	if (messages->head &&
-	    messages->head->type == type &&
-	    !strcmp(messages->head->str, str))
+/*
+ * Claim "need" bytes of the arena, dropping the messages whose text is in
+ * the way, and return where to write.
+ */
+static u32b message_claim(u32b need)
+{
+	u32b start = messages->arena_pos;
+	u32b pos = start;
+	u32b claimed = need;
+
+	/* No room before the end, so skip the rest of the arena */
+	if (pos + need > MSG_ARENA_SIZE)
 	{
-		messages->head->count++;
-		return;
+		claimed += MSG_ARENA_SIZE - pos;
+		pos = 0;
 	}
 
-	m = ZNEW(message_t);
-	m->str = string_make(str);
-	m->type = type;
-	m->count = 1;
-	m->older = messages->head;
+	/* Drop old messages whose text starts in the claimed stretch */
+	while (messages->count)
+	{
+		message_t *m = message_get(messages->count - 1);
+		u32b dist = (m->offset + MSG_ARENA_SIZE - start) % MSG_ARENA_SIZE;
 
-	if (messages->head)
-		messages->head->newer = m;
+		if (dist >= claimed)
+			break;
 
-	messages->head = m;
-	messages->count++;
+		messages->count--;
+	}
+
+	messages->arena_pos = pos + need;
+	return pos;
+}
+
+void message_add(const char *str, u16b type)
+{
+	message_add_len(str, strlen(str), type);
+}
+
+void message_add_len(const char *str, size_t len, u16b type)
+{
+	message_t *m = message_get(0);
+	u32b offset;
 
-	if (!messages->tail)
-		messages->tail = m;
+	/* Paranoia */
+	if (len >= MSG_ARENA_SIZE)
+		len = MSG_ARENA_SIZE - 1;
 
-	if (messages->count > messages->max)
+	if (m && m->type == type && m->len == len &&
+	    !memcmp(messages->arena + m->offset, str, len))
 	{
-		message_t *old_tail = messages->tail;
+		m->count++;
+		return;
+	}
 
-		messages->tail = old_tail->newer;
-		messages->tail->older = NULL;
-		FREE(old_tail->str);
-		FREE(old_tail);
+	/* The ring is full, so drop the oldest message */
+	if (messages->count == messages->max)
 		messages->count--;
-	}
-}
 
-static message_t *message_get(u16b age)
-{
-	message_t *m = messages->head;
+	/* Store the text */
+	offset = message_claim(len + 1);
+	memcpy(messages->arena + offset, str, len);
+	messages->arena[offset + len] = '\0';
 
-	while (m && age--)
-		m = m->older;
+	/* Make the new record */
+	messages->head = (messages->head + 1) % messages->max;
+	m = &messages->ring[messages->head];
+	m->offset = offset;
+	m->len = len;
+	m->type = type;
+	m->count = 1;
 
-	return m;
+	messages->count++;
 }
 
 
 const char *message_str(u16b age)
 {
 	message_t *m = message_get(age);
-	return (m ? m->str : "");
+	return (m ? messages->arena + m->offset : "");
 }
 
 u16b message_count(u16b age)
@@ -203,6 +203,12 @@ u16b messages_num(void);
  */
 void message_add(const char *str, u16b type);
 
+/**
+ * As message_add(), for a caller which already knows that `str` is `len`
+ * characters long.
+ */
+void message_add_len(const char *str, size_t len, u16b type);
+
 
 /**
  * Returns the text of the message of age `age`.  The age of the most recently
@@ -24,30 +24,102 @@ static char **quarks;
 static size_t nr_quarks = 1;
 static size_t alloc_quarks = 0;
 
+/*
+ * Open-addressed index into quarks[], with linear probing.  Each slot
+ * holds a quark, or 0 if empty; the table is a power of two in size and
+ * is kept at most half full.
+ */
+static quark_t *quark_index;
+static size_t index_size = 0;
+
 #define QUARKS_INIT	16
 
-quark_t quark_add(const char *str)
+/*
+ * Hash a string (FNV-1a)
+ */
+static u32b quark_hash(const char *str)
 {
-	quark_t q;
+	u32b h = 2166136261UL;
 
-	for (q = 1; q < nr_quarks; q++)
+	while (*str)
 	{
-		if (!strcmp(quarks[q], str))
-			return q;
+		h ^= (byte)*str++;
+		h *= 16777619UL;
 	}
 
-	if (nr_quarks == alloc_quarks)
+	return h;
+}
+
+/*
+ * Find the index slot for "str": either the slot holding its quark, or
+ * the empty slot where it belongs.
+ */
+static size_t quark_slot(const char *str)
+{
+	size_t i = quark_hash(str) & (index_size - 1);
+
+	while (quark_index[i] && strcmp(quarks[quark_index[i]], str))
+		i = (i + 1) & (index_size - 1);
+
+	return i;
+}
+
+/*
+ * Make room for "n" quarks in all, in both the array and the index.
+ */
+static void quark_grow(size_t n)
+{
+	size_t q;
+
+	if (n > alloc_quarks)
 	{
-		alloc_quarks *= 2;
+		while (alloc_quarks < n)
+			alloc_quarks *= 2;
 		quarks = mem_realloc(quarks, alloc_quarks * sizeof(char *));
 	}
 
+	if (2 * n <= index_size)
+		return;
+
+	/* Rebuild the index */
+	while (2 * n > index_size)
+		index_size *= 2;
+
+	FREE(quark_index);
+	quark_index = C_ZNEW(index_size, quark_t);
+
+	for (q = 1; q < nr_quarks; q++)
+		quark_index[quark_slot(quarks[q])] = q;
+}
+
+quark_t quark_add(const char *str)
+{
+	quark_t q;
+	size_t slot = quark_slot(str);
+
+	/* Already known */
+	if (quark_index[slot])
+		return quark_index[slot];
+
+	/* Growing moves everything, so find the slot again */
+	if (nr_quarks == alloc_quarks || 2 * (nr_quarks + 1) > index_size)
+	{
+		quark_grow(nr_quarks + 1);
+		slot = quark_slot(str);
+	}
+
 	q = nr_quarks++;
 	quarks[q] = string_make(str);
+	quark_index[slot] = q;
 
 	return q;
 }
 
+void quarks_reserve(size_t n)
+{
+	quark_grow(nr_quarks + n);
+}
+
 const char *quark_str(quark_t q)
 {
 	return (q >= nr_quarks ? NULL : quarks[q]);
@@ -58,6 +130,9 @@ errr quarks_init(void)
 	alloc_quarks = QUARKS_INIT;
 	quarks = C_ZNEW(alloc_quarks, char *);
 
+	index_size = 2 * QUARKS_INIT;
+	quark_index = C_ZNEW(index_size, quark_t);
+
 	return 0;
 }
 
@@ -69,5 +144,6 @@ errr quarks_free(void)
 		string_free(quarks[i]);
 
 	FREE(quarks);
+	FREE(quark_index);
 	return 0;
 }
@@ -10,6 +10,9 @@ typedef size_t quark_t;
 /* Return a quark for the string 'str' */
 quark_t quark_add(const char *str);
 
+/* Make room for 'n' more quarks, ahead of adding a batch of them */
+void quarks_reserve(size_t n);
+
 /* Return the string corresponding to the quark */
 const char *quark_str(quark_t q);
 
@@ -322,6 +322,45 @@ int damcalc(int num, int sides, aspect dam_aspect) {
 }
 
 
+/**
+ * Make the guide for the first `n` running totals of a rand_table.
+ */
+void rand_table_guide(rand_table *t, int n) {
+	int i = 0, s;
+
+	t->n = n;
+	t->total = (n ? t->sum[n - 1] : 0);
+	t->step = t->total / (n ? n : 1) + 1;
+
+	for (s = 0; s < n; s++) {
+		u32b start = s * t->step;
+
+		while ((i < n - 1) && (t->sum[i] <= start))
+			i++;
+
+		t->guide[s] = i;
+	}
+}
+
+/**
+ * Find the first entry whose running total is more than `value`.
+ */
+int rand_table_find(const rand_table *t, u32b value) {
+	int i = t->guide[value / t->step];
+
+	while (t->sum[i] <= value)
+		i++;
+
+	return i;
+}
+
+/**
+ * Pick an entry at random, in proportion to its weight.
+ */
+int rand_table_pick(const rand_table *t) {
+	return rand_table_find(t, Rand_div(t->total));
+}
+
 /**
  * Generates a random signed long integer X where `A` <= X <= `B`.
  * The integer X falls along a uniform distribution.
@@ -17,6 +17,23 @@ typedef struct random {
 	int m_bonus;
 } random_value;
 
+/**
+ * A table for picking one of "n" entries in proportion to its weight.
+ *
+ * The caller provides room for "n" running totals of the weights in `sum`
+ * and "n" guide entries in `guide`, fills in `sum`, and calls
+ * rand_table_guide().  Each guide entry is the first entry whose running
+ * total passes the start of one equal slice of the grand total, so a pick
+ * only has to look at the few entries within a slice.
+ */
+typedef struct rand_table {
+	u32b *sum;
+	u16b *guide;
+	u32b step;
+	u32b total;
+	int n;
+} rand_table;
+
 /**
  * The number of 32-bit integers worth of seed state.
  */
@@ -92,6 +109,24 @@ void Rand_state_init(u32b seed);
  */
 u32b Rand_div(u32b m);
 
+/**
+ * Make the guide for the first `n` running totals of a rand_table.
+ */
+void rand_table_guide(rand_table *t, int n);
+
+/**
+ * Find the first entry of a rand_table whose running total is more than
+ * `value`.  This is the entry which a linear scan subtracting each weight
+ * from `value` in turn would stop at.
+ */
+int rand_table_find(const rand_table *t, u32b value);
+
+/**
+ * Pick an entry of a rand_table at random, in proportion to its weight.
+ * Exactly one value is taken from Rand_div(), as for a linear scan.
+ */
+int rand_table_pick(const rand_table *t);
+
 /**
  * Generate a signed random integer within `stand` standard deviations of
  * `mean`, following a normal distribution.
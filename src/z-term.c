@@ -1015,6 +1015,118 @@ static void Term_fresh_row_text(int y, int x1, int x2)
 	}
 }
 
+/*
+ * Spans of changed text collected for "Term->text_batch_hook"
+ */
+static term_span *fresh_span;
+static int fresh_span_num = 0;
+static int fresh_span_max = 0;
+
+/*
+ * The most unchanged grids that may be redrawn to join two spans
+ */
+#define TERM_SPAN_GAP	4
+
+/*
+ * Add a span to the batch (see "Term_fresh_row_span")
+ */
+static void Term_fresh_span_add(int x, int y, int n, byte a, const wchar_t *s)
+{
+	term_span *sp;
+
+	if (fresh_span_num == fresh_span_max)
+	{
+		fresh_span_max = fresh_span_max ? 2 * fresh_span_max : 256;
+		fresh_span = mem_realloc(fresh_span, fresh_span_max * sizeof(term_span));
+	}
+
+	sp = &fresh_span[fresh_span_num++];
+	sp->x = x;
+	sp->y = y;
+	sp->n = n;
+	sp->a = a;
+	sp->s = ((a || Term->always_text) ? s : NULL);
+}
+
+
+/*
+ * Collect the changes to a row of the current window (see "Term_fresh")
+ *
+ * This is "Term_fresh_row_text()", except that the runs are kept for the
+ * "Term->text_batch_hook" hook.  Runs of the same attr with only a few
+ * unchanged grids of that attr between them are joined up, as redrawing
+ * those grids is harmless, and cheaper than another run.
+ */
+static void Term_fresh_row_span(int y, int x1, int x2)
+{
+	int x;
+
+	byte *old_aa = Term->old->a[y];
+	wchar_t *old_cc = Term->old->c[y];
+
+	byte *scr_aa = Term->scr->a[y];
+	wchar_t *scr_cc = Term->scr->c[y];
+
+	/* Pending run */
+	int fx = 0, fn = 0;
+	byte fa = Term->attr_blank;
+
+	/* Unchanged grids of attr "fa" since the pending run */
+	int gap = 0;
+
+	byte na;
+	wchar_t nc;
+
+
+	/* Scan "modified" columns */
+	for (x = x1; x <= x2; x++)
+	{
+		/* See what is desired there */
+		na = scr_aa[x];
+		nc = scr_cc[x];
+
+		/* Handle unchanged grids */
+		if ((na == old_aa[x]) && (nc == old_cc[x]))
+		{
+			/* Perhaps bridge the gap to a later change */
+			if (fn && (na == fa) && (gap < TERM_SPAN_GAP))
+			{
+				gap++;
+				continue;
+			}
+
+			/* Flush */
+			if (fn) Term_fresh_span_add(fx, y, fn, fa, &scr_cc[fx]);
+			fn = 0;
+			gap = 0;
+			continue;
+		}
+
+		/* Save new contents */
+		old_aa[x] = na;
+		old_cc[x] = nc;
+
+		/* Join the pending run, across any gap */
+		if (fn && (na == fa))
+		{
+			fn += gap + 1;
+			gap = 0;
+			continue;
+		}
+
+		/* Flush, and start again */
+		if (fn) Term_fresh_span_add(fx, y, fn, fa, &scr_cc[fx]);
+		fa = na;
+		fx = x;
+		fn = 1;
+		gap = 0;
+	}
+
+	/* Flush */
+	if (fn) Term_fresh_span_add(fx, y, fn, fa, &scr_cc[fx]);
+}
+
+
 /*
  * Mark a spot as needing refresh (see "Term_fresh")
  */
@@ -1119,6 +1231,11 @@ bool smlcurs = TRUE;
  * high-bit set) to be sent (one pair at a time) to the "Term->pict_hook"
  * hook, which can draw these pairs in whatever way it would like.
  *
+ * Otherwise, if there is a "Term->text_batch_hook" hook, then the changed
+ * text of every row is collected by "Term_fresh_row_span()" and handed to
+ * that hook in a single call, which lets the window draw the whole update
+ * in one pass.  Such windows are not sent "TERM_XTRA_FROSH".
+ *
  * Normally, the "Term_wipe()" function is used only to display "blanks"
  * that were induced by "Term_clear()" or "Term_erase()", and then only
  * if the "attr_blank" and "char_blank" fields have not been redefined
@@ -1350,6 +1467,12 @@ errr Term_fresh(void)
 					Term_fresh_row_both(y, x1, x2);
 				}
 
+				/* Collect the row for the batch */
+				else if (Term->text_batch_hook)
+				{
+					Term_fresh_row_span(y, x1, x2);
+				}
+
 				/* Never use "Term_pict()" */
 				else
 				{
@@ -1362,10 +1485,18 @@ errr Term_fresh(void)
 				Term->x2[y] = 0;
 
 				/* Hack -- Flush that row (if allowed) */
-				if (!Term->never_frosh) Term_xtra(TERM_XTRA_FROSH, y);
+				if (!Term->never_frosh && !Term->text_batch_hook)
+					Term_xtra(TERM_XTRA_FROSH, y);
 			}
 		}
 
+		/* Draw the batch */
+		if (fresh_span_num)
+		{
+			(void)((*Term->text_batch_hook)(fresh_span, fresh_span_num));
+			fresh_span_num = 0;
+		}
+
 		/* No rows are invalid */
 		Term->y1 = h;
 		Term->y2 = 0;
@@ -57,6 +57,21 @@ struct term_win
 };
 
 
+/*
+ * A run of grids for "text_batch_hook": "n" grids from (x,y), to be drawn
+ * as the chars "s" in the attr "a", or erased (if "s" is NULL).  The chars
+ * belong to the term, and are only good until the hook returns.
+ */
+typedef struct term_span term_span;
+
+struct term_span
+{
+	int x, y, n;
+	byte a;
+	const wchar_t *s;
+};
+
+
 /*
  * An actual "term" structure
  *
@@ -155,6 +170,8 @@ struct term_win
  *	- Hook for drawing a string of chars using an attr
  *
  *	- Hook for drawing a sequence of special attr/char pairs
+ *
+ *	- Hook for drawing all the changed text of a refresh at once
  */
 
 typedef struct term term;
@@ -231,6 +248,8 @@ struct term
 
 	errr (*pict_hook)(int x, int y, int n, const byte *ap, const wchar_t *cp, const byte *tap, const wchar_t *tcp);
 
+	errr (*text_batch_hook)(const term_span *spans, int n);
+
 	size_t (*mbcs_hook)(wchar_t *dest, const char *src, int n);
 
 	void (*view_map_hook)(term *t);
@@ -17,38 +17,269 @@
  */
 #include "z-virt.h"
 #include "z-util.h"
+#include "z-form.h"
+
+/* The real functions, not the call-site macros */
+#ifdef MEM_STATS
+# undef mem_alloc
+# undef mem_zalloc
+# undef mem_realloc
+# undef string_make
+#endif
 
 unsigned int mem_flags = 0;
+unsigned long mem_allocs = 0;
+
+/*
+ * Small blocks come from pools, one per size class, which are carved out
+ * of big slabs and never given back; freed blocks go on a free list for
+ * their class.  Larger blocks come straight from malloc().  Whether a block
+ * is pooled, and which pool, is worked out from its length, which is kept
+ * in a header just before the block.
+ */
+#define MEM_CLASSES	8
+#define MEM_POOL_MAX	256
+#define MEM_SLAB_SIZE	65536
+
+typedef struct mem_head
+{
+	size_t len;
+#ifdef MEM_STATS
+	size_t site;
+#endif
+} mem_head;
+
+static const size_t mem_class_size[MEM_CLASSES] =
+	{ 16, 32, 48, 64, 96, 128, 192, 256 };
+
+/* Size class for each 16 bytes of length */
+static const byte mem_class_of[MEM_POOL_MAX / 16] =
+	{ 0, 1, 2, 3, 4, 4, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7 };
+
+#define MEM_CLASS(len)	mem_class_of[((len) - 1) / 16]
 
-#define SZ(uptr)	*((size_t *)((char *)(uptr) - sizeof(size_t)))
+#define HEAD(uptr)	((mem_head *)(uptr) - 1)
+
+/* Free lists, and blocks handed out, by class */
+static void *mem_pool[MEM_CLASSES];
+static u32b mem_pool_used[MEM_CLASSES];
+static u32b mem_pool_slabs[MEM_CLASSES];
 
 /*
- * Allocate `len` bytes of memory.
- *
- * Returns:
- *  - NULL if `len` == 0; or
- *  - a pointer to a block of memory of at least `len` bytes
- *
- * Doesn't return on out of memory.
+ * Take a block from pool `c`, making a new slab of blocks if needed.
  */
-void *mem_alloc(size_t len)
+static mem_head *mem_pool_get(int c)
+{
+	mem_head *head;
+
+	if (!mem_pool[c])
+	{
+		size_t size = sizeof(mem_head) + mem_class_size[c];
+		size_t i, n = MEM_SLAB_SIZE / size;
+		char *slab = malloc(MEM_SLAB_SIZE);
+
+		if (!slab)
+			quit("Out of Memory!");
+
+		/* Chain the blocks together */
+		for (i = 0; i < n; i++)
+			*(void **)(slab + i * size + sizeof(mem_head)) =
+				(i + 1 < n) ? slab + (i + 1) * size + sizeof(mem_head) : NULL;
+
+		mem_pool[c] = slab + sizeof(mem_head);
+		mem_pool_slabs[c]++;
+	}
+
+	head = HEAD(mem_pool[c]);
+	mem_pool[c] = *(void **)mem_pool[c];
+	mem_pool_used[c]++;
+
+	return head;
+}
+
+/*
+ * Return a block to pool `c`.
+ */
+static void mem_pool_put(int c, mem_head *head)
+{
+	*(void **)(head + 1) = mem_pool[c];
+	mem_pool[c] = head + 1;
+	mem_pool_used[c]--;
+}
+
+
+#ifdef MEM_STATS
+
+/*
+ * Allocation statistics, kept by the call site which asked for the memory.
+ * Site 0 collects calls which give no site.
+ */
+#define MEM_SITES_MAX	2048
+#define MEM_SITE_HASH	4096
+
+typedef struct mem_site
+{
+	const char *file;
+	int line;
+	size_t bytes;
+	size_t peak;
+	u32b live;
+	u32b allocs;
+} mem_site;
+
+static mem_site mem_sites[MEM_SITES_MAX] = { { "(unknown)", 0 } };
+static size_t mem_sites_n = 1;
+static u16b mem_site_hash[MEM_SITE_HASH];
+
+/*
+ * Find (or add) the statistics for a call site
+ */
+static size_t mem_site_find(const char *file, int line)
+{
+	size_t h = (((size_t)file >> 4) * 31 + (size_t)line) % MEM_SITE_HASH;
+
+	while (mem_site_hash[h])
+	{
+		mem_site *s = &mem_sites[mem_site_hash[h]];
+
+		if ((s->file == file) && (s->line == line))
+			return mem_site_hash[h];
+
+		h = (h + 1) % MEM_SITE_HASH;
+	}
+
+	/* Table full; lump it in with the unknowns */
+	if (mem_sites_n == MEM_SITES_MAX)
+		return 0;
+
+	mem_sites[mem_sites_n].file = file;
+	mem_sites[mem_sites_n].line = line;
+	mem_site_hash[h] = mem_sites_n;
+
+	return mem_sites_n++;
+}
+
+static void mem_site_add(mem_head *head, size_t site)
 {
-	char *mem;
+	mem_site *s = &mem_sites[site];
+
+	head->site = site;
+	s->bytes += head->len;
+	s->live++;
+	s->allocs++;
+	if (s->bytes > s->peak)
+		s->peak = s->bytes;
+}
+
+static void mem_site_remove(mem_head *head)
+{
+	mem_site *s = &mem_sites[head->site];
+
+	s->bytes -= head->len;
+	s->live--;
+}
+
+#else /* MEM_STATS */
+
+#define mem_site_add(HEAD, SITE)	((void)0)
+#define mem_site_remove(HEAD)		((void)0)
+
+#endif /* MEM_STATS */
+
+
+/*
+ * Allocate `len` bytes of memory, for call site `site`.
+ */
+static void *mem_alloc_aux(size_t len, size_t site)
+{
+	mem_head *head;
 
 	/* Allow allocation of "zero bytes" */
 	if (len == 0) return (NULL);
 
-	mem = malloc(len + sizeof(size_t));
-	if (!mem)
+	if (len <= MEM_POOL_MAX)
+		head = mem_pool_get(MEM_CLASS(len));
+	else
+		head = malloc(sizeof(mem_head) + len);
+
+	if (!head)
 		quit("Out of Memory!");
-	mem += sizeof(size_t);
+
+	mem_allocs++;
+	head->len = len;
+	mem_site_add(head, site);
+
 	if (mem_flags & MEM_POISON_ALLOC)
-		memset(mem, 0xCC, len);
-	SZ(mem) = len;
+		memset(head + 1, 0xCC, len);
+
+	return head + 1;
+}
+
+/*
+ * Change the size of the block at `p`, for call site `site`.
+ */
+static void *mem_realloc_aux(void *p, size_t len, size_t site)
+{
+	mem_head *head;
+	size_t old;
+	void *mem;
+
+	/* Fail gracefully */
+	if (len == 0) return (NULL);
+
+	if (!p) return mem_alloc_aux(len, site);
+
+	head = HEAD(p);
+	old = head->len;
+
+	/* Big to big */
+	if ((old > MEM_POOL_MAX) && (len > MEM_POOL_MAX))
+	{
+		mem_site_remove(head);
+		head = realloc(head, sizeof(mem_head) + len);
+
+		/* Handle OOM */
+		if (!head) quit("Out of Memory!");
+		mem_allocs++;
+		head->len = len;
+		mem_site_add(head, site);
+
+		return head + 1;
+	}
+
+	/* Still fits the same pool */
+	if ((old <= MEM_POOL_MAX) && (len <= MEM_POOL_MAX) &&
+		(MEM_CLASS(old) == MEM_CLASS(len)))
+	{
+		mem_site_remove(head);
+		head->len = len;
+		mem_site_add(head, site);
+
+		return p;
+	}
+
+	/* Move it */
+	mem = mem_alloc_aux(len, site);
+	memcpy(mem, p, MIN(old, len));
+	mem_free(p);
 
 	return mem;
 }
 
+/*
+ * Allocate `len` bytes of memory.
+ *
+ * Returns:
+ *  - NULL if `len` == 0; or
+ *  - a pointer to a block of memory of at least `len` bytes
+ *
+ * Doesn't return on out of memory.
+ */
+void *mem_alloc(size_t len)
+{
+	return mem_alloc_aux(len, 0);
+}
+
 void *mem_zalloc(size_t len)
 {
 	void *mem = mem_alloc(len);
@@ -58,28 +289,102 @@ void *mem_zalloc(size_t len)
 
 void mem_free(void *p)
 {
+	mem_head *head;
+
 	if (!p) return;
 
+	head = HEAD(p);
+	mem_site_remove(head);
+
 	if (mem_flags & MEM_POISON_FREE)
-		memset(p, 0xCD, SZ(p));
-	free((char *)p - sizeof(size_t));
+		memset(p, 0xCD, head->len);
+
+	if (head->len <= MEM_POOL_MAX)
+		mem_pool_put(MEM_CLASS(head->len), head);
+	else
+		free(head);
 }
 
 void *mem_realloc(void *p, size_t len)
 {
-	char *m = p;
+	return mem_realloc_aux(p, len, 0);
+}
 
-	/* Fail gracefully */
-	if (len == 0) return (NULL);
+#ifdef MEM_STATS
+
+void *mem_alloc_site(size_t len, const char *file, int line)
+{
+	return mem_alloc_aux(len, mem_site_find(file, line));
+}
+
+void *mem_zalloc_site(size_t len, const char *file, int line)
+{
+	void *mem = mem_alloc_site(len, file, line);
+	memset(mem, 0, len);
+	return mem;
+}
+
+void *mem_realloc_site(void *p, size_t len, const char *file, int line)
+{
+	return mem_realloc_aux(p, len, mem_site_find(file, line));
+}
+
+char *string_make_site(const char *str, const char *file, int line)
+{
+	char *res;
+	size_t siz;
 
-	m = realloc(m ? m - sizeof(size_t) : NULL, len + sizeof(size_t));
-	m += sizeof(size_t);
+	if (!str) return NULL;
 
-	/* Handle OOM */
-	if (!m) quit("Out of Memory!");
-	SZ(m) = len;
+	siz = strlen(str) + 1;
+	res = mem_alloc_site(siz, file, line);
+	my_strcpy(res, str, siz);
 
-	return m;
+	return res;
+}
+
+#endif /* MEM_STATS */
+
+/*
+ * Describe the memory in use, a line at a time, to `dump`.
+ */
+void mem_stats_dump(void (*dump)(const char *line))
+{
+	char buf[160];
+	int c;
+#ifdef MEM_STATS
+	size_t i;
+#endif
+
+	dump("Pool    In use   Slabs");
+	for (c = 0; c < MEM_CLASSES; c++)
+	{
+		strnfmt(buf, sizeof(buf), "%4lu  %8lu  %6lu",
+			(unsigned long)mem_class_size[c],
+			(unsigned long)mem_pool_used[c],
+			(unsigned long)mem_pool_slabs[c]);
+		dump(buf);
+	}
+
+#ifdef MEM_STATS
+	dump("");
+	dump("Bytes      Peak       Live     Allocs   Site");
+	for (i = 0; i < mem_sites_n; i++)
+	{
+		mem_site *s = &mem_sites[i];
+
+		if (!s->allocs) continue;
+
+		strnfmt(buf, sizeof(buf), "%-10lu %-10lu %-8lu %-8lu %s:%d",
+			(unsigned long)s->bytes, (unsigned long)s->peak,
+			(unsigned long)s->live, (unsigned long)s->allocs,
+			s->file, s->line);
+		dump(buf);
+	}
+#else
+	dump("");
+	dump("(Build with MEM_STATS defined for figures by call site.)");
+#endif
 }
 
 /*
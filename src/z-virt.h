@@ -62,6 +62,25 @@ char *string_make(const char *str);
 void string_free(char *str);
 char *string_append(char *s1, const char *s2);
 
+/*
+ * With MEM_STATS defined (for example in CFLAGS), allocations are counted
+ * by the call site which made them, at a small cost in speed and space.
+ */
+#ifdef MEM_STATS
+void *mem_alloc_site(size_t len, const char *file, int line);
+void *mem_zalloc_site(size_t len, const char *file, int line);
+void *mem_realloc_site(void *p, size_t len, const char *file, int line);
+char *string_make_site(const char *str, const char *file, int line);
+
+#define mem_alloc(L)		mem_alloc_site((L), __FILE__, __LINE__)
+#define mem_zalloc(L)		mem_zalloc_site((L), __FILE__, __LINE__)
+#define mem_realloc(P, L)	mem_realloc_site((P), (L), __FILE__, __LINE__)
+#define string_make(S)		string_make_site((S), __FILE__, __LINE__)
+#endif
+
+/* Describe the memory in use, a line at a time */
+void mem_stats_dump(void (*dump)(const char *line));
+
 enum {
 	MEM_POISON_ALLOC = 0x00000001,
 	MEM_POISON_FREE  = 0x00000002
@@ -69,4 +88,7 @@ enum {
 
 extern unsigned int mem_flags;
 
+/* Number of blocks allocated (or moved by mem_realloc()) so far */
+extern unsigned long mem_allocs;
+
 #endif /* INCLUDED_Z_VIRT_H */